@@ -7,6 +7,7 @@
 #include "Character/TrueFPSCharacterInterface.h"
 #include "Weapons/TrueFPSWeaponBase.h"
 #include "Settings/TrueFPSAnimInstanceSettings.h"
+#include "Camera/PlayerCameraManager.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -20,6 +21,7 @@ void UTrueFPSAnimInstanceBase::NativeInitializeAnimation()
 	Super::NativeInitializeAnimation();
 
 	Character = Cast<ACharacter>(GetOwningActor());
+	Mesh = GetSkelMeshComponent();
 }
 
 void UTrueFPSAnimInstanceBase::NativeBeginPlay()
@@ -39,17 +41,48 @@ void UTrueFPSAnimInstanceBase::NativeUpdateAnimation(const float DeltaTime)
 
 	State.bFirstPerson = Character->IsLocallyControlled() && ITrueFPSCharacterInterface::Execute_TrueFPSInterface_IsAlive(Character);
 
+	CurrentVelocity = Character->GetCharacterMovement()->Velocity;
+	CurrentSpeed = CurrentVelocity.Size();
+
 	RefreshRotations(DeltaTime);
 	RefreshLocomotionState(DeltaTime);
 	RefreshAiming(DeltaTime);
 	RefreshRelativeTransforms(DeltaTime);
-	RefreshAccumulativeOffsets(DeltaTime);
+
+	if (State.bFirstPerson || IsWithinWeaponSwayDistance())
+	{
+		RefreshAccumulativeOffsets(DeltaTime);
+	}
+	else
+	{
+		const ATrueFPSWeaponBase* CurrentWeapon = ITrueFPSCharacterInterface::Execute_TrueFPSInterface_GetCurrentWeapon(Character);
+		State.OffsetTransform = CurrentWeapon ? CurrentWeapon->GetOffsetTransform() : FTransform::Identity;
+	}
+
 	RefreshPlacementTransform(DeltaTime);
 	RefreshTurnInPlaceState(DeltaTime);
 
 	PostRefresh();
 }
 
+bool UTrueFPSAnimInstanceBase::IsWithinWeaponSwayDistance() const
+{
+	const FVector CharacterLocation = Character->GetActorLocation();
+	const float MaxDistanceSquared = FMath::Square(Settings->MaxWeaponSwayDistance);
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager
+			&& FVector::DistSquared(PC->PlayerCameraManager->GetCameraLocation(), CharacterLocation) <= MaxDistanceSquared)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void UTrueFPSAnimInstanceBase::RefreshRotations(const float DeltaTime)
 {
 	check(IsInGameThread());
@@ -87,8 +120,8 @@ void UTrueFPSAnimInstanceBase::RefreshLocomotionState(const float DeltaTime)
 {
 	check(IsInGameThread());
 	
-	State.MovementDirection = UKismetAnimationLibrary::CalculateDirection(Character->GetCharacterMovement()->Velocity, FRotator(0.f, Character->GetBaseAimRotation().Yaw, 0.f));
-	State.MovementSpeed = Character->GetCharacterMovement()->Velocity.Size();
+	State.MovementDirection = UKismetAnimationLibrary::CalculateDirection(CurrentVelocity, FRotator(0.f, Character->GetBaseAimRotation().Yaw, 0.f));
+	State.MovementSpeed = CurrentSpeed;
 
 	State.bIsFalling = Character->GetCharacterMovement()->IsFalling();
 	State.bIsRunning = ITrueFPSCharacterInterface::Execute_TrueFPSInterface_IsRunning(Character);
@@ -103,10 +136,20 @@ void UTrueFPSAnimInstanceBase::RefreshRelativeTransforms(float DeltaTime)
 	{
 		const FTransform DomHandTransform = ITrueFPSCharacterInterface::Execute_TrueFPSInterface_GetDomHandTransform(Character);
 
+		// The weapon hangs off the dominant hand, the sights relative to it only move with the weapon and its sights
+		const int32 SightsChangeCounter = CurrentWeapon->GetState().SightsChangeCounter;
+		if (CurrentWeapon != CountedWeapon.Get() || SightsChangeCounter != CountedSightsChangeCounter)
+		{
+			CountedWeapon = CurrentWeapon;
+			CountedSightsChangeCounter = SightsChangeCounter;
+			State.SightsRelativeTransform = CurrentWeapon->GetSightsWorldTransform().GetRelativeTransform(DomHandTransform);
+			State.WeaponChangeCounter++;
+		}
+
+		// The origin blends towards the sights with the aiming value, it's refreshed every update
 		const FTransform OrientationWorldTransform = CurrentWeapon->GetOrientationWorldTransform(State.AimingValue);
 		
 		State.OriginRelativeTransform = OrientationWorldTransform.GetRelativeTransform(DomHandTransform);
-		if (State.AimingValue > 0.f) State.SightsRelativeTransform = CurrentWeapon->GetSightsWorldTransform().GetRelativeTransform(DomHandTransform);
 
 		State.CurrentWeaponOffHandAdditiveTransform = CurrentWeapon->GetState().OffHandAdditiveTransform;
 	}
@@ -140,13 +183,12 @@ void UTrueFPSAnimInstanceBase::RefreshAccumulativeOffsets(float DeltaTime)
 	State.AccumulativeRotation = UKismetMathLibrary::RInterpTo(State.AccumulativeRotation, FRotator::ZeroRotator, DeltaTime, Settings->AccumulativeRotationReturnInterpSpeed);
 	State.AccumulativeRotationInterp = UKismetMathLibrary::RInterpTo(State.AccumulativeRotationInterp, State.AccumulativeRotation, DeltaTime, Settings->AccumulativeRotationInterpSpeed);
 
-	const auto bApplyWeaponSwayCurve = !Character->GetCharacterMovement()->IsFalling() && Character->GetCharacterMovement()->Velocity.Size() > Settings->MinMoveSpeedToApplyMovementSway;
-	State.MovementSpeedInterp = UKismetMathLibrary::FInterpTo(State.MovementSpeedInterp, bApplyWeaponSwayCurve ? Character->GetCharacterMovement()->Velocity.Size() : 0.f, DeltaTime, 3.f);
+	const auto bApplyWeaponSwayCurve = !State.bIsFalling && CurrentSpeed > Settings->MinMoveSpeedToApplyMovementSway;
+	State.MovementSpeedInterp = UKismetMathLibrary::FInterpTo(State.MovementSpeedInterp, bApplyWeaponSwayCurve ? CurrentSpeed : 0.f, DeltaTime, 3.f);
 
-	const FVector Velocity = Character->GetCharacterMovement()->Velocity;
-	const FVector Difference = (Velocity - State.LastVelocity) * DeltaTime;
+	const FVector Difference = (CurrentVelocity - State.LastVelocity) * DeltaTime;
 	
-	State.VelocityTarget = UKismetMathLibrary::VInterpTo(State.VelocityTarget, Character->GetCharacterMovement()->Velocity, DeltaTime, Settings->VelocityInterpSpeed);
+	State.VelocityTarget = UKismetMathLibrary::VInterpTo(State.VelocityTarget, CurrentVelocity, DeltaTime, Settings->VelocityInterpSpeed);
 	if (Difference.Z > 1.5f) // Jumping / landing impulse
 		State.VelocityTarget.Z += Difference.Z * 400.f;
 
@@ -188,19 +230,21 @@ void UTrueFPSAnimInstanceBase::RefreshAccumulativeOffsets(float DeltaTime)
 		TargetOffsetRotation.Yaw *= State.OffsetWeightScale;
 		TargetOffsetRotation.Roll *= State.OffsetWeightScale;
 
+		const FSwaySamples SwaySamples = UpdateSwaySamples(DeltaTime);
+
 		// Apply idle vector curve anim to offset location
-		if (State.IdleWeaponSwayCurve.IsValid())
+		if (BakedIdleSway.IsValid())
 		{
-			const FVector SwayOffset = State.IdleWeaponSwayCurve->GetVectorValue(GetWorld()->GetTimeSeconds()) * 8.f * FMath::Max<float>(1.f - State.AimingValue, 0.1f);
+			const FVector SwayOffset = SwaySamples.Idle * 8.f * FMath::Max<float>(1.f - State.AimingValue, 0.1f);
 			TargetOffsetLocation += SwayOffset;
 			TargetOffsetRotation += FRotator(SwayOffset.Z * 0.3f, SwayOffset.Y * 0.5f, SwayOffset.Y * 1.2f);
 		}
 		
 		// Apply movement offset to offset location
-		if (State.MovementWeaponSwayLocationCurve.IsValid() && State.MovementWeaponSwayRotationCurve.IsValid() && State.bFirstPerson)
+		if (BakedMovementSwayLocation.IsValid() && BakedMovementSwayRotation.IsValid() && State.bFirstPerson)
 		{
-			const FVector SwayLocationOffset = State.MovementWeaponSwayLocationCurve->GetVectorValue(State.MovementWeaponSwayProgressTime) * (State.MovementSpeedInterp / Settings->MaxMoveSpeed) * 5.f * FMath::Max<float>(1.f - State.MovementAnimationsAvoidance, 0.05f);
-			const FVector SwayRotationOffset = State.MovementWeaponSwayRotationCurve->GetVectorValue(State.MovementWeaponSwayProgressTime) * (State.MovementSpeedInterp / Settings->MaxMoveSpeed) * 5.f * FMath::Max<float>(1.f - State.MovementAnimationsAvoidance, 0.05f);
+			const FVector SwayLocationOffset = SwaySamples.MovementLocation * (State.MovementSpeedInterp / Settings->MaxMoveSpeed) * 5.f * FMath::Max<float>(1.f - State.MovementAnimationsAvoidance, 0.05f);
+			const FVector SwayRotationOffset = SwaySamples.MovementRotation * (State.MovementSpeedInterp / Settings->MaxMoveSpeed) * 5.f * FMath::Max<float>(1.f - State.MovementAnimationsAvoidance, 0.05f);
 			TargetOffsetLocation += SwayLocationOffset * 0.7f;
 			TargetOffsetRotation += FRotator(SwayRotationOffset.Z, SwayRotationOffset.Y, SwayRotationOffset.Y);
 		}
@@ -213,6 +257,38 @@ void UTrueFPSAnimInstanceBase::RefreshAccumulativeOffsets(float DeltaTime)
 	}
 }
 
+UTrueFPSAnimInstanceBase::FSwaySamples UTrueFPSAnimInstanceBase::SampleSwayCurves() const
+{
+	FSwaySamples Samples;
+	Samples.Idle = BakedIdleSway.Sample(GetWorld()->GetTimeSeconds());
+	Samples.MovementLocation = BakedMovementSwayLocation.Sample(State.MovementWeaponSwayProgressTime);
+	Samples.MovementRotation = BakedMovementSwayRotation.Sample(State.MovementWeaponSwayProgressTime);
+	return Samples;
+}
+
+UTrueFPSAnimInstanceBase::FSwaySamples UTrueFPSAnimInstanceBase::UpdateSwaySamples(const float DeltaTime)
+{
+	if (Settings->SwaySampleRate <= 0.f) return SampleSwayCurves();
+
+	// Sample at a fixed rate and blend between the last two samples, trailing the curves by one sample interval
+	const float SampleInterval = 1.f / Settings->SwaySampleRate;
+	SwaySampleTime += DeltaTime;
+	if (SwaySampleTime >= SampleInterval)
+	{
+		PreviousSwaySamples = NextSwaySamples;
+		NextSwaySamples = SampleSwayCurves();
+		SwaySampleTime = FMath::Fmod(SwaySampleTime, SampleInterval);
+	}
+
+	const float Alpha = FMath::Min(SwaySampleTime * Settings->SwaySampleRate, 1.f);
+
+	FSwaySamples Samples;
+	Samples.Idle = FMath::Lerp(PreviousSwaySamples.Idle, NextSwaySamples.Idle, Alpha);
+	Samples.MovementLocation = FMath::Lerp(PreviousSwaySamples.MovementLocation, NextSwaySamples.MovementLocation, Alpha);
+	Samples.MovementRotation = FMath::Lerp(PreviousSwaySamples.MovementRotation, NextSwaySamples.MovementRotation, Alpha);
+	return Samples;
+}
+
 void UTrueFPSAnimInstanceBase::RefreshPlacementTransform(float DeltaTime)
 {
 	FVector TargetPlacementLocation{FVector::ZeroVector};
@@ -226,7 +302,7 @@ void UTrueFPSAnimInstanceBase::RefreshPlacementTransform(float DeltaTime)
 
 void UTrueFPSAnimInstanceBase::RefreshTurnInPlaceState(const float DeltaTime)
 {
-	if (!State.bIsTurningInPlace && abs(State.RootYawOffset) < 2.f && Character->GetCharacterMovement()->Velocity.Size() < State.StationaryVelocityThreshold)
+	if (!State.bIsTurningInPlace && abs(State.RootYawOffset) < 2.f && CurrentSpeed < State.StationaryVelocityThreshold)
 	{
 		State.bIsTurningInPlace = true;
 	}
@@ -236,7 +312,7 @@ void UTrueFPSAnimInstanceBase::RefreshTurnInPlaceState(const float DeltaTime)
 		State.RootYawOffset += FRotator::NormalizeAxis(State.LastCameraRotation.Yaw - State.CameraRotation.Yaw);
 
 		// If exceeded rotation or velocity thresholds, set turn in place to false and set rot speed to desired speed
-		if (Character->GetCharacterMovement()->Velocity.Size() >= State.StationaryVelocityThreshold)
+		if (CurrentSpeed >= State.StationaryVelocityThreshold)
 		{
 			State.bIsTurningInPlace = false;
 			State.StationaryYawInterpSpeed = 8.f;
@@ -285,7 +361,7 @@ void UTrueFPSAnimInstanceBase::RefreshTurnInPlaceState(const float DeltaTime)
 void UTrueFPSAnimInstanceBase::PostRefresh()
 {
 	State.LastCameraRotation = State.CameraRotation;
-	State.LastVelocity = Character->GetCharacterMovement()->Velocity;
+	State.LastVelocity = CurrentVelocity;
 }
 
 void UTrueFPSAnimInstanceBase::OnChangeWeapon(const ATrueFPSWeaponBase* NewWeapon)
@@ -302,6 +378,12 @@ void UTrueFPSAnimInstanceBase::OnChangeWeapon(const ATrueFPSWeaponBase* NewWeapo
 
 		const FTransform DomHandTransform = ITrueFPSCharacterInterface::Execute_TrueFPSInterface_GetDomHandTransform(Character);
 		State.SightsRelativeTransform = NewWeapon->GetSightsWorldTransform().GetRelativeTransform(DomHandTransform);
+
+		// Bake the sway curves into tables once here instead of evaluating the curves every update
+		const float BakeSampleRate = IsValid(Settings) ? Settings->SwayBakeSampleRate : 60.f;
+		if (BakedIdleSway.SourceCurve != State.IdleWeaponSwayCurve.Get()) BakedIdleSway.Bake(State.IdleWeaponSwayCurve.Get(), BakeSampleRate);
+		if (BakedMovementSwayLocation.SourceCurve != State.MovementWeaponSwayLocationCurve.Get()) BakedMovementSwayLocation.Bake(State.MovementWeaponSwayLocationCurve.Get(), BakeSampleRate);
+		if (BakedMovementSwayRotation.SourceCurve != State.MovementWeaponSwayRotationCurve.Get()) BakedMovementSwayRotation.Bake(State.MovementWeaponSwayRotationCurve.Get(), BakeSampleRate);
 	}
 	else
 	{
@@ -313,5 +395,13 @@ void UTrueFPSAnimInstanceBase::OnChangeWeapon(const ATrueFPSWeaponBase* NewWeapo
 		State.CurrentWeaponCustomOffsetTransform = FTransform::Identity;
 		State.AimingHeadRotationOffset = FRotator::ZeroRotator;
 		State.SightsRelativeTransform = FTransform::Identity;
+
+		BakedIdleSway.Reset();
+		BakedMovementSwayLocation.Reset();
+		BakedMovementSwayRotation.Reset();
 	}
+
+	PreviousSwaySamples = NextSwaySamples = SampleSwayCurves();
+	SwaySampleTime = 0.f;
+	State.WeaponChangeCounter++;
 }
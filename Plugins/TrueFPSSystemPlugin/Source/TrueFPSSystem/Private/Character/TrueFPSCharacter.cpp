@@ -5,13 +5,17 @@
 
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
+#include "AnimationRuntime.h"
 #include "Character/Animation/TrueFPSAnimInstanceBase.h"
 #include "TrueFPSSystem.h"
 #include "Weapons/TrueFPSWeaponBase.h"
 #include "Camera/CameraComponent.h"
 #include "Character/TrueFPSCharacterMovement.h"
 #include "Character/TrueFPSPlayerController.h"
+#include "Character/TrueFPSRagdollManager.h"
+#include "Character/TrueFPSTickManager.h"
 #include "Components/CapsuleComponent.h"
+#include "Engine/SkinnedAsset.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
@@ -42,6 +46,8 @@ ATrueFPSCharacter::ATrueFPSCharacter(const FObjectInitializer& ObjectInitializer
 	GetMesh()->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
 	GetMesh()->bOnlyOwnerSee = false;
 	GetMesh()->bOwnerNoSee = true;
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+	GetMesh()->OnAnimUpdateRateParamsCreated.BindUObject(this, &ThisClass::OnAnimUpdateRateParamsCreated);
 
 	// Create the ClientMesh
 	ClientMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("Client Mesh"));
@@ -88,28 +94,71 @@ void ATrueFPSCharacter::PostInitializeComponents()
 		{
 			// Needs to happen after character is added to rep graph
 			GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::SpawnDefaultInventory);
+
+			GetWorldTimerManager().SetTimer(TimerHandle_HealthRegen, this, &ThisClass::RefreshHealthRegen, Settings->HealthRegenInterval, true);
 		}
 	}
 }
 
+void ATrueFPSCharacter::OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params)
+{
+	if (!IsValid(Settings) || Settings->ThirdPersonLODFrameSkips.IsEmpty())
+	{
+		return;
+	}
+
+	// Skip frames by LOD rather than by screen size, the LOD screen sizes are already tuned per mesh
+	Params->bShouldUseLodMap = true;
+	Params->LODToFrameSkipMap.Reset();
+	for (int32 LODIndex = 0; LODIndex < MAX_MESH_LOD_COUNT; ++LODIndex)
+	{
+		Params->LODToFrameSkipMap.Add(LODIndex, Settings->ThirdPersonLODFrameSkips[FMath::Min(LODIndex, Settings->ThirdPersonLODFrameSkips.Num() - 1)]);
+	}
+	Params->MaxEvalRateForInterpolation = Settings->MaxInterpolatedUpdateRate;
+}
+
 void ATrueFPSCharacter::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bManagedTick)
+	{
+		RefreshState(DeltaTime);
+	}
+
+	UpdateActorTickEnabled();
+}
+
+void ATrueFPSCharacter::RefreshState(const float DeltaTime)
 {
 	if (!IsValid(Settings))
 	{
-		Super::Tick(DeltaTime);
 		return;
 	}
-	
-	Super::Tick(DeltaTime);
-	
-	RefreshLeanValue(DeltaTime);
 
-	RefreshCrouchValue(DeltaTime);
+	if (bRefreshLean)
+	{
+		RefreshLeanValue(DeltaTime);
+	}
+
+	if (bRefreshCrouch)
+	{
+		RefreshCrouchValue(DeltaTime);
+	}
 
-	RefreshHealthRegen(DeltaTime);
+	if (bRefreshWallAvoidance)
+	{
+		RefreshWallAvoidanceState(DeltaTime);
+	}
+}
 
-	RefreshWallAvoidanceState(DeltaTime);
+void ATrueFPSCharacter::UpdateActorTickEnabled()
+{
+	SetActorTickEnabled(bBlueprintTick || (!bManagedTick && NeedsStateRefresh()));
+}
 
+void ATrueFPSCharacter::UpdateLocallyControlledActorCache() const
+{
 	const APlayerController* PC = Cast<APlayerController>(GetController());
 	const bool bLocallyControlled = (PC ? PC->IsLocalController() : false);
 	const uint32 UniqueID = GetUniqueID();
@@ -117,9 +166,20 @@ void ATrueFPSCharacter::Tick(float DeltaTime)
 	{
 	    ULocalPlayerSoundNode::GetLocallyControlledActorCache().Add(UniqueID, bLocallyControlled);
 	});
-	
-	TArray<FVector> PointsToTest;
-	BuildPauseReplicationCheckPoints(PointsToTest);
+}
+
+void ATrueFPSCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bManagedTick)
+	{
+		if (UTrueFPSTickManager* TickManager = GetWorld()->GetSubsystem<UTrueFPSTickManager>())
+		{
+			TickManager->UnregisterCharacter(this);
+		}
+		bManagedTick = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ATrueFPSCharacter::Destroyed()
@@ -140,11 +200,27 @@ void ATrueFPSCharacter::PawnClientRestart()
 void ATrueFPSCharacter::PossessedBy(AController* C)
 {
 	Super::PossessedBy(C);
+
+	RefreshTeamCache();
 }
 
 void ATrueFPSCharacter::OnRep_PlayerState()
 {
 	Super::OnRep_PlayerState();
+
+	RefreshTeamCache();
+}
+
+void ATrueFPSCharacter::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	UpdateLocallyControlledActorCache();
+
+	// Leaning only interpolates with a player controller, pick up a target set before possession
+	bRefreshLean = true;
+	bRefreshWallAvoidance = bIsAiming && IsLocallyControlled();
+	UpdateActorTickEnabled();
 }
 
 bool ATrueFPSCharacter::IsReplicationPausedForConnection(const FNetViewer& ConnectionOwnerNetViewer)
@@ -164,20 +240,43 @@ bool ATrueFPSCharacter::IsEnemyFor(AController* TestPC) const
 		return false;
 	}
 
-	ATrueFPSPlayerState* TestPlayerState = Cast<ATrueFPSPlayerState>(TestPC->PlayerState);
-	ATrueFPSPlayerState* MyPlayerState = Cast<ATrueFPSPlayerState>(GetPlayerState());
+	return CanBeDamagedByTeam(GetTeamNumOf(TestPC));
+}
+
+void ATrueFPSCharacter::RefreshTeamCache()
+{
+	const ATrueFPSPlayerState* MyPlayerState = Cast<ATrueFPSPlayerState>(GetPlayerState());
+	State.TeamNum = MyPlayerState ? MyPlayerState->GetTeamNum() : INDEX_NONE;
+}
 
-	bool bIsEnemy = true;
-	if (GetWorld()->GetGameState())
+bool ATrueFPSCharacter::CanBeDamagedByTeam(const int32 InstigatorTeamNum) const
+{
+	// clients only know the game mode's defaults, and until the game state replicated everyone is an enemy
+	const ATrueFPSGameMode* Game = GetWorld()->GetAuthGameMode<ATrueFPSGameMode>();
+	if (!Game)
 	{
-		const ATrueFPSGameMode* DefGame = GetWorld()->GetGameState()->GetDefaultGameMode<ATrueFPSGameMode>();
-		if (DefGame && MyPlayerState && TestPlayerState)
-		{
-			bIsEnemy = DefGame->CanDealDamage(TestPlayerState, MyPlayerState);
-		}
+		const AGameStateBase* const GameState = GetWorld()->GetGameState();
+		Game = GameState ? GameState->GetDefaultGameMode<ATrueFPSGameMode>() : nullptr;
 	}
 
-	return bIsEnemy;
+	return !Game || Game->CanDealDamage(InstigatorTeamNum, State.TeamNum);
+}
+
+int32 ATrueFPSCharacter::GetTeamNumOf(const AController* InController)
+{
+	if (!InController)
+	{
+		return INDEX_NONE;
+	}
+
+	if (const ATrueFPSCharacter* ControlledCharacter = Cast<ATrueFPSCharacter>(InController->GetPawn()))
+	{
+		return ControlledCharacter->GetTeamNum();
+	}
+
+	// e.g. damage from a projectile whose instigator has died since
+	const ATrueFPSPlayerState* ControllerPlayerState = Cast<ATrueFPSPlayerState>(InController->PlayerState);
+	return ControllerPlayerState ? ControllerPlayerState->GetTeamNum() : INDEX_NONE;
 }
 
 void ATrueFPSCharacter::BeginPlay()
@@ -194,6 +293,144 @@ void ATrueFPSCharacter::BeginPlay()
 	}
 
 	ClientMesh->HideBoneByName(FName("neck_01"), PBO_None);
+
+	if (IsValid(Settings) && Settings->CameraTargetMode != ETrueFPSCameraTargetMode::HeadSocket)
+	{
+		InitHeadOffsetTable();
+		GetMesh()->OnBoneTransformsFinalizedMC.AddUObject(this, &ThisClass::OnPoseFinalized);
+	}
+
+	// The character only ticks while something needs refreshing, unless a blueprint relies on the tick event
+	bBlueprintTick = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(ATrueFPSCharacter, ReceiveTick));
+	if (UTrueFPSTickManager* TickManager = UTrueFPSTickManager::Get(this))
+	{
+		TickManager->RegisterCharacter(this);
+		bManagedTick = true;
+	}
+	UpdateLocallyControlledActorCache();
+	UpdateActorTickEnabled();
+}
+
+FVector2f ATrueFPSCharacter::GetHeadOffsetTableCoords() const
+{
+	const float LeanAlpha = Settings->LeanAmount > 0.f ? FMath::Clamp(State.LeanValue / Settings->LeanAmount, -1.f, 1.f) * 0.5f + 0.5f : 0.5f;
+	return FVector2f(FMath::Clamp(State.CrouchValue, 0.f, 1.f) * (HeadOffsetCrouchSteps - 1), LeanAlpha * (HeadOffsetLeanSteps - 1));
+}
+
+bool ATrueFPSCharacter::BuildHeadOffsetTable(const FReferenceSkeleton& RefSkeleton, const FTransform& MeshRelativeTransform, const float CrouchHeadDrop, const float LeanAmount, TArrayView<FVector> OutTable)
+{
+	const int32 HeadIndex = RefSkeleton.FindBoneIndex(FName("head"));
+	if (HeadIndex == INDEX_NONE || OutTable.Num() != HeadOffsetCrouchSteps * HeadOffsetLeanSteps)
+	{
+		return false;
+	}
+
+	const FVector Head = MeshRelativeTransform.TransformPosition(FAnimationRuntime::GetComponentSpaceTransformRefPose(RefSkeleton, HeadIndex).GetLocation());
+
+	const int32 PelvisIndex = RefSkeleton.FindBoneIndex(FName("pelvis"));
+	const FVector Pivot = PelvisIndex != INDEX_NONE
+		? MeshRelativeTransform.TransformPosition(FAnimationRuntime::GetComponentSpaceTransformRefPose(RefSkeleton, PelvisIndex).GetLocation())
+		: MeshRelativeTransform.GetLocation();
+	const FVector PivotToHead = Head - Pivot;
+
+	for (int32 Crouch = 0; Crouch < HeadOffsetCrouchSteps; ++Crouch)
+	{
+		const FVector CrouchOffset(0.0, 0.0, -CrouchHeadDrop * Crouch / (HeadOffsetCrouchSteps - 1));
+
+		for (int32 Lean = 0; Lean < HeadOffsetLeanSteps; ++Lean)
+		{
+			// Rolls towards -Y when leaning left, +Y when leaning right
+			float Sin, Cos;
+			FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(LeanAmount * (2.f * Lean / (HeadOffsetLeanSteps - 1) - 1.f)));
+			const FVector Leaned(PivotToHead.X, PivotToHead.Y * Cos + PivotToHead.Z * Sin, PivotToHead.Z * Cos - PivotToHead.Y * Sin);
+
+			OutTable[Crouch * HeadOffsetLeanSteps + Lean] = Pivot + Leaned + CrouchOffset;
+		}
+	}
+
+	return true;
+}
+
+void ATrueFPSCharacter::InitHeadOffsetTable()
+{
+	const USkinnedAsset* SkinnedAsset = GetMesh()->GetSkinnedAsset();
+	const ACharacter* DefaultCharacter = GetClass()->GetDefaultObject<ACharacter>();
+	const float CrouchHeightDelta = (DefaultCharacter->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight() - GetCharacterMovement()->GetCrouchedHalfHeight()) * GetCapsuleComponent()->GetShapeScale();
+	const FTransform MeshRelativeTransform(GetBaseRotationOffset(), GetBaseTranslationOffset(), GetMesh()->GetRelativeScale3D());
+
+	// The top of the capsule, and the head with it, drops by twice the half height difference over the feet
+	bHasHeadOffsetTable = SkinnedAsset && BuildHeadOffsetTable(SkinnedAsset->GetRefSkeleton(), MeshRelativeTransform, 2.f * CrouchHeightDelta, Settings->LeanAmount, MakeArrayView(HeadOffsetTable));
+
+	// Kept relative to the mesh rather than the actor, the capsule snaps to its crouched height while the crouch value eases in and the mesh is moved to make up for it
+	for (FVector& HeadOffset : HeadOffsetTable)
+	{
+		HeadOffset = MeshRelativeTransform.InverseTransformPosition(HeadOffset);
+	}
+}
+
+void ATrueFPSCharacter::OnPoseFinalized()
+{
+	LastPoseHeadLocation = GetMesh()->GetSocketLocation(FName("head"));
+	LastPoseTime = GetWorld()->GetTimeSeconds();
+	bHasLastPose = true;
+
+	if (!bHasHeadOffsetTable)
+	{
+		return;
+	}
+
+	// Only record poses close to a table entry, in between ones would blur the entries
+	const FVector2f Coords = GetHeadOffsetTableCoords();
+	const FVector2f Nearest(FMath::RoundToFloat(Coords.X), FMath::RoundToFloat(Coords.Y));
+	if (FMath::Abs(Coords.X - Nearest.X) > 0.1f || FMath::Abs(Coords.Y - Nearest.Y) > 0.1f)
+	{
+		return;
+	}
+
+	// Eases from the seed towards what the animations actually do, and smooths out the odd pose from a montage or a hit reaction
+	const int32 Index = FMath::RoundToInt(Nearest.X) * HeadOffsetLeanSteps + FMath::RoundToInt(Nearest.Y);
+	HeadOffsetTable[Index] = FMath::Lerp(HeadOffsetTable[Index], GetMesh()->GetComponentTransform().InverseTransformPosition(LastPoseHeadLocation), 0.1f);
+}
+
+FVector ATrueFPSCharacter::GetBakedHeadOffset() const
+{
+	const FVector2f Coords = GetHeadOffsetTableCoords();
+	const int32 Crouch0 = FMath::FloorToInt(Coords.X);
+	const int32 Lean0 = FMath::FloorToInt(Coords.Y);
+	const int32 Crouch1 = FMath::Min(Crouch0 + 1, HeadOffsetCrouchSteps - 1);
+	const int32 Lean1 = FMath::Min(Lean0 + 1, HeadOffsetLeanSteps - 1);
+
+	return FMath::BiLerp(
+		HeadOffsetTable[Crouch0 * HeadOffsetLeanSteps + Lean0], HeadOffsetTable[Crouch0 * HeadOffsetLeanSteps + Lean1],
+		HeadOffsetTable[Crouch1 * HeadOffsetLeanSteps + Lean0], HeadOffsetTable[Crouch1 * HeadOffsetLeanSteps + Lean1],
+		Coords.Y - Lean0, Coords.X - Crouch0);
+}
+
+FVector ATrueFPSCharacter::TrueFPSInterface_GetFirstPersonCameraTarget_Implementation() const
+{
+	// Without a head bone or a finished pose there is nothing to go on, fall back on the socket
+	if (IsValid(Settings))
+	{
+		switch (Settings->CameraTargetMode)
+		{
+		case ETrueFPSCameraTargetMode::Analytic:
+			if (bHasHeadOffsetTable)
+			{
+				return GetMesh()->GetComponentTransform().TransformPosition(GetBakedHeadOffset());
+			}
+			break;
+		case ETrueFPSCameraTargetMode::Extrapolated:
+			if (bHasLastPose)
+			{
+				return LastPoseHeadLocation + GetVelocity() * (GetWorld()->GetTimeSeconds() - LastPoseTime);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	return GetMesh()->GetSocketLocation(FName("head"));
 }
 
 void ATrueFPSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -353,6 +590,9 @@ void ATrueFPSCharacter::SetAiming(bool bNewAiming)
 {
 	bIsAiming = bNewAiming;
 
+	bRefreshWallAvoidance = bIsAiming && IsLocallyControlled();
+	UpdateActorTickEnabled();
+
 	if (GetLocalRole() < ROLE_Authority)
 	{
 		ServerSetAiming(bNewAiming);
@@ -602,6 +842,7 @@ float ATrueFPSCharacter::GetLowHealthPercentage() const
 void ATrueFPSCharacter::SetLeanValue(const float NewLeanValue)
 {
 	LeanValueTarget = NewLeanValue;
+	OnRep_LeanValueTarget();
 	
 	if (GetLocalRole() < ROLE_Authority)
 	{
@@ -626,6 +867,7 @@ void ATrueFPSCharacter::ToggleCrouching(const bool bNewCrouching)
 		CrouchValueTarget = 0.f;
 		UnCrouch();
 	}
+	OnRep_CrouchValueTarget();
 	
 	if (GetLocalRole() < ROLE_Authority)
 	{
@@ -638,9 +880,33 @@ void ATrueFPSCharacter::ServerToggleCrouching_Implementation(const bool bNewCrou
 	ToggleCrouching(bNewCrouching);
 }
 
+void ATrueFPSCharacter::OnRep_LeanValueTarget()
+{
+	bRefreshLean = true;
+	UpdateActorTickEnabled();
+}
+
+void ATrueFPSCharacter::OnRep_CrouchValueTarget()
+{
+	bRefreshCrouch = true;
+	UpdateActorTickEnabled();
+}
+
 void ATrueFPSCharacter::RefreshLeanValue(const float DeltaTime)
 {
-	if (const APlayerController* PC = GetController<APlayerController>(); !PC) return;
+	if (const APlayerController* PC = GetController<APlayerController>(); !PC)
+	{
+		bRefreshLean = false;
+		return;
+	}
+
+	// FInterpTo snaps to the target once close enough, the last update zeroes the roll input like the frame after used to
+	if (State.LeanValue == LeanValueTarget)
+	{
+		State.CurrentRollControllerInput = 0.f;
+		bRefreshLean = false;
+		return;
+	}
 
 	const float OldLeanValue = State.LeanValue;
 	State.LeanValue = UKismetMathLibrary::FInterpTo(State.LeanValue, LeanValueTarget, DeltaTime, Settings->AimingInterpSpeed);
@@ -652,15 +918,16 @@ void ATrueFPSCharacter::RefreshLeanValue(const float DeltaTime)
 void ATrueFPSCharacter::RefreshCrouchValue(const float DeltaTime)
 {
 	State.CrouchValue = UKismetMathLibrary::FInterpTo(State.CrouchValue, CrouchValueTarget, DeltaTime, 8.f);
+	bRefreshCrouch = State.CrouchValue != CrouchValueTarget;
 }
 
-void ATrueFPSCharacter::RefreshHealthRegen(const float DeltaTime)
+void ATrueFPSCharacter::RefreshHealthRegen()
 {
 	if (const ATrueFPSPlayerController* PC = Cast<ATrueFPSPlayerController>(Controller); PC && PC->HasHealthRegen())
 	{
 		if (this->Health < this->GetMaxHealth())
 		{
-			this->Health += 5 * DeltaTime;
+			this->Health += 5 * GetWorldTimerManager().GetTimerRate(TimerHandle_HealthRegen);
 			if (Health > this->GetMaxHealth())
 			{
 				Health = this->GetMaxHealth();
@@ -671,9 +938,14 @@ void ATrueFPSCharacter::RefreshHealthRegen(const float DeltaTime)
 
 void ATrueFPSCharacter::RefreshWallAvoidanceState(const float DeltaTime)
 {
-	if (IsLocallyControlled() && bIsAiming)
-		if (CurrentWeapon && CurrentWeapon->IsCloseToWall())
-			OnStopAiming();
+	if (!IsLocallyControlled() || !bIsAiming)
+	{
+		bRefreshWallAvoidance = false;
+		return;
+	}
+
+	if (CurrentWeapon && CurrentWeapon->IsCloseToWall())
+		OnStopAiming();
 }
 
 void ATrueFPSCharacter::TornOff()
@@ -996,6 +1268,11 @@ void ATrueFPSCharacter::SetRagdollPhysics()
 	else
 	{
 		SetLifeSpan(10.0f);
+
+		if (UTrueFPSRagdollManager* RagdollManager = GetWorld()->GetSubsystem<UTrueFPSRagdollManager>())
+		{
+			RagdollManager->AddRagdoll(this);
+		}
 	}
 }
 
@@ -1004,8 +1281,7 @@ void ATrueFPSCharacter::ReplicateHit(float Damage, FDamageEvent const& DamageEve
 {
 	const float TimeoutTime = GetWorld()->GetTimeSeconds() + 0.5f;
 
-	FDamageEvent const& LastDamageEvent = LastTakeHitInfo.GetDamageEvent();
-	if ((PawnInstigator == LastTakeHitInfo.PawnInstigator.Get()) && (LastDamageEvent.DamageTypeClass == LastTakeHitInfo.DamageTypeClass) && (State.LastTakeHitTimeTimeout == TimeoutTime))
+	if ((PawnInstigator == LastTakeHitInfo.PawnInstigator.Get()) && (DamageEvent.DamageTypeClass == LastTakeHitInfo.DamageTypeClass) && (State.LastTakeHitTimeTimeout == TimeoutTime))
 	{
 		// same frame damage
 		if (bKilled && LastTakeHitInfo.bKilled)
@@ -1021,7 +1297,7 @@ void ATrueFPSCharacter::ReplicateHit(float Damage, FDamageEvent const& DamageEve
 	LastTakeHitInfo.ActualDamage = Damage;
 	LastTakeHitInfo.PawnInstigator = Cast<ATrueFPSCharacter>(PawnInstigator);
 	LastTakeHitInfo.DamageCauser = DamageCauser;
-	LastTakeHitInfo.SetDamageEvent(DamageEvent);
+	LastTakeHitInfo.SetDamageEvent(DamageEvent, this, PawnInstigator);
 	LastTakeHitInfo.bKilled = bKilled;
 	LastTakeHitInfo.EnsureReplication();
 
@@ -1032,10 +1308,10 @@ void ATrueFPSCharacter::OnRep_LastTakeHitInfo()
 {
 	if (LastTakeHitInfo.bKilled)
 	{
-		OnDeath(LastTakeHitInfo.ActualDamage, LastTakeHitInfo.GetDamageEvent(), LastTakeHitInfo.PawnInstigator.Get(), LastTakeHitInfo.DamageCauser.Get());
+		OnDeath(LastTakeHitInfo.ActualDamage, LastTakeHitInfo.GetDamageEvent(this), LastTakeHitInfo.PawnInstigator.Get(), LastTakeHitInfo.DamageCauser.Get());
 	}
 	
-	PlayHit(LastTakeHitInfo.ActualDamage, LastTakeHitInfo.GetDamageEvent(), LastTakeHitInfo.PawnInstigator.Get(), LastTakeHitInfo.DamageCauser.Get(), LastTakeHitInfo.bKilled);
+	PlayHit(LastTakeHitInfo.ActualDamage, LastTakeHitInfo.GetDamageEvent(this), LastTakeHitInfo.PawnInstigator.Get(), LastTakeHitInfo.DamageCauser.Get(), LastTakeHitInfo.bKilled);
 }
 
 void ATrueFPSCharacter::SetCurrentWeapon(ATrueFPSWeaponBase* NewWeapon, ATrueFPSWeaponBase* LastWeapon)
@@ -1086,14 +1362,25 @@ void ATrueFPSCharacter::SpawnDefaultInventory()
 		return;
 	}
 
+	// weapons are recycled through the game mode's pools when there is one
+	ATrueFPSGameMode* const GameMode = GetWorld()->GetAuthGameMode<ATrueFPSGameMode>();
+
 	const int32 NumWeaponClasses = Settings->DefaultWeapons.Num();
 	for (int32 i = 0; i < NumWeaponClasses; i++)
 	{
 		if (Settings->DefaultWeapons[i])
 		{
-			FActorSpawnParameters SpawnInfo;
-			SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-			ATrueFPSWeaponBase* NewWeapon = GetWorld()->SpawnActor<ATrueFPSWeaponBase>(Settings->DefaultWeapons[i], SpawnInfo);
+			ATrueFPSWeaponBase* NewWeapon = nullptr;
+			if (GameMode)
+			{
+				NewWeapon = GameMode->AcquireWeapon(Settings->DefaultWeapons[i]);
+			}
+			else
+			{
+				FActorSpawnParameters SpawnInfo;
+				SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+				NewWeapon = GetWorld()->SpawnActor<ATrueFPSWeaponBase>(Settings->DefaultWeapons[i], SpawnInfo);
+			}
 			AddWeapon(NewWeapon);
 		}
 	}
@@ -1112,13 +1399,23 @@ void ATrueFPSCharacter::DestroyInventory()
 		return;
 	}
 
-	// remove all weapons from inventory and destroy them
+	ATrueFPSGameMode* const GameMode = GetWorld()->GetAuthGameMode<ATrueFPSGameMode>();
+
+	// remove all weapons from inventory and return them to the pool (or destroy them)
 	for (int32 i = Inventory.Num() - 1; i >= 0; i--)
 	{
 		if (ATrueFPSWeaponBase* Weapon = Inventory[i])
 		{
 			RemoveWeapon(Weapon);
-			Weapon->Destroy();
+
+			if (GameMode)
+			{
+				GameMode->ReleaseWeapon(Weapon);
+			}
+			else
+			{
+				Weapon->Destroy();
+			}
 		}
 	}
 }
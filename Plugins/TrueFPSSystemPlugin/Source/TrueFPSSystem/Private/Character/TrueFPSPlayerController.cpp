@@ -12,10 +12,13 @@
 #include "TrueFPSGameInstance.h"
 #include "TrueFPSGameViewportClient.h"
 #include "TrueFPSLeaderboards.h"
+#include "TrueFPSSystem.h"
 #include "Character/TrueFPSLocalPlayer.h"
 #include "Character/TrueFPSPersistentUser.h"
 #include "Net/UnrealNetwork.h"
 #include "Online/TrueFPSGameMode.h"
+#include "Online/TrueFPSLeaderboardCache.h"
+#include "Online/TrueFPSMatchReportQueue.h"
 #include "Online/TrueFPSPlayerState.h"
 #include "Sound/LocalPlayerSoundNode.h"
 #include "UI/TrueFPSHUD.h"
@@ -61,8 +64,15 @@ ATrueFPSPlayerController::ATrueFPSPlayerController(const FObjectInitializer& Obj
 	LastDeathLocation = FVector::ZeroVector;
 
 	ServerSayString = TEXT("Say");
-	TrueFPSFriendUpdateTimer = 0.0f;
+	ChatBurstSize = 5.0f;
+	ChatMessagesPerSecond = 1.0f;
+	ChatRepeatInterval = 5.0f;
+	ChatMaxMessageLength = 128;
+	ChatAllowance = 0.0f;
+	LastChatAllowanceTime = 0.0;
+	LastChatMessageTime = 0.0;
 	bHasSentStartEvents = false;
+	MatchReportStep = 0;
 
 	StatMatchesPlayed = 0;
 	StatKills = 0;
@@ -181,6 +191,12 @@ void ATrueFPSPlayerController::ClientGameStarted_Implementation()
 
 	const UWorld* World = GetWorld();
 
+	UTrueFPSGameInstance* const GameInstance = World ? Cast<UTrueFPSGameInstance>(World->GetGameInstance()) : nullptr;
+	if (GameInstance)
+	{
+		GameInstance->NotifyMatchPlayable();
+	}
+
 	// Send round start event
 	const IOnlineEventsPtr Events = Online::GetEventsInterface(World);
 	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
@@ -225,6 +241,15 @@ void ATrueFPSPlayerController::ClientGameStarted_Implementation()
 	}
 }
 
+void ATrueFPSPlayerController::ClientPreloadMap_Implementation(const FString& MapName)
+{
+	UTrueFPSGameInstance* const GameInstance = Cast<UTrueFPSGameInstance>(GetGameInstance());
+	if (GameInstance)
+	{
+		GameInstance->PreloadTravelPackages(MapName, TArray<FName>());
+	}
+}
+
 void ATrueFPSPlayerController::ClientStartOnlineGame_Implementation()
 {
 	if (!IsPrimaryPlayer())
@@ -290,10 +315,31 @@ void ATrueFPSPlayerController::ClientGameEnded_Implementation(AActor* EndGameFoc
 		TrueFPSHUD->SetMatchState(bIsWinner ? ETrueFPSMatchState::Won : ETrueFPSMatchState::Lost);
 	}
 
-	UpdateSaveFileOnGameEnd(bIsWinner);
-	UpdateAchievementsOnGameEnd();
-	UpdateLeaderboardsOnGameEnd();
-	UpdateStatsOnGameEnd(bIsWinner);
+	// Only take a copy of the results here, this runs in the frame the match ends (inside FinishMatch on a listen server).
+	// The save file and online writes are spread over the following frames.
+	ATrueFPSPlayerState* TrueFPSPlayerState = Cast<ATrueFPSPlayerState>(PlayerState);
+	UTrueFPSGameInstance* GameInstance = GetWorld() ? Cast<UTrueFPSGameInstance>(GetWorld()->GetGameInstance()) : nullptr;
+	if (TrueFPSPlayerState && Cast<ULocalPlayer>(Player))
+	{
+		FTrueFPSMatchResult& Result = PendingMatchResults.AddDefaulted_GetRef();
+		Result.SessionName = TrueFPSPlayerState->SessionName;
+		Result.MapName = FPackageName::GetShortName(GetWorld()->PersistentLevel->GetOutermost()->GetName());
+		Result.Kills = TrueFPSPlayerState->GetKills();
+		Result.Deaths = TrueFPSPlayerState->GetDeaths();
+		Result.Score = (int32)TrueFPSPlayerState->GetScore();
+		Result.BulletsFired = TrueFPSPlayerState->GetNumBulletsFired();
+		Result.bIsWinner = bIsWinner;
+
+		if (GameInstance && GameInstance->GetMatchReportQueue().IsValid())
+		{
+			GameInstance->GetMatchReportQueue()->Add(this);
+		}
+		else
+		{
+			UE_LOG(LogTrueFPSSystem, Warning, TEXT("No match report queue, writing the results of %s right away"), *GetNameSafe(this));
+			FlushMatchReports();
+		}
+	}
 
 	// Flag that the game has just ended (if it's ended due to host loss we want to wait for ClientReturnToMainMenu_Implementation first, incase we don't want to process)
 	bGameEndedFrame = true;
@@ -339,12 +385,27 @@ void ATrueFPSPlayerController::ToggleChatWindow()
 
 void ATrueFPSPlayerController::Say(const FString& Msg)
 {
-	ServerSay(Msg.Left(128));
+	ServerSay(Msg.Left(ChatMaxMessageLength));
 }
 
 void ATrueFPSPlayerController::ServerSay_Implementation(const FString& Msg)
 {
-	GetWorld()->GetAuthGameMode<ATrueFPSGameMode>()->Broadcast(this, Msg, ServerSayString);
+	// Rate limit and drop repeats here, before every client has to receive and show them
+	const double Now = FPlatformTime::Seconds();
+	ChatAllowance = FMath::Min<float>(ChatBurstSize, ChatAllowance + (Now - LastChatAllowanceTime) * ChatMessagesPerSecond);
+	LastChatAllowanceTime = Now;
+
+	const FString TrimmedMsg = Msg.Left(ChatMaxMessageLength);
+	if (ChatAllowance < 1.0f || (TrimmedMsg == LastChatMessage && Now - LastChatMessageTime < ChatRepeatInterval))
+	{
+		return;
+	}
+
+	ChatAllowance -= 1.0f;
+	LastChatMessage = TrimmedMsg;
+	LastChatMessageTime = Now;
+
+	GetWorld()->GetAuthGameMode<ATrueFPSGameMode>()->Broadcast(this, TrimmedMsg, ServerSayString);
 }
 
 void ATrueFPSPlayerController::ShowInGameMenu()
@@ -703,6 +764,31 @@ bool ATrueFPSPlayerController::FindDeathCameraSpot(FVector& CameraLocation, FRot
 	return false;
 }
 
+void ATrueFPSPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Don't lose results still waiting for their turn in the report queue
+	FlushMatchReports();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATrueFPSPlayerController::FlushMatchReports()
+{
+	bool bWroteLeaderboards = false;
+	while (RunMatchReportStep(bWroteLeaderboards))
+	{
+	}
+
+	if (bWroteLeaderboards)
+	{
+		const IOnlineLeaderboardsPtr Leaderboards = Online::GetLeaderboardsInterface(GetWorld());
+		if (Leaderboards.IsValid())
+		{
+			Leaderboards->FlushLeaderboards(TEXT("TRUEFPSSYSTEM"));
+		}
+	}
+}
+
 void ATrueFPSPlayerController::BeginDestroy()
 {
 	Super::BeginDestroy();
@@ -725,7 +811,6 @@ void ATrueFPSPlayerController::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 	FTrueFPSStyle::Initialize();
-	TrueFPSFriendUpdateTimer = 0;
 }
 
 void ATrueFPSPlayerController::ClearLeaderboardDelegate()
@@ -745,27 +830,6 @@ void ATrueFPSPlayerController::TickActor(float DeltaTime, ELevelTick TickType, F
 {
 	Super::TickActor(DeltaTime, TickType, ThisTickFunction);
 
-	if (IsGameMenuVisible())
-	{
-		if (TrueFPSFriendUpdateTimer > 0)
-		{
-			TrueFPSFriendUpdateTimer -= DeltaTime;
-		}
-		else
-		{
-			TSharedPtr<class FTrueFPSFriends> TrueFPSFriends = TrueFPSIngameMenu->GetTrueFPSFriends();
-			ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
-			if (TrueFPSFriends.IsValid() && LocalPlayer && LocalPlayer->GetControllerId() >= 0)
-			{
-				TrueFPSFriends->UpdateFriends(LocalPlayer->GetControllerId());
-			}
-			
-			// Make sure the time between calls is long enough that we won't trigger (0x80552C81) and not exceed the web api rate limit
-			// That value is currently 75 requests / 15 minutes.
-			TrueFPSFriendUpdateTimer = 15;
-		}
-	}
-
 	// Is this the first frame after the game has ended
 	if(bGameEndedFrame)
 	{
@@ -1070,6 +1134,13 @@ bool ATrueFPSPlayerController::IsGameMenuVisible() const
 }
 
 void ATrueFPSPlayerController::UpdateAchievementProgress(const FString& Id, float Percent)
+{
+	FOnlineAchievementsWriteRef Write = MakeShareable(new FOnlineAchievementsWrite());
+	Write->SetFloatStat(*Id, Percent);
+	WriteAchievements(Write);
+}
+
+void ATrueFPSPlayerController::WriteAchievements(const FOnlineAchievementsWriteRef& Write)
 {
 	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
 	if (LocalPlayer)
@@ -1088,8 +1159,7 @@ void ATrueFPSPlayerController::UpdateAchievementProgress(const FString& Id, floa
 					IOnlineAchievementsPtr Achievements = OnlineSub->GetAchievementsInterface();
 					if (Achievements.IsValid() && (!WriteObject.IsValid() || WriteObject->WriteState != EOnlineAsyncTaskState::InProgress))
 					{
-						WriteObject = MakeShareable(new FOnlineAchievementsWrite());
-						WriteObject->SetFloatStat(*Id, Percent);
+						WriteObject = Write;
 
 						FOnlineAchievementsWriteRef WriteObjectRef = WriteObject.ToSharedRef();
 						Achievements->WriteAchievements(*UserId, WriteObjectRef);
@@ -1131,7 +1201,44 @@ UTrueFPSPersistentUser* ATrueFPSPlayerController::GetPersistentUser() const
 	return TrueFPSLocalPlayer ? TrueFPSLocalPlayer->GetPersistentUser() : nullptr;
 }
 
-void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
+bool ATrueFPSPlayerController::RunMatchReportStep(bool& bOutWroteLeaderboards)
+{
+	if (ReportingMatchResults.Num() == 0)
+	{
+		if (PendingMatchResults.Num() == 0)
+		{
+			return false;
+		}
+
+		// Everything that piled up is reported in one go, one write per user and backend
+		ReportingMatchResults = MoveTemp(PendingMatchResults);
+		PendingMatchResults.Reset();
+		MatchReportStep = 0;
+	}
+
+	switch (MatchReportStep++)
+	{
+	case 0:
+		UpdateSaveFileOnGameEnd(ReportingMatchResults);
+		break;
+	case 1:
+		// Achievements are based on the persistent user totals, which now include these results
+		UpdateAchievementsOnGameEnd(ReportingMatchResults.Last());
+		break;
+	case 2:
+		UpdateLeaderboardsOnGameEnd(ReportingMatchResults);
+		bOutWroteLeaderboards = true;
+		break;
+	default:
+		UpdateStatsOnGameEnd(ReportingMatchResults);
+		ReportingMatchResults.Reset();
+		break;
+	}
+
+	return ReportingMatchResults.Num() > 0 || PendingMatchResults.Num() > 0;
+}
+
+void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd(const FTrueFPSMatchResult& Result)
 {
 	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
 	if (LocalPlayer)
@@ -1148,10 +1255,13 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				const int32 Matches = Wins + Losses;
 
 				const int32 TotalKills = PersistentUser->GetKills();
-				const int32 MatchScore = (int32)TrueFPSPlayerState->GetScore();
+				const int32 MatchScore = Result.Score;
 
 				const int32 TotalBulletsFired = PersistentUser->GetBulletsFired();
 			
+				// All progress goes out in a single write
+				FOnlineAchievementsWriteRef AchievementsWrite = MakeShareable(new FOnlineAchievementsWrite());
+
 				float TotalGameAchievement = 0;
 				float CurrentGameAchievement = 0;
 			
@@ -1166,7 +1276,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				{
 					float fSomeKillPct = ((float)TotalKills / (float)SomeKillsCount) * 100.0f;
 					fSomeKillPct = FMath::RoundToFloat(fSomeKillPct);
-					UpdateAchievementProgress(ACH_SOME_KILLS, fSomeKillPct);
+					AchievementsWrite->SetFloatStat(ACH_SOME_KILLS, fSomeKillPct);
 
 					CurrentGameAchievement += FMath::Min(fSomeKillPct, 100.0f);
 					TotalGameAchievement += 100;
@@ -1175,7 +1285,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				{
 					float fLotsKillPct = ((float)TotalKills / (float)LotsKillsCount) * 100.0f;
 					fLotsKillPct = FMath::RoundToFloat(fLotsKillPct);
-					UpdateAchievementProgress(ACH_LOTS_KILLS, fLotsKillPct);
+					AchievementsWrite->SetFloatStat(ACH_LOTS_KILLS, fLotsKillPct);
 
 					CurrentGameAchievement += FMath::Min(fLotsKillPct, 100.0f);
 					TotalGameAchievement += 100;
@@ -1185,7 +1295,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				///////////////////////////////////////
 				// Match Achievements
 				{
-					UpdateAchievementProgress(ACH_FINISH_MATCH, 100.0f);
+					AchievementsWrite->SetFloatStat(ACH_FINISH_MATCH, 100.0f);
 
 					CurrentGameAchievement += 100;
 					TotalGameAchievement += 100;
@@ -1194,7 +1304,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				{
 					float fLotsRoundsPct = ((float)Matches / (float)LotsMatchesCount) * 100.0f;
 					fLotsRoundsPct = FMath::RoundToFloat(fLotsRoundsPct);
-					UpdateAchievementProgress(ACH_LOTS_MATCHES, fLotsRoundsPct);
+					AchievementsWrite->SetFloatStat(ACH_LOTS_MATCHES, fLotsRoundsPct);
 
 					CurrentGameAchievement += FMath::Min(fLotsRoundsPct, 100.0f);
 					TotalGameAchievement += 100;
@@ -1205,7 +1315,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				// Win Achievements
 				if (Wins >= 1)
 				{
-					UpdateAchievementProgress(ACH_FIRST_WIN, 100.0f);
+					AchievementsWrite->SetFloatStat(ACH_FIRST_WIN, 100.0f);
 
 					CurrentGameAchievement += 100.0f;
 				}
@@ -1214,7 +1324,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				{			
 					float fLotsWinPct = ((float)Wins / (float)LotsWinsCount) * 100.0f;
 					fLotsWinPct = FMath::RoundToInt(fLotsWinPct);
-					UpdateAchievementProgress(ACH_LOTS_WIN, fLotsWinPct);
+					AchievementsWrite->SetFloatStat(ACH_LOTS_WIN, fLotsWinPct);
 
 					CurrentGameAchievement += FMath::Min(fLotsWinPct, 100.0f);
 					TotalGameAchievement += 100;
@@ -1223,7 +1333,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				{			
 					float fManyWinPct = ((float)Wins / (float)ManyWinsCount) * 100.0f;
 					fManyWinPct = FMath::RoundToInt(fManyWinPct);
-					UpdateAchievementProgress(ACH_MANY_WIN, fManyWinPct);
+					AchievementsWrite->SetFloatStat(ACH_MANY_WIN, fManyWinPct);
 
 					CurrentGameAchievement += FMath::Min(fManyWinPct, 100.0f);
 					TotalGameAchievement += 100;
@@ -1235,7 +1345,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				{
 					float fLotsBulletsPct = ((float)TotalBulletsFired / (float)LotsBulletsCount) * 100.0f;
 					fLotsBulletsPct = FMath::RoundToFloat(fLotsBulletsPct);
-					UpdateAchievementProgress(ACH_SHOOT_BULLETS, fLotsBulletsPct);
+					AchievementsWrite->SetFloatStat(ACH_SHOOT_BULLETS, fLotsBulletsPct);
 
 					CurrentGameAchievement += FMath::Min(fLotsBulletsPct, 100.0f);
 					TotalGameAchievement += 100;
@@ -1247,33 +1357,31 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 				{
 					float fGoodScorePct = ((float)MatchScore / (float)GoodScoreCount) * 100.0f;
 					fGoodScorePct = FMath::RoundToFloat(fGoodScorePct);
-					UpdateAchievementProgress(ACH_GOOD_SCORE, fGoodScorePct);
+					AchievementsWrite->SetFloatStat(ACH_GOOD_SCORE, fGoodScorePct);
 				}
 
 				{
 					float fGreatScorePct = ((float)MatchScore / (float)GreatScoreCount) * 100.0f;
 					fGreatScorePct = FMath::RoundToFloat(fGreatScorePct);
-					UpdateAchievementProgress(ACH_GREAT_SCORE, fGreatScorePct);
+					AchievementsWrite->SetFloatStat(ACH_GREAT_SCORE, fGreatScorePct);
 				}
 				///////////////////////////////////////
 
 				///////////////////////////////////////
 				// Map Play Achievements
-				UWorld* World = GetWorld();
-				if (World)
-				{			
-					FString MapName = *FPackageName::GetShortName(World->PersistentLevel->GetOutermost()->GetName());
-					if (MapName.Find(TEXT("Highrise")) != -1)
-					{
-						UpdateAchievementProgress(ACH_PLAY_HIGHRISE, 100.0f);
-					}
-					else if (MapName.Find(TEXT("Sanctuary")) != -1)
-					{
-						UpdateAchievementProgress(ACH_PLAY_SANCTUARY, 100.0f);
-					}
+				if (Result.MapName.Find(TEXT("Highrise")) != -1)
+				{
+					AchievementsWrite->SetFloatStat(ACH_PLAY_HIGHRISE, 100.0f);
+				}
+				else if (Result.MapName.Find(TEXT("Sanctuary")) != -1)
+				{
+					AchievementsWrite->SetFloatStat(ACH_PLAY_SANCTUARY, 100.0f);
 				}
 				///////////////////////////////////////			
 
+				WriteAchievements(AchievementsWrite);
+
+				UWorld* World = GetWorld();
 				const IOnlineEventsPtr Events = Online::GetEventsInterface(World);
 				const IOnlineIdentityPtr Identity = Online::GetIdentityInterface(World);
 
@@ -1299,7 +1407,7 @@ void ATrueFPSPlayerController::UpdateAchievementsOnGameEnd()
 	}
 }
 
-void ATrueFPSPlayerController::UpdateLeaderboardsOnGameEnd()
+void ATrueFPSPlayerController::UpdateLeaderboardsOnGameEnd(const TArray<FTrueFPSMatchResult>& Results)
 {
 	UTrueFPSLocalPlayer* LocalPlayer = Cast<UTrueFPSLocalPlayer>(Player);
 	if (LocalPlayer)
@@ -1317,13 +1425,17 @@ void ATrueFPSPlayerController::UpdateLeaderboardsOnGameEnd()
 					IOnlineLeaderboardsPtr Leaderboards = OnlineSub->GetLeaderboardsInterface();
 					if (Leaderboards.IsValid())
 					{
-						ATrueFPSPlayerState* TrueFPSPlayerState = Cast<ATrueFPSPlayerState>(PlayerState);
-						if (TrueFPSPlayerState)
+						if (Results.Num() > 0)
 						{
 							FTrueFPSAllTimeMatchResultsWrite ResultsWriteObject;
-							int32 MatchWriteData = 1;
-							int32 KillsWriteData = TrueFPSPlayerState->GetKills();
-							int32 DeathsWriteData = TrueFPSPlayerState->GetDeaths();
+							int32 MatchWriteData = Results.Num();
+							int32 KillsWriteData = 0;
+							int32 DeathsWriteData = 0;
+							for (const FTrueFPSMatchResult& Result : Results)
+							{
+								KillsWriteData += Result.Kills;
+								DeathsWriteData += Result.Deaths;
+							}
 
 #if TRACK_STATS_LOCALLY
 							StatMatchesPlayed = (MatchWriteData += StatMatchesPlayed);
@@ -1336,9 +1448,15 @@ void ATrueFPSPlayerController::UpdateLeaderboardsOnGameEnd()
 							ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_DEATHS, DeathsWriteData);
 							ResultsWriteObject.SetIntStat(LEADERBOARD_STAT_MATCHESPLAYED, MatchWriteData);
 
-							// the call will copy the user id and write object to its own memory
-							Leaderboards->WriteLeaderboards(TrueFPSPlayerState->SessionName, *UserId, ResultsWriteObject);
-							Leaderboards->FlushLeaderboards(TEXT("TRUEFPSSYSTEM"));
+							// the call will copy the user id and write object to its own memory, the flush is shared with the other players
+							Leaderboards->WriteLeaderboards(Results.Last().SessionName, *UserId, ResultsWriteObject);
+
+							// cached reads no longer reflect the board
+							UTrueFPSGameInstance* GameInstance = Cast<UTrueFPSGameInstance>(GetGameInstance());
+							if (GameInstance && GameInstance->GetLeaderboardCache().IsValid())
+							{
+								GameInstance->GetLeaderboardCache()->Invalidate();
+							}
 						}
 					}
 				}
@@ -1347,27 +1465,36 @@ void ATrueFPSPlayerController::UpdateLeaderboardsOnGameEnd()
 	}
 }
 
-void ATrueFPSPlayerController::UpdateStatsOnGameEnd(bool bIsWinner)
+void ATrueFPSPlayerController::UpdateStatsOnGameEnd(const TArray<FTrueFPSMatchResult>& Results)
 {
 	const IOnlineStatsPtr Stats = Online::GetStatsInterface(GetWorld());
 	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
-	ATrueFPSPlayerState* TrueFPSPlayerState = Cast<ATrueFPSPlayerState>(PlayerState);
 
-	if (Stats.IsValid() && LocalPlayer != nullptr && TrueFPSPlayerState != nullptr)
+	if (Stats.IsValid() && LocalPlayer != nullptr && Results.Num() > 0)
 	{
 		FUniqueNetIdRepl UniqueId = LocalPlayer->GetCachedUniqueNetId();
 
 		if (UniqueId.IsValid() )
 		{
+			int32 Kills = 0;
+			int32 Deaths = 0;
+			int32 RoundsWon = 0;
+			for (const FTrueFPSMatchResult& Result : Results)
+			{
+				Kills += Result.Kills;
+				Deaths += Result.Deaths;
+				RoundsWon += Result.bIsWinner ? 1 : 0;
+			}
+
 			TArray<FOnlineStatsUserUpdatedStats> UpdatedUserStats;
 
 			FOnlineStatsUserUpdatedStats& UpdatedStats = UpdatedUserStats.Emplace_GetRef( UniqueId.GetUniqueNetId().ToSharedRef() );
-			UpdatedStats.Stats.Add( TEXT("Kills"), FOnlineStatUpdate( TrueFPSPlayerState->GetKills(), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
-			UpdatedStats.Stats.Add( TEXT("Deaths"), FOnlineStatUpdate( TrueFPSPlayerState->GetDeaths(), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
-			UpdatedStats.Stats.Add( TEXT("RoundsPlayed"), FOnlineStatUpdate( 1, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
-			if (bIsWinner)
+			UpdatedStats.Stats.Add( TEXT("Kills"), FOnlineStatUpdate( Kills, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+			UpdatedStats.Stats.Add( TEXT("Deaths"), FOnlineStatUpdate( Deaths, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+			UpdatedStats.Stats.Add( TEXT("RoundsPlayed"), FOnlineStatUpdate( Results.Num(), FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+			if (RoundsWon > 0)
 			{
-				UpdatedStats.Stats.Add( TEXT("RoundsWon"), FOnlineStatUpdate( 1, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
+				UpdatedStats.Stats.Add( TEXT("RoundsWon"), FOnlineStatUpdate( RoundsWon, FOnlineStatUpdate::EOnlineStatModificationType::Sum ) );
 			}
 
 			Stats->UpdateStats( UniqueId.GetUniqueNetId().ToSharedRef(), UpdatedUserStats, FOnlineStatsUpdateStatsComplete() );
@@ -1375,17 +1502,16 @@ void ATrueFPSPlayerController::UpdateStatsOnGameEnd(bool bIsWinner)
 	}
 }
 
-void ATrueFPSPlayerController::UpdateSaveFileOnGameEnd(bool bIsWinner)
+void ATrueFPSPlayerController::UpdateSaveFileOnGameEnd(const TArray<FTrueFPSMatchResult>& Results)
 {
-	ATrueFPSPlayerState* TrueFPSPlayerState = Cast<ATrueFPSPlayerState>(PlayerState);
-	if (TrueFPSPlayerState)
+	// update local saved profile, saved once for all the results
+	UTrueFPSPersistentUser* const PersistentUser = GetPersistentUser();
+	if (PersistentUser)
 	{
-		// update local saved profile
-		UTrueFPSPersistentUser* const PersistentUser = GetPersistentUser();
-		if (PersistentUser)
+		for (const FTrueFPSMatchResult& Result : Results)
 		{
-			PersistentUser->AddMatchResult(TrueFPSPlayerState->GetKills(), TrueFPSPlayerState->GetDeaths(), TrueFPSPlayerState->GetNumBulletsFired(), bIsWinner);
-			PersistentUser->SaveIfDirty();
+			PersistentUser->AddMatchResult(Result.Kills, Result.Deaths, Result.BulletsFired, Result.bIsWinner);
 		}
+		PersistentUser->SaveIfDirty();
 	}
 }
@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/TrueFPSRagdollManager.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("TrueFPS Ragdoll Manager"), STAT_TrueFPSRagdollManager, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TrueFPS Simulated Ragdolls"), STAT_TrueFPSSimulatedRagdolls, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TrueFPS Queued Ragdolls"), STAT_TrueFPSQueuedRagdolls, STATGROUP_Game);
+
+int32 GTrueFPSMaxSimulatedRagdolls = 8;
+static FAutoConsoleVariableRef CVarTrueFPSMaxSimulatedRagdolls(
+	TEXT("TrueFPS.MaxSimulatedRagdolls"),
+	GTrueFPSMaxSimulatedRagdolls,
+	TEXT("Maximum number of ragdolls simulating at once, the least important ones over it wait in their current pose until they rank within it."),
+	ECVF_Default);
+
+int32 GTrueFPSMaxRagdolls = 24;
+static FAutoConsoleVariableRef CVarTrueFPSMaxRagdolls(
+	TEXT("TrueFPS.MaxRagdolls"),
+	GTrueFPSMaxRagdolls,
+	TEXT("Number of ragdolls, simulated or frozen, over which the least important ones are removed shortly."),
+	ECVF_Default);
+
+float GTrueFPSRagdollSettleSpeed = 5.f;
+static FAutoConsoleVariableRef CVarTrueFPSRagdollSettleSpeed(
+	TEXT("TrueFPS.RagdollSettleSpeed"),
+	GTrueFPSRagdollSettleSpeed,
+	TEXT("Speed of the root body under which a ragdoll is considered at rest and frozen."),
+	ECVF_Default);
+
+/** seconds between two updates, ranking and settling don't need to be any more responsive */
+static constexpr float RagdollUpdateInterval = 0.25f;
+
+/** seconds a ragdoll simulates before it can be considered at rest */
+static constexpr double RagdollMinSimulateTime = 1.0;
+
+/** lifespan of the ragdolls over budget */
+static constexpr float RagdollOverBudgetLifeSpan = 1.f;
+
+/** how much further a ragdoll that wasn't rendered recently counts as */
+static constexpr double RagdollHiddenDistanceScale = 2.0;
+
+/** Bodies turn kinematic and the bones are no longer updated, so the mesh keeps the last simulated pose */
+static void HoldPose(USkeletalMeshComponent* Mesh)
+{
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	Mesh->bNoSkeletonUpdate = true;
+	Mesh->SetComponentTickEnabled(false);
+}
+
+static void ShortenLifeSpan(AActor* Actor)
+{
+	// no lifespan reads as 0, which would clear it
+	const float LifeSpan = Actor->GetLifeSpan();
+	if (LifeSpan <= 0.f || LifeSpan > RagdollOverBudgetLifeSpan)
+	{
+		Actor->SetLifeSpan(RagdollOverBudgetLifeSpan);
+	}
+}
+
+bool UTrueFPSRagdollManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UTrueFPSRagdollManager::Deinitialize()
+{
+	if (const UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(TimerHandle_UpdateRagdolls);
+	}
+	Ragdolls.Reset();
+
+	Super::Deinitialize();
+}
+
+void UTrueFPSRagdollManager::AddRagdoll(ACharacter* Character)
+{
+	if (!IsValid(Character) || !Character->GetMesh())
+	{
+		return;
+	}
+
+	FRagdoll& Ragdoll = Ragdolls.AddDefaulted_GetRef();
+	Ragdoll.Character = Character;
+	Ragdoll.StartTime = GetWorld()->GetTimeSeconds();
+	Ragdoll.SimulateStartTime = Ragdoll.StartTime;
+	Ragdoll.CollisionEnabled = Character->GetMesh()->GetCollisionEnabled();
+
+	if (!TimerHandle_UpdateRagdolls.IsValid())
+	{
+		GetWorld()->GetTimerManager().SetTimer(TimerHandle_UpdateRagdolls, this, &ThisClass::UpdateRagdolls, RagdollUpdateInterval, true);
+	}
+
+	// A burst of deaths mustn't all simulate until the next update
+	UpdateRagdolls();
+}
+
+void UTrueFPSRagdollManager::UpdateRagdolls()
+{
+	SCOPE_CYCLE_COUNTER(STAT_TrueFPSRagdollManager);
+
+	Ragdolls.RemoveAllSwap([](const FRagdoll& Ragdoll)
+	{
+		return !Ragdoll.Character.IsValid() || Ragdoll.Character->IsActorBeingDestroyed() || !Ragdoll.Character->GetMesh();
+	});
+
+	if (Ragdolls.Num() == 0)
+	{
+		GetWorld()->GetTimerManager().ClearTimer(TimerHandle_UpdateRagdolls);
+		SET_DWORD_STAT(STAT_TrueFPSSimulatedRagdolls, 0);
+		SET_DWORD_STAT(STAT_TrueFPSQueuedRagdolls, 0);
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	for (FRagdoll& Ragdoll : Ragdolls)
+	{
+		const USkeletalMeshComponent* Mesh = Ragdoll.Character->GetMesh();
+		const FVector Location = Mesh->GetComponentLocation();
+
+		// Without any local view (dedicated server) every ragdoll ranks the same and the newest win
+		double DistanceSquared = ViewLocations.Num() > 0 ? DBL_MAX : 0.0;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(Location, ViewLocation));
+		}
+
+		Ragdoll.Priority = Mesh->WasRecentlyRendered(RagdollUpdateInterval) ? DistanceSquared : DistanceSquared * FMath::Square(RagdollHiddenDistanceScale);
+	}
+
+	Ragdolls.Sort([](const FRagdoll& A, const FRagdoll& B)
+	{
+		return A.Priority != B.Priority ? A.Priority < B.Priority : A.StartTime > B.StartTime;
+	});
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float SettleSpeedSquared = FMath::Square(GTrueFPSRagdollSettleSpeed);
+	int32 NumSimulating = 0;
+	int32 NumQueued = 0;
+
+	for (int32 i = 0; i < Ragdolls.Num(); i++)
+	{
+		FRagdoll& Ragdoll = Ragdolls[i];
+
+		if (!Ragdoll.bFrozen)
+		{
+			const USkeletalMeshComponent* Mesh = Ragdoll.Character->GetMesh();
+			const bool bSettled = !Ragdoll.bQueued && Now - Ragdoll.SimulateStartTime >= RagdollMinSimulateTime
+				&& (!Mesh->RigidBodyIsAwake() || Mesh->GetPhysicsLinearVelocity().SizeSquared() < SettleSpeedSquared);
+
+			if (bSettled)
+			{
+				FreezeRagdoll(Ragdoll);
+			}
+			else if (NumSimulating >= GTrueFPSMaxSimulatedRagdolls)
+			{
+				// Freezing it now could leave it standing or hanging mid fall, it waits for a slot instead
+				if (!Ragdoll.bQueued)
+				{
+					QueueRagdoll(Ragdoll);
+				}
+				NumQueued++;
+			}
+			else
+			{
+				if (Ragdoll.bQueued)
+				{
+					ResumeRagdoll(Ragdoll, Now);
+				}
+				NumSimulating++;
+			}
+		}
+
+		if (i >= GTrueFPSMaxRagdolls)
+		{
+			ShortenLifeSpan(Ragdoll.Character.Get());
+		}
+	}
+
+	SET_DWORD_STAT(STAT_TrueFPSSimulatedRagdolls, NumSimulating);
+	SET_DWORD_STAT(STAT_TrueFPSQueuedRagdolls, NumQueued);
+}
+
+void UTrueFPSRagdollManager::FreezeRagdoll(FRagdoll& Ragdoll) const
+{
+	Ragdoll.bFrozen = true;
+	HoldPose(Ragdoll.Character->GetMesh());
+}
+
+void UTrueFPSRagdollManager::QueueRagdoll(FRagdoll& Ragdoll) const
+{
+	Ragdoll.bQueued = true;
+	HoldPose(Ragdoll.Character->GetMesh());
+}
+
+void UTrueFPSRagdollManager::ResumeRagdoll(FRagdoll& Ragdoll, const double Now) const
+{
+	USkeletalMeshComponent* Mesh = Ragdoll.Character->GetMesh();
+	Ragdoll.bQueued = false;
+	Ragdoll.SimulateStartTime = Now;
+
+	// The bodies start from the held pose, at rest, the speed they were queued with is lost
+	Mesh->bNoSkeletonUpdate = false;
+	Mesh->SetComponentTickEnabled(true);
+	Mesh->SetCollisionEnabled(Ragdoll.CollisionEnabled);
+	Mesh->SetSimulatePhysics(true);
+	Mesh->WakeAllRigidBodies();
+}
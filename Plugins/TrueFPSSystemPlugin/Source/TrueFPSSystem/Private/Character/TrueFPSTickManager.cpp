@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/TrueFPSTickManager.h"
+
+#include "Async/ParallelFor.h"
+#include "Character/TrueFPSCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "Weapons/TrueFPSWeaponBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("TrueFPS Tick Manager"), STAT_TrueFPSTickManager, STATGROUP_Game);
+
+bool GTrueFPSBatchedTick = true;
+static FAutoConsoleVariableRef CVarTrueFPSBatchedTick(
+	TEXT("TrueFPS.BatchedTick"),
+	GTrueFPSBatchedTick,
+	TEXT("Whether characters and weapons are ticked together by the tick manager, instead of by their own actor tick.\n")
+	TEXT("Only applies to actors that begin play after it changes."),
+	ECVF_Default);
+
+bool GTrueFPSParallelWeaponTick = false;
+static FAutoConsoleVariableRef CVarTrueFPSParallelWeaponTick(
+	TEXT("TrueFPS.ParallelWeaponTick"),
+	GTrueFPSParallelWeaponTick,
+	TEXT("Whether the tick manager interpolates the weapons' recoil, sights and wall offset in parallel."),
+	ECVF_Default);
+
+void FTrueFPSTickManagerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Manager && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Manager->Tick(DeltaTime, TickGroup);
+	}
+}
+
+FString FTrueFPSTickManagerTickFunction::DiagnosticMessage()
+{
+	return TEXT("FTrueFPSTickManagerTickFunction");
+}
+
+FName FTrueFPSTickManagerTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return FName(TEXT("TrueFPSTickManager"));
+}
+
+UTrueFPSTickManager* UTrueFPSTickManager::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return GTrueFPSBatchedTick && World ? World->GetSubsystem<UTrueFPSTickManager>() : nullptr;
+}
+
+bool UTrueFPSTickManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UTrueFPSTickManager::Deinitialize()
+{
+	for (TUniquePtr<FTrueFPSTickManagerTickFunction>& TickFunction : TickFunctions)
+	{
+		if (TickFunction && TickFunction->IsTickFunctionRegistered())
+		{
+			TickFunction->UnRegisterTickFunction();
+		}
+		TickFunction.Reset();
+	}
+
+	Characters.Reset();
+	Weapons.Reset();
+	CharacterTickGroups.Reset();
+	WeaponTickGroups.Reset();
+	TickingWeapons.Reset();
+
+	Super::Deinitialize();
+}
+
+FTrueFPSTickManagerTickFunction& UTrueFPSTickManager::FindOrAddTickFunction(const ETickingGroup TickGroup)
+{
+	TUniquePtr<FTrueFPSTickManagerTickFunction>& TickFunction = TickFunctions[TickGroup];
+	if (!TickFunction)
+	{
+		TickFunction = MakeUnique<FTrueFPSTickManagerTickFunction>();
+		TickFunction->Manager = this;
+		TickFunction->bCanEverTick = true;
+		TickFunction->bStartWithTickEnabled = true;
+		TickFunction->TickGroup = TickGroup;
+		TickFunction->RegisterTickFunction(GetWorld()->PersistentLevel);
+	}
+	return *TickFunction;
+}
+
+void UTrueFPSTickManager::RegisterCharacter(ATrueFPSCharacter* Character)
+{
+	if (IsValid(Character) && !Characters.Contains(Character))
+	{
+		const ETickingGroup TickGroup = Character->PrimaryActorTick.TickGroup;
+		Characters.Add(Character);
+		CharacterTickGroups.Add(TickGroup);
+		AddMeshPrerequisites(Character, FindOrAddTickFunction(TickGroup));
+	}
+}
+
+void UTrueFPSTickManager::UnregisterCharacter(ATrueFPSCharacter* Character)
+{
+	const int32 Index = Characters.Find(Character);
+	if (Index != INDEX_NONE)
+	{
+		RemoveMeshPrerequisites(Character, *TickFunctions[CharacterTickGroups[Index]]);
+		Characters.RemoveAtSwap(Index);
+		CharacterTickGroups.RemoveAtSwap(Index);
+	}
+}
+
+void UTrueFPSTickManager::RegisterWeapon(ATrueFPSWeaponBase* Weapon)
+{
+	if (IsValid(Weapon) && !Weapons.Contains(Weapon))
+	{
+		const ETickingGroup TickGroup = Weapon->PrimaryActorTick.TickGroup;
+		Weapons.Add(Weapon);
+		WeaponTickGroups.Add(TickGroup);
+		AddMeshPrerequisites(Weapon, FindOrAddTickFunction(TickGroup));
+	}
+}
+
+void UTrueFPSTickManager::UnregisterWeapon(ATrueFPSWeaponBase* Weapon)
+{
+	const int32 Index = Weapons.Find(Weapon);
+	if (Index != INDEX_NONE)
+	{
+		RemoveMeshPrerequisites(Weapon, *TickFunctions[WeaponTickGroups[Index]]);
+		Weapons.RemoveAtSwap(Index);
+		WeaponTickGroups.RemoveAtSwap(Index);
+	}
+}
+
+void UTrueFPSTickManager::AddMeshPrerequisites(AActor* Actor, FTrueFPSTickManagerTickFunction& TickFunction)
+{
+	Actor->ForEachComponent<USkeletalMeshComponent>(false, [this, &TickFunction](USkeletalMeshComponent* Mesh)
+	{
+		Mesh->PrimaryComponentTick.AddPrerequisite(this, TickFunction);
+	});
+}
+
+void UTrueFPSTickManager::RemoveMeshPrerequisites(AActor* Actor, FTrueFPSTickManagerTickFunction& TickFunction)
+{
+	Actor->ForEachComponent<USkeletalMeshComponent>(false, [this, &TickFunction](USkeletalMeshComponent* Mesh)
+	{
+		Mesh->PrimaryComponentTick.RemovePrerequisite(this, TickFunction);
+	});
+}
+
+void UTrueFPSTickManager::Tick(const float DeltaTime, const ETickingGroup TickGroup)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TrueFPSTickManager);
+
+	// Each actor gets the delta time its own actor tick would, dilated by its CustomTimeDilation
+	for (int32 Index = 0; Index < Characters.Num(); Index++)
+	{
+		ATrueFPSCharacter* Character = Characters[Index];
+		if (CharacterTickGroups[Index] == TickGroup && Character->NeedsStateRefresh())
+		{
+			Character->RefreshState(DeltaTime * Character->CustomTimeDilation);
+		}
+	}
+
+	TickingWeapons.Reset();
+	for (int32 Index = 0; Index < Weapons.Num(); Index++)
+	{
+		// Weapons switched away from mid recoil keep ticking until it settled, or the camera would keep the unrecovered recoil
+		ATrueFPSWeaponBase* Weapon = Weapons[Index];
+		if (WeaponTickGroups[Index] == TickGroup && (Weapon->IsAttachedToPawn() || Weapon->IsRecoilSettling()))
+		{
+			TickingWeapons.Add(Weapon);
+		}
+	}
+
+	// Traces and controller input stay on the game thread, the interpolation after it only touches each weapon's own state
+	for (ATrueFPSWeaponBase* Weapon : TickingWeapons)
+	{
+		Weapon->TickAttached(DeltaTime * Weapon->CustomTimeDilation);
+	}
+
+	ParallelFor(TickingWeapons.Num(), [this, DeltaTime](const int32 Index)
+	{
+		TickingWeapons[Index]->TickAttachedInterpolation(DeltaTime * TickingWeapons[Index]->CustomTimeDilation);
+	}, !GTrueFPSParallelWeaponTick);
+}
@@ -15,6 +15,8 @@
 #include "Online/TrueFPSGameState.h"
 #include "Online/TrueFPSPlayerState.h"
 #include "UI/TrueFPSHUD.h"
+#include "Weapons/TrueFPSWeaponBase.h"
+#include "Weapons/Attachments/TrueFPSWeaponAttachmentBase.h"
 
 ATrueFPSGameMode::ATrueFPSGameMode(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -35,6 +37,9 @@ ATrueFPSGameMode::ATrueFPSGameMode(const FObjectInitializer& ObjectInitializer)
 
 	MinRespawnDelay = 5.0f;
 
+	WeaponPoolWarmUpSize = 4;
+	MaxPooledWeaponsPerClass = 16;
+
 	bAllowBots = true;	
 	bNeedsBotCreation = true;
 	bUseSeamlessTravel = FParse::Param(FCommandLine::Get(), TEXT("NoSeamlessTravel")) ? false : true;
@@ -188,23 +193,19 @@ float ATrueFPSGameMode::ModifyDamage(float Damage, AActor* DamagedActor, FDamage
 {
 	float ActualDamage = Damage;
 
-	ATrueFPSCharacter* DamagedPawn = Cast<ATrueFPSCharacter>(DamagedActor);
+	const ATrueFPSCharacter* DamagedPawn = Cast<ATrueFPSCharacter>(DamagedActor);
 	if (DamagedPawn && EventInstigator)
 	{
-		ATrueFPSPlayerState* DamagedPlayerState = Cast<ATrueFPSPlayerState>(DamagedPawn->GetPlayerState());
-		ATrueFPSPlayerState* InstigatorPlayerState = Cast<ATrueFPSPlayerState>(EventInstigator->PlayerState);
-
-		// disable friendly fire
-		if (!CanDealDamage(InstigatorPlayerState, DamagedPlayerState))
-		{
-			ActualDamage = 0.0f;
-		}
-
 		// scale self instigated damage
-		if (InstigatorPlayerState == DamagedPlayerState)
+		if (EventInstigator->PlayerState == DamagedPawn->GetPlayerState())
 		{
 			ActualDamage *= DamageSelfScale;
 		}
+		// disable friendly fire
+		else if (!CanDealDamage(ATrueFPSCharacter::GetTeamNumOf(EventInstigator), DamagedPawn->GetTeamNum()))
+		{
+			ActualDamage = 0.0f;
+		}
 	}
 
 	return ActualDamage;
@@ -219,19 +220,27 @@ void ATrueFPSGameMode::Killed(AController* Killer, AController* KilledPlayer, AP
 	if (KillerPlayerState && KillerPlayerState != VictimPlayerState)
 	{
 		KillerPlayerState->ScoreKill(VictimPlayerState, KillScore);
-		KillerPlayerState->InformAboutKill(KillerPlayerState, DamageType, VictimPlayerState);
+		KillerPlayerState->InformAboutKill();
 	}
 
 	if (VictimPlayerState)
 	{
 		VictimPlayerState->ScoreDeath(KillerPlayerState, DeathScore);
-		VictimPlayerState->BroadcastDeath(KillerPlayerState, DamageType, VictimPlayerState);
+	}
+
+	// the kill feed tells every client about the death
+	ATrueFPSGameState* const MyGameState = Cast<ATrueFPSGameState>(GameState);
+	if (MyGameState && (VictimPlayerState || KillerPlayerState))
+	{
+		MyGameState->AddKill(KillerPlayerState, DamageType, VictimPlayerState);
 	}
 }
 
-bool ATrueFPSGameMode::CanDealDamage(ATrueFPSPlayerState* DamageInstigator, ATrueFPSPlayerState* DamagedPlayer) const
+bool ATrueFPSGameMode::CanDealDamage(const int32 InstigatorTeamNum, const int32 DamagedTeamNum) const
 {
-	return true;
+	return bAllowFriendlyFire
+		|| InstigatorTeamNum == INDEX_NONE || DamagedTeamNum == INDEX_NONE
+		|| InstigatorTeamNum != DamagedTeamNum;
 }
 
 bool ATrueFPSGameMode::AllowCheats(APlayerController* P)
@@ -299,6 +308,8 @@ void ATrueFPSGameMode::HandleMatchIsWaitingToStart()
 		bNeedsBotCreation = false;
 	}
 
+	WarmUpWeaponPools();
+
 	if (bDelayedStart)
 	{
 		// start warmup if needed
@@ -327,6 +338,12 @@ void ATrueFPSGameMode::HandleMatchHasStarted()
 	MyGameState->RemainingTime = RoundTime;	
 	StartBots();	
 
+	UTrueFPSGameInstance* const GameInstance = Cast<UTrueFPSGameInstance>(GetGameInstance());
+	if (GameInstance)
+	{
+		GameInstance->NotifyMatchPlayable();
+	}
+
 	// notify players
 	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
 	{
@@ -360,9 +377,100 @@ void ATrueFPSGameMode::RestartGame()
 		}
 	}
 
+	const FString NextMapName = GetNextMapName();
+	if (!NextMapName.IsEmpty() && GameSession->CanRestartGame() && GetMatchState() != MatchState::LeavingMap)
+	{
+		GetWorld()->ServerTravel(NextMapName, false);
+		return;
+	}
+
 	Super::RestartGame();
 }
 
+void ATrueFPSGameMode::GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList)
+{
+	Super::GetSeamlessTravelActorList(bToTransition, ActorList);
+
+	TArray<ATrueFPSWeaponAttachmentBase*> Attachments;
+	for (const TPair<TSubclassOf<ATrueFPSWeaponBase>, FTrueFPSWeaponPool>& Pool : WeaponPools)
+	{
+		for (ATrueFPSWeaponBase* Weapon : Pool.Value.Weapons)
+		{
+			if (IsValid(Weapon))
+			{
+				ActorList.Add(Weapon);
+
+				Weapon->GetAttachments(Attachments);
+				ActorList.Append(Attachments);
+				Attachments.Reset();
+			}
+		}
+	}
+}
+
+void ATrueFPSGameMode::PostSeamlessTravel()
+{
+	Super::PostSeamlessTravel();
+
+	// Weapons loaded with the level aren't ours, everything else without an owner was carried over from the previous pools
+	for (ATrueFPSWeaponBase* Weapon : TActorRange<ATrueFPSWeaponBase>(GetWorld()))
+	{
+		if (!Weapon->HasAnyFlags(RF_WasLoaded) && Weapon->GetPawnOwner() == nullptr)
+		{
+			ReleaseWeapon(Weapon);
+		}
+	}
+}
+
+FString ATrueFPSGameMode::GetNextMapName() const
+{
+	if (MapRotation.Num() == 0)
+	{
+		return FString();
+	}
+
+	// Maps outside the rotation continue with its first entry
+	const FString CurrentMapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+	const int32 CurrentIndex = MapRotation.IndexOfByKey(CurrentMapName);
+	return MapRotation[(CurrentIndex + 1) % MapRotation.Num()];
+}
+
+void ATrueFPSGameMode::PreloadNextMatch()
+{
+	const FString NextMapName = GetNextMapName();
+	if (NextMapName.IsEmpty())
+	{
+		return;
+	}
+
+	TSet<TSubclassOf<ATrueFPSWeaponBase>> WeaponClasses;
+	GetDefaultWeaponClasses(WeaponClasses);
+
+	TArray<FName> PackageNames;
+	for (const TSubclassOf<ATrueFPSWeaponBase>& WeaponClass : WeaponClasses)
+	{
+		if (WeaponClass && !WeaponClass->IsNative())
+		{
+			PackageNames.AddUnique(WeaponClass->GetOutermost()->GetFName());
+		}
+	}
+
+	UTrueFPSGameInstance* const GameInstance = Cast<UTrueFPSGameInstance>(GetGameInstance());
+	if (GameInstance)
+	{
+		GameInstance->PreloadTravelPackages(NextMapName, PackageNames);
+	}
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		ATrueFPSPlayerController* PC = Cast<ATrueFPSPlayerController>(*It);
+		if (PC && !PC->IsLocalController())
+		{
+			PC->ClientPreloadMap(NextMapName);
+		}
+	}
+}
+
 void ATrueFPSGameMode::CreateBotControllers()
 {
 	UWorld* World = GetWorld();
@@ -407,6 +515,102 @@ void ATrueFPSGameMode::PostInitProperties()
 	}
 }
 
+ATrueFPSWeaponBase* ATrueFPSGameMode::AcquireWeapon(TSubclassOf<ATrueFPSWeaponBase> WeaponClass)
+{
+	if (!WeaponClass)
+	{
+		return nullptr;
+	}
+
+	if (FTrueFPSWeaponPool* Pool = WeaponPools.Find(WeaponClass))
+	{
+		while (Pool->Weapons.Num() > 0)
+		{
+			ATrueFPSWeaponBase* Weapon = Pool->Weapons.Pop(false);
+			if (IsValid(Weapon))
+			{
+				Weapon->Reinitialize();
+				return Weapon;
+			}
+		}
+	}
+
+	return SpawnPooledWeapon(WeaponClass);
+}
+
+void ATrueFPSGameMode::ReleaseWeapon(ATrueFPSWeaponBase* Weapon)
+{
+	if (!IsValid(Weapon))
+	{
+		return;
+	}
+
+	FTrueFPSWeaponPool& Pool = WeaponPools.FindOrAdd(Weapon->GetClass());
+	if (GetWorld()->bIsTearingDown || GetMatchState() == MatchState::LeavingMap || Pool.Weapons.Num() >= MaxPooledWeaponsPerClass)
+	{
+		Weapon->Destroy();
+		return;
+	}
+
+	// Idle weapons neither tick nor replicate until they're acquired again
+	Weapon->ResetForPool();
+	Weapon->SetActorTickEnabled(false);
+	Weapon->SetNetDormancy(DORM_DormantAll);
+	Pool.Weapons.Add(Weapon);
+}
+
+void ATrueFPSGameMode::WarmUpWeaponPools()
+{
+	const int32 WarmUpSize = FMath::Min(WeaponPoolWarmUpSize, MaxPooledWeaponsPerClass);
+	if (WarmUpSize <= 0)
+	{
+		return;
+	}
+
+	TSet<TSubclassOf<ATrueFPSWeaponBase>> WeaponClasses;
+	GetDefaultWeaponClasses(WeaponClasses);
+
+	for (const TSubclassOf<ATrueFPSWeaponBase>& WeaponClass : WeaponClasses)
+	{
+		const FTrueFPSWeaponPool* Pool = WeaponPools.Find(WeaponClass);
+		const int32 NumToSpawn = WarmUpSize - (Pool ? Pool->Weapons.Num() : 0);
+		for (int32 i = 0; i < NumToSpawn; i++)
+		{
+			ReleaseWeapon(SpawnPooledWeapon(WeaponClass));
+		}
+	}
+}
+
+void ATrueFPSGameMode::GetDefaultWeaponClasses(TSet<TSubclassOf<ATrueFPSWeaponBase>>& OutWeaponClasses) const
+{
+	for (const UClass* PawnClass : { DefaultPawnClass.Get(), BotPawnClass.Get() })
+	{
+		const ATrueFPSCharacter* DefaultCharacter = PawnClass ? Cast<ATrueFPSCharacter>(PawnClass->GetDefaultObject()) : nullptr;
+		if (DefaultCharacter && DefaultCharacter->GetSettings())
+		{
+			OutWeaponClasses.Append(DefaultCharacter->GetSettings()->DefaultWeapons);
+		}
+	}
+}
+
+ATrueFPSWeaponBase* ATrueFPSGameMode::SpawnPooledWeapon(TSubclassOf<ATrueFPSWeaponBase> WeaponClass)
+{
+	if (!WeaponClass)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ATrueFPSWeaponBase* NewWeapon = GetWorld()->SpawnActor<ATrueFPSWeaponBase>(WeaponClass, SpawnInfo);
+	if (NewWeapon)
+	{
+		NewWeapon->SpawnDefaultAttachments();
+	}
+
+	return NewWeapon;
+}
+
 void ATrueFPSGameMode::StartBots()
 {
 	// checking number of existing human player.
@@ -532,6 +736,9 @@ void ATrueFPSGameMode::FinishMatch()
 
 		// set up to restart the match
 		MyGameState->RemainingTime = TimeBetweenMatches;
+
+		// use the time between matches to get the next one loaded
+		PreloadNextMatch();
 	}
 }
 
@@ -357,8 +357,14 @@ void ATrueFPSGameSession::OnNoMatchesAvailable()
 	SearchSettings = nullptr;
 }
 
-void ATrueFPSGameSession::FindSessions(TSharedPtr<const FUniqueNetId> UserId, FName InSessionName, bool bIsLAN, bool bIsPresence)
+bool ATrueFPSGameSession::FindSessions(TSharedPtr<const FUniqueNetId> UserId, FName InSessionName, bool bIsLAN, bool bIsPresence)
 {
+	// A search that is still running completes for this request as well
+	if (SearchSettings.IsValid() && SearchSettings->SearchState == EOnlineAsyncTaskState::InProgress && OnFindSessionsCompleteDelegateHandle.IsValid())
+	{
+		return true;
+	}
+
 	IOnlineSubsystem* OnlineSub = Online::GetSubsystem(GetWorld());
 	if (OnlineSub)
 	{
@@ -376,13 +382,18 @@ void ATrueFPSGameSession::FindSessions(TSharedPtr<const FUniqueNetId> UserId, FN
 			TSharedRef<FOnlineSessionSearch> SearchSettingsRef = SearchSettings.ToSharedRef();
 
 			OnFindSessionsCompleteDelegateHandle = Sessions->AddOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegate);
-			Sessions->FindSessions(*CurrentSessionParams.UserId, SearchSettingsRef);
+			if (Sessions->FindSessions(*CurrentSessionParams.UserId, SearchSettingsRef))
+			{
+				return true;
+			}
+
+			// Failed right away, the delegate may or may not have fired
+			Sessions->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
+			SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
 		}
 	}
-	else
-	{
-		OnFindSessionsComplete(false);
-	}
+
+	return false;
 }
 
 bool ATrueFPSGameSession::JoinSession(TSharedPtr<const FUniqueNetId> UserId, FName InSessionName, int32 SessionIndexInSearchResults)
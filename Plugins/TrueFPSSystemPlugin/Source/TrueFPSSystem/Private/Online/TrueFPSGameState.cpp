@@ -8,11 +8,69 @@
 #include "Online/TrueFPSGameMode.h"
 #include "Online/TrueFPSPlayerState.h"
 
+void FTrueFPSKillFeedEntry::PostReplicatedAdd(const FTrueFPSKillFeed& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnKillFeedEntryReceived(*this);
+	}
+}
+
+void FTrueFPSKillFeedEntry::PostReplicatedChange(const FTrueFPSKillFeed& InArraySerializer)
+{
+	// a ring slot reused for a newer kill
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnKillFeedEntryReceived(*this);
+	}
+}
+
+uint16 FTrueFPSKillFeedEntry::ToEntryPlayerId(const APlayerState* PlayerState)
+{
+	return PlayerState ? static_cast<uint16>(PlayerState->GetPlayerId()) : NoPlayer;
+}
+
+const FTrueFPSKillFeedEntry& FTrueFPSKillFeed::AddKill(uint16 KillerId, uint16 VictimId, uint8 DamageTypeIndex, uint8 Flags)
+{
+	++LastSerial;
+	// Capacity divides the serial range, so slots stay in order when the serial wraps
+	const int32 Slot = static_cast<uint16>(LastSerial - 1) % Capacity;
+	if (!Items.IsValidIndex(Slot))
+	{
+		Items.AddDefaulted();
+	}
+
+	FTrueFPSKillFeedEntry& Entry = Items[Slot];
+	Entry.Serial = LastSerial;
+	Entry.KillerId = KillerId;
+	Entry.VictimId = VictimId;
+	Entry.DamageTypeIndex = DamageTypeIndex;
+	Entry.Flags = Flags;
+	MarkItemDirty(Entry);
+
+	return Entry;
+}
+
+void FTrueFPSKillFeed::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (Owner)
+	{
+		Owner->FlushReceivedKills();
+	}
+}
+
 // Sets default values
 ATrueFPSGameState::ATrueFPSGameState(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
 
+void ATrueFPSGameState::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	KillFeed.Owner = this;
+}
+
 void ATrueFPSGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
@@ -21,6 +79,8 @@ void ATrueFPSGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	DOREPLIFETIME( ThisClass, RemainingTime );
 	// DOREPLIFETIME( ThisClass, bTimerPaused );
 	DOREPLIFETIME( ThisClass, TeamScores );
+	DOREPLIFETIME( ThisClass, KillFeed );
+	DOREPLIFETIME( ThisClass, KillFeedDamageTypes );
 }
 
 void ATrueFPSGameState::GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const
@@ -80,3 +140,115 @@ void ATrueFPSGameState::RequestFinishAndExitToMainMenu()
 	}
 }
 
+void ATrueFPSGameState::AddKill(ATrueFPSPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, ATrueFPSPlayerState* KilledPlayerState)
+{
+	check(HasAuthority());
+
+	uint8 DamageTypeIndex = MAX_uint8;
+	if (KillerDamageType)
+	{
+		int32 Index = KillFeedDamageTypes.Find(KillerDamageType->GetClass());
+		if (Index == INDEX_NONE && KillFeedDamageTypes.Num() < MAX_uint8)
+		{
+			Index = KillFeedDamageTypes.Add(KillerDamageType->GetClass());
+		}
+		DamageTypeIndex = Index != INDEX_NONE ? static_cast<uint8>(Index) : MAX_uint8;
+	}
+
+	uint8 Flags = 0;
+	if (KillerPlayerState == nullptr)
+	{
+		Flags |= EKillFeedFlags::NoKiller;
+	}
+	else if (KillerPlayerState == KilledPlayerState)
+	{
+		Flags |= EKillFeedFlags::Suicide;
+	}
+
+	const FTrueFPSKillFeedEntry& Entry = KillFeed.AddKill(
+		FTrueFPSKillFeedEntry::ToEntryPlayerId(KillerPlayerState),
+		FTrueFPSKillFeedEntry::ToEntryPlayerId(KilledPlayerState),
+		DamageTypeIndex, Flags);
+
+	// no replication callbacks for the server's own local players
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		LastShownKillSerial = Entry.Serial;
+		ShowKill(Entry);
+	}
+}
+
+void ATrueFPSGameState::OnKillFeedEntryReceived(const FTrueFPSKillFeedEntry& Entry)
+{
+	// The feed arrives with the game state for late joiners, those kills are old news
+	if (!HasActorBegunPlay())
+	{
+		if (FTrueFPSKillFeedEntry::IsNewerSerial(Entry.Serial, LastShownKillSerial))
+		{
+			LastShownKillSerial = Entry.Serial;
+		}
+		return;
+	}
+
+	if (FTrueFPSKillFeedEntry::IsNewerSerial(Entry.Serial, LastShownKillSerial))
+	{
+		ReceivedKills.Add(Entry);
+	}
+}
+
+void ATrueFPSGameState::FlushReceivedKills()
+{
+	if (ReceivedKills.Num() == 0)
+	{
+		return;
+	}
+
+	// ring slots are received in slot order, not kill order
+	ReceivedKills.Sort([](const FTrueFPSKillFeedEntry& A, const FTrueFPSKillFeedEntry& B) { return FTrueFPSKillFeedEntry::IsNewerSerial(B.Serial, A.Serial); });
+	for (const FTrueFPSKillFeedEntry& Entry : ReceivedKills)
+	{
+		if (FTrueFPSKillFeedEntry::IsNewerSerial(Entry.Serial, LastShownKillSerial))
+		{
+			LastShownKillSerial = Entry.Serial;
+			ShowKill(Entry);
+		}
+	}
+	ReceivedKills.Reset();
+}
+
+void ATrueFPSGameState::ShowKill(const FTrueFPSKillFeedEntry& Entry)
+{
+	ATrueFPSPlayerState* KillerPlayerState = nullptr;
+	ATrueFPSPlayerState* KilledPlayerState = nullptr;
+	for (APlayerState* TestPlayerState : PlayerArray)
+	{
+		const uint16 TestPlayerId = FTrueFPSKillFeedEntry::ToEntryPlayerId(TestPlayerState);
+		if (TestPlayerState && TestPlayerId == Entry.KillerId && !(Entry.Flags & EKillFeedFlags::NoKiller))
+		{
+			KillerPlayerState = Cast<ATrueFPSPlayerState>(TestPlayerState);
+		}
+		if (TestPlayerState && TestPlayerId == Entry.VictimId && Entry.VictimId != FTrueFPSKillFeedEntry::NoPlayer)
+		{
+			KilledPlayerState = Cast<ATrueFPSPlayerState>(TestPlayerState);
+		}
+	}
+
+	const UDamageType* KillerDamageType = nullptr;
+	if (KillFeedDamageTypes.IsValidIndex(Entry.DamageTypeIndex) && KillFeedDamageTypes[Entry.DamageTypeIndex])
+	{
+		KillerDamageType = KillFeedDamageTypes[Entry.DamageTypeIndex]->GetDefaultObject<UDamageType>();
+	}
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		ATrueFPSPlayerController* TestPC = Cast<ATrueFPSPlayerController>(*It);
+		if (TestPC && TestPC->IsLocalController())
+		{
+			// all local players get death messages so they can update their huds, the HUD formats them when shown
+			if (KilledPlayerState)
+			{
+				TestPC->OnDeathMessage(KillerPlayerState, KilledPlayerState, KillerDamageType);
+			}
+		}
+	}
+}
@@ -0,0 +1,190 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TrueFPSLeaderboardCache.h"
+
+#include "TrueFPSLeaderboards.h"
+#include "TrueFPSSystem.h"
+#include "OnlineSubsystemUtils.h"
+#include "Interfaces/OnlineLeaderboardInterface.h"
+#include "Engine/GameInstance.h"
+
+FTrueFPSLeaderboardCache::FTrueFPSLeaderboardCache(UGameInstance* InGameInstance)
+	: GameInstance(InGameInstance)
+{
+}
+
+FTrueFPSLeaderboardCache::~FTrueFPSLeaderboardCache()
+{
+	if (ReadCompleteHandle.IsValid() && GameInstance.IsValid())
+	{
+		if (IOnlineLeaderboardsPtr Leaderboards = Online::GetLeaderboardsInterface(GameInstance->GetWorld()))
+		{
+			Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(ReadCompleteHandle);
+		}
+	}
+}
+
+void FTrueFPSLeaderboardCache::ReadAroundUser(const FUniqueNetIdRepl& UserId, const FOnLeaderboardCacheReadComplete& Delegate)
+{
+	FReadKey Key;
+	Key.User = UserId;
+	Read(Key, Delegate);
+}
+
+void FTrueFPSLeaderboardCache::ReadPage(int32 PageIndex, const FOnLeaderboardCacheReadComplete& Delegate)
+{
+	FReadKey Key;
+	Key.PageIndex = PageIndex;
+	Read(Key, Delegate);
+}
+
+const FTrueFPSLeaderboardCache::FCachedRead* FTrueFPSLeaderboardCache::FindValidRead(const FReadKey& Key) const
+{
+	const FCachedRead* CachedRead = Reads.Find(Key);
+	return CachedRead && CachedRead->bValid && GetTime() - CachedRead->ReadTime < ReadTTL ? CachedRead : nullptr;
+}
+
+const TArray<FOnlineStatsRow>* FTrueFPSLeaderboardCache::GetRowsAroundUser(const FUniqueNetIdRepl& UserId) const
+{
+	FReadKey Key;
+	Key.User = UserId;
+	const FCachedRead* CachedRead = Reads.Find(Key);
+	return CachedRead && CachedRead->bValid ? &CachedRead->Rows : nullptr;
+}
+
+const TArray<FOnlineStatsRow>* FTrueFPSLeaderboardCache::GetPage(int32 PageIndex) const
+{
+	FReadKey Key;
+	Key.PageIndex = PageIndex;
+	const FCachedRead* CachedRead = Reads.Find(Key);
+	return CachedRead && CachedRead->bValid ? &CachedRead->Rows : nullptr;
+}
+
+void FTrueFPSLeaderboardCache::Invalidate()
+{
+	++Generation;
+	for (TPair<FReadKey, FCachedRead>& Pair : Reads)
+	{
+		Pair.Value.ReadTime = -DBL_MAX;
+	}
+}
+
+void FTrueFPSLeaderboardCache::Read(const FReadKey& Key, const FOnLeaderboardCacheReadComplete& Delegate)
+{
+	if (FindValidRead(Key))
+	{
+		Delegate.ExecuteIfBound(true);
+		return;
+	}
+
+	// Whoever asks while the read is queued or in flight shares it
+	FCachedRead& CachedRead = Reads.FindOrAdd(Key);
+	CachedRead.Waiting.Add(Delegate);
+
+	const bool bInFlight = CurrentRead.IsSet() && CurrentRead.GetValue() == Key;
+	if (!bInFlight && !QueuedReads.Contains(Key))
+	{
+		QueuedReads.Add(Key);
+		StartNextRead();
+	}
+}
+
+void FTrueFPSLeaderboardCache::StartNextRead()
+{
+	if (CurrentRead.IsSet() || QueuedReads.Num() == 0)
+	{
+		return;
+	}
+
+	CurrentRead = QueuedReads[0];
+	QueuedReads.RemoveAt(0);
+	CurrentReadGeneration = Generation;
+
+	CurrentReadObject = MakeShareable(new FTrueFPSAllTimeMatchResultsRead());
+	FOnlineLeaderboardReadRef ReadObjectRef = CurrentReadObject.ToSharedRef();
+
+	if (!ReadLeaderboards(CurrentRead.GetValue(), ReadObjectRef))
+	{
+		FinishRead(false);
+	}
+}
+
+bool FTrueFPSLeaderboardCache::ReadLeaderboards(const FReadKey& Key, FOnlineLeaderboardReadRef& ReadObjectRef)
+{
+	const IOnlineLeaderboardsPtr Leaderboards = GameInstance.IsValid() ? Online::GetLeaderboardsInterface(GameInstance->GetWorld()) : nullptr;
+	if (!Leaderboards.IsValid())
+	{
+		return false;
+	}
+
+	if (!ReadCompleteHandle.IsValid())
+	{
+		ReadCompleteHandle = Leaderboards->AddOnLeaderboardReadCompleteDelegate_Handle(FOnLeaderboardReadCompleteDelegate::CreateSP(this, &FTrueFPSLeaderboardCache::OnReadComplete));
+	}
+
+	bool bStarted = false;
+	if (Key.PageIndex != INDEX_NONE)
+	{
+		// Ranks are 1 based, the read covers Range ranks on each side
+		const int32 HalfPage = PageSize / 2;
+		bStarted = Leaderboards->ReadLeaderboardsAroundRank(Key.PageIndex * PageSize + HalfPage + 1, HalfPage, ReadObjectRef);
+	}
+	else if (Key.User.IsValid())
+	{
+		bStarted = Leaderboards->ReadLeaderboardsAroundUser(Key.User->AsShared(), PageSize / 2, ReadObjectRef);
+		if (!bStarted)
+		{
+			// Not every backend can read around a user, at least get the user's own row
+			TArray<TSharedRef<const FUniqueNetId>> Players;
+			Players.Add(Key.User->AsShared());
+			bStarted = Leaderboards->ReadLeaderboards(Players, ReadObjectRef);
+		}
+	}
+
+	return bStarted;
+}
+
+double FTrueFPSLeaderboardCache::GetTime() const
+{
+	return FPlatformTime::Seconds();
+}
+
+void FTrueFPSLeaderboardCache::OnReadComplete(bool bWasSuccessful)
+{
+	// The interface reports every leaderboard read through the same delegate, ignore the ones that aren't ours
+	if (!CurrentRead.IsSet() || !CurrentReadObject.IsValid()
+		|| CurrentReadObject->ReadState == EOnlineAsyncTaskState::InProgress || CurrentReadObject->ReadState == EOnlineAsyncTaskState::NotStarted)
+	{
+		return;
+	}
+
+	FinishRead(bWasSuccessful && CurrentReadObject->ReadState == EOnlineAsyncTaskState::Done);
+}
+
+void FTrueFPSLeaderboardCache::FinishRead(bool bWasSuccessful)
+{
+	const FReadKey Key = CurrentRead.GetValue();
+	CurrentRead.Reset();
+
+	TArray<FOnLeaderboardCacheReadComplete> Waiting;
+	if (FCachedRead* CachedRead = Reads.Find(Key))
+	{
+		if (bWasSuccessful && CurrentReadObject.IsValid())
+		{
+			CachedRead->Rows = MoveTemp(CurrentReadObject->Rows);
+			CachedRead->bValid = true;
+
+			// A write since the read started may not be in it, keep the rows but read again next time
+			CachedRead->ReadTime = CurrentReadGeneration == Generation ? GetTime() : -DBL_MAX;
+		}
+		Waiting = MoveTemp(CachedRead->Waiting);
+	}
+	CurrentReadObject.Reset();
+
+	StartNextRead();
+
+	for (const FOnLeaderboardCacheReadComplete& Delegate : Waiting)
+	{
+		Delegate.ExecuteIfBound(bWasSuccessful);
+	}
+}
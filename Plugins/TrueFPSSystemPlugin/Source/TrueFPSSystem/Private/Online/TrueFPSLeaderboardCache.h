@@ -0,0 +1,112 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineStats.h"
+#include "OnlineSubsystemTypes.h"
+#include "GameFramework/OnlineReplStructs.h"
+
+class UGameInstance;
+
+/** delegate called when a leaderboard read requested from the cache completes, straight away if the cache was fresh */
+DECLARE_DELEGATE_OneParam(FOnLeaderboardCacheReadComplete, bool /*bWasSuccessful*/);
+
+/**
+ * Caches reads of the all time leaderboard, so reopening the leaderboard doesn't hit the backend every time.
+ * - the board is read in pages of consecutive ranks, plus the rows around a given user
+ * - cached reads expire after a while, or as soon as the board is written to
+ * - requests for a read already in flight wait for it instead of issuing another one
+ */
+class FTrueFPSLeaderboardCache : public TSharedFromThis<FTrueFPSLeaderboardCache>
+{
+public:
+
+	/** ranks per page */
+	static constexpr int32 PageSize = 50;
+
+	/** how long a read is handed out from the cache before the board is read again */
+	static constexpr double ReadTTL = 60.0;
+
+	FTrueFPSLeaderboardCache(UGameInstance* InGameInstance);
+	virtual ~FTrueFPSLeaderboardCache();
+
+	/** Reads the rows around the given user */
+	void ReadAroundUser(const FUniqueNetIdRepl& UserId, const FOnLeaderboardCacheReadComplete& Delegate);
+
+	/** Reads ranks [PageIndex * PageSize + 1, (PageIndex + 1) * PageSize] */
+	void ReadPage(int32 PageIndex, const FOnLeaderboardCacheReadComplete& Delegate);
+
+	/** @return the rows around the given user, null unless read */
+	const TArray<FOnlineStatsRow>* GetRowsAroundUser(const FUniqueNetIdRepl& UserId) const;
+
+	/** @return the rows of a page, null unless read */
+	const TArray<FOnlineStatsRow>* GetPage(int32 PageIndex) const;
+
+	/** @return page a rank is on */
+	static int32 GetPageIndex(int32 Rank) { return FMath::Max(Rank - 1, 0) / PageSize; }
+
+	/** Drops every cached read, e.g. after writing to the board */
+	void Invalidate();
+
+protected:
+
+	/** What a read is for */
+	struct FReadKey
+	{
+		/** page index, or INDEX_NONE for the rows around User */
+		int32 PageIndex = INDEX_NONE;
+		FUniqueNetIdRepl User;
+
+		bool operator==(const FReadKey& Other) const { return PageIndex == Other.PageIndex && User == Other.User; }
+		friend uint32 GetTypeHash(const FReadKey& Key) { return HashCombine(::GetTypeHash(Key.PageIndex), GetTypeHash(Key.User)); }
+	};
+
+	struct FCachedRead
+	{
+		TArray<FOnlineStatsRow> Rows;
+		double ReadTime = -DBL_MAX;
+		bool bValid = false;
+
+		/** callers waiting on this read, whether queued or in flight */
+		TArray<FOnLeaderboardCacheReadComplete> Waiting;
+	};
+
+	void Read(const FReadKey& Key, const FOnLeaderboardCacheReadComplete& Delegate);
+
+	/** Starts the next queued read, the leaderboards interface reports completion through a single delegate so one runs at a time */
+	void StartNextRead();
+
+	/**
+	 * Reads the board for a key through the leaderboards interface, OnReadComplete is called once done.
+	 *
+	 * @return	false if the read couldn't be started
+	 */
+	virtual bool ReadLeaderboards(const FReadKey& Key, FOnlineLeaderboardReadRef& ReadObjectRef);
+
+	/** @return the time cached reads expire against */
+	virtual double GetTime() const;
+
+	void OnReadComplete(bool bWasSuccessful);
+
+	/** Completes the read in flight and moves on to the next one */
+	void FinishRead(bool bWasSuccessful);
+
+	const FCachedRead* FindValidRead(const FReadKey& Key) const;
+
+	TWeakObjectPtr<UGameInstance> GameInstance;
+
+	TMap<FReadKey, FCachedRead> Reads;
+
+	/** reads waiting for their turn, oldest first */
+	TArray<FReadKey> QueuedReads;
+
+	/** read in flight, if any */
+	TOptional<FReadKey> CurrentRead;
+	FOnlineLeaderboardReadPtr CurrentReadObject;
+	FDelegateHandle ReadCompleteHandle;
+
+	/** bumped by Invalidate, reads that started before are not cached */
+	uint32 Generation = 0;
+	uint32 CurrentReadGeneration = 0;
+};
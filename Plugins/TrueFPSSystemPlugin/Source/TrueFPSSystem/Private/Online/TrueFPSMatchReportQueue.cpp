@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TrueFPSMatchReportQueue.h"
+
+#include "OnlineSubsystemUtils.h"
+#include "Character/TrueFPSPlayerController.h"
+#include "Interfaces/OnlineLeaderboardInterface.h"
+
+float GTrueFPSMatchReportBudgetMs = 1.0f;
+static FAutoConsoleVariableRef CVarTrueFPSMatchReportBudgetMs(
+	TEXT("TrueFPS.MatchReportBudgetMs"),
+	GTrueFPSMatchReportBudgetMs,
+	TEXT("Time in milliseconds spent each frame writing end of match reports (save file, achievements, leaderboards, stats).\n")
+	TEXT("At least one step runs every frame."),
+	ECVF_Default);
+
+FTrueFPSMatchReportQueue::~FTrueFPSMatchReportQueue()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+}
+
+void FTrueFPSMatchReportQueue::Add(ATrueFPSPlayerController* PlayerController)
+{
+	PendingControllers.AddUnique(PlayerController);
+
+	if (!TickHandle.IsValid())
+	{
+		TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FTrueFPSMatchReportQueue::Tick));
+	}
+}
+
+bool FTrueFPSMatchReportQueue::Tick(float DeltaTime)
+{
+	if (PendingControllers.Num() == 0)
+	{
+		TickHandle.Reset();
+		return false;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + GTrueFPSMatchReportBudgetMs / 1000.0;
+	UWorld* LeaderboardsWorld = nullptr;
+
+	do
+	{
+		ATrueFPSPlayerController* PlayerController = PendingControllers[0].Get();
+
+		bool bWroteLeaderboards = false;
+		if (PlayerController == nullptr || !PlayerController->RunMatchReportStep(bWroteLeaderboards))
+		{
+			PendingControllers.RemoveAt(0);
+		}
+
+		if (bWroteLeaderboards)
+		{
+			LeaderboardsWorld = PlayerController->GetWorld();
+		}
+	}
+	while (PendingControllers.Num() > 0 && FPlatformTime::Seconds() < EndTime);
+
+	// One flush for every player's leaderboards written this frame
+	if (LeaderboardsWorld)
+	{
+		const IOnlineLeaderboardsPtr Leaderboards = Online::GetLeaderboardsInterface(LeaderboardsWorld);
+		if (Leaderboards.IsValid())
+		{
+			Leaderboards->FlushLeaderboards(TEXT("TRUEFPSSYSTEM"));
+		}
+	}
+
+	if (PendingControllers.Num() == 0)
+	{
+		// Also when ticked by hand, the core ticker must not call back into an empty queue
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+		return false;
+	}
+	return true;
+}
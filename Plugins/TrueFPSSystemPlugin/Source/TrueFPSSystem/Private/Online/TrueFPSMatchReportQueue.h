@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+class ATrueFPSPlayerController;
+
+/**
+ * Spreads the end of match reports of the local players (save file, achievements, leaderboards and stats writes)
+ * over the frames following the end of the match, under a time budget, instead of running them all in the frame
+ * the match ends and travel starts.
+ */
+class FTrueFPSMatchReportQueue : public TSharedFromThis<FTrueFPSMatchReportQueue>
+{
+public:
+
+	~FTrueFPSMatchReportQueue();
+
+	/** Queues the pending match results of the given player controller, once per controller however many are pending */
+	void Add(ATrueFPSPlayerController* PlayerController);
+
+	/** @return true while some controller's reports haven't been written */
+	bool HasPendingReports() const { return PendingControllers.Num() > 0; }
+
+	/** Runs report steps until the budget is spent, called by the core ticker while reports are pending */
+	bool Tick(float DeltaTime);
+
+private:
+
+	/** Controllers with reports left, oldest first */
+	TArray<TWeakObjectPtr<ATrueFPSPlayerController>> PendingControllers;
+
+	FTSTicker::FDelegateHandle TickHandle;
+};
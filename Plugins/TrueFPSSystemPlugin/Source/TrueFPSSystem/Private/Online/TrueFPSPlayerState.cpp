@@ -123,42 +123,16 @@ FString ATrueFPSPlayerState::GetShortPlayerName() const
 	return GetPlayerName();
 }
 
-void ATrueFPSPlayerState::InformAboutKill_Implementation(ATrueFPSPlayerState* KillerPlayerState,
-	const UDamageType* KillerDamageType, ATrueFPSPlayerState* KilledPlayerState)
-{
-	// id can be nullptr for bots
-	if (KillerPlayerState->GetUniqueId().IsValid())
-	{	
-		// search for the actual killer before calling OnKill()	
-		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-		{		
-			ATrueFPSPlayerController* TestPC = Cast<ATrueFPSPlayerController>(*It);
-			if (TestPC && TestPC->IsLocalController())
-			{
-				// a local player might not have an ID if it was created with CreateDebugPlayer.
-				ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(TestPC->Player);
-				FUniqueNetIdRepl LocalID = LocalPlayer->GetCachedUniqueNetId();
-				if (LocalID.IsValid() &&  *LocalPlayer->GetCachedUniqueNetId() == *KillerPlayerState->GetUniqueId())
-				{			
-					TestPC->OnKill();
-				}
-			}
-		}
-	}
-}
-
-void ATrueFPSPlayerState::BroadcastDeath_Implementation(ATrueFPSPlayerState* KillerPlayerState,
-	const UDamageType* KillerDamageType, ATrueFPSPlayerState* KilledPlayerState)
+void ATrueFPSPlayerState::InformAboutKill_Implementation()
 {
 	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
 	{
-		// all local players get death messages so they can update their huds.
 		ATrueFPSPlayerController* TestPC = Cast<ATrueFPSPlayerController>(*It);
-		if (TestPC && TestPC->IsLocalController())
+		if (TestPC && TestPC->IsLocalController() && TestPC->PlayerState == this)
 		{
-			TestPC->OnDeathMessage(KillerPlayerState, this, KillerDamageType);				
+			TestPC->OnKill();
 		}
-	}	
+	}
 }
 
 void ATrueFPSPlayerState::OnRep_TeamColor()
@@ -194,14 +168,12 @@ void ATrueFPSPlayerState::CopyProperties(APlayerState* PlayerState)
 
 void ATrueFPSPlayerState::UpdateTeamColors()
 {
-	AController* OwnerController = Cast<AController>(GetOwner());
-	if (OwnerController != nullptr)
+	// the owning controller only exists on the server and its owning client, the pawn is known everywhere
+	ATrueFPSCharacter* TrueFPSCharacter = GetPawn<ATrueFPSCharacter>();
+	if (TrueFPSCharacter != nullptr)
 	{
-		ATrueFPSCharacter* TrueFPSCharacter = Cast<ATrueFPSCharacter>(OwnerController->GetCharacter());
-		if (TrueFPSCharacter != nullptr)
-		{
-			// ShooterCharacter->UpdateTeamColorsAllMIDs(); @todo add team colors
-		}
+		TrueFPSCharacter->RefreshTeamCache();
+		// ShooterCharacter->UpdateTeamColorsAllMIDs(); @todo add team colors
 	}
 }
 
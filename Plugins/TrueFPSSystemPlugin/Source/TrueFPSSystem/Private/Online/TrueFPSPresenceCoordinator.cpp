@@ -0,0 +1,350 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TrueFPSPresenceCoordinator.h"
+
+#include "TrueFPSSystem.h"
+#include "OnlineSubsystemUtils.h"
+#include "Engine/GameInstance.h"
+
+/** first retry delay after a failed call, doubled with every further failure */
+static constexpr double RetryBaseDelay = 2.0;
+
+/** longest we wait before retrying a failed call */
+static constexpr double RetryMaxDelay = 300.0;
+
+/** a cached friends list younger than this is handed out as is, the backend tells us about changes in between */
+static constexpr double FriendsListMaxAge = 60.0;
+
+void FTrueFPSPresenceCoordinator::FRetryState::OnFailure(double Now)
+{
+	++NumFailures;
+	const double Delay = FMath::Min(RetryBaseDelay * FMath::Pow(2.0, FMath::Min(NumFailures - 1, 16)), RetryMaxDelay);
+
+	// A little jitter keeps several clients that failed together from retrying together
+	RetryTime = Now + Delay * FMath::FRandRange(0.9, 1.1);
+}
+
+FTrueFPSPresenceCoordinator::FTrueFPSPresenceCoordinator(UGameInstance* InGameInstance)
+	: GameInstance(InGameInstance)
+{
+}
+
+FTrueFPSPresenceCoordinator::~FTrueFPSPresenceCoordinator()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(FlushHandle);
+
+	if (IOnlineFriendsPtr Friends = GetFriendsInterface())
+	{
+		for (TPair<int32, FUserFriends>& UserFriends : FriendsByUser)
+		{
+			Friends->ClearOnFriendsChangeDelegate_Handle(UserFriends.Key, UserFriends.Value.FriendsChangeHandle);
+		}
+	}
+}
+
+IOnlinePresencePtr FTrueFPSPresenceCoordinator::GetPresenceInterface() const
+{
+	return GameInstance.IsValid() ? Online::GetPresenceInterface(GameInstance->GetWorld()) : nullptr;
+}
+
+IOnlineFriendsPtr FTrueFPSPresenceCoordinator::GetFriendsInterface() const
+{
+	return GameInstance.IsValid() ? Online::GetFriendsInterface(GameInstance->GetWorld()) : nullptr;
+}
+
+bool FTrueFPSPresenceCoordinator::SendPresence(int32 LocalUserNum, const FUniqueNetId& UserId, const FOnlineUserPresenceStatus& Update)
+{
+	const IOnlinePresencePtr Presence = GetPresenceInterface();
+	if (!Presence.IsValid())
+	{
+		return false;
+	}
+
+	Presence->SetPresence(UserId, Update, IOnlinePresence::FOnPresenceTaskCompleteDelegate::CreateSP(this, &FTrueFPSPresenceCoordinator::OnSetPresenceComplete, LocalUserNum, Update));
+	return true;
+}
+
+bool FTrueFPSPresenceCoordinator::ReadFriendsList(int32 LocalUserNum, const FString& ListName)
+{
+	const IOnlineFriendsPtr Friends = GetFriendsInterface();
+	if (!Friends.IsValid())
+	{
+		return false;
+	}
+
+	Friends->ReadFriendsList(LocalUserNum, ListName, FOnReadFriendsListComplete::CreateSP(this, &FTrueFPSPresenceCoordinator::OnReadFriendsListComplete));
+	return true;
+}
+
+bool FTrueFPSPresenceCoordinator::GetReadFriendsList(int32 LocalUserNum, const FString& ListName, TArray<TSharedRef<FOnlineFriend>>& OutFriends) const
+{
+	const IOnlineFriendsPtr Friends = GetFriendsInterface();
+	return Friends.IsValid() && Friends->GetFriendsList(LocalUserNum, ListName, OutFriends);
+}
+
+double FTrueFPSPresenceCoordinator::GetTime() const
+{
+	return FPlatformTime::Seconds();
+}
+
+void FTrueFPSPresenceCoordinator::SetPresence(int32 LocalUserNum, const FUniqueNetIdRepl& UserId, const FString& StatusStr, const FPresenceKey& Key, const FVariantData& Value)
+{
+	if (!UserId.IsValid())
+	{
+		return;
+	}
+
+	FUserPresence& UserPresence = PresenceByUser.FindOrAdd(LocalUserNum);
+	if (UserPresence.UserId != UserId)
+	{
+		// Someone else signed in on this slot, nothing we sent applies to them
+		UserPresence = FUserPresence();
+		UserPresence.UserId = UserId;
+	}
+
+	UserPresence.Desired.StatusStr = StatusStr;
+	UserPresence.Desired.State = EOnlinePresenceState::Online;
+	UserPresence.Desired.Properties.Add(Key, Value);
+
+	FOnlineUserPresenceStatus Update;
+	if (!UserPresence.bInFlight && GetPresenceDiff(UserPresence, Update))
+	{
+		// Next frame, so every local player set in this one goes out in the same flush
+		ScheduleFlush(FMath::Max(UserPresence.Retry.RetryTime - GetTime(), 0.0));
+	}
+}
+
+bool FTrueFPSPresenceCoordinator::GetPresenceDiff(const FUserPresence& UserPresence, FOnlineUserPresenceStatus& OutUpdate)
+{
+	// Some backends replace the whole property set on every call, so the update always carries every key
+	OutUpdate = UserPresence.Desired;
+
+	bool bPropertiesChanged = false;
+	for (const TPair<FPresenceKey, FVariantData>& Property : UserPresence.Desired.Properties)
+	{
+		const FVariantData* SentValue = UserPresence.bHasSent ? UserPresence.Sent.Properties.Find(Property.Key) : nullptr;
+		if (SentValue == nullptr || *SentValue != Property.Value)
+		{
+			bPropertiesChanged = true;
+			break;
+		}
+	}
+
+	return !UserPresence.bHasSent
+		|| bPropertiesChanged
+		|| OutUpdate.StatusStr != UserPresence.Sent.StatusStr
+		|| OutUpdate.State != UserPresence.Sent.State;
+}
+
+void FTrueFPSPresenceCoordinator::ScheduleFlush(double Delay)
+{
+	const double FlushTime = GetTime() + Delay;
+	if (FlushHandle.IsValid())
+	{
+		if (ScheduledFlushTime <= FlushTime)
+		{
+			return;
+		}
+		FTSTicker::GetCoreTicker().RemoveTicker(FlushHandle);
+	}
+
+	ScheduledFlushTime = FlushTime;
+	FlushHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FTrueFPSPresenceCoordinator::FlushPresence), Delay);
+}
+
+bool FTrueFPSPresenceCoordinator::FlushPresence(float DeltaTime)
+{
+	FlushHandle.Reset();
+
+	const double Now = GetTime();
+	double NextRetryTime = DBL_MAX;
+
+	for (TPair<int32, FUserPresence>& Pair : PresenceByUser)
+	{
+		FUserPresence& UserPresence = Pair.Value;
+
+		FOnlineUserPresenceStatus Update;
+		if (UserPresence.bInFlight || !GetPresenceDiff(UserPresence, Update))
+		{
+			continue;
+		}
+
+		if (UserPresence.Retry.RetryTime > Now)
+		{
+			NextRetryTime = FMath::Min(NextRetryTime, UserPresence.Retry.RetryTime);
+			continue;
+		}
+
+		// In flight before sending, the backend may complete the request right away
+		UserPresence.bInFlight = true;
+		if (!SendPresence(Pair.Key, *UserPresence.UserId, Update))
+		{
+			UserPresence.bInFlight = false;
+			return false;
+		}
+	}
+
+	if (NextRetryTime < DBL_MAX)
+	{
+		ScheduleFlush(NextRetryTime - Now);
+	}
+
+	// One shot, rescheduled whenever there is something to send
+	return false;
+}
+
+void FTrueFPSPresenceCoordinator::OnSetPresenceComplete(const FUniqueNetId& UserId, const bool bWasSuccessful, int32 LocalUserNum, FOnlineUserPresenceStatus Update)
+{
+	FUserPresence* UserPresence = PresenceByUser.Find(LocalUserNum);
+	if (UserPresence == nullptr || !UserPresence->UserId.IsValid() || *UserPresence->UserId != UserId)
+	{
+		return;
+	}
+
+	UserPresence->bInFlight = false;
+
+	if (bWasSuccessful)
+	{
+		UserPresence->Retry.OnSuccess();
+		UserPresence->Sent = Update;
+		UserPresence->bHasSent = true;
+	}
+	else
+	{
+		UserPresence->Retry.OnFailure(GetTime());
+		UE_LOG(LogTrueFPSSystem, Warning, TEXT("Setting presence for local user %d failed, retrying in %.1fs"), LocalUserNum, UserPresence->Retry.RetryTime - GetTime());
+	}
+
+	// Whatever changed while the request was in flight (or the failed update) goes out now
+	FOnlineUserPresenceStatus PendingUpdate;
+	if (GetPresenceDiff(*UserPresence, PendingUpdate))
+	{
+		ScheduleFlush(FMath::Max(UserPresence->Retry.RetryTime - GetTime(), 0.0));
+	}
+}
+
+void FTrueFPSPresenceCoordinator::RefreshFriends(int32 LocalUserNum, bool bForce)
+{
+	FUserFriends& UserFriends = FriendsByUser.FindOrAdd(LocalUserNum);
+	const IOnlineFriendsPtr Friends = GetFriendsInterface();
+	if (Friends.IsValid() && !UserFriends.FriendsChangeHandle.IsValid())
+	{
+		UserFriends.FriendsChangeHandle = Friends->AddOnFriendsChangeDelegate_Handle(LocalUserNum, FOnFriendsChangeDelegate::CreateSP(this, &FTrueFPSPresenceCoordinator::OnFriendsChange, LocalUserNum));
+	}
+
+	const double Now = GetTime();
+	if (UserFriends.bReadInFlight || UserFriends.Retry.RetryTime > Now || (!bForce && Now - UserFriends.LastReadTime < FriendsListMaxAge))
+	{
+		return;
+	}
+
+	// In flight before reading, the backend may complete the read right away
+	UserFriends.bReadInFlight = true;
+	if (!ReadFriendsList(LocalUserNum, EFriendsLists::ToString(EFriendsLists::OnlinePlayers)))
+	{
+		UserFriends.bReadInFlight = false;
+	}
+}
+
+void FTrueFPSPresenceCoordinator::OnReadFriendsListComplete(int32 LocalUserNum, bool bWasSuccessful, const FString& ListName, const FString& ErrorString)
+{
+	FUserFriends* UserFriends = FriendsByUser.Find(LocalUserNum);
+	if (UserFriends == nullptr)
+	{
+		return;
+	}
+
+	UserFriends->bReadInFlight = false;
+
+	TArray<TSharedRef<FOnlineFriend>> NewFriends;
+	if (!bWasSuccessful || !GetReadFriendsList(LocalUserNum, ListName, NewFriends))
+	{
+		UserFriends->Retry.OnFailure(GetTime());
+		UE_LOG(LogOnline, Warning, TEXT("Unable to update friendslist %s due to error=[%s]"), *ListName, *ErrorString);
+		return;
+	}
+
+	UserFriends->Retry.OnSuccess();
+	UserFriends->LastReadTime = GetTime();
+
+	// Only a real change bumps the version, consumers rebuild on that alone
+	if (UserFriends->Version == 0 || !AreFriendListsEqual(UserFriends->Friends, NewFriends))
+	{
+		UserFriends->Friends = MoveTemp(NewFriends);
+		++UserFriends->Version;
+		FriendsListChangedEvent.Broadcast(LocalUserNum, UserFriends->Version);
+	}
+}
+
+void FTrueFPSPresenceCoordinator::OnFriendsChange(int32 LocalUserNum)
+{
+	if (FUserFriends* UserFriends = FriendsByUser.Find(LocalUserNum))
+	{
+		UserFriends->LastReadTime = -DBL_MAX;
+	}
+
+	// The UI doesn't poll, it rebuilds when the read lands and the list actually changed
+	RefreshFriends(LocalUserNum, true);
+}
+
+bool FTrueFPSPresenceCoordinator::AreFriendListsEqual(const TArray<TSharedRef<FOnlineFriend>>& A, const TArray<TSharedRef<FOnlineFriend>>& B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < A.Num(); ++i)
+	{
+		const FOnlineFriend& FriendA = *A[i];
+		const FOnlineFriend& FriendB = *B[i];
+		const FOnlineUserPresence& PresenceA = FriendA.GetPresence();
+		const FOnlineUserPresence& PresenceB = FriendB.GetPresence();
+
+		if (*FriendA.GetUserId() != *FriendB.GetUserId()
+			|| FriendA.GetDisplayName() != FriendB.GetDisplayName()
+			|| FriendA.GetInviteStatus() != FriendB.GetInviteStatus()
+			|| PresenceA.bIsOnline != PresenceB.bIsOnline
+			|| PresenceA.bIsPlayingThisGame != PresenceB.bIsPlayingThisGame
+			|| PresenceA.Status.StatusStr != PresenceB.Status.StatusStr)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32 FTrueFPSPresenceCoordinator::GetFriends(int32 LocalUserNum, TArray<TSharedRef<FOnlineFriend>>& OutFriends) const
+{
+	const FUserFriends* UserFriends = FriendsByUser.Find(LocalUserNum);
+	if (UserFriends == nullptr)
+	{
+		OutFriends.Reset();
+		return 0;
+	}
+
+	OutFriends = UserFriends->Friends;
+	return UserFriends->Version;
+}
+
+uint32 FTrueFPSPresenceCoordinator::GetFriendsVersion(int32 LocalUserNum) const
+{
+	const FUserFriends* UserFriends = FriendsByUser.Find(LocalUserNum);
+	return UserFriends ? UserFriends->Version : 0;
+}
+
+void FTrueFPSPresenceCoordinator::ResetUser(int32 LocalUserNum)
+{
+	PresenceByUser.Remove(LocalUserNum);
+
+	// The entry stays so the version keeps counting up, consumers never mistake the next user's list for one they've shown
+	if (FUserFriends* UserFriends = FriendsByUser.Find(LocalUserNum))
+	{
+		UserFriends->Friends.Reset();
+		UserFriends->LastReadTime = -DBL_MAX;
+		UserFriends->Retry.OnSuccess();
+		++UserFriends->Version;
+		FriendsListChangedEvent.Broadcast(LocalUserNum, UserFriends->Version);
+	}
+}
@@ -0,0 +1,138 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "OnlineSubsystemTypes.h"
+#include "Interfaces/OnlineFriendsInterface.h"
+#include "Interfaces/OnlinePresenceInterface.h"
+
+class UGameInstance;
+
+/**
+ * Funnels the presence and friends list traffic of every local player through one place, so rate limited backends
+ * only see the calls that matter:
+ * - presence updates made in the same frame are flushed together, and only sent if a key changed (always with the full key set)
+ * - friends list reads are shared by every UI consumer through a versioned cache, refreshed when the backend reports a change
+ * - failed calls are retried with an exponential back off
+ */
+class FTrueFPSPresenceCoordinator : public TSharedFromThis<FTrueFPSPresenceCoordinator>
+{
+public:
+
+	FTrueFPSPresenceCoordinator(UGameInstance* InGameInstance);
+	virtual ~FTrueFPSPresenceCoordinator();
+
+	/** Queues a presence update for the given local player, sent on the next flush if it changes anything */
+	void SetPresence(int32 LocalUserNum, const FUniqueNetIdRepl& UserId, const FString& StatusStr, const FPresenceKey& Key, const FVariantData& Value);
+
+	/**
+	 * Reads the friends list of the given local player unless the cached one is recent enough or a read is already in flight.
+	 *
+	 * @param	bForce		ignore the age of the cached list (still waits for a back off or a read in flight)
+	 */
+	void RefreshFriends(int32 LocalUserNum, bool bForce = false);
+
+	/**
+	 * Gets the cached friends list of the given local player.
+	 *
+	 * @return	version of the list, bumped every time its contents change (0 until the first read completes)
+	 */
+	uint32 GetFriends(int32 LocalUserNum, TArray<TSharedRef<FOnlineFriend>>& OutFriends) const;
+
+	/** @return version of the cached friends list of the given local player */
+	uint32 GetFriendsVersion(int32 LocalUserNum) const;
+
+	/** Drops everything known about a local player, e.g. when they sign out */
+	void ResetUser(int32 LocalUserNum);
+
+	DECLARE_EVENT_TwoParams(FTrueFPSPresenceCoordinator, FOnFriendsListChanged, int32 /*LocalUserNum*/, uint32 /*Version*/);
+	FOnFriendsListChanged& OnFriendsListChanged() { return FriendsListChangedEvent; }
+
+protected:
+
+	/** Exponential back off shared by presence and friends requests */
+	struct FRetryState
+	{
+		int32 NumFailures = 0;
+		double RetryTime = 0.0;
+
+		void OnSuccess() { NumFailures = 0; RetryTime = 0.0; }
+		void OnFailure(double Now);
+	};
+
+	struct FUserPresence
+	{
+		FUniqueNetIdRepl UserId;
+
+		/** presence the game wants */
+		FOnlineUserPresenceStatus Desired;
+
+		/** presence the backend confirmed */
+		FOnlineUserPresenceStatus Sent;
+		bool bHasSent = false;
+
+		bool bInFlight = false;
+		FRetryState Retry;
+	};
+
+	struct FUserFriends
+	{
+		TArray<TSharedRef<FOnlineFriend>> Friends;
+		uint32 Version = 0;
+		double LastReadTime = -DBL_MAX;
+		bool bReadInFlight = false;
+		FRetryState Retry;
+		FDelegateHandle FriendsChangeHandle;
+	};
+
+	/** Builds the update to send to bring the backend up to date, false if it already is */
+	static bool GetPresenceDiff(const FUserPresence& UserPresence, FOnlineUserPresenceStatus& OutUpdate);
+
+	/** @return true if both lists hold the same friends in the same state */
+	static bool AreFriendListsEqual(const TArray<TSharedRef<FOnlineFriend>>& A, const TArray<TSharedRef<FOnlineFriend>>& B);
+
+	/** Makes sure a flush happens no later than Delay seconds from now */
+	void ScheduleFlush(double Delay);
+
+	/** Ticker callback, sends every pending presence update that isn't waiting on a request or a back off */
+	bool FlushPresence(float DeltaTime);
+
+	void OnSetPresenceComplete(const FUniqueNetId& UserId, const bool bWasSuccessful, int32 LocalUserNum, FOnlineUserPresenceStatus Update);
+	void OnReadFriendsListComplete(int32 LocalUserNum, bool bWasSuccessful, const FString& ListName, const FString& ErrorString);
+	void OnFriendsChange(int32 LocalUserNum);
+
+	IOnlinePresencePtr GetPresenceInterface() const;
+	IOnlineFriendsPtr GetFriendsInterface() const;
+
+	/**
+	 * Sends a presence update to the backend, OnSetPresenceComplete is called once it's done.
+	 *
+	 * @return	false if there is no presence service to send it to
+	 */
+	virtual bool SendPresence(int32 LocalUserNum, const FUniqueNetId& UserId, const FOnlineUserPresenceStatus& Update);
+
+	/**
+	 * Asks the backend for a friends list, OnReadFriendsListComplete is called once it's done.
+	 *
+	 * @return	false if there is no friends service to ask
+	 */
+	virtual bool ReadFriendsList(int32 LocalUserNum, const FString& ListName);
+
+	/** Gets the friends list the last read returned, false if there is no friends service */
+	virtual bool GetReadFriendsList(int32 LocalUserNum, const FString& ListName, TArray<TSharedRef<FOnlineFriend>>& OutFriends) const;
+
+	/** Current time, every delay and back off is measured against it */
+	virtual double GetTime() const;
+
+	TWeakObjectPtr<UGameInstance> GameInstance;
+
+	TMap<int32, FUserPresence> PresenceByUser;
+	TMap<int32, FUserFriends> FriendsByUser;
+
+	FTSTicker::FDelegateHandle FlushHandle;
+	double ScheduledFlushTime = 0.0;
+
+	FOnFriendsListChanged FriendsListChangedEvent;
+};
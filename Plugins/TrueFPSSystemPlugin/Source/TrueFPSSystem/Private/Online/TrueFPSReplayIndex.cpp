@@ -0,0 +1,255 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TrueFPSReplayIndex.h"
+
+#include "TrueFPSSystem.h"
+#include "Async/Async.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+/** bump when the layout of the index changes, older indices are thrown away */
+static constexpr int32 ReplayIndexFormatVersion = 1;
+
+/** extension the LocalFile streamer gives the replays in its demo path */
+static const TCHAR* ReplayFileExtension = TEXT(".replay");
+
+FCriticalSection FTrueFPSReplayIndex::IndexCritical;
+
+bool FTrueFPSReplayIndex::GetDemoDirectory(const TSharedPtr<INetworkReplayStreamer>& Streamer, FString& OutDemoDirectory)
+{
+	// Only the streamers writing replay files have a demo path, http and in memory streamers report it as unsupported
+	OutDemoDirectory.Reset();
+	return Streamer.IsValid() && Streamer->GetDemoPath(OutDemoDirectory) == EStreamingOperationResult::Success && !OutDemoDirectory.IsEmpty();
+}
+
+FString FTrueFPSReplayIndex::GetIndexFilename(const FString& DemoDirectory, const FNetworkReplayVersion& Version)
+{
+	return FPaths::Combine(DemoDirectory, FString::Printf(TEXT("ReplayIndex_%u_%u.json"), Version.NetworkVersion, Version.Changelist));
+}
+
+void FTrueFPSReplayIndex::GetReplayFileTimestamps(const FString& DemoDirectory, TMap<FString, FDateTime>& OutTimestamps)
+{
+	// Only stats the files, the replays themselves aren't opened
+	IFileManager::Get().IterateDirectoryStat(*DemoDirectory, [&OutTimestamps](const TCHAR* Filename, const FFileStatData& StatData)
+	{
+		const FString File(Filename);
+		if (!StatData.bIsDirectory && File.EndsWith(ReplayFileExtension))
+		{
+			OutTimestamps.Add(FPaths::GetBaseFilename(File), StatData.ModificationTime);
+		}
+		return true;
+	});
+}
+
+bool FTrueFPSReplayIndex::Load(const FString& DemoDirectory, const FNetworkReplayVersion& Version, TArray<FTrueFPSReplayIndexEntry>& OutEntries, bool& bOutIsStale)
+{
+	bOutIsStale = true;
+
+	FString JsonString;
+	{
+		FScopeLock Lock(&IndexCritical);
+		if (!FFileHelper::LoadFileToString(JsonString, *GetIndexFilename(DemoDirectory, Version)))
+		{
+			return false;
+		}
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || Root->GetIntegerField(TEXT("Format")) != ReplayIndexFormatVersion)
+	{
+		UE_LOG(LogTrueFPSSystem, Warning, TEXT("Ignoring unreadable replay index %s"), *GetIndexFilename(DemoDirectory, Version));
+		return false;
+	}
+
+	TMap<FString, FDateTime> FileTimestamps;
+	GetReplayFileTimestamps(DemoDirectory, FileTimestamps);
+
+	// Every replay on disk has to be accounted for, either listed or skipped by the enumeration, or the index is stale
+	int32 NumAccountedFor = 0;
+	bool bChanged = false;
+
+	const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+	if (Root->TryGetArrayField(TEXT("Entries"), Entries))
+	{
+		OutEntries.Reserve(Entries->Num());
+		for (const TSharedPtr<FJsonValue>& Value : *Entries)
+		{
+			const TSharedPtr<FJsonObject> Object = Value->AsObject();
+			if (!Object.IsValid())
+			{
+				continue;
+			}
+
+			FTrueFPSReplayIndexEntry Entry;
+			Entry.StreamInfo.Name = Object->GetStringField(TEXT("Name"));
+			Entry.FileTimestamp = FDateTime(FCString::Atoi64(*Object->GetStringField(TEXT("FileTime"))));
+
+			// Replays deleted behind our back are just dropped
+			const FDateTime* FileTimestamp = FileTimestamps.Find(Entry.StreamInfo.Name);
+			if (FileTimestamp == nullptr)
+			{
+				continue;
+			}
+
+			++NumAccountedFor;
+			bChanged |= *FileTimestamp != Entry.FileTimestamp;
+
+			Entry.StreamInfo.FriendlyName = Object->GetStringField(TEXT("FriendlyName"));
+			Entry.StreamInfo.Timestamp = FDateTime(FCString::Atoi64(*Object->GetStringField(TEXT("Timestamp"))));
+			Entry.StreamInfo.SizeInBytes = FCString::Atoi64(*Object->GetStringField(TEXT("Size")));
+			Entry.StreamInfo.LengthInMS = Object->GetIntegerField(TEXT("Length"));
+			Entry.StreamInfo.NumViewers = Object->GetIntegerField(TEXT("Viewers"));
+			Entry.StreamInfo.bIsLive = Object->GetBoolField(TEXT("Live"));
+			Entry.StreamInfo.Changelist = Object->GetIntegerField(TEXT("Changelist"));
+			OutEntries.Add(MoveTemp(Entry));
+		}
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* Skipped = nullptr;
+	if (Root->TryGetArrayField(TEXT("Skipped"), Skipped))
+	{
+		for (const TSharedPtr<FJsonValue>& Value : *Skipped)
+		{
+			const TSharedPtr<FJsonObject> Object = Value->AsObject();
+			const FDateTime* FileTimestamp = Object.IsValid() ? FileTimestamps.Find(Object->GetStringField(TEXT("Name"))) : nullptr;
+			if (FileTimestamp)
+			{
+				++NumAccountedFor;
+				bChanged |= *FileTimestamp != FDateTime(FCString::Atoi64(*Object->GetStringField(TEXT("FileTime"))));
+			}
+		}
+	}
+
+	OutEntries.Sort([](const FTrueFPSReplayIndexEntry& A, const FTrueFPSReplayIndexEntry& B)
+	{
+		return A.StreamInfo.Timestamp > B.StreamInfo.Timestamp;
+	});
+
+	bOutIsStale = bChanged || NumAccountedFor != FileTimestamps.Num();
+	return true;
+}
+
+bool FTrueFPSReplayIndex::Save(const FString& DemoDirectory, const FNetworkReplayVersion& Version, const TArray<FNetworkReplayStreamInfo>& Streams)
+{
+	TMap<FString, FDateTime> FileTimestamps;
+	GetReplayFileTimestamps(DemoDirectory, FileTimestamps);
+
+	TArray<TSharedPtr<FJsonValue>> Entries;
+	Entries.Reserve(Streams.Num());
+	for (const FNetworkReplayStreamInfo& StreamInfo : Streams)
+	{
+		FDateTime FileTimestamp;
+		if (!FileTimestamps.RemoveAndCopyValue(StreamInfo.Name, FileTimestamp))
+		{
+			continue;
+		}
+
+		// Ticks don't fit a json number without losing precision, they're stored as strings
+		const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("Name"), StreamInfo.Name);
+		Object->SetStringField(TEXT("FriendlyName"), StreamInfo.FriendlyName);
+		Object->SetStringField(TEXT("Timestamp"), LexToString(StreamInfo.Timestamp.GetTicks()));
+		Object->SetStringField(TEXT("Size"), LexToString(StreamInfo.SizeInBytes));
+		Object->SetNumberField(TEXT("Length"), StreamInfo.LengthInMS);
+		Object->SetNumberField(TEXT("Viewers"), StreamInfo.NumViewers);
+		Object->SetBoolField(TEXT("Live"), StreamInfo.bIsLive);
+		Object->SetNumberField(TEXT("Changelist"), StreamInfo.Changelist);
+		Object->SetStringField(TEXT("FileTime"), LexToString(FileTimestamp.GetTicks()));
+		Entries.Add(MakeShared<FJsonValueObject>(Object));
+	}
+
+	// Whatever is left on disk wasn't returned for this version, remember it so it doesn't mark the index stale
+	TArray<TSharedPtr<FJsonValue>> Skipped;
+	Skipped.Reserve(FileTimestamps.Num());
+	for (const TPair<FString, FDateTime>& FileTimestamp : FileTimestamps)
+	{
+		const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("Name"), FileTimestamp.Key);
+		Object->SetStringField(TEXT("FileTime"), LexToString(FileTimestamp.Value.GetTicks()));
+		Skipped.Add(MakeShared<FJsonValueObject>(Object));
+	}
+
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Format"), ReplayIndexFormatVersion);
+	Root->SetArrayField(TEXT("Entries"), Entries);
+	Root->SetArrayField(TEXT("Skipped"), Skipped);
+
+	FString JsonString;
+	const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonString);
+	if (!FJsonSerializer::Serialize(Root, Writer))
+	{
+		return false;
+	}
+
+	FScopeLock Lock(&IndexCritical);
+	return FFileHelper::SaveStringToFile(JsonString, *GetIndexFilename(DemoDirectory, Version));
+}
+
+void FTrueFPSReplayIndex::Remove(const FString& DemoDirectory, const FString& StreamName)
+{
+	TArray<FString> IndexFilenames;
+	IFileManager::Get().FindFiles(IndexFilenames, *FPaths::Combine(DemoDirectory, TEXT("ReplayIndex_*.json")), true, false);
+
+	FScopeLock Lock(&IndexCritical);
+	for (const FString& IndexFilename : IndexFilenames)
+	{
+		const FString IndexPath = FPaths::Combine(DemoDirectory, IndexFilename);
+
+		FString JsonString;
+		TSharedPtr<FJsonObject> Root;
+		if (!FFileHelper::LoadFileToString(JsonString, *IndexPath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), Root) || !Root.IsValid())
+		{
+			continue;
+		}
+
+		bool bRemoved = false;
+		for (const TCHAR* Field : { TEXT("Entries"), TEXT("Skipped") })
+		{
+			const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+			if (Root->TryGetArrayField(Field, Values))
+			{
+				TArray<TSharedPtr<FJsonValue>> Kept = *Values;
+				bRemoved |= Kept.RemoveAll([&StreamName](const TSharedPtr<FJsonValue>& Value)
+				{
+					const TSharedPtr<FJsonObject> Object = Value->AsObject();
+					return Object.IsValid() && Object->GetStringField(TEXT("Name")) == StreamName;
+				}) > 0;
+				Root->SetArrayField(Field, Kept);
+			}
+		}
+
+		if (bRemoved)
+		{
+			JsonString.Reset();
+			FJsonSerializer::Serialize(Root.ToSharedRef(), TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonString));
+			FFileHelper::SaveStringToFile(JsonString, *IndexPath);
+		}
+	}
+}
+
+void FTrueFPSReplayIndex::Rebuild(const TSharedPtr<INetworkReplayStreamer>& Streamer, const FNetworkReplayVersion& Version)
+{
+	FString DemoDirectory;
+	if (!GetDemoDirectory(Streamer, DemoDirectory))
+	{
+		return;
+	}
+
+	// The streamer is kept alive by the callback until the enumeration is done
+	Streamer->EnumerateStreams(Version, INDEX_NONE, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateLambda([Streamer, DemoDirectory, Version](const FEnumerateStreamsResult& Result)
+	{
+		if (Result.WasSuccessful())
+		{
+			Async(EAsyncExecution::ThreadPool, [DemoDirectory, Version, Streams = Result.FoundStreams]()
+			{
+				Save(DemoDirectory, Version, Streams);
+			});
+		}
+	}));
+}
@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NetworkReplayStreaming.h"
+
+/** A replay as stored in the index */
+struct FTrueFPSReplayIndexEntry
+{
+	FNetworkReplayStreamInfo StreamInfo;
+
+	/** modification time of the replay file when the entry was written */
+	FDateTime FileTimestamp;
+};
+
+/**
+ * Compact index of the local replays, kept next to the demos so the demo browser doesn't have to enumerate
+ * (and open) every replay on disk each time it's shown. One index is kept per enumerated replay version.
+ * Entries are validated lazily against the replay files' timestamps when the index is read.
+ * Only streamers that record to local files (the LocalFile streamer) can be indexed, the others are always enumerated.
+ */
+class FTrueFPSReplayIndex
+{
+public:
+
+	/**
+	 * Directory the streamer records its replay files to.
+	 *
+	 * @return	false if the streamer doesn't record to local files, its replays can't be indexed
+	 */
+	static bool GetDemoDirectory(const TSharedPtr<INetworkReplayStreamer>& Streamer, FString& OutDemoDirectory);
+
+	/** index file for replays enumerated with the given version */
+	static FString GetIndexFilename(const FString& DemoDirectory, const FNetworkReplayVersion& Version);
+
+	/**
+	 * [any thread] Reads the index, dropping entries whose replay file is gone.
+	 *
+	 * @param	OutEntries		indexed replays, newest first
+	 * @param	bOutIsStale		set when replays were added or changed since the index was written
+	 * @return	false if there is no readable index
+	 */
+	static bool Load(const FString& DemoDirectory, const FNetworkReplayVersion& Version, TArray<FTrueFPSReplayIndexEntry>& OutEntries, bool& bOutIsStale);
+
+	/** [any thread] Writes the index for the streams enumerated with the given version */
+	static bool Save(const FString& DemoDirectory, const FNetworkReplayVersion& Version, const TArray<FNetworkReplayStreamInfo>& Streams);
+
+	/** [any thread] Removes a deleted replay from every index */
+	static void Remove(const FString& DemoDirectory, const FString& StreamName);
+
+	/** Enumerates the replays with the given streamer and rewrites the index in the background, if the streamer can be indexed */
+	static void Rebuild(const TSharedPtr<INetworkReplayStreamer>& Streamer, const FNetworkReplayVersion& Version);
+
+private:
+
+	/** modification times of the replay files on disk, by stream name */
+	static void GetReplayFileTimestamps(const FString& DemoDirectory, TMap<FString, FDateTime>& OutTimestamps);
+
+	/** serializes reads and writes of the index files */
+	static FCriticalSection IndexCritical;
+};
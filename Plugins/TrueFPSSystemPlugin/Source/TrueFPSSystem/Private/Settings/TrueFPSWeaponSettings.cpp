@@ -1 +1,52 @@
-﻿// 
\ No newline at end of file
+﻿// 
+
+
+#include "Settings/TrueFPSWeaponSettings.h"
+
+#include "Curves/CurveVector.h"
+
+void UTrueFPSWeaponSettings::PostLoad()
+{
+	Super::PostLoad();
+
+	BakeRecoil();
+}
+
+#if WITH_EDITOR
+void UTrueFPSWeaponSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BakeRecoil(true);
+}
+
+void UTrueFPSWeaponSettings::OnRecoilCurveUpdated(UCurveBase* Curve, EPropertyChangeType::Type ChangeType)
+{
+	BakeRecoil(true);
+}
+#endif// WITH_EDITOR
+
+void UTrueFPSWeaponSettings::BakeRecoil(const bool bForce)
+{
+	if (!bForce && BakedRecoil.IsBakedFrom(Recoil, RecoilBakeSampleRate)) return;
+
+	BakedRecoil.Bake(Recoil, RecoilBakeSampleRate);
+
+#if WITH_EDITOR
+	// The curve assets can be edited without touching the settings
+	for (const TWeakObjectPtr<UCurveBase>& Curve : BoundRecoilCurves)
+	{
+		if (Curve.IsValid()) Curve->OnUpdateCurve.RemoveAll(this);
+	}
+	BoundRecoilCurves.Reset();
+
+	for (UCurveBase* Curve : {static_cast<UCurveBase*>(Recoil.LocationCurve), static_cast<UCurveBase*>(Recoil.RotationCurve)})
+	{
+		if (Curve)
+		{
+			Curve->OnUpdateCurve.AddUObject(this, &ThisClass::OnRecoilCurveUpdated);
+			BoundRecoilCurves.Add(Curve);
+		}
+	}
+#endif// WITH_EDITOR
+}
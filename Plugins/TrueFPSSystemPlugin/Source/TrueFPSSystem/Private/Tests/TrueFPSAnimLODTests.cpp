@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestWorld.h"
+#include "AnimationRuntime.h"
+#include "Character/TrueFPSCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+
+namespace TrueFPSAnimLODTests
+{
+	static const TCHAR* CharacterClassPath = TEXT("/TrueFPSSystemPlugin/Characters/BP_TrueFPSCharacter.BP_TrueFPSCharacter_C");
+
+	static constexpr int32 NumCharacters = 64;
+
+	/** the nearest character's distance from the local camera, and the spacing of the others behind it */
+	static constexpr float NearestDistance = 300.f;
+	static constexpr float DistanceStep = 250.f;
+
+	/** distance bands, each a mesh LOD further than the previous one */
+	static constexpr int32 NumBands = 4;
+
+	static constexpr int32 NumWarmupFrames = 10;
+	static constexpr int32 NumFrames = 120;
+
+	struct FAnimLODRun
+	{
+		/** seconds the timed frames took, animation included */
+		double Seconds = 0.0;
+
+		/** animation updates the meshes of each band ran over the timed frames */
+		int32 NumUpdates[NumBands] = {};
+	};
+
+	static int32 GetBand(const int32 CharacterIndex)
+	{
+		return CharacterIndex * NumBands / NumCharacters;
+	}
+
+	/** 64 third person characters in a line away from a local camera, ticked with or without the animation LOD */
+	static FAnimLODRun Run(UClass* CharacterClass, const bool bAnimLOD)
+	{
+		const FTrueFPSTestWorld TestWorld;
+
+		// The local camera the sway distance is measured from, standalone controllers are local
+		TestWorld.World->SpawnActor<APlayerController>();
+
+		// Not possessed, locally controlled characters are first person
+		TArray<USkeletalMeshComponent*> Meshes;
+		for (int32 i = 0; i < NumCharacters; i++)
+		{
+			const FVector Location(NearestDistance + i * DistanceStep, 0.f, 100.f);
+			ATrueFPSCharacter* Character = TestWorld.World->SpawnActor<ATrueFPSCharacter>(CharacterClass, FTransform(Location));
+
+			USkeletalMeshComponent* Mesh = Character->GetMesh();
+			const int32 NumLODs = FMath::Max(Mesh->GetNumLODs(), 1);
+			Mesh->bEnableUpdateRateOptimizations = bAnimLOD;
+			Mesh->SetForcedLOD(bAnimLOD ? FMath::Min(GetBand(i), NumLODs - 1) + 1 : 1);
+			Meshes.Add(Mesh);
+		}
+
+		FAnimLODRun Result;
+		for (int32 Frame = 0; Frame < NumWarmupFrames + NumFrames; Frame++)
+		{
+			// Nothing renders headless, every mesh counts as on screen like the players in view would
+			for (USkeletalMeshComponent* Mesh : Meshes)
+			{
+				Mesh->SetLastRenderTime(TestWorld.World->GetTimeSeconds());
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			TestWorld.Tick(1);
+			if (Frame < NumWarmupFrames)
+			{
+				continue;
+			}
+			Result.Seconds += FPlatformTime::Seconds() - StartTime;
+
+			for (int32 i = 0; i < Meshes.Num(); i++)
+			{
+				const bool bSkipped = Meshes[i]->bEnableUpdateRateOptimizations && Meshes[i]->AnimUpdateRateParams && Meshes[i]->AnimUpdateRateParams->ShouldSkipUpdate();
+				Result.NumUpdates[GetBand(i)] += bSkipped ? 0 : 1;
+			}
+		}
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSAnimLODBenchmarkTest, "TrueFPS.Animation.LODBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSAnimLODBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSAnimLODTests;
+
+	UClass* CharacterClass = LoadClass<ATrueFPSCharacter>(nullptr, CharacterClassPath);
+	if (!TestNotNull(TEXT("Character class loads"), CharacterClass))
+	{
+		return false;
+	}
+
+	const FAnimLODRun Full = Run(CharacterClass, false);
+	const FAnimLODRun LOD = Run(CharacterClass, true);
+
+	const ATrueFPSCharacter* DefaultCharacter = CharacterClass->GetDefaultObject<ATrueFPSCharacter>();
+	const TArray<int32> FrameSkips = DefaultCharacter->GetSettings() ? DefaultCharacter->GetSettings()->ThirdPersonLODFrameSkips : TArray<int32>();
+	const int32 NumLODs = DefaultCharacter->GetMesh()->GetSkeletalMeshAsset() ? FMath::Max(DefaultCharacter->GetMesh()->GetNumLODs(), 1) : 1;
+
+	const int32 CharactersPerBand = NumCharacters / NumBands;
+	for (int32 Band = 0; Band < NumBands; Band++)
+	{
+		TestEqual(FString::Printf(TEXT("Without the LOD band %d updates every frame"), Band), Full.NumUpdates[Band], CharactersPerBand * NumFrames);
+
+		// The band's LOD, as far as the mesh has LODs, skips the frames the character settings give it
+		const int32 LODIndex = FMath::Min(Band, NumLODs - 1);
+		const int32 FrameSkip = FrameSkips.Num() > 0 ? FrameSkips[FMath::Min(LODIndex, FrameSkips.Num() - 1)] : 0;
+		if (FrameSkip == 0)
+		{
+			TestEqual(FString::Printf(TEXT("Band %d, at LOD %d, updates every frame"), Band, LODIndex), LOD.NumUpdates[Band], CharactersPerBand * NumFrames);
+		}
+		else
+		{
+			TestTrue(FString::Printf(TEXT("Band %d, at LOD %d, skips updates"), Band, LODIndex), LOD.NumUpdates[Band] < CharactersPerBand * NumFrames);
+		}
+	}
+
+	int32 NumFullUpdates = 0;
+	int32 NumLODUpdates = 0;
+	for (int32 Band = 0; Band < NumBands; Band++)
+	{
+		NumFullUpdates += Full.NumUpdates[Band];
+		NumLODUpdates += LOD.NumUpdates[Band];
+	}
+
+	AddInfo(FString::Printf(TEXT("%d characters %.0f to %.0fcm away, %d mesh LODs: %.3fms per frame and %d anim updates without the LOD, %.3fms and %d with it"),
+		NumCharacters, NearestDistance, NearestDistance + (NumCharacters - 1) * DistanceStep, NumLODs,
+		Full.Seconds * 1000.0 / NumFrames, NumFullUpdates, LOD.Seconds * 1000.0 / NumFrames, NumLODUpdates));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
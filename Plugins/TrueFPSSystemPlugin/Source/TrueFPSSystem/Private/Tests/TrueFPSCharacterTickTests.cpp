@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestWorld.h"
+#include "Character/TrueFPSCharacter.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/KismetMathLibrary.h"
+
+namespace TrueFPSCharacterTickTests
+{
+	static const TCHAR* CharacterClassPath = TEXT("/TrueFPSSystemPlugin/Characters/BP_TrueFPSCharacter.BP_TrueFPSCharacter_C");
+
+	static constexpr int32 NumCharacters = 64;
+
+	static constexpr int32 NumSettleFrames = 10;
+	static constexpr int32 NumFrames = 300;
+
+	/** lean and crouch targets the equivalence test interpolates to, then back from halfway through */
+	static constexpr float LeanTarget = 10.f;
+	static constexpr float CrouchTarget = 1.f;
+	static constexpr int32 NumInterpFrames = 120;
+
+	/** whether the class ticks every frame regardless, its blueprint implementing the tick event */
+	static bool HasBlueprintTick(const UClass* CharacterClass)
+	{
+		return CharacterClass->IsFunctionImplementedInScript(FName(TEXT("ReceiveTick")));
+	}
+
+	/** the character's state and replicated targets are protected, reached through reflection like the replication does */
+	template <typename T>
+	static T& GetProperty(ATrueFPSCharacter* Character, const TCHAR* Name)
+	{
+		return *FindFProperty<FProperty>(ATrueFPSCharacter::StaticClass(), Name)->ContainerPtrToValuePtr<T>(Character);
+	}
+
+	/** sets a replicated target the way a client receives it */
+	static void SetTarget(ATrueFPSCharacter* Character, const TCHAR* TargetName, const TCHAR* OnRepName, const float Value)
+	{
+		GetProperty<float>(Character, TargetName) = Value;
+		Character->ProcessEvent(Character->FindFunctionChecked(OnRepName), nullptr);
+	}
+
+	/** seconds the world takes to tick NumFrames, with NumCharacters idle characters in it or none */
+	static double TimeIdleFrames(UClass* CharacterClass, const int32 NumSpawned, int32& OutNumTicking)
+	{
+		const FScopedBatchedTick BatchedTick(false);
+		const FTrueFPSTestWorld TestWorld;
+
+		TArray<ATrueFPSCharacter*> Characters;
+		for (int32 i = 0; i < NumSpawned; i++)
+		{
+			Characters.Add(TestWorld.World->SpawnActor<ATrueFPSCharacter>(CharacterClass, FTransform(FVector(i * 200.0, 0.0, 100.0))));
+		}
+
+		// Spawning refreshes nothing, the first frames settle whatever BeginPlay flagged
+		TestWorld.Tick(NumSettleFrames);
+
+		OutNumTicking = 0;
+		for (const ATrueFPSCharacter* Character : Characters)
+		{
+			OutNumTicking += Character->IsActorTickEnabled() ? 1 : 0;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		TestWorld.Tick(NumFrames);
+		return FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSCharacterIdleTickTest, "TrueFPS.Character.IdleTick",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSCharacterIdleTickTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSCharacterTickTests;
+
+	UClass* CharacterClass = LoadClass<ATrueFPSCharacter>(nullptr, CharacterClassPath);
+	if (!TestNotNull(TEXT("Character class loads"), CharacterClass))
+	{
+		return false;
+	}
+
+	int32 NumEmptyTicking = 0;
+	int32 NumIdleTicking = 0;
+	const double EmptySeconds = TimeIdleFrames(CharacterClass, 0, NumEmptyTicking);
+	const double IdleSeconds = TimeIdleFrames(CharacterClass, NumCharacters, NumIdleTicking);
+
+	// Only a blueprint tick event keeps an idle character ticking
+	const int32 NumExpectedTicking = HasBlueprintTick(CharacterClass) ? NumCharacters : 0;
+	TestEqual(TEXT("Idle characters with their actor tick enabled"), NumIdleTicking, NumExpectedTicking);
+
+	AddInfo(FString::Printf(TEXT("%d idle characters, %d ticking: %.3fms per frame, %.3fms without them (%.2fus per character)"),
+		NumCharacters, NumIdleTicking, IdleSeconds * 1000.0 / NumFrames, EmptySeconds * 1000.0 / NumFrames,
+		(IdleSeconds - EmptySeconds) * 1e6 / (NumFrames * NumCharacters)));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSCharacterRefreshEquivalenceTest, "TrueFPS.Character.RefreshEquivalence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSCharacterRefreshEquivalenceTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSCharacterTickTests;
+
+	UClass* CharacterClass = LoadClass<ATrueFPSCharacter>(nullptr, CharacterClassPath);
+	if (!TestNotNull(TEXT("Character class loads"), CharacterClass))
+	{
+		return false;
+	}
+
+	const UTrueFPSCharacterSettings* Settings = CharacterClass->GetDefaultObject<ATrueFPSCharacter>()->GetSettings();
+	if (!TestNotNull(TEXT("Character has settings"), Settings))
+	{
+		return false;
+	}
+
+	// Refreshed by the actor tick and by the tick manager, both against the interpolation every frame used to run
+	for (const bool bBatchedTick : {false, true})
+	{
+		const FScopedBatchedTick BatchedTick(bBatchedTick);
+		const FTrueFPSTestWorld TestWorld;
+		const TCHAR* TickName = bBatchedTick ? TEXT("tick manager") : TEXT("actor tick");
+
+		// Leaning only interpolates for player controlled characters
+		ATrueFPSCharacter* Character = TestWorld.World->SpawnActor<ATrueFPSCharacter>(CharacterClass, FTransform(FVector(0.0, 0.0, 100.0)));
+		TestWorld.World->SpawnActor<APlayerController>()->Possess(Character);
+		TestWorld.Tick(NumSettleFrames);
+
+		const FTrueFPSCharacterState& State = GetProperty<FTrueFPSCharacterState>(Character, TEXT("State"));
+		float ReferenceLean = State.LeanValue;
+		float ReferenceCrouch = State.CrouchValue;
+
+		float MaxLeanDifference = 0.f;
+		float MaxCrouchDifference = 0.f;
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			// Out to the targets, then back before they are reached
+			if (Frame == 0 || Frame == NumInterpFrames / 2)
+			{
+				const bool bOut = Frame == 0;
+				SetTarget(Character, TEXT("LeanValueTarget"), TEXT("OnRep_LeanValueTarget"), bOut ? LeanTarget : 0.f);
+				SetTarget(Character, TEXT("CrouchValueTarget"), TEXT("OnRep_CrouchValueTarget"), bOut ? CrouchTarget : 0.f);
+			}
+
+			const float DeltaTime = 1.f / 60.f;
+			const float LeanValueTarget = GetProperty<float>(Character, TEXT("LeanValueTarget"));
+			const float CrouchValueTarget = GetProperty<float>(Character, TEXT("CrouchValueTarget"));
+			ReferenceLean = UKismetMathLibrary::FInterpTo(ReferenceLean, LeanValueTarget, DeltaTime, Settings->AimingInterpSpeed);
+			ReferenceCrouch = UKismetMathLibrary::FInterpTo(ReferenceCrouch, CrouchValueTarget, DeltaTime, 8.f);
+			TestWorld.Tick(1, DeltaTime);
+
+			MaxLeanDifference = FMath::Max(MaxLeanDifference, FMath::Abs(State.LeanValue - ReferenceLean));
+			MaxCrouchDifference = FMath::Max(MaxCrouchDifference, FMath::Abs(State.CrouchValue - ReferenceCrouch));
+		}
+
+		TestEqual(FString::Printf(TEXT("Lean refreshed by the %s interpolates like every frame"), TickName), MaxLeanDifference, 0.f);
+		TestEqual(FString::Printf(TEXT("Crouch refreshed by the %s interpolates like every frame"), TickName), MaxCrouchDifference, 0.f);
+		TestEqual(FString::Printf(TEXT("Lean refreshed by the %s settles on its target"), TickName), State.LeanValue, 0.f);
+		TestEqual(FString::Printf(TEXT("Crouch refreshed by the %s settles on its target"), TickName), State.CrouchValue, 0.f);
+		TestFalse(FString::Printf(TEXT("Nothing is left to refresh by the %s once settled"), TickName), Character->NeedsStateRefresh());
+		TestEqual(FString::Printf(TEXT("Actor tick enabled once settled, refreshed by the %s"), TickName), Character->IsActorTickEnabled(), HasBlueprintTick(CharacterClass));
+	}
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "UI/Widgets/TrueFPSChatHistory.h"
+
+namespace TrueFPSChatHistoryTests
+{
+	static constexpr int32 NumLines = 1000000;
+
+	/** what the chat widget keeps */
+	static constexpr int32 MaxLines = 64;
+
+	/** lines timed together, the cost of a batch is compared from the first to the last */
+	static constexpr int32 BatchSize = 100000;
+
+	/** every how many lines one repeats the previous one, like kill feed spam */
+	static constexpr int32 RepeatInterval = 10;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSChatHistoryBoundedTest, "TrueFPS.UI.ChatHistoryBounded",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSChatHistoryBoundedTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSChatHistoryTests;
+
+	FTrueFPSChatHistory ChatHistory(MaxLines);
+
+	// Fill the history, every line from there on is recycled
+	int32 NumAdded = 0;
+	while (NumAdded < MaxLines)
+	{
+		ChatHistory.Add(FText::AsCultureInvariant(FString::Printf(TEXT("Player%d: line %d"), NumAdded % 16, NumAdded)));
+		NumAdded++;
+	}
+
+	TSet<const FTrueFPSChatLine*> FullLines;
+	for (const TSharedPtr<FTrueFPSChatLine>& Line : ChatHistory.GetLines())
+	{
+		FullLines.Add(Line.Get());
+	}
+	const int64 FullAllocatedSize = static_cast<int64>(ChatHistory.GetLines().GetAllocatedSize());
+
+	// Then a long running server's worth of chat
+	TArray<double> BatchNsPerLine;
+	int32 NumNewLines = 0;
+	int32 MaxNumLines = 0;
+	bool bOnlyRecycledLines = true;
+	while (NumAdded < NumLines)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		int32 NumBatchLines = 0;
+		for (; NumBatchLines < BatchSize && NumAdded < NumLines; NumBatchLines++, NumAdded++)
+		{
+			const int32 LineIndex = NumAdded % RepeatInterval == 0 ? NumAdded - 1 : NumAdded;
+			NumNewLines += ChatHistory.Add(FText::AsCultureInvariant(FString::Printf(TEXT("Player%d: line %d"), LineIndex % 16, LineIndex))) ? 1 : 0;
+
+			// Recycling hands the oldest line back, never a new one
+			bOnlyRecycledLines &= FullLines.Contains(ChatHistory.GetLines().Last().Get());
+			MaxNumLines = FMath::Max(MaxNumLines, ChatHistory.GetLines().Num());
+		}
+		BatchNsPerLine.Add((FPlatformTime::Seconds() - StartTime) * 1e9 / NumBatchLines);
+	}
+
+	TestEqual(TEXT("The history never grows past its capacity"), MaxNumLines, MaxLines);
+	TestTrue(TEXT("Lines are only recycled once the history is full"), bOnlyRecycledLines);
+	TestEqual(TEXT("The history doesn't reallocate once full"), static_cast<int64>(ChatHistory.GetLines().GetAllocatedSize()), FullAllocatedSize);
+
+	const int32 NumRepeats = (NumLines - MaxLines) / RepeatInterval;
+	TestTrue(TEXT("Repeated lines are coalesced"), FMath::Abs(NumNewLines - (NumLines - MaxLines - NumRepeats)) <= 1);
+
+	// The last line is the last one received, and repeats show their count
+	const int32 LastIndex = NumLines - 1;
+	TestEqual(TEXT("The newest line is last"), ChatHistory.GetLines().Last()->ChatString.ToString(), FString::Printf(TEXT("Player%d: line %d"), LastIndex % 16, LastIndex));
+
+	FTrueFPSChatHistory RepeatHistory(MaxLines);
+	for (int32 i = 0; i < 3; i++)
+	{
+		RepeatHistory.Add(FText::AsCultureInvariant(TEXT("Bot1 killed Bot2")));
+	}
+	TestEqual(TEXT("A line repeated three times is kept once"), RepeatHistory.GetLines().Num(), 1);
+	TestEqual(TEXT("A repeated line counts its repeats"), RepeatHistory.GetLines()[0]->RepeatCount, 3);
+	TestTrue(TEXT("A repeated line shows its count"), RepeatHistory.GetLines()[0]->DisplayString.ToString().Contains(TEXT("3")));
+
+	// Each add costs the same after a million lines as after the first hundred thousand
+	if (BatchNsPerLine.Num() > 1)
+	{
+		AddInfo(FString::Printf(TEXT("%d lines into %d: %.1fns per line in the first batch of %d, %.1fns in the last"),
+			NumLines, MaxLines, BatchNsPerLine[0], BatchSize, BatchNsPerLine.Last()));
+	}
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,265 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestGameMode.h"
+#include "TrueFPSTestWorld.h"
+#include "Bots/TrueFPSAIController.h"
+#include "Character/TrueFPSCharacter.h"
+#include "Engine/DamageEvents.h"
+#include "GameFramework/DamageType.h"
+#include "Online/TrueFPSPlayerState.h"
+#include "Serialization/ObjectReader.h"
+#include "Serialization/ObjectWriter.h"
+
+namespace TrueFPSDamageTests
+{
+	static const TCHAR* CharacterClassPath = TEXT("/TrueFPSSystemPlugin/Characters/BP_TrueFPSCharacter.BP_TrueFPSCharacter_C");
+
+	static constexpr float HitDamage = 4.f;
+	static constexpr float SelfScale = 0.5f;
+	static constexpr float ExplosionRadius = 1000.f;
+
+	static constexpr int32 NumBenchmarkHits = 10000;
+
+	/** a tiny amount so that the benchmark's hits don't kill */
+	static constexpr float BenchmarkDamage = 0.0001f;
+
+	/** a character possessed by a bot controller with a player state on the given team */
+	static ATrueFPSCharacter* SpawnPlayer(UWorld* World, UClass* CharacterClass, const int32 TeamNum, const FVector& Location)
+	{
+		ATrueFPSAIController* Controller = World->SpawnActor<ATrueFPSAIController>();
+		ATrueFPSCharacter* Character = World->SpawnActor<ATrueFPSCharacter>(CharacterClass, FTransform(Location));
+		Controller->Possess(Character);
+		Controller->GetPlayerState<ATrueFPSPlayerState>()->SetTeamNum(TeamNum);
+		return Character;
+	}
+
+	static float HitWith(ATrueFPSCharacter* Damaged, ATrueFPSCharacter* Instigator, const float Damage = HitDamage)
+	{
+		const FVector ShotDirection = (Damaged->GetActorLocation() - Instigator->GetActorLocation()).GetSafeNormal();
+		FHitResult Hit;
+		Hit.Location = Hit.ImpactPoint = Damaged->GetActorLocation();
+		const FPointDamageEvent DamageEvent(Damage, Hit, ShotDirection, UDamageType::StaticClass());
+		return Damaged->TakeDamage(Damage, DamageEvent, Instigator->GetController(), Instigator);
+	}
+
+	/** an explosion going off at the given distance from the damaged character, hitting it at its location */
+	static float ExplodeNear(ATrueFPSCharacter* Damaged, ATrueFPSCharacter* Instigator, const float Distance)
+	{
+		FRadialDamageEvent DamageEvent;
+		DamageEvent.DamageTypeClass = UDamageType::StaticClass();
+		DamageEvent.Params = FRadialDamageParams(HitDamage, 0.f, 0.f, ExplosionRadius, 1.f);
+		DamageEvent.Origin = Damaged->GetActorLocation() + FVector(Distance, 0.f, 0.f);
+
+		FHitResult& Hit = DamageEvent.ComponentHits.AddDefaulted_GetRef();
+		Hit.Location = Hit.ImpactPoint = Damaged->GetActorLocation();
+
+		return Damaged->TakeDamage(HitDamage, DamageEvent, Instigator->GetController(), Instigator);
+	}
+
+	/** the received copy after a trip through the hit info's net serializer */
+	static FTakeHitInfo RoundTrip(FTakeHitInfo& Info, int32& OutNumBytes)
+	{
+		TArray<uint8> Bytes;
+		bool bSuccess = false;
+
+		FObjectWriter Writer(Bytes);
+		Info.NetSerialize(Writer, nullptr, bSuccess);
+		OutNumBytes = Bytes.Num();
+
+		FTakeHitInfo Received;
+		FObjectReader Reader(Bytes);
+		Received.NetSerialize(Reader, nullptr, bSuccess);
+		return Received;
+	}
+
+	static FVector GetHitDirection(const FDamageEvent& DamageEvent, const AActor* HitActor, const AActor* HitInstigator)
+	{
+		FHitResult UnusedHitInfo;
+		FVector HitDirection;
+		DamageEvent.GetBestHitInfo(HitActor, HitInstigator, UnusedHitInfo, HitDirection);
+		return HitDirection;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSDamageRulesTest, "TrueFPS.Damage.FriendlyFireRules",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSDamageRulesTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSDamageTests;
+
+	UClass* CharacterClass = LoadClass<ATrueFPSCharacter>(nullptr, CharacterClassPath);
+	if (!TestNotNull(TEXT("Character class loads"), CharacterClass))
+	{
+		return false;
+	}
+
+	const FTrueFPSTestWorld TestWorld;
+	ATrueFPSTestGameMode* GameMode = TestWorld.SpawnGameMode<ATrueFPSTestGameMode>();
+	GameMode->SetDamageRules(false, SelfScale);
+
+	ATrueFPSCharacter* Shooter = SpawnPlayer(TestWorld.World, CharacterClass, 0, FVector(0.f, 0.f, 100.f));
+	ATrueFPSCharacter* Teammate = SpawnPlayer(TestWorld.World, CharacterClass, 0, FVector(500.f, 0.f, 100.f));
+	ATrueFPSCharacter* Enemy = SpawnPlayer(TestWorld.World, CharacterClass, 1, FVector(0.f, 500.f, 100.f));
+	TestWorld.Tick(1);
+
+	// Friendly fire off
+	TestEqual(TEXT("Teammate takes no damage"), HitWith(Teammate, Shooter), 0.f);
+	TestEqual(TEXT("Enemy takes full damage"), HitWith(Enemy, Shooter), HitDamage);
+	TestFalse(TEXT("Teammate isn't an enemy"), Teammate->IsEnemyFor(Shooter->GetController()));
+	TestTrue(TEXT("Enemy is an enemy"), Enemy->IsEnemyFor(Shooter->GetController()));
+
+	// Suicide, scaled whatever the friendly fire rule
+	TestEqual(TEXT("Self damage is scaled"), HitWith(Shooter, Shooter), HitDamage * SelfScale);
+	TestFalse(TEXT("Nobody is their own enemy"), Shooter->IsEnemyFor(Shooter->GetController()));
+
+	// Radial damage falls off linearly to the outer radius
+	TestEqual(TEXT("Teammate takes no explosion damage"), ExplodeNear(Teammate, Shooter, ExplosionRadius * 0.5f), 0.f);
+	TestEqual(TEXT("Enemy takes explosion damage with falloff"), ExplodeNear(Enemy, Shooter, ExplosionRadius * 0.5f), HitDamage * 0.5f, 0.01f);
+
+	// Friendly fire on
+	GameMode->SetDamageRules(true, SelfScale);
+	TestEqual(TEXT("Teammate takes full damage with friendly fire"), HitWith(Teammate, Shooter), HitDamage);
+	TestTrue(TEXT("Teammate is an enemy with friendly fire"), Teammate->IsEnemyFor(Shooter->GetController()));
+	TestFalse(TEXT("Nobody is their own enemy with friendly fire"), Shooter->IsEnemyFor(Shooter->GetController()));
+
+	// Both paths go through the game mode's overridable rule
+	GameMode->SetDamageRules(false, SelfScale);
+	GameMode->PacifistTeamNum = 1;
+	TestEqual(TEXT("Overridden rule applies to damage"), HitWith(Shooter, Enemy), 0.f);
+	TestFalse(TEXT("Overridden rule applies to the enemy check"), Shooter->IsEnemyFor(Enemy->GetController()));
+	TestTrue(TEXT("Overridden rule leaves the other team alone"), Enemy->IsEnemyFor(Shooter->GetController()));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSDamageBenchmarkTest, "TrueFPS.Damage.TeamCheckBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSDamageBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSDamageTests;
+
+	UClass* CharacterClass = LoadClass<ATrueFPSCharacter>(nullptr, CharacterClassPath);
+	if (!TestNotNull(TEXT("Character class loads"), CharacterClass))
+	{
+		return false;
+	}
+
+	const FTrueFPSTestWorld TestWorld;
+	ATrueFPSTestGameMode* GameMode = TestWorld.SpawnGameMode<ATrueFPSTestGameMode>();
+	GameMode->SetDamageRules(false, SelfScale);
+
+	ATrueFPSCharacter* Shooter = SpawnPlayer(TestWorld.World, CharacterClass, 0, FVector(0.f, 0.f, 100.f));
+	ATrueFPSCharacter* Teammate = SpawnPlayer(TestWorld.World, CharacterClass, 0, FVector(500.f, 0.f, 100.f));
+	ATrueFPSCharacter* Enemy = SpawnPlayer(TestWorld.World, CharacterClass, 1, FVector(0.f, 500.f, 100.f));
+	TestWorld.Tick(1);
+
+	AController* ShooterController = Shooter->GetController();
+	const FDamageEvent DamageEvent(UDamageType::StaticClass());
+
+	int32 NumEnemies = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumBenchmarkHits; i++)
+	{
+		NumEnemies += Enemy->IsEnemyFor(ShooterController) ? 1 : 0;
+		NumEnemies += Teammate->IsEnemyFor(ShooterController) ? 1 : 0;
+	}
+	const double EnemyCheckSeconds = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumDamaging = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumBenchmarkHits; i++)
+	{
+		NumDamaging += GameMode->ModifyDamage(HitDamage, Enemy, DamageEvent, ShooterController, Shooter) > 0.f ? 1 : 0;
+		NumDamaging += GameMode->ModifyDamage(HitDamage, Teammate, DamageEvent, ShooterController, Shooter) > 0.f ? 1 : 0;
+	}
+	const double ModifyDamageSeconds = FPlatformTime::Seconds() - StartTime;
+
+	const float EnemyHealth = Enemy->GetHealth();
+	float DealtDamage = 0.f;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumBenchmarkHits; i++)
+	{
+		DealtDamage += HitWith(Enemy, Shooter, BenchmarkDamage);
+	}
+	const double HitsSeconds = FPlatformTime::Seconds() - StartTime;
+
+	AddInfo(FString::Printf(TEXT("Enemy check: %.1fns, ModifyDamage: %.1fns, TakeDamage: %.1fns per hit over %d hits"),
+		EnemyCheckSeconds * 1e9 / (NumBenchmarkHits * 2), ModifyDamageSeconds * 1e9 / (NumBenchmarkHits * 2), HitsSeconds * 1e9 / NumBenchmarkHits, NumBenchmarkHits));
+
+	TestEqual(TEXT("Only the enemy is an enemy"), NumEnemies, NumBenchmarkHits);
+	TestEqual(TEXT("Only the enemy is damaged"), NumDamaging, NumBenchmarkHits);
+	TestEqual(TEXT("Every hit lands"), DealtDamage, NumBenchmarkHits * BenchmarkDamage, 0.01f);
+	TestEqual(TEXT("Health drops by the damage dealt"), EnemyHealth - Enemy->GetHealth(), DealtDamage, 0.01f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSTakeHitInfoRoundTripTest, "TrueFPS.Damage.TakeHitInfoRoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSTakeHitInfoRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSDamageTests;
+
+	const FTrueFPSTestWorld TestWorld;
+	ACharacter* Instigator = TestWorld.World->SpawnActor<ACharacter>(ACharacter::StaticClass(), FTransform(FVector(0.f, 0.f, 100.f)));
+	ACharacter* Damaged = TestWorld.World->SpawnActor<ACharacter>(ACharacter::StaticClass(), FTransform(FVector(300.f, 400.f, 100.f)));
+
+	FHitResult Hit;
+	Hit.Location = Hit.ImpactPoint = Damaged->GetActorLocation();
+	const FPointDamageEvent PointEvent(HitDamage, Hit, FVector(0.6f, 0.8f, 0.f), UDamageType::StaticClass());
+
+	FRadialDamageEvent RadialEvent;
+	RadialEvent.DamageTypeClass = UDamageType::StaticClass();
+	RadialEvent.Origin = Damaged->GetActorLocation() - FVector(100.f, 0.f, 100.f);
+	RadialEvent.ComponentHits.Add(Hit);
+
+	const FDamageEvent GeneralEvent(UDamageType::StaticClass());
+
+	const TPair<const TCHAR*, const FDamageEvent*> Events[] = {
+		{TEXT("Point"), &PointEvent},
+		{TEXT("Radial"), &RadialEvent},
+		{TEXT("General"), &GeneralEvent},
+	};
+
+	for (const TPair<const TCHAR*, const FDamageEvent*>& Event : Events)
+	{
+		FTakeHitInfo Sent;
+		Sent.ActualDamage = HitDamage;
+		Sent.PawnInstigator = Instigator;
+		Sent.DamageCauser = Instigator;
+		Sent.SetDamageEvent(*Event.Value, Damaged, Instigator);
+		Sent.bKilled = true;
+		Sent.EnsureReplication();
+
+		int32 NumBytes = 0;
+		FTakeHitInfo Received = RoundTrip(Sent, NumBytes);
+		AddInfo(FString::Printf(TEXT("%s hit: %d bytes"), Event.Key, NumBytes));
+
+		TestEqual(FString::Printf(TEXT("%s damage"), Event.Key), Received.ActualDamage, Sent.ActualDamage);
+		TestTrue(FString::Printf(TEXT("%s damage type"), Event.Key), Received.DamageTypeClass == Sent.DamageTypeClass);
+		TestTrue(FString::Printf(TEXT("%s instigator and causer"), Event.Key), Received.PawnInstigator == Sent.PawnInstigator && Received.DamageCauser == Sent.DamageCauser);
+		TestEqual(FString::Printf(TEXT("%s damage event class"), Event.Key), Received.DamageEventClassID, Event.Value->GetTypeID());
+		TestTrue(FString::Printf(TEXT("%s kill"), Event.Key), Received.bKilled);
+
+		// What clients play the hit back from
+		const FVector SentDirection = GetHitDirection(*Event.Value, Damaged, Instigator);
+		const FVector ReceivedDirection = GetHitDirection(Received.GetDamageEvent(Damaged), Damaged, Instigator);
+		TestTrue(FString::Printf(TEXT("%s hit direction %s received as %s"), Event.Key, *SentDirection.ToString(), *ReceivedDirection.ToString()), ReceivedDirection.Equals(SentDirection, 1e-3));
+
+		// The same hit again still changes the received value, so the rep notify fires
+		Sent.EnsureReplication();
+		const FTakeHitInfo ReceivedAgain = RoundTrip(Sent, NumBytes);
+		TestFalse(FString::Printf(TEXT("%s identical hit is received as a change"), Event.Key), FTakeHitInfo::StaticStruct()->CompareScriptStruct(&Received, &ReceivedAgain, PPF_None));
+	}
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
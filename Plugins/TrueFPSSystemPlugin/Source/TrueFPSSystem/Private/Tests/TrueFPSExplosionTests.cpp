@@ -0,0 +1,227 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestDamageTarget.h"
+#include "TrueFPSTestWorld.h"
+#include "Components/BoxComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Weapons/TrueFPSExplosionResolver.h"
+
+namespace TrueFPSExplosionTests
+{
+	static constexpr float BaseDamage = 100.f;
+	static constexpr float Radius = 1000.f;
+
+	static constexpr int32 NumBenchmarkPawns = 100;
+	static constexpr int32 NumBenchmarkExplosions = 100;
+	static constexpr int32 BenchmarkSyncTraceBudget = 16;
+
+	/** how the explosion is resolved */
+	enum class EMethod : uint8
+	{
+		ApplyRadialDamage,
+		Resolver,
+		BudgetedResolver,
+	};
+
+	static const TCHAR* GetMethodName(const EMethod Method)
+	{
+		switch (Method)
+		{
+		case EMethod::ApplyRadialDamage:
+			return TEXT("ApplyRadialDamage");
+		case EMethod::Resolver:
+			return TEXT("Resolver");
+		default:
+			return TEXT("Budgeted resolver");
+		}
+	}
+
+	/** damage targets and walls around an explosion at the origin */
+	struct FExplosionScene
+	{
+		FTrueFPSTestWorld TestWorld;
+		AActor* Grenade{nullptr};
+		TArray<ATrueFPSTestDamageTarget*> Targets;
+		FTrueFPSExplosionResolver Resolver;
+
+		FExplosionScene()
+		{
+			TestWorld.SpawnGameMode<AGameModeBase>();
+			Grenade = TestWorld.World->SpawnActor<AActor>();
+		}
+
+		ATrueFPSTestDamageTarget* AddTarget(const FVector& Location)
+		{
+			return Targets.Add_GetRef(TestWorld.World->SpawnActor<ATrueFPSTestDamageTarget>(ATrueFPSTestDamageTarget::StaticClass(), FTransform(Location)));
+		}
+
+		/** a second shape on the target, so that it overlaps the explosion twice */
+		void AddShape(ATrueFPSTestDamageTarget* Target, const FVector& RelativeLocation) const
+		{
+			UBoxComponent* Box = NewObject<UBoxComponent>(Target);
+			Box->InitBoxExtent(FVector(20.f));
+			Box->SetCollisionProfileName(UCollisionProfile::BlockAllDynamic_ProfileName);
+			Box->SetupAttachment(Target->GetRootComponent());
+			Box->SetRelativeLocation(RelativeLocation);
+			Box->RegisterComponent();
+		}
+
+		/** static geometry blocking the damage */
+		void AddWall(const FVector& Location, const FVector& Extent) const
+		{
+			AActor* Wall = TestWorld.World->SpawnActor<AActor>();
+			UBoxComponent* Box = NewObject<UBoxComponent>(Wall);
+			Box->InitBoxExtent(Extent);
+			Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+			Wall->SetRootComponent(Box);
+			Box->RegisterComponent();
+			Box->SetWorldLocation(Location);
+		}
+
+		/** sets off one explosion at the origin, the explosion frame's work */
+		void Explode(const EMethod Method, const int32 SyncTraceBudget = 1)
+		{
+			for (ATrueFPSTestDamageTarget* Target : Targets)
+			{
+				Target->ResetDamage();
+			}
+
+			if (Method == EMethod::ApplyRadialDamage)
+			{
+				UGameplayStatics::ApplyRadialDamage(TestWorld.World, BaseDamage, FVector::ZeroVector, Radius, UDamageType::StaticClass(), {}, Grenade);
+			}
+			else
+			{
+				FTrueFPSExplosionParams Params;
+				Params.BaseDamage = BaseDamage;
+				Params.Radius = Radius;
+				Params.DamageType = UDamageType::StaticClass();
+				Params.DamageCauser = Grenade;
+				Params.SyncTraceBudget = Method == EMethod::BudgetedResolver ? SyncTraceBudget : -1;
+				Resolver.Resolve(TestWorld.World, Params);
+			}
+		}
+
+		/** damage taken by every target from the last explosion, -1 for targets damaged more than once */
+		TArray<float> GetDamage()
+		{
+			// Asynchronous traces are kicked off at the end of a frame, their results delivered on the next
+			for (int32 Frame = 0; Frame < 3 && Resolver.IsPending(); Frame++)
+			{
+				TestWorld.Tick(1);
+			}
+
+			TArray<float> Damage;
+			for (const ATrueFPSTestDamageTarget* Target : Targets)
+			{
+				Damage.Add(Target->NumDamageEvents > 1 ? -1.f : Target->DamageTaken);
+			}
+			return Damage;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSExplosionMatchesRadialDamageTest, "TrueFPS.Weapons.ExplosionMatchesRadialDamage",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSExplosionMatchesRadialDamageTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSExplosionTests;
+
+	FExplosionScene Scene;
+
+	// Falloff, the last one out of range
+	for (const float Distance : {150.f, 400.f, 700.f, 950.f, 1200.f})
+	{
+		Scene.AddTarget(FVector(Distance, 0.f, 0.f));
+	}
+
+	// Occlusion, one target fully behind a wall and one beside it
+	Scene.AddWall(FVector(0.f, 300.f, 0.f), FVector(200.f, 10.f, 200.f));
+	Scene.AddTarget(FVector(0.f, 500.f, 0.f));
+	Scene.AddTarget(FVector(400.f, 500.f, 0.f));
+
+	// Several overlapping shapes on one target, damaged once from the closest
+	ATrueFPSTestDamageTarget* MultiShapeTarget = Scene.AddTarget(FVector(-500.f, 0.f, 0.f));
+	Scene.AddShape(MultiShapeTarget, FVector(-100.f, 0.f, 0.f));
+	Scene.AddShape(MultiShapeTarget, FVector(0.f, 0.f, 60.f));
+
+	Scene.TestWorld.Tick(1);
+
+	Scene.Explode(EMethod::ApplyRadialDamage);
+	const TArray<float> Expected = Scene.GetDamage();
+	AddInfo(FString::Printf(TEXT("ApplyRadialDamage: %s"), *FString::JoinBy(Expected, TEXT(", "), [](const float Damage) { return FString::SanitizeFloat(Damage); })));
+
+	TestTrue(TEXT("Scene has falloff"), Expected[0] > Expected[1] && Expected[1] > Expected[2] && Expected[2] > Expected[3] && Expected[3] > 0.f);
+	TestEqual(TEXT("Scene has an out of range target"), Expected[4], 0.f);
+	TestEqual(TEXT("Scene has an occluded target"), Expected[5], 0.f);
+	TestTrue(TEXT("Scene has a visible target beside the wall"), Expected[6] > 0.f);
+
+	for (const EMethod Method : {EMethod::Resolver, EMethod::BudgetedResolver})
+	{
+		Scene.Explode(Method);
+		const TArray<float> Damage = Scene.GetDamage();
+		TestFalse(FString::Printf(TEXT("%s has no traces left pending"), GetMethodName(Method)), Scene.Resolver.IsPending());
+
+		for (int32 i = 0; i < Expected.Num(); i++)
+		{
+			TestEqual(FString::Printf(TEXT("%s damage to target %d"), GetMethodName(Method), i), Damage[i], Expected[i], 0.01f);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSExplosionBenchmarkTest, "TrueFPS.Weapons.ExplosionBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSExplosionBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSExplosionTests;
+
+	FExplosionScene Scene;
+
+	// Pawns in rings all within range, a few behind walls
+	for (int32 i = 0; i < NumBenchmarkPawns; i++)
+	{
+		const float Distance = 150.f + (i % 8) * 100.f;
+		const float Angle = i * 2.f * PI / NumBenchmarkPawns;
+		Scene.AddTarget(FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.f));
+	}
+	Scene.AddWall(FVector(120.f, 0.f, 0.f), FVector(10.f, 60.f, 200.f));
+	Scene.AddWall(FVector(-120.f, 0.f, 0.f), FVector(10.f, 60.f, 200.f));
+	Scene.TestWorld.Tick(1);
+
+	Scene.Explode(EMethod::ApplyRadialDamage);
+	const TArray<float> Expected = Scene.GetDamage();
+
+	for (const EMethod Method : {EMethod::ApplyRadialDamage, EMethod::Resolver, EMethod::BudgetedResolver})
+	{
+		// Only the explosion frame's work is timed, asynchronous traces run alongside the next frame
+		double Seconds = 0.0;
+		int32 NumMismatches = 0;
+		for (int32 Explosion = 0; Explosion < NumBenchmarkExplosions; Explosion++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Scene.Explode(Method, BenchmarkSyncTraceBudget);
+			Seconds += FPlatformTime::Seconds() - StartTime;
+
+			const TArray<float> Damage = Scene.GetDamage();
+			for (int32 i = 0; i < Expected.Num(); i++)
+			{
+				NumMismatches += FMath::IsNearlyEqual(Damage[i], Expected[i], 0.01f) ? 0 : 1;
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: %.1fus per explosion with %d pawns in range"), GetMethodName(Method), Seconds * 1e6 / NumBenchmarkExplosions, NumBenchmarkPawns));
+		TestEqual(FString::Printf(TEXT("%s damages every pawn as ApplyRadialDamage does"), GetMethodName(Method)), NumMismatches, 0);
+	}
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
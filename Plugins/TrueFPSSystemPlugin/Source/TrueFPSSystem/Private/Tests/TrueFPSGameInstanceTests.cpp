@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OnlineSubsystemUtils.h"
+#include "TrueFPSTestGameInstance.h"
+#include "TrueFPSTestWorld.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Interfaces/OnlineIdentityInterface.h"
+#include "Misc/CoreDelegates.h"
+
+namespace TrueFPSGameInstanceTests
+{
+	/** idle frames simulated after each transition */
+	static constexpr int32 NumIdleFrames = 120;
+
+	/** ticks the game instance's world and ends the frame, where requested state updates run */
+	static void SimulateFrame(UTrueFPSTestGameInstance* GameInstance, UWorld* World)
+	{
+		World->Tick(LEVELTICK_All, 1.f / 60.f);
+		FCoreDelegates::OnEndFrame.Broadcast();
+		GameInstance->Frame++;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSGameInstanceStatesTest, "TrueFPS.GameInstance.StateTransitions",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSGameInstanceStatesTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSGameInstanceTests;
+
+	// The null online subsystem stands in for the platform's, its delegates are fired by hand below
+	const TTrueFPSTestGameInstance<UTrueFPSTestGameInstance> TestGameInstance;
+	UTrueFPSTestGameInstance* GameInstance = TestGameInstance.GameInstance;
+
+	// Init asks for the initial state, entered at the end of the first frame
+	SimulateFrame(GameInstance, TestGameInstance.World);
+	TestEqual(TEXT("The initial state is entered"), GameInstance->GetCurrentState(), GameInstance->GetInitialState());
+	const int32 NumInitialTransitions = GameInstance->Transitions.Num();
+
+	const FName Path[] = {
+		TrueFPSGameInstanceState::WelcomeScreen,
+		TrueFPSGameInstanceState::MainMenu,
+		TrueFPSGameInstanceState::Playing,
+		TrueFPSGameInstanceState::MainMenu,
+	};
+
+	int32 NumIdleUpdates = 0;
+	FName PrevState = GameInstance->GetCurrentState();
+	for (const FName& State : Path)
+	{
+		const int32 RequestFrame = GameInstance->Frame;
+		const int32 NumUpdates = GameInstance->NumStateUpdates;
+
+		GameInstance->GotoState(State);
+		SimulateFrame(GameInstance, TestGameInstance.World);
+
+		TestEqual(FString::Printf(TEXT("%s is entered"), *State.ToString()), GameInstance->GetCurrentState(), State);
+		if (TestTrue(FString::Printf(TEXT("%s has a transition"), *State.ToString()), GameInstance->Transitions.Num() > 0))
+		{
+			const UTrueFPSTestGameInstance::FTransition& Transition = GameInstance->Transitions.Last();
+			TestEqual(FString::Printf(TEXT("%s is entered from %s"), *State.ToString(), *PrevState.ToString()), Transition.PrevState, PrevState);
+			TestEqual(FString::Printf(TEXT("%s is entered on the frame it was requested"), *State.ToString()), Transition.Frame, RequestFrame);
+		}
+		TestEqual(FString::Printf(TEXT("%s takes a single state update"), *State.ToString()), GameInstance->NumStateUpdates - NumUpdates, 1);
+
+		// Nothing runs while nothing happens
+		const int32 NumUpdatesBeforeIdle = GameInstance->NumStateUpdates;
+		for (int32 i = 0; i < NumIdleFrames; i++)
+		{
+			SimulateFrame(GameInstance, TestGameInstance.World);
+		}
+		NumIdleUpdates += GameInstance->NumStateUpdates - NumUpdatesBeforeIdle;
+
+		PrevState = State;
+	}
+
+	TestEqual(TEXT("Every requested state is entered once"), GameInstance->Transitions.Num() - NumInitialTransitions, static_cast<int32>(UE_ARRAY_COUNT(Path)));
+	TestEqual(TEXT("Idle frames run no state updates"), NumIdleUpdates, 0);
+
+	// A sign in change is reacted to at the end of the frame it happened on
+	const IOnlineIdentityPtr Identity = Online::GetIdentityInterface(TestGameInstance.World);
+	const FUniqueNetIdPtr UserId = Identity.IsValid() ? Identity->CreateUniquePlayerId(TEXT("TrueFPSTestUser")) : nullptr;
+	if (FSlateApplication::IsInitialized() && UserId.IsValid())
+	{
+		const int32 NumUpdates = GameInstance->NumStateUpdates;
+		Identity->TriggerOnLoginStatusChangedDelegates(0, ELoginStatus::NotLoggedIn, ELoginStatus::LoggedIn, *UserId);
+		SimulateFrame(GameInstance, TestGameInstance.World);
+
+		TestEqual(TEXT("A login change runs a state update on its frame"), GameInstance->NumStateUpdates - NumUpdates, 1);
+		TestEqual(TEXT("Signing in stays in the main menu"), GameInstance->GetCurrentState(), TrueFPSGameInstanceState::MainMenu);
+	}
+	else
+	{
+		AddInfo(TEXT("Login change skipped, it needs Slate and an identity interface"));
+	}
+
+	AddInfo(FString::Printf(TEXT("%d frames, %d state updates, the per frame ticker ran one update per frame"), GameInstance->Frame, GameInstance->NumStateUpdates));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,258 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestWorld.h"
+#include "Character/TrueFPSCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+namespace TrueFPSHeadOffsetTests
+{
+	static const TCHAR* MannequinMeshPath = TEXT("/TrueFPSSystemPlugin/Characters/Heroes/Mannequin/Meshes/SKM_Manny.SKM_Manny");
+
+	static constexpr float CrouchHeadDrop = 80.f;
+	static constexpr float LeanAmount = 15.f;
+
+	/** the seeded entries stay within this of the evaluated head bone */
+	static constexpr float MaxSeedError = 0.5f;
+
+	static const TCHAR* CharacterClassPath = TEXT("/TrueFPSSystemPlugin/Characters/BP_TrueFPSCharacter.BP_TrueFPSCharacter_C");
+
+	/** the sweep goes through every table entry and halfway between each of them */
+	static constexpr int32 SweepCrouchSteps = 2 * (ATrueFPSCharacter::HeadOffsetCrouchSteps - 1) + 1;
+	static constexpr int32 SweepLeanSteps = 2 * (ATrueFPSCharacter::HeadOffsetLeanSteps - 1) + 1;
+
+	/** frames spent at each sweep point, the table entries get refined from these poses */
+	static constexpr int32 NumSettleFrames = 60;
+
+	/** how far the analytic camera target may be from the head socket, on a table entry and in between */
+	static constexpr float MaxEntryError = 2.f;
+	static constexpr float MaxBetweenError = 5.f;
+
+	static constexpr int32 NumBenchmarkCharacters = 16;
+	static constexpr int32 NumBenchmarkFrames = 100;
+
+	template<typename T>
+	static T& GetProperty(ATrueFPSCharacter* Character, const TCHAR* Name)
+	{
+		return *FindFProperty<FProperty>(ATrueFPSCharacter::StaticClass(), Name)->ContainerPtrToValuePtr<T>(Character);
+	}
+
+	/** a character looking its camera target up from the head offset table, its mesh evaluated every frame as if on screen */
+	static ATrueFPSCharacter* SpawnAnalyticCharacter(UWorld* World, UClass* CharacterClass, const FVector& Location)
+	{
+		ATrueFPSCharacter* Character = World->SpawnActorDeferred<ATrueFPSCharacter>(CharacterClass, FTransform(Location));
+
+		// A copy of the settings, not to change the shared asset
+		TObjectPtr<UTrueFPSCharacterSettings>& Settings = GetProperty<TObjectPtr<UTrueFPSCharacterSettings>>(Character, TEXT("Settings"));
+		Settings = DuplicateObject(Settings.Get(), Character);
+		Settings->CameraTargetMode = ETrueFPSCameraTargetMode::Analytic;
+		Character->FinishSpawning(FTransform(Location));
+
+		USkeletalMeshComponent* Mesh = Character->GetMesh();
+		Mesh->bEnableUpdateRateOptimizations = false;
+		Mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+		Character->GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+		return Character;
+	}
+
+	/** crouches and leans the character as its input would, the capsule snapping to its crouched height as soon as it starts crouching */
+	static void SetCrouchAndLean(ATrueFPSCharacter* Character, const float CrouchValue, const float LeanValue)
+	{
+		FTrueFPSCharacterState& State = GetProperty<FTrueFPSCharacterState>(Character, TEXT("State"));
+		State.CrouchValue = CrouchValue;
+		State.LeanValue = LeanValue;
+
+		UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+		Movement->bWantsToCrouch = CrouchValue > 0.f;
+		if (Movement->bWantsToCrouch && !Character->bIsCrouched)
+		{
+			Movement->Crouch();
+		}
+		else if (!Movement->bWantsToCrouch && Character->bIsCrouched)
+		{
+			Movement->UnCrouch();
+		}
+	}
+
+	/** distance from the camera target to where the head socket is in the pose just evaluated */
+	static float GetTargetError(ATrueFPSCharacter* Character)
+	{
+		const FVector Socket = Character->GetMesh()->GetSocketTransform(FName("head")).GetLocation();
+		return FVector::Dist(ITrueFPSCharacterInterface::Execute_TrueFPSInterface_GetFirstPersonCameraTarget(Character), Socket);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSHeadOffsetTableTest, "TrueFPS.Camera.HeadOffsetTable",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSHeadOffsetTableTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSHeadOffsetTests;
+
+	USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, MannequinMeshPath);
+	if (!TestNotNull(TEXT("Mannequin mesh loads"), Mesh))
+	{
+		return false;
+	}
+
+	constexpr int32 Steps = ATrueFPSCharacter::HeadOffsetCrouchSteps * ATrueFPSCharacter::HeadOffsetLeanSteps;
+	FVector Table[Steps];
+	if (!TestTrue(TEXT("Table is built from the reference skeleton"), ATrueFPSCharacter::BuildHeadOffsetTable(Mesh->GetRefSkeleton(), FTransform::Identity, CrouchHeadDrop, LeanAmount, MakeArrayView(Table))))
+	{
+		return false;
+	}
+
+	// The head bone of the reference pose as the mesh component evaluates it
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	USkeletalMeshComponent* MeshComponent = NewObject<USkeletalMeshComponent>(World);
+	MeshComponent->SetSkeletalMesh(Mesh);
+	MeshComponent->RegisterComponentWithWorld(World);
+	MeshComponent->RefreshBoneTransforms();
+	const FVector EvaluatedHead = MeshComponent->GetSocketLocation(FName("head"));
+	MeshComponent->UnregisterComponent();
+	World->DestroyWorld(false);
+
+	constexpr int32 NeutralLean = ATrueFPSCharacter::HeadOffsetLeanSteps / 2;
+	const FVector& Standing = Table[NeutralLean];
+	AddInfo(FString::Printf(TEXT("Seeded head %s, evaluated head %s"), *Standing.ToString(), *EvaluatedHead.ToString()));
+	TestTrue(TEXT("Standing neutral entry matches the evaluated head bone"), Standing.Equals(EvaluatedHead, MaxSeedError));
+
+	const FVector& Crouched = Table[(ATrueFPSCharacter::HeadOffsetCrouchSteps - 1) * ATrueFPSCharacter::HeadOffsetLeanSteps + NeutralLean];
+	TestEqual(TEXT("Crouched entry is lower by the crouched head drop"), Standing.Z - Crouched.Z, static_cast<double>(CrouchHeadDrop), 0.01);
+
+	// Leaning rolls the head around the pelvis, to either side and slightly down
+	const FVector& LeftLean = Table[0];
+	const FVector& RightLean = Table[ATrueFPSCharacter::HeadOffsetLeanSteps - 1];
+	TestTrue(TEXT("Leaning left and right move the head to either side"), LeftLean.Y < Standing.Y && RightLean.Y > Standing.Y);
+	TestTrue(TEXT("Leaning lowers the head"), LeftLean.Z < Standing.Z && RightLean.Z < Standing.Z);
+	TestEqual(TEXT("Leaning is symmetrical in height"), LeftLean.Z, RightLean.Z, 1.0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSCameraTargetSweepTest, "TrueFPS.Camera.TargetSweep",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSCameraTargetSweepTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSHeadOffsetTests;
+
+	UClass* CharacterClass = LoadClass<ATrueFPSCharacter>(nullptr, CharacterClassPath);
+	if (!TestNotNull(TEXT("Character class loads"), CharacterClass))
+	{
+		return false;
+	}
+
+	const FTrueFPSTestWorld TestWorld;
+	ATrueFPSCharacter* Character = SpawnAnalyticCharacter(TestWorld.World, CharacterClass, FVector(0.f, 0.f, 100.f));
+	const float CharacterLeanAmount = Character->GetSettings()->LeanAmount;
+
+	SetCrouchAndLean(Character, 1.f, 0.f);
+	TestTrue(TEXT("The character's capsule crouches"), Character->bIsCrouched);
+
+	// Every table entry first, their poses refining the entries, then every point halfway between them
+	float MaxEntryErrorFound = 0.f;
+	float MaxBetweenErrorFound = 0.f;
+	for (const bool bEntries : {true, false})
+	{
+		for (int32 Crouch = 0; Crouch < SweepCrouchSteps; Crouch++)
+		{
+			for (int32 Lean = 0; Lean < SweepLeanSteps; Lean++)
+			{
+				const bool bIsEntry = Crouch % 2 == 0 && Lean % 2 == 0;
+				if (bIsEntry != bEntries)
+				{
+					continue;
+				}
+
+				const float CrouchValue = static_cast<float>(Crouch) / (SweepCrouchSteps - 1);
+				const float LeanValue = CharacterLeanAmount * (2.f * Lean / (SweepLeanSteps - 1) - 1.f);
+				SetCrouchAndLean(Character, CrouchValue, LeanValue);
+				TestWorld.Tick(NumSettleFrames);
+
+				const float Error = GetTargetError(Character);
+				float& MaxErrorFound = bIsEntry ? MaxEntryErrorFound : MaxBetweenErrorFound;
+				MaxErrorFound = FMath::Max(MaxErrorFound, Error);
+				TestTrue(FString::Printf(TEXT("Camera target at crouch %.2f lean %.1f is %.2fcm from the head socket"), CrouchValue, LeanValue, Error),
+					Error <= (bIsEntry ? MaxEntryError : MaxBetweenError));
+			}
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Camera target against the head socket over %dx%d crouch and lean values: %.2fcm off at most on a table entry, %.2fcm in between"),
+		SweepCrouchSteps, SweepLeanSteps, MaxEntryErrorFound, MaxBetweenErrorFound));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSCameraTargetPoseWaitBenchmark, "TrueFPS.Camera.PoseWaitBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSCameraTargetPoseWaitBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSHeadOffsetTests;
+
+	UClass* CharacterClass = LoadClass<ATrueFPSCharacter>(nullptr, CharacterClassPath);
+	if (!TestNotNull(TEXT("Character class loads"), CharacterClass))
+	{
+		return false;
+	}
+
+	const FTrueFPSTestWorld TestWorld;
+	TArray<ATrueFPSCharacter*> Characters;
+	for (int32 i = 0; i < NumBenchmarkCharacters; i++)
+	{
+		Characters.Add(SpawnAnalyticCharacter(TestWorld.World, CharacterClass, FVector(i * 200.f, 0.f, 100.f)));
+	}
+	TestWorld.Tick(10);
+
+	int32 NumPosesFinalized = 0;
+	for (ATrueFPSCharacter* Character : Characters)
+	{
+		Character->GetMesh()->OnBoneTransformsFinalizedMC.AddLambda([&NumPosesFinalized]()
+		{
+			NumPosesFinalized++;
+		});
+	}
+
+	// The head socket is only there once the frame's pose is evaluated, which the game thread waited on every frame
+	double SocketSeconds = 0.0;
+	double AnalyticSeconds = 0.0;
+	int32 NumAnalyticPoses = 0;
+	for (int32 Frame = 0; Frame < NumBenchmarkFrames; Frame++)
+	{
+		for (ATrueFPSCharacter* Character : Characters)
+		{
+			USkeletalMeshComponent* Mesh = Character->GetMesh();
+
+			double StartTime = FPlatformTime::Seconds();
+			Mesh->TickPose(1.f / 60.f, false);
+			Mesh->RefreshBoneTransforms();
+			Mesh->GetSocketLocation(FName("head"));
+			SocketSeconds += FPlatformTime::Seconds() - StartTime;
+
+			const int32 NumPosesBefore = NumPosesFinalized;
+			StartTime = FPlatformTime::Seconds();
+			ITrueFPSCharacterInterface::Execute_TrueFPSInterface_GetFirstPersonCameraTarget(Character);
+			AnalyticSeconds += FPlatformTime::Seconds() - StartTime;
+			NumAnalyticPoses += NumPosesFinalized - NumPosesBefore;
+		}
+	}
+
+	TestEqual(TEXT("The analytic camera target evaluates no pose"), NumAnalyticPoses, 0);
+	TestEqual(TEXT("The head socket needs the pose every frame"), NumPosesFinalized, NumBenchmarkCharacters * NumBenchmarkFrames);
+
+	const int32 NumTargets = NumBenchmarkCharacters * NumBenchmarkFrames;
+	AddInfo(FString::Printf(TEXT("Camera target per character: %.2fus waiting on the pose for the head socket, %.3fus analytic"),
+		SocketSeconds * 1e6 / NumTargets, AnalyticSeconds * 1e6 / NumTargets));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
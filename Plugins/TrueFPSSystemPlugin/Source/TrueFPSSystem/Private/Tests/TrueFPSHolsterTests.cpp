@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestWorld.h"
+#include "Weapons/TrueFPSWeaponBase.h"
+#include "Weapons/Attachments/TrueFPSWeaponAttachmentBase.h"
+
+namespace TrueFPSHolsterTests
+{
+	static const TCHAR* WeaponClassPath = TEXT("/TrueFPSSystemPlugin/Weapons/Pistol/BP_WeaponInstant_Pistol.BP_WeaponInstant_Pistol_C");
+
+	static constexpr int32 NumSwitches = 1000;
+
+	struct FComponentCounts
+	{
+		int32 Registered = 0;
+		int32 Ticking = 0;
+		int32 Colliding = 0;
+		int32 TickingActors = 0;
+	};
+
+	/** counts the components of the weapon and its attachments */
+	static FComponentCounts CountComponents(ATrueFPSWeaponBase* Weapon)
+	{
+		TArray<AActor*> Actors{Weapon};
+		TArray<ATrueFPSWeaponAttachmentBase*> Attachments;
+		Weapon->GetAttachments(Attachments);
+		Actors.Append(Attachments);
+
+		FComponentCounts Counts;
+		for (const AActor* Actor : Actors)
+		{
+			Counts.TickingActors += Actor->IsActorTickEnabled() ? 1 : 0;
+			Actor->ForEachComponent(false, [&Counts](const UActorComponent* Component)
+			{
+				if (!Component->IsRegistered()) return;
+				Counts.Registered++;
+				Counts.Ticking += Component->IsComponentTickEnabled() ? 1 : 0;
+
+				const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+				Counts.Colliding += Primitive && Primitive->IsCollisionEnabled() ? 1 : 0;
+			});
+		}
+		return Counts;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSHolsterComponentsTest, "TrueFPS.Weapons.HolsteredComponents",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSHolsterComponentsTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSHolsterTests;
+
+	UClass* WeaponClass = LoadClass<ATrueFPSWeaponBase>(nullptr, WeaponClassPath);
+	if (!TestNotNull(TEXT("Weapon class loads"), WeaponClass))
+	{
+		return false;
+	}
+
+	// Weapons tick themselves here, holstering is what stops their tick
+	const FScopedBatchedTick BatchedTick(false);
+	const FTrueFPSTestWorld TestWorld;
+
+	ATrueFPSWeaponBase* Weapon = TestWorld.World->SpawnActor<ATrueFPSWeaponBase>(WeaponClass, FTransform::Identity);
+	Weapon->OnEquip(nullptr);
+	TestWorld.Tick(1);
+
+	const FComponentCounts Equipped = CountComponents(Weapon);
+	AddInfo(FString::Printf(TEXT("Equipped: %d registered, %d ticking, %d colliding components, %d ticking actors"), Equipped.Registered, Equipped.Ticking, Equipped.Colliding, Equipped.TickingActors));
+
+	Weapon->OnUnEquip();
+	TestWorld.Tick(1);
+
+	const FComponentCounts Holstered = CountComponents(Weapon);
+	AddInfo(FString::Printf(TEXT("Holstered: %d registered, %d ticking, %d colliding components, %d ticking actors"), Holstered.Registered, Holstered.Ticking, Holstered.Colliding, Holstered.TickingActors));
+
+	TestTrue(TEXT("Holstered weapon is hidden"), Weapon->IsHolstered() && Weapon->GetWeaponMesh()->bHiddenInGame);
+	TestEqual(TEXT("Holstering keeps the components registered"), Holstered.Registered, Equipped.Registered);
+	TestEqual(TEXT("Holstered components don't tick"), Holstered.Ticking, 0);
+	TestEqual(TEXT("Holstered components don't collide"), Holstered.Colliding, 0);
+	TestEqual(TEXT("Holstered weapon and attachments don't tick"), Holstered.TickingActors, 0);
+
+	// Switching back and forth only flips flags on the registered components
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumSwitches; i++)
+	{
+		Weapon->OnEquip(nullptr);
+		Weapon->OnUnEquip();
+	}
+	const double SwitchSeconds = (FPlatformTime::Seconds() - StartTime) / NumSwitches;
+
+	AddInfo(FString::Printf(TEXT("Equip and holster: %.3fus"), SwitchSeconds * 1e6));
+	TestEqual(TEXT("Switching doesn't add components"), CountComponents(Weapon).Registered, Equipped.Registered);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSHolsterRecoilTest, "TrueFPS.Weapons.HolsterAfterRecoilSettles",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSHolsterRecoilTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSHolsterTests;
+
+	UClass* WeaponClass = LoadClass<ATrueFPSWeaponBase>(nullptr, WeaponClassPath);
+	if (!TestNotNull(TEXT("Weapon class loads"), WeaponClass))
+	{
+		return false;
+	}
+
+	// Weapons tick themselves here, holstering is what stops their tick
+	const FScopedBatchedTick BatchedTick(false);
+	const FTrueFPSTestWorld TestWorld;
+
+	ATrueFPSWeaponBase* Weapon = TestWorld.World->SpawnActor<ATrueFPSWeaponBase>(WeaponClass, FTransform::Identity);
+	Weapon->OnEquip(nullptr);
+	TestWorld.Tick(1);
+
+	// Holstered right after a shot, both recoil modes have half a second left to play
+	FRecoilInstance Recoil;
+	Recoil.Lifetime = 0.5f;
+	Weapon->GetState().CurrentRecoilInstance = Recoil;
+	Weapon->GetState().RecoilInstances.Add(Recoil);
+	Weapon->OnUnEquip();
+
+	TestTrue(TEXT("Holstered weapon keeps ticking while its recoil settles"), Weapon->IsHolstered() && Weapon->IsActorTickEnabled());
+
+	TestWorld.Tick(45);
+	TestFalse(TEXT("Recoil settled"), Weapon->IsRecoilSettling());
+	TestFalse(TEXT("Holstered weapon stops ticking once its recoil settled"), Weapon->IsActorTickEnabled());
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
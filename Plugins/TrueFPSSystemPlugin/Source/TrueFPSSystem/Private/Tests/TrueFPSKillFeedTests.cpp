@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestGameState.h"
+#include "TrueFPSTestWorld.h"
+#include "Online/TrueFPSPlayerState.h"
+#include "UObject/CoreNet.h"
+
+namespace TrueFPSKillFeedTests
+{
+	static constexpr int32 NumPlayers = 64;
+
+	/** enough for the 16 bit serial to wrap around */
+	static constexpr int32 NumKills = 70000;
+
+	/** every how many net updates a burst of kills overflows the ring before the next one */
+	static constexpr int32 BurstInterval = 50;
+	static constexpr int32 BurstSize = FTrueFPSKillFeed::Capacity + 4;
+
+	/** odds of a net update being lost, and of a received slot being sent again as its ack was lost */
+	static constexpr float DropChance = 0.2f;
+	static constexpr float DuplicateChance = 0.1f;
+
+	/** bits the fast array writes ahead of each changed item, its replication id */
+	static constexpr int32 ItemHeaderBits = 32;
+
+	/** copies an entry's replicated properties the way property replication does, returning the bits it took */
+	static int32 ReplicateEntry(FTrueFPSKillFeedEntry& ServerEntry, FTrueFPSKillFeedEntry& ClientEntry)
+	{
+		FNetBitWriter Writer(nullptr, 256);
+		for (TFieldIterator<FProperty> It(FTrueFPSKillFeedEntry::StaticStruct()); It; ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_RepSkip))
+			{
+				It->NetSerializeItem(Writer, nullptr, It->ContainerPtrToValuePtr<void>(&ServerEntry));
+			}
+		}
+
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		for (TFieldIterator<FProperty> It(FTrueFPSKillFeedEntry::StaticStruct()); It; ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_RepSkip))
+			{
+				It->NetSerializeItem(Reader, nullptr, It->ContainerPtrToValuePtr<void>(&ClientEntry));
+			}
+		}
+
+		return static_cast<int32>(Writer.GetNumBits());
+	}
+
+	static bool IsSameKill(const FTrueFPSKillFeedEntry& A, const FTrueFPSKillFeedEntry& B)
+	{
+		return A.Serial == B.Serial && A.KillerId == B.KillerId && A.VictimId == B.VictimId && A.DamageTypeIndex == B.DamageTypeIndex && A.Flags == B.Flags;
+	}
+
+	/** reliable multicast functions a class declares itself, what every kill used to go out as */
+	static int32 GetNumReliableMulticasts(const UClass* Class)
+	{
+		int32 Num = 0;
+		for (TFieldIterator<UFunction> It(Class, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			Num += It->HasAllFunctionFlags(FUNC_Net | FUNC_NetReliable | FUNC_NetMulticast) ? 1 : 0;
+		}
+		return Num;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSKillFeedTest, "TrueFPS.Online.KillFeedReplication",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSKillFeedTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSKillFeedTests;
+
+	const FTrueFPSTestWorld TestWorld;
+	ATrueFPSTestGameState* ClientGameState = TestWorld.World->SpawnActor<ATrueFPSTestGameState>();
+	ATrueFPSTestGameState* ServerGameState = TestWorld.World->SpawnActor<ATrueFPSTestGameState>();
+
+	TArray<ATrueFPSPlayerState*> PlayerStates;
+	for (int32 i = 0; i < NumPlayers; i++)
+	{
+		ATrueFPSPlayerState* PlayerState = TestWorld.World->SpawnActor<ATrueFPSPlayerState>();
+		PlayerState->SetPlayerId(i);
+		PlayerStates.Add(PlayerState);
+	}
+
+	FTrueFPSKillFeed& ServerFeed = ServerGameState->GetKillFeed();
+	FTrueFPSKillFeed& ClientFeed = ClientGameState->GetKillFeed();
+	ClientFeed.Items.SetNum(FTrueFPSKillFeed::Capacity);
+
+	// Replication keys of the slots the client has acked, INDEX_NONE until first received
+	TArray<int32> AckedKeys;
+	AckedKeys.Init(INDEX_NONE, FTrueFPSKillFeed::Capacity);
+
+	FRandomStream Random(NumKills);
+
+	// Kills the client received, numbered from the first as the serials wrap
+	TSet<int32> DeliveredKills;
+	int64 NumSentBits = 0;
+	int32 NumSentItems = 0;
+	int32 NumAdded = 0;
+
+	for (int32 Update = 0; NumAdded < NumKills; Update++)
+	{
+		// Kills since the last net update, the odd burst overwriting slots the client never saw
+		const int32 NumUpdateKills = FMath::Min(Update % BurstInterval == 0 ? BurstSize : Random.RandRange(0, 3), NumKills - NumAdded);
+		for (int32 i = 0; i < NumUpdateKills; i++, NumAdded++)
+		{
+			ATrueFPSPlayerState* Killer = Random.FRand() < 0.05f ? nullptr : PlayerStates[Random.RandRange(0, NumPlayers - 1)];
+			ATrueFPSPlayerState* Victim = PlayerStates[Random.RandRange(0, NumPlayers - 1)];
+			ServerGameState->AddKill(Killer, Random.FRand() < 0.5f ? GetDefault<UDamageType>() : nullptr, Victim);
+		}
+
+		// The fast array sends the slots changed since the client's last ack, unreliably
+		const bool bDropped = Random.FRand() < DropChance;
+		for (int32 Slot = 0; Slot < ServerFeed.Items.Num(); Slot++)
+		{
+			FTrueFPSKillFeedEntry& ServerEntry = ServerFeed.Items[Slot];
+			const bool bChanged = ServerEntry.ReplicationKey != AckedKeys[Slot];
+			const bool bDuplicate = !bChanged && AckedKeys[Slot] != INDEX_NONE && Random.FRand() < DuplicateChance;
+			if (!bChanged && !bDuplicate)
+			{
+				continue;
+			}
+
+			FTrueFPSKillFeedEntry& ClientEntry = ClientFeed.Items[Slot];
+			FTrueFPSKillFeedEntry LostEntry;
+			NumSentBits += ReplicateEntry(ServerEntry, bDropped ? LostEntry : ClientEntry) + ItemHeaderBits;
+			NumSentItems++;
+			if (bDropped)
+			{
+				continue;
+			}
+
+			if (AckedKeys[Slot] == INDEX_NONE)
+			{
+				ClientEntry.PostReplicatedAdd(ClientFeed);
+			}
+			else
+			{
+				ClientEntry.PostReplicatedChange(ClientFeed);
+			}
+			AckedKeys[Slot] = ServerEntry.ReplicationKey;
+			DeliveredKills.Add(NumAdded - static_cast<uint16>(ServerFeed.LastSerial - ClientEntry.Serial));
+		}
+
+		if (!bDropped)
+		{
+			ClientGameState->FlushReceivedKills();
+		}
+	}
+
+	// The server shows its own kills as they happen
+	TestEqual(TEXT("The server shows every kill"), ServerGameState->ShownKills.Num(), NumKills);
+
+	// Each kill the client received is shown once, in the order the kills happened, as the server added it
+	bool bInOrder = true;
+	bool bMatchesServer = true;
+	int32 ServerIndex = 0;
+	for (int32 i = 0; i < ClientGameState->ShownKills.Num(); i++)
+	{
+		const FTrueFPSKillFeedEntry& Shown = ClientGameState->ShownKills[i];
+		bInOrder &= i == 0 || FTrueFPSKillFeedEntry::IsNewerSerial(Shown.Serial, ClientGameState->ShownKills[i - 1].Serial);
+
+		// Serials wrap, match against the server's kills up to this one
+		while (ServerIndex < ServerGameState->ShownKills.Num() && ServerGameState->ShownKills[ServerIndex].Serial != Shown.Serial)
+		{
+			ServerIndex++;
+		}
+		bMatchesServer &= ServerGameState->ShownKills.IsValidIndex(ServerIndex) && IsSameKill(ServerGameState->ShownKills[ServerIndex], Shown);
+	}
+
+	TestTrue(TEXT("Kills show in the order they happened and never twice, across the serial wrapping around"), bInOrder);
+	TestTrue(TEXT("Kills show as the server added them"), bMatchesServer);
+	TestEqual(TEXT("Every kill received is shown once, resent and duplicated slots included"), ClientGameState->ShownKills.Num(), DeliveredKills.Num());
+	TestTrue(TEXT("Kills overwritten before a client saw them are skipped"), ClientGameState->ShownKills.Num() < NumKills);
+
+	// None of it goes through the reliable buffer any more, only the killer's own InformAboutKill does
+	TestEqual(TEXT("The game state sends no reliable multicasts"), GetNumReliableMulticasts(ATrueFPSGameState::StaticClass()), 0);
+	TestEqual(TEXT("The player state sends no reliable multicasts"), GetNumReliableMulticasts(ATrueFPSPlayerState::StaticClass()), 0);
+
+	AddInfo(FString::Printf(TEXT("%d kills, %d shown on a client losing %.0f%% of its updates: %.1f bytes per kill (%d slots sent), reliable RPCs per kill %d instead of %d"),
+		NumKills, ClientGameState->ShownKills.Num(), DropChance * 100.f, NumSentBits / 8.0 / NumKills, NumSentItems, 1, NumPlayers));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
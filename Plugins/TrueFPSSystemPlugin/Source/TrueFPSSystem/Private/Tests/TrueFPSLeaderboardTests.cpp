@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OnlineSubsystemNames.h"
+#include "Online/TrueFPSLeaderboardCache.h"
+
+namespace TrueFPSLeaderboardTests
+{
+	/** times the leaderboard menu is opened */
+	static constexpr int32 NumOpens = 50;
+
+	/** time between two openings */
+	static constexpr double OpenInterval = 10.0;
+
+	static constexpr int32 NumRanks = 10000;
+
+	/** rank of the local player on the board */
+	static constexpr int32 LocalRank = 1234;
+
+	/** menus opened at once, e.g. by split screen players */
+	static constexpr int32 NumConcurrentOpens = 4;
+
+	static FUniqueNetIdRepl GetRankUserId(const int32 Rank)
+	{
+		return FUniqueNetIdRepl(FUniqueNetIdString::Create(FString::Printf(TEXT("Player%d"), Rank), NULL_SUBSYSTEM));
+	}
+
+	/** a cache reading from a mock board of NumRanks players on a simulated clock, counting every backend read */
+	class FTestLeaderboardCache : public FTrueFPSLeaderboardCache
+	{
+	public:
+
+		double Now = 0.0;
+		int32 NumReads = 0;
+
+		FTestLeaderboardCache()
+			: FTrueFPSLeaderboardCache(nullptr)
+		{
+		}
+
+		/** answers the reads in flight, and the ones queued behind them */
+		void CompleteReads()
+		{
+			while (PendingReads.Num() > 0)
+			{
+				const TPair<FReadKey, FOnlineLeaderboardReadRef> PendingRead = PendingReads[0];
+				PendingReads.RemoveAt(0);
+
+				const FReadKey& Key = PendingRead.Key;
+				const int32 FirstRank = Key.PageIndex != INDEX_NONE ? Key.PageIndex * PageSize + 1 : LocalRank - PageSize / 2;
+				const int32 LastRank = Key.PageIndex != INDEX_NONE ? FirstRank + PageSize - 1 : LocalRank + PageSize / 2;
+				for (int32 Rank = FMath::Max(FirstRank, 1); Rank <= FMath::Min(LastRank, NumRanks); Rank++)
+				{
+					FOnlineStatsRow& Row = PendingRead.Value->Rows.Emplace_GetRef(FString::Printf(TEXT("Player%d"), Rank), GetRankUserId(Rank)->AsShared());
+					Row.Rank = Rank;
+				}
+				PendingRead.Value->ReadState = EOnlineAsyncTaskState::Done;
+
+				OnReadComplete(true);
+			}
+		}
+
+	protected:
+
+		virtual bool ReadLeaderboards(const FReadKey& Key, FOnlineLeaderboardReadRef& ReadObjectRef) override
+		{
+			NumReads++;
+			ReadObjectRef->ReadState = EOnlineAsyncTaskState::InProgress;
+			PendingReads.Emplace(Key, ReadObjectRef);
+			return true;
+		}
+
+		virtual double GetTime() const override
+		{
+			return Now;
+		}
+
+	private:
+
+		TArray<TPair<FReadKey, FOnlineLeaderboardReadRef>> PendingReads;
+	};
+
+	/** what the leaderboard menu does when opened, read the rows around the local player then the page of their rank */
+	static void OpenLeaderboard(FTestLeaderboardCache& Cache, const FUniqueNetIdRepl& LocalUserId, int32& NumShown, int32& ShownPageIndex)
+	{
+		Cache.ReadAroundUser(LocalUserId, FOnLeaderboardCacheReadComplete::CreateLambda([&Cache, LocalUserId, &NumShown, &ShownPageIndex](bool bWasSuccessful)
+		{
+			const TArray<FOnlineStatsRow>* Rows = bWasSuccessful ? Cache.GetRowsAroundUser(LocalUserId) : nullptr;
+			const FOnlineStatsRow* LocalRow = Rows ? Rows->FindByPredicate([&LocalUserId](const FOnlineStatsRow& Row)
+			{
+				return *Row.PlayerId == *LocalUserId;
+			}) : nullptr;
+			if (!LocalRow)
+			{
+				return;
+			}
+
+			const int32 PageIndex = FTrueFPSLeaderboardCache::GetPageIndex(LocalRow->Rank);
+			Cache.ReadPage(PageIndex, FOnLeaderboardCacheReadComplete::CreateLambda([&NumShown, &ShownPageIndex, PageIndex](bool bPageRead)
+			{
+				NumShown += bPageRead ? 1 : 0;
+				ShownPageIndex = PageIndex;
+			}));
+		}));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSLeaderboardCacheTest, "TrueFPS.Online.LeaderboardCache",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSLeaderboardCacheTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSLeaderboardTests;
+
+	const TSharedRef<FTestLeaderboardCache> Cache = MakeShared<FTestLeaderboardCache>();
+	const FUniqueNetIdRepl LocalUserId = GetRankUserId(LocalRank);
+
+	// The menu opened over and over, each opening used to read the whole board again
+	int32 NumShown = 0;
+	int32 ShownPageIndex = INDEX_NONE;
+	for (int32 i = 0; i < NumOpens; i++)
+	{
+		Cache->Now = i * OpenInterval;
+		OpenLeaderboard(*Cache, LocalUserId, NumShown, ShownPageIndex);
+		Cache->CompleteReads();
+	}
+
+	// Two reads per opening, the rows around the player and their page, at most once per TTL
+	const int32 MaxReads = 2 * (FMath::CeilToInt(NumOpens * OpenInterval / FTrueFPSLeaderboardCache::ReadTTL) + 1);
+	TestEqual(TEXT("The leaderboard shows every time it's opened"), NumShown, NumOpens);
+	TestTrue(FString::Printf(TEXT("Opening the leaderboard %d times reads the board %d times"), NumOpens, Cache->NumReads), Cache->NumReads > 0 && Cache->NumReads <= MaxReads);
+	TestEqual(TEXT("The page shown is the local player's"), ShownPageIndex, FTrueFPSLeaderboardCache::GetPageIndex(LocalRank));
+
+	const TArray<FOnlineStatsRow>* Page = Cache->GetPage(ShownPageIndex);
+	if (TestNotNull(TEXT("The local player's page is cached"), Page))
+	{
+		TestEqual(TEXT("A page holds a page of ranks"), Page->Num(), static_cast<int32>(FTrueFPSLeaderboardCache::PageSize));
+		TestTrue(TEXT("A page holds the ranks it's for"), !Page->ContainsByPredicate([&ShownPageIndex](const FOnlineStatsRow& Row)
+		{
+			return FTrueFPSLeaderboardCache::GetPageIndex(Row.Rank) != ShownPageIndex;
+		}));
+	}
+
+	// Menus opened while a read is in flight share it
+	Cache->Now += FTrueFPSLeaderboardCache::ReadTTL;
+	const int32 NumReadsBeforeConcurrent = Cache->NumReads;
+	NumShown = 0;
+	for (int32 i = 0; i < NumConcurrentOpens; i++)
+	{
+		OpenLeaderboard(*Cache, LocalUserId, NumShown, ShownPageIndex);
+	}
+	Cache->CompleteReads();
+
+	TestEqual(TEXT("Every concurrent opening shows the leaderboard"), NumShown, NumConcurrentOpens);
+	TestEqual(TEXT("Concurrent openings share their reads"), Cache->NumReads - NumReadsBeforeConcurrent, 2);
+
+	// Writing the board at the end of a match invalidates what's cached
+	const int32 NumReadsBeforeInvalidate = Cache->NumReads;
+	Cache->Invalidate();
+	OpenLeaderboard(*Cache, LocalUserId, NumShown, ShownPageIndex);
+	Cache->CompleteReads();
+
+	TestEqual(TEXT("An invalidated cache reads the board again"), Cache->NumReads - NumReadsBeforeInvalidate, 2);
+
+	AddInfo(FString::Printf(TEXT("%d openings %.0fs apart: %d board reads (%d without the cache)"), NumOpens, OpenInterval, NumReadsBeforeConcurrent, NumOpens));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestGameInstance.h"
+#include "TrueFPSTestGameMode.h"
+#include "TrueFPSTestLocalPlayer.h"
+#include "TrueFPSTestWorld.h"
+#include "Bots/TrueFPSAIController.h"
+#include "Character/TrueFPSPersistentUser.h"
+#include "Character/TrueFPSPlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Online/TrueFPSMatchReportQueue.h"
+
+namespace TrueFPSMatchReportTests
+{
+	static constexpr int32 NumPlayers = 64;
+
+	/** split screen players on the listen server, the rest are bots */
+	static constexpr int32 NumLocalPlayers = 4;
+
+	/** frames given to the queue to write every report */
+	static constexpr int32 MaxReportFrames = 1000;
+
+	static FString GetSlotName(const int32 LocalPlayerIndex)
+	{
+		return FString::Printf(TEXT("TrueFPSTest_MatchReport_%d"), LocalPlayerIndex);
+	}
+
+	/** what FinishMatch does for the players in the frame the match ends, timed */
+	static double EndMatch(const TArray<AController*>& Controllers)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Controllers.Num(); i++)
+		{
+			Controllers[i]->GameHasEnded(nullptr, i % 2 == 0);
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	/** matches every local player's persistent user has recorded */
+	static int32 GetNumRecordedMatches(const TArray<UTrueFPSTestLocalPlayer*>& LocalPlayers, const int32 LocalPlayerIndex)
+	{
+		const UTrueFPSPersistentUser* PersistentUser = LocalPlayers[LocalPlayerIndex]->GetPersistentUser();
+		return PersistentUser ? PersistentUser->GetWins() + PersistentUser->GetLosses() : 0;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSMatchReportFrameTest, "TrueFPS.Online.MatchReportFrame",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSMatchReportFrameTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSMatchReportTests;
+
+	const TTrueFPSTestGameInstance<UTrueFPSTestGameInstance> TestGameInstance;
+	UTrueFPSTestGameInstance* GameInstance = TestGameInstance.GameInstance;
+	UWorld* World = TestGameInstance.World;
+
+	const TSharedPtr<FTrueFPSMatchReportQueue> Queue = GameInstance->GetMatchReportQueue();
+	if (!TestTrue(TEXT("The game instance has a report queue"), Queue.IsValid()))
+	{
+		return false;
+	}
+
+	World->AuthorityGameMode = World->SpawnActor<ATrueFPSTestGameMode>();
+
+	// The local players save to test slots, the bots only have a player state
+	TArray<AController*> Controllers;
+	TArray<UTrueFPSTestLocalPlayer*> LocalPlayers;
+	for (int32 i = 0; i < NumLocalPlayers; i++)
+	{
+		UGameplayStatics::DeleteGameInSlot(GetSlotName(i), 0);
+
+		UTrueFPSTestLocalPlayer* LocalPlayer = NewObject<UTrueFPSTestLocalPlayer>(GEngine);
+		LocalPlayer->LoadTestPersistentUser(GetSlotName(i));
+		LocalPlayers.Add(LocalPlayer);
+
+		// Not through SetPlayer, which builds the in game menu
+		ATrueFPSPlayerController* PlayerController = World->SpawnActor<ATrueFPSPlayerController>();
+		PlayerController->Player = LocalPlayer;
+		LocalPlayer->PlayerController = PlayerController;
+		if (!PlayerController->PlayerState)
+		{
+			PlayerController->InitPlayerState();
+		}
+		Controllers.Add(PlayerController);
+	}
+	for (int32 i = NumLocalPlayers; i < NumPlayers; i++)
+	{
+		Controllers.Add(World->SpawnActor<ATrueFPSAIController>());
+	}
+
+	// Before, every local player's save file and online writes ran in the frame the match ended
+	GameInstance->SetMatchReportQueue(nullptr);
+	AddExpectedError(TEXT("No match report queue"), EAutomationExpectedErrorFlags::Contains, NumLocalPlayers);
+	const double SyncEndFrameSeconds = EndMatch(Controllers);
+
+	for (int32 i = 0; i < NumLocalPlayers; i++)
+	{
+		TestEqual(FString::Printf(TEXT("Local player %d's match is recorded right away without a queue"), i), GetNumRecordedMatches(LocalPlayers, i), 1);
+	}
+
+	// After, the frame only takes a copy of the results
+	GameInstance->SetMatchReportQueue(Queue);
+	const double QueuedEndFrameSeconds = EndMatch(Controllers);
+
+	TestTrue(TEXT("Every local player's report is queued"), Queue->HasPendingReports());
+	for (int32 i = 0; i < NumLocalPlayers; i++)
+	{
+		TestEqual(FString::Printf(TEXT("Local player %d's match isn't recorded in the frame it ended"), i), GetNumRecordedMatches(LocalPlayers, i), 1);
+	}
+
+	// And the reports go out over the following frames
+	int32 NumReportFrames = 0;
+	double MaxReportFrameSeconds = 0.0;
+	while (Queue->HasPendingReports() && NumReportFrames < MaxReportFrames)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Queue->Tick(1.f / 60.f);
+		MaxReportFrameSeconds = FMath::Max(MaxReportFrameSeconds, FPlatformTime::Seconds() - StartTime);
+		NumReportFrames++;
+	}
+
+	TestFalse(TEXT("Every report is written"), Queue->HasPendingReports());
+	for (int32 i = 0; i < NumLocalPlayers; i++)
+	{
+		TestEqual(FString::Printf(TEXT("Local player %d's match is recorded by the queue"), i), GetNumRecordedMatches(LocalPlayers, i), 2);
+		UGameplayStatics::DeleteGameInSlot(GetSlotName(i), 0);
+	}
+
+	AddInfo(FString::Printf(TEXT("%d players, %d local: match end frame %.3fms writing reports right away, %.3fms queued, then %d frames of at most %.3fms"),
+		NumPlayers, NumLocalPlayers, SyncEndFrameSeconds * 1000.0, QueuedEndFrameSeconds * 1000.0, NumReportFrames, MaxReportFrameSeconds * 1000.0));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
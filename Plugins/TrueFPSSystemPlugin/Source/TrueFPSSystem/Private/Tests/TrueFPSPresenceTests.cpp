@@ -0,0 +1,288 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OnlineSubsystemNames.h"
+#include "Online/TrueFPSPresenceCoordinator.h"
+
+namespace TrueFPSPresenceTests
+{
+	static constexpr int32 NumLocalPlayers = 2;
+	static constexpr int32 SessionSeconds = 30 * 60;
+
+	/** how often the game used to refresh friends and presence, whether anything changed or not */
+	static constexpr int32 RefreshInterval = 15;
+
+	/** a match every five minutes, the presence changes at these seconds into it */
+	static constexpr int32 MatchSeconds = 5 * 60;
+
+	/** the backend fails every call in between */
+	static constexpr int32 OutageStart = 600;
+	static constexpr int32 OutageEnd = 700;
+
+	/** the backend reports a friends list change at these seconds */
+	static const int32 FriendsChangeTimes[] = { 200, 900, 1500 };
+
+	/** a backend round trip */
+	static constexpr double Latency = 0.25;
+
+	/** presence the game sets at that second into a match, nullptr if it doesn't change */
+	static const TCHAR* GetMatchPresence(const int32 MatchTime)
+	{
+		switch (MatchTime)
+		{
+		case 0:
+			return TEXT("In Menu");
+		case 30:
+			return TEXT("In Game");
+		case 120:
+			return TEXT("On Pause");
+		case 130:
+			return TEXT("In Game");
+		default:
+			return nullptr;
+		}
+	}
+
+	/** a coordinator talking to a mock backend on a simulated clock, counting every outbound call */
+	class FTestPresenceCoordinator : public FTrueFPSPresenceCoordinator
+	{
+	public:
+
+		double Now = 0.0;
+		bool bBackendDown = false;
+
+		/** outbound calls by local player, and when each was made */
+		TMap<int32, TArray<double>> PresenceCallTimes;
+		TMap<int32, TArray<double>> FailedPresenceCallTimes;
+		TMap<int32, int32> NumFriendsReads;
+		TMap<int32, int32> NumFailedFriendsReads;
+
+		FTestPresenceCoordinator()
+			: FTrueFPSPresenceCoordinator(nullptr)
+		{
+		}
+
+		/** runs flushes and delivers completions until the given time */
+		void RunUntil(const double Time)
+		{
+			for (;;)
+			{
+				const double FlushTime = FlushHandle.IsValid() ? ScheduledFlushTime : DBL_MAX;
+				const double CompletionTime = Completions.Num() > 0 ? Completions[0].Key : DBL_MAX;
+				if (FMath::Min(FlushTime, CompletionTime) > Time)
+				{
+					break;
+				}
+
+				if (FlushTime <= CompletionTime)
+				{
+					Now = FMath::Max(Now, FlushTime);
+					FTSTicker::GetCoreTicker().RemoveTicker(FlushHandle);
+					FlushPresence(0.f);
+				}
+				else
+				{
+					Now = FMath::Max(Now, CompletionTime);
+					const TFunction<void()> Completion = MoveTemp(Completions[0].Value);
+					Completions.RemoveAt(0);
+					Completion();
+				}
+			}
+
+			Now = Time;
+		}
+
+		void SimulateFriendsChange(const int32 LocalUserNum)
+		{
+			OnFriendsChange(LocalUserNum);
+		}
+
+		/** whether the backend has every local player's latest presence */
+		bool IsPresenceUpToDate() const
+		{
+			for (const TPair<int32, FUserPresence>& Pair : PresenceByUser)
+			{
+				FOnlineUserPresenceStatus Update;
+				if (GetPresenceDiff(Pair.Value, Update))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+	protected:
+
+		virtual bool SendPresence(int32 LocalUserNum, const FUniqueNetId& UserId, const FOnlineUserPresenceStatus& Update) override
+		{
+			PresenceCallTimes.FindOrAdd(LocalUserNum).Add(Now);
+			if (bBackendDown)
+			{
+				FailedPresenceCallTimes.FindOrAdd(LocalUserNum).Add(Now);
+			}
+
+			const FUniqueNetIdRef UserIdRef = UserId.AsShared();
+			Complete([this, UserIdRef, bWasSuccessful = !bBackendDown, LocalUserNum, Update]()
+			{
+				OnSetPresenceComplete(*UserIdRef, bWasSuccessful, LocalUserNum, Update);
+			});
+			return true;
+		}
+
+		virtual bool ReadFriendsList(int32 LocalUserNum, const FString& ListName) override
+		{
+			NumFriendsReads.FindOrAdd(LocalUserNum)++;
+			if (bBackendDown)
+			{
+				NumFailedFriendsReads.FindOrAdd(LocalUserNum)++;
+			}
+
+			Complete([this, LocalUserNum, ListName, bWasSuccessful = !bBackendDown]()
+			{
+				OnReadFriendsListComplete(LocalUserNum, bWasSuccessful, ListName, bWasSuccessful ? FString() : FString(TEXT("Backend down")));
+			});
+			return true;
+		}
+
+		virtual bool GetReadFriendsList(int32 LocalUserNum, const FString& ListName, TArray<TSharedRef<FOnlineFriend>>& OutFriends) const override
+		{
+			OutFriends.Reset();
+			return true;
+		}
+
+		virtual double GetTime() const override
+		{
+			return Now;
+		}
+
+	private:
+
+		/** backend responses in the order they arrive */
+		TArray<TPair<double, TFunction<void()>>> Completions;
+
+		void Complete(TFunction<void()>&& Completion)
+		{
+			Completions.Emplace(Now + Latency, MoveTemp(Completion));
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSPresenceSessionTest, "TrueFPS.Online.PresenceSession",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSPresenceSessionTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSPresenceTests;
+
+	const TSharedRef<FTestPresenceCoordinator> Coordinator = MakeShared<FTestPresenceCoordinator>();
+
+	TArray<FUniqueNetIdRepl> UserIds;
+	for (int32 LocalUserNum = 0; LocalUserNum < NumLocalPlayers; LocalUserNum++)
+	{
+		UserIds.Add(FUniqueNetIdRepl(FUniqueNetIdString::Create(FString::Printf(TEXT("Player%d"), LocalUserNum), NULL_SUBSYSTEM)));
+	}
+
+	int32 NumPresenceRequests = 0;
+	int32 NumPresenceChanges = 0;
+	int32 NumFriendsRequests = 0;
+	FString CurrentPresence;
+
+	// A split screen session, the game asking for everything the way it used to and the coordinator deciding what goes out
+	for (int32 Time = 0; Time < SessionSeconds; Time++)
+	{
+		Coordinator->bBackendDown = Time >= OutageStart && Time < OutageEnd;
+
+		const TCHAR* MatchPresence = GetMatchPresence(Time % MatchSeconds);
+		if (MatchPresence || Time % RefreshInterval == 0)
+		{
+			if (MatchPresence)
+			{
+				CurrentPresence = MatchPresence;
+				NumPresenceChanges++;
+			}
+
+			for (int32 LocalUserNum = 0; LocalUserNum < NumLocalPlayers; LocalUserNum++)
+			{
+				Coordinator->SetPresence(LocalUserNum, UserIds[LocalUserNum], CurrentPresence, DefaultPresenceKey, FVariantData(CurrentPresence));
+				NumPresenceRequests++;
+			}
+		}
+
+		if (Time % RefreshInterval == 0)
+		{
+			for (int32 LocalUserNum = 0; LocalUserNum < NumLocalPlayers; LocalUserNum++)
+			{
+				Coordinator->RefreshFriends(LocalUserNum);
+				NumFriendsRequests++;
+			}
+		}
+
+		for (const int32 FriendsChangeTime : FriendsChangeTimes)
+		{
+			if (Time == FriendsChangeTime)
+			{
+				for (int32 LocalUserNum = 0; LocalUserNum < NumLocalPlayers; LocalUserNum++)
+				{
+					Coordinator->SimulateFriendsChange(LocalUserNum);
+				}
+			}
+		}
+
+		Coordinator->RunUntil(Time + 1.0);
+	}
+
+	// Every back off has run out by then
+	Coordinator->RunUntil(SessionSeconds + 600.0);
+	TestTrue(TEXT("The backend ends up with every player's latest presence"), Coordinator->IsPresenceUpToDate());
+
+	// Failed calls are retried a handful of times over the outage, not every refresh
+	const int32 MaxFailedCalls = FMath::CeilToInt(FMath::Log2(static_cast<float>(OutageEnd - OutageStart))) + 2;
+
+	int32 NumPresenceCalls = 0;
+	int32 NumFriendsReads = 0;
+	for (int32 LocalUserNum = 0; LocalUserNum < NumLocalPlayers; LocalUserNum++)
+	{
+		const TArray<double> CallTimes = Coordinator->PresenceCallTimes.FindRef(LocalUserNum);
+		const TArray<double> FailedCallTimes = Coordinator->FailedPresenceCallTimes.FindRef(LocalUserNum);
+		NumPresenceCalls += CallTimes.Num();
+
+		TestTrue(FString::Printf(TEXT("Player %d only sends presence that changed"), LocalUserNum), CallTimes.Num() - FailedCallTimes.Num() <= NumPresenceChanges);
+		TestTrue(FString::Printf(TEXT("Player %d retries presence %d times during the outage"), LocalUserNum, FailedCallTimes.Num()), FailedCallTimes.Num() > 0 && FailedCallTimes.Num() <= MaxFailedCalls);
+
+		// Doubling, give or take the 10% jitter and the round trip
+		bool bBacksOff = true;
+		for (int32 i = 2; i < FailedCallTimes.Num(); i++)
+		{
+			bBacksOff &= FailedCallTimes[i] - FailedCallTimes[i - 1] >= 1.5 * (FailedCallTimes[i - 1] - FailedCallTimes[i - 2]);
+		}
+		TestTrue(FString::Printf(TEXT("Player %d backs off exponentially"), LocalUserNum), bBacksOff);
+
+		// Friends are read once the cache is a minute old or the backend reports a change
+		const int32 PlayerFriendsReads = Coordinator->NumFriendsReads.FindRef(LocalUserNum);
+		NumFriendsReads += PlayerFriendsReads;
+		const int32 MaxFriendsReads = SessionSeconds / 60 + static_cast<int32>(UE_ARRAY_COUNT(FriendsChangeTimes)) + MaxFailedCalls;
+		TestTrue(FString::Printf(TEXT("Player %d reads friends %d times"), LocalUserNum, PlayerFriendsReads), PlayerFriendsReads > 0 && PlayerFriendsReads <= MaxFriendsReads);
+		TestTrue(FString::Printf(TEXT("Player %d backs off failed friends reads"), LocalUserNum), Coordinator->NumFailedFriendsReads.FindRef(LocalUserNum) <= MaxFailedCalls);
+
+		// Nothing changed after the first read, consumers have no reason to rebuild
+		TestEqual(FString::Printf(TEXT("Player %d's friends list version"), LocalUserNum), static_cast<int32>(Coordinator->GetFriendsVersion(LocalUserNum)), 1);
+	}
+
+	// Players set in the same frame go out in the same flush
+	const TArray<double> FirstPlayerCalls = Coordinator->PresenceCallTimes.FindRef(0);
+	const TArray<double> SecondPlayerCalls = Coordinator->PresenceCallTimes.FindRef(1);
+	if (TestTrue(TEXT("Both players sent presence"), FirstPlayerCalls.Num() > 0 && SecondPlayerCalls.Num() > 0))
+	{
+		TestEqual(TEXT("Both players' first presence goes out together"), FirstPlayerCalls[0], SecondPlayerCalls[0]);
+	}
+
+	AddInfo(FString::Printf(TEXT("%d minutes, %d local players: %d presence calls for %d requests, %d friends reads for %d requests"),
+		SessionSeconds / 60, NumLocalPlayers, NumPresenceCalls, NumPresenceRequests, NumFriendsReads, NumFriendsRequests));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestWorld.h"
+#include "Character/TrueFPSRagdollManager.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "GameFramework/Character.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+
+namespace TrueFPSRagdollTests
+{
+	static const TCHAR* MannequinMeshPath = TEXT("/TrueFPSSystemPlugin/Characters/Heroes/Mannequin/Meshes/SKM_Manny.SKM_Manny");
+	static const TCHAR* MannequinPhysicsAssetPath = TEXT("/TrueFPSSystemPlugin/Characters/Heroes/Mannequin/Rig/PA_Mannequin.PA_Mannequin");
+
+	static constexpr int32 NumKills = 100;
+	static constexpr int32 NumFrames = 30;
+
+	struct FSimulatingCounts
+	{
+		int32 Ragdolls = 0;
+		int32 Bodies = 0;
+	};
+
+	/** a killed character in the air, with nothing to land on its ragdoll never settles */
+	static ACharacter* SpawnRagdoll(UWorld* World, USkeletalMesh* SkeletalMesh, UPhysicsAsset* PhysicsAsset, const int32 Index)
+	{
+		ACharacter* Character = World->SpawnActor<ACharacter>(ACharacter::StaticClass(), FTransform(FVector(Index % 10 * 200.0, Index / 10 * 200.0, 1000.0)));
+		Character->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+		USkeletalMeshComponent* Mesh = Character->GetMesh();
+		Mesh->SetSkeletalMesh(SkeletalMesh);
+		Mesh->SetPhysicsAsset(PhysicsAsset);
+		Mesh->SetCollisionProfileName(TEXT("Ragdoll"));
+		Mesh->SetSimulatePhysics(true);
+		Mesh->WakeAllRigidBodies();
+		Mesh->bBlendPhysics = true;
+
+		World->GetSubsystem<UTrueFPSRagdollManager>()->AddRagdoll(Character);
+		return Character;
+	}
+
+	static FSimulatingCounts CountSimulating(const TArray<TWeakObjectPtr<ACharacter>>& Characters)
+	{
+		FSimulatingCounts Counts;
+		for (const TWeakObjectPtr<ACharacter>& Character : Characters)
+		{
+			if (!Character.IsValid() || Character->IsActorBeingDestroyed()) continue;
+
+			int32 Bodies = 0;
+			for (const FBodyInstance* Body : Character->GetMesh()->Bodies)
+			{
+				Bodies += Body && Body->IsInstanceSimulatingPhysics() ? 1 : 0;
+			}
+			Counts.Ragdolls += Bodies > 0 ? 1 : 0;
+			Counts.Bodies += Bodies;
+		}
+		return Counts;
+	}
+
+	/** kills that many characters at once and ticks the world, physics included */
+	struct FRagdollWorld
+	{
+		FTrueFPSTestWorld TestWorld;
+		TArray<TWeakObjectPtr<ACharacter>> Characters;
+
+		/** most ragdolls and bodies simulating in any of the timed frames */
+		FSimulatingCounts MaxSimulating;
+
+		FRagdollWorld(USkeletalMesh* SkeletalMesh, UPhysicsAsset* PhysicsAsset, const int32 Kills)
+		{
+			for (int32 i = 0; i < Kills; i++)
+			{
+				Characters.Add(SpawnRagdoll(TestWorld.World, SkeletalMesh, PhysicsAsset, i));
+			}
+		}
+
+		/** seconds the timed frames took */
+		double TimeTicks()
+		{
+			// Leave the first frame's body creation out
+			TestWorld.Tick(1);
+
+			double Seconds = 0.0;
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				TestWorld.Tick(1);
+				Seconds += FPlatformTime::Seconds() - StartTime;
+
+				const FSimulatingCounts Counts = CountSimulating(Characters);
+				MaxSimulating.Ragdolls = FMath::Max(MaxSimulating.Ragdolls, Counts.Ragdolls);
+				MaxSimulating.Bodies = FMath::Max(MaxSimulating.Bodies, Counts.Bodies);
+			}
+			return Seconds;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSRagdollBudgetTest, "TrueFPS.Ragdolls.HundredKillsBudget",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSRagdollBudgetTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSRagdollTests;
+
+	USkeletalMesh* SkeletalMesh = LoadObject<USkeletalMesh>(nullptr, MannequinMeshPath);
+	UPhysicsAsset* PhysicsAsset = LoadObject<UPhysicsAsset>(nullptr, MannequinPhysicsAssetPath);
+	if (!TestNotNull(TEXT("Mannequin mesh loads"), SkeletalMesh) || !TestNotNull(TEXT("Mannequin physics asset loads"), PhysicsAsset))
+	{
+		return false;
+	}
+
+	const int32 MaxSimulated = IConsoleManager::Get().FindConsoleVariable(TEXT("TrueFPS.MaxSimulatedRagdolls"))->GetInt();
+	const int32 BodiesPerRagdoll = PhysicsAsset->SkeletalBodySetups.Num();
+
+	double BudgetSeconds;
+	{
+		FRagdollWorld BudgetWorld(SkeletalMesh, PhysicsAsset, MaxSimulated);
+		BudgetSeconds = BudgetWorld.TimeTicks();
+	}
+
+	FRagdollWorld World(SkeletalMesh, PhysicsAsset, NumKills);
+	const double KillsSeconds = World.TimeTicks();
+
+	AddInfo(FString::Printf(TEXT("%d kills x %d frames: %.3fms, %d ragdolls alone: %.3fms, at most %d ragdolls and %d bodies simulating"),
+		NumKills, NumFrames, KillsSeconds * 1000.0, MaxSimulated, BudgetSeconds * 1000.0, World.MaxSimulating.Ragdolls, World.MaxSimulating.Bodies));
+
+	TestEqual(TEXT("The budget's worth of ragdolls simulates"), World.MaxSimulating.Ragdolls, MaxSimulated);
+	TestTrue(TEXT("Simulating bodies stay within the budget"), World.MaxSimulating.Bodies <= MaxSimulated * BodiesPerRagdoll);
+
+	// None of them settled, the queued ones take the slots of the ones that go away
+	for (const TWeakObjectPtr<ACharacter>& Character : World.Characters)
+	{
+		if (Character.IsValid() && CountSimulating({Character}).Ragdolls > 0)
+		{
+			Character->Destroy();
+		}
+	}
+	TestEqual(TEXT("Removed ragdolls free their slots"), CountSimulating(World.Characters).Ragdolls, 0);
+
+	World.TestWorld.Tick(20);
+	TestEqual(TEXT("Queued ragdolls simulate once slots free up"), CountSimulating(World.Characters).Ragdolls, MaxSimulated);
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
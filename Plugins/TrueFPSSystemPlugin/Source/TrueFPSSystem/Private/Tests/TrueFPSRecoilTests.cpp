@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTypes.h"
+#include "Curves/CurveVector.h"
+#include "UObject/Package.h"
+
+namespace TrueFPSRecoilTests
+{
+	/** a kick followed by a slower recovery on every channel, with cubic keys like the recoil curves authored in the editor */
+	static UCurveVector* MakeRecoilCurve(const float Scale)
+	{
+		UCurveVector* Curve = NewObject<UCurveVector>(GetTransientPackage());
+		for (int32 Channel = 0; Channel < 3; Channel++)
+		{
+			FRichCurve& RichCurve = Curve->FloatCurves[Channel];
+			const float ChannelScale = Scale * (Channel + 1);
+			for (const FVector2f& Key : {FVector2f(0.f, 0.f), FVector2f(0.05f, 2.f), FVector2f(0.12f, -0.5f), FVector2f(0.3f, 0.f)})
+			{
+				RichCurve.SetKeyInterpMode(RichCurve.AddKey(Key.X, Key.Y * ChannelScale), RCIM_Cubic);
+			}
+			RichCurve.AutoSetTangents();
+		}
+		return Curve;
+	}
+
+	/** a looping sway like curve, each channel with its own key range and extrapolation */
+	static UCurveVector* MakeSwayCurve(const ERichCurveExtrapolation PreInfinityExtrap[3], const ERichCurveExtrapolation PostInfinityExtrap[3])
+	{
+		UCurveVector* Curve = NewObject<UCurveVector>(GetTransientPackage());
+		for (int32 Channel = 0; Channel < 3; Channel++)
+		{
+			FRichCurve& RichCurve = Curve->FloatCurves[Channel];
+			const float Period = 0.5f * (Channel + 1);
+			for (const FVector2f& Key : {FVector2f(0.f, 0.f), FVector2f(0.25f, 1.f), FVector2f(0.5f, -1.f), FVector2f(1.f, 0.f)})
+			{
+				RichCurve.SetKeyInterpMode(RichCurve.AddKey(Key.X * Period, Key.Y), RCIM_Cubic);
+			}
+			RichCurve.AutoSetTangents();
+			RichCurve.PreInfinityExtrap = PreInfinityExtrap[Channel];
+			RichCurve.PostInfinityExtrap = PostInfinityExtrap[Channel];
+		}
+		return Curve;
+	}
+
+	static float MaxSampleError(const FTrueFPSBakedCurveVector& Baked, const UCurveVector* Curve)
+	{
+		float MaxError = 0.f;
+		for (float Time = -2.f; Time <= 4.f; Time += 0.0007f)
+		{
+			MaxError = FMath::Max(MaxError, static_cast<float>(FVector::Dist(Baked.Sample(Time), Curve->GetVectorValue(Time))));
+		}
+		return MaxError;
+	}
+
+	static constexpr float SampleRate = 120.f;
+
+	/** linear interpolation of the 120Hz tables stays within this of the cubic curves */
+	static constexpr float MaxBakeError = 0.05f;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSBakedRecoilErrorTest, "TrueFPS.Recoil.BakedCurveError",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSBakedRecoilErrorTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSRecoilTests;
+
+	const FRecoilParams RecoilParams(MakeRecoilCurve(1.f), MakeRecoilCurve(0.5f));
+
+	FTrueFPSBakedRecoil BakedRecoil;
+	BakedRecoil.Bake(RecoilParams, SampleRate);
+	TestTrue(TEXT("Recoil is baked"), BakedRecoil.IsValid() && BakedRecoil.IsBakedFrom(RecoilParams, SampleRate));
+	TestEqual(TEXT("Lifetime is the location curve's last key"), BakedRecoil.Lifetime, 0.3f);
+
+	float MaxError = 0.f;
+	for (float Time = -0.05f; Time <= 0.35f; Time += 0.0007f)
+	{
+		MaxError = FMath::Max(MaxError, static_cast<float>(FVector::Dist(BakedRecoil.Location.Sample(Time), RecoilParams.LocationCurve->GetVectorValue(Time))));
+		MaxError = FMath::Max(MaxError, static_cast<float>(FVector::Dist(BakedRecoil.Rotation.Sample(Time), RecoilParams.RotationCurve->GetVectorValue(Time))));
+	}
+
+	AddInfo(FString::Printf(TEXT("Max error %f at %.0fHz"), MaxError, SampleRate));
+	TestTrue(TEXT("Baked tables stay within the error bound of the source curves"), MaxError <= MaxBakeError);
+
+	// Curves that weren't baked fall back to evaluating them
+	const FRecoilParams OtherParams(MakeRecoilCurve(2.f), MakeRecoilCurve(2.f));
+	const FRecoilInstance OtherInstance(OtherParams, &BakedRecoil);
+	FVector Rotation;
+	FVector Location;
+	OtherInstance.Sample(0.05f, Rotation, Location);
+	TestTrue(TEXT("Instances of other curves play their own curves"), Location.Equals(OtherParams.LocationCurve->GetVectorValue(0.05f)));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSBakedCurveExtrapolationTest, "TrueFPS.Recoil.BakedCurveExtrapolation",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSBakedCurveExtrapolationTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSRecoilTests;
+
+	// Channels of different lengths, cycling on one side, both or neither
+	{
+		const ERichCurveExtrapolation Pre[3] = {RCCE_Constant, RCCE_Cycle, RCCE_None};
+		const ERichCurveExtrapolation Post[3] = {RCCE_Cycle, RCCE_Cycle, RCCE_Constant};
+		const UCurveVector* Curve = MakeSwayCurve(Pre, Post);
+
+		FTrueFPSBakedCurveVector Baked;
+		Baked.Bake(Curve, SampleRate);
+		TestTrue(TEXT("Constant and cycling channels are baked"), Baked.IsBaked() && !Baked.bEvaluateSourceCurve);
+
+		const float MaxError = MaxSampleError(Baked, Curve);
+		AddInfo(FString::Printf(TEXT("Mixed cycling channels, max error %f at %.0fHz"), MaxError, SampleRate));
+		TestTrue(TEXT("Each channel extrapolates like its curve, within the error bound"), MaxError <= MaxBakeError);
+	}
+
+	// Extrapolations the tables don't reproduce evaluate the curve
+	for (const ERichCurveExtrapolation Extrapolation : {RCCE_CycleWithOffset, RCCE_Oscillate, RCCE_Linear})
+	{
+		for (const bool bPreInfinity : {false, true})
+		{
+			ERichCurveExtrapolation Pre[3] = {RCCE_Cycle, RCCE_Cycle, RCCE_Cycle};
+			ERichCurveExtrapolation Post[3] = {RCCE_Cycle, RCCE_Cycle, RCCE_Cycle};
+			(bPreInfinity ? Pre : Post)[2] = Extrapolation;
+			const UCurveVector* Curve = MakeSwayCurve(Pre, Post);
+
+			FTrueFPSBakedCurveVector Baked;
+			Baked.Bake(Curve, SampleRate);
+
+			const FString What = FString::Printf(TEXT("%s %s"), bPreInfinity ? TEXT("Pre infinity") : TEXT("Post infinity"), *UEnum::GetValueAsString(Extrapolation));
+			TestTrue(What + TEXT(" falls back to the curve"), Baked.IsValid() && Baked.bEvaluateSourceCurve);
+			TestEqual(What + TEXT(" samples exactly like the curve"), MaxSampleError(Baked, Curve), 0.f);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSRecoilRingBenchmark, "TrueFPS.Recoil.Benchmark64Instances",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSRecoilRingBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSRecoilTests;
+
+	const FRecoilParams RecoilParams(MakeRecoilCurve(1.f), MakeRecoilCurve(0.5f));
+
+	FTrueFPSBakedRecoil BakedRecoil;
+	BakedRecoil.Bake(RecoilParams, SampleRate);
+
+	FRecoilInstanceRing BakedInstances;
+	FRecoilInstanceRing CurveInstances;
+	for (int32 i = 0; i < FRecoilInstanceRing::Capacity + 8; i++)
+	{
+		FRecoilInstance Instance(RecoilParams, &BakedRecoil);
+		Instance.CurrentTime = Instance.Lifetime * i / (FRecoilInstanceRing::Capacity + 8);
+		BakedInstances.Add(Instance);
+
+		Instance.BakedRecoil = nullptr;
+		CurveInstances.Add(Instance);
+	}
+	TestEqual(TEXT("The ring keeps its capacity of instances"), BakedInstances.Num(), FRecoilInstanceRing::Capacity);
+
+	constexpr int32 NumIterations = 2000;
+	auto Run = [](const FRecoilInstanceRing& Instances)
+	{
+		FVector Sum(ForceInitToZero);
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			for (int32 i = 0; i < Instances.Num(); i++)
+			{
+				FVector Rotation;
+				FVector Location;
+				Instances[i].Sample(Instances[i].CurrentTime + Iteration * 1e-5f, Rotation, Location);
+				Sum += Rotation + Location;
+			}
+		}
+		return TPair<double, FVector>(FPlatformTime::Seconds() - StartTime, Sum);
+	};
+
+	const TPair<double, FVector> Baked = Run(BakedInstances);
+	const TPair<double, FVector> Curves = Run(CurveInstances);
+
+	AddInfo(FString::Printf(TEXT("%d instances x %d frames: baked %.3fms, curves %.3fms"), BakedInstances.Num(), NumIterations, Baked.Key * 1000.0, Curves.Key * 1000.0));
+	TestTrue(TEXT("Baked and curve sums agree"), Baked.Value.Equals(Curves.Value, NumIterations * FRecoilInstanceRing::Capacity * MaxBakeError));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Online/TrueFPSReplayIndex.h"
+
+namespace TrueFPSReplayIndexTests
+{
+	static constexpr int32 NumReplays = 1000;
+
+	/** rows the demo list adds at a time */
+	static constexpr int32 PageSize = 50;
+
+	static const FNetworkReplayVersion Version(TEXT("TrueFPSTest"), 1, 1);
+
+	static FString GetReplayFilename(const FString& DemoDirectory, const FString& StreamName)
+	{
+		return FPaths::Combine(DemoDirectory, StreamName + TEXT(".replay"));
+	}
+
+	/** replay files on disk and the streams an enumeration would have returned for them */
+	static TArray<FNetworkReplayStreamInfo> MakeReplays(const FString& DemoDirectory)
+	{
+		TArray<FNetworkReplayStreamInfo> Streams;
+		Streams.Reserve(NumReplays);
+
+		FRandomStream Random(NumReplays);
+		for (int32 i = 0; i < NumReplays; i++)
+		{
+			FNetworkReplayStreamInfo& StreamInfo = Streams.AddDefaulted_GetRef();
+			StreamInfo.Name = FString::Printf(TEXT("Replay%04d"), i);
+			StreamInfo.FriendlyName = FString::Printf(TEXT("Match %d"), i);
+			// Recorded in no particular order, ten minutes apart
+			StreamInfo.Timestamp = FDateTime(2026, 1, 1) + FTimespan::FromMinutes((i * 7919) % NumReplays * 10);
+			StreamInfo.SizeInBytes = Random.RandRange(1 << 20, 64 << 20);
+			StreamInfo.LengthInMS = Random.RandRange(60 * 1000, 30 * 60 * 1000);
+			StreamInfo.Changelist = Version.Changelist;
+
+			FFileHelper::SaveStringToFile(StreamInfo.Name, *GetReplayFilename(DemoDirectory, StreamInfo.Name));
+		}
+
+		return Streams;
+	}
+
+	/** a temp demo directory, gone when the test ends */
+	struct FScopedDemoDirectory
+	{
+		FString Path;
+
+		FScopedDemoDirectory()
+			: Path(FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ReplayIndex")))
+		{
+			IFileManager::Get().DeleteDirectory(*Path, false, true);
+			IFileManager::Get().MakeDirectory(*Path, true);
+		}
+
+		~FScopedDemoDirectory()
+		{
+			IFileManager::Get().DeleteDirectory(*Path, false, true);
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSReplayIndexTest, "TrueFPS.Replays.ReplayIndex",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSReplayIndexTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSReplayIndexTests;
+
+	const FScopedDemoDirectory DemoDirectory;
+	const TArray<FNetworkReplayStreamInfo> Streams = MakeReplays(DemoDirectory.Path);
+
+	double StartTime = FPlatformTime::Seconds();
+	const bool bSaved = FTrueFPSReplayIndex::Save(DemoDirectory.Path, Version, Streams);
+	const double SaveSeconds = FPlatformTime::Seconds() - StartTime;
+	if (!TestTrue(TEXT("The index is written"), bSaved))
+	{
+		return false;
+	}
+
+	// What the demo list does on a worker before its first page of rows goes up
+	StartTime = FPlatformTime::Seconds();
+	TArray<FTrueFPSReplayIndexEntry> Entries;
+	bool bIsStale = true;
+	const bool bLoaded = FTrueFPSReplayIndex::Load(DemoDirectory.Path, Version, Entries, bIsStale);
+	TArray<FNetworkReplayStreamInfo> FirstPage;
+	for (int32 i = 0; i < FMath::Min(PageSize, Entries.Num()); i++)
+	{
+		FirstPage.Add(Entries[i].StreamInfo);
+	}
+	const double FirstRowSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TestTrue(TEXT("The index is read"), bLoaded);
+	TestFalse(TEXT("A freshly written index is up to date"), bIsStale);
+	TestEqual(TEXT("Every replay is indexed"), Entries.Num(), NumReplays);
+	TestEqual(TEXT("The first page is full"), FirstPage.Num(), PageSize);
+
+	// Newest first, with everything the rows show
+	TArray<FNetworkReplayStreamInfo> SortedStreams = Streams;
+	SortedStreams.Sort([](const FNetworkReplayStreamInfo& A, const FNetworkReplayStreamInfo& B)
+	{
+		return A.Timestamp > B.Timestamp;
+	});
+
+	int32 NumMismatches = 0;
+	for (int32 i = 0; i < FMath::Min(Entries.Num(), SortedStreams.Num()); i++)
+	{
+		const FNetworkReplayStreamInfo& Indexed = Entries[i].StreamInfo;
+		const FNetworkReplayStreamInfo& Expected = SortedStreams[i];
+		NumMismatches += Indexed.Timestamp == Expected.Timestamp && Indexed.FriendlyName == Expected.FriendlyName && Indexed.SizeInBytes == Expected.SizeInBytes
+			&& Indexed.LengthInMS == Expected.LengthInMS && Indexed.Changelist == Expected.Changelist ? 0 : 1;
+	}
+	TestEqual(TEXT("Entries read back newest first as written"), NumMismatches, 0);
+
+	// A replay recorded since the index was written makes it stale
+	const FString NewReplayFilename = GetReplayFilename(DemoDirectory.Path, TEXT("NewReplay"));
+	FFileHelper::SaveStringToFile(FString(TEXT("NewReplay")), *NewReplayFilename);
+	Entries.Reset();
+	FTrueFPSReplayIndex::Load(DemoDirectory.Path, Version, Entries, bIsStale);
+	TestTrue(TEXT("A new replay makes the index stale"), bIsStale);
+	IFileManager::Get().Delete(*NewReplayFilename);
+
+	// So does a replay rewritten since
+	const FString& ChangedStreamName = Streams[NumReplays / 2].Name;
+	IFileManager::Get().SetTimeStamp(*GetReplayFilename(DemoDirectory.Path, ChangedStreamName), FDateTime::UtcNow() + FTimespan::FromHours(1.0));
+	Entries.Reset();
+	FTrueFPSReplayIndex::Load(DemoDirectory.Path, Version, Entries, bIsStale);
+	TestTrue(TEXT("A rewritten replay makes the index stale"), bIsStale);
+
+	// Deleting a replay takes it out of the index without making it stale
+	FTrueFPSReplayIndex::Save(DemoDirectory.Path, Version, Streams);
+	const FString& DeletedStreamName = Streams[0].Name;
+	IFileManager::Get().Delete(*GetReplayFilename(DemoDirectory.Path, DeletedStreamName));
+	FTrueFPSReplayIndex::Remove(DemoDirectory.Path, DeletedStreamName);
+
+	Entries.Reset();
+	FTrueFPSReplayIndex::Load(DemoDirectory.Path, Version, Entries, bIsStale);
+	TestFalse(TEXT("Deleting a replay keeps the index up to date"), bIsStale);
+	TestEqual(TEXT("The deleted replay is no longer indexed"), Entries.Num(), NumReplays - 1);
+	TestFalse(TEXT("The deleted replay isn't listed"), Entries.ContainsByPredicate([&DeletedStreamName](const FTrueFPSReplayIndexEntry& Entry)
+	{
+		return Entry.StreamInfo.Name == DeletedStreamName;
+	}));
+
+	AddInfo(FString::Printf(TEXT("%d replays: index written in %.2fms, first row after %.2fms"), NumReplays, SaveSeconds * 1000.0, FirstRowSeconds * 1000.0));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OnlineSessionSettings.h"
+#include "OnlineSubsystemNames.h"
+#include "OnlineSubsystemTypes.h"
+#include "UI/Menu/Widgets/STrueFPSServerList.h"
+
+namespace TrueFPSServerListTests
+{
+	static constexpr int32 NumResults = 5000;
+
+	/** every how many results one changes between two searches */
+	static constexpr int32 ChangedResultInterval = 20;
+
+	static const TCHAR* MapNames[] = {
+		TEXT("Killhouse2"),
+		TEXT("Weapons_Showcase"),
+		TEXT("Welcome"),
+		TEXT("Highrise"),
+	};
+
+	/** session info of a synthetic search result, only its id is used by the server list */
+	class FTestSessionInfo : public FOnlineSessionInfo
+	{
+	public:
+
+		explicit FTestSessionInfo(const FString& InSessionId)
+			: SessionId(FUniqueNetIdString::Create(InSessionId, NULL_SUBSYSTEM))
+		{
+		}
+
+		virtual const uint8* GetBytes() const override { return nullptr; }
+		virtual int32 GetSize() const override { return sizeof(FTestSessionInfo); }
+		virtual bool IsValid() const override { return true; }
+		virtual const FUniqueNetId& GetSessionId() const override { return *SessionId; }
+		virtual FString ToString() const override { return SessionId->ToString(); }
+		virtual FString ToDebugString() const override { return SessionId->ToString(); }
+
+	private:
+
+		FUniqueNetIdStringRef SessionId;
+	};
+
+	/** what a search over that many servers finds, the ping of every ChangedResultInterval-th server offset by PingOffset */
+	static TArray<FOnlineSessionSearchResult> MakeSearchResults(const int32 Num, const int32 PingOffset)
+	{
+		TArray<FOnlineSessionSearchResult> SearchResults;
+		SearchResults.SetNum(Num);
+
+		for (int32 i = 0; i < Num; i++)
+		{
+			FOnlineSessionSearchResult& Result = SearchResults[i];
+			Result.PingInMs = (i * 37) % 300 + (i % ChangedResultInterval == 0 ? PingOffset : 0);
+			Result.Session.OwningUserId = FUniqueNetIdString::Create(FString::Printf(TEXT("Owner%d"), i), NULL_SUBSYSTEM);
+			Result.Session.OwningUserName = FString::Printf(TEXT("Owner%d"), i);
+			Result.Session.SessionInfo = MakeShared<FTestSessionInfo>(FString::Printf(TEXT("Session%d"), i));
+			Result.Session.SessionSettings.NumPublicConnections = 16;
+			Result.Session.NumOpenPublicConnections = i % 17;
+			Result.Session.SessionSettings.Set(SETTING_GAMEMODE, FString(TEXT("FFA")), EOnlineDataAdvertisementType::ViaOnlineService);
+			Result.Session.SessionSettings.Set(SETTING_MAPNAME, FString(MapNames[i % UE_ARRAY_COUNT(MapNames)]), EOnlineDataAdvertisementType::ViaOnlineService);
+		}
+
+		return SearchResults;
+	}
+
+	/** the list as it was filtered before, removing one server at a time */
+	static void FilterServersOneByOne(TArray< TSharedPtr<FServerEntry> >& Servers, const FString& InMapFilterName)
+	{
+		for (int32 i = 0; i < Servers.Num(); ++i)
+		{
+			if (Servers[i]->MapName != InMapFilterName)
+			{
+				Servers.RemoveAt(i);
+				i--;
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSServerListMergeAndFilterTest, "TrueFPS.UI.ServerListMergeAndFilter",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSServerListMergeAndFilterTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSServerListTests;
+
+	const TArray<FOnlineSessionSearchResult> FirstResults = MakeSearchResults(NumResults, 0);
+	const TArray<FOnlineSessionSearchResult> RefreshedResults = MakeSearchResults(NumResults, 1);
+
+	// The first search lists every server
+	TMap< FString, TSharedPtr<FServerEntry> > Entries;
+	double StartTime = FPlatformTime::Seconds();
+	STrueFPSServerList::MergeSearchResults(FirstResults, Entries);
+	const double FirstMergeSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Every server is listed"), Entries.Num(), NumResults);
+
+	// Refreshing keeps the entries, and with them the rows, of servers that didn't change
+	const TMap< FString, TSharedPtr<FServerEntry> > FirstEntries = Entries;
+	StartTime = FPlatformTime::Seconds();
+	STrueFPSServerList::MergeSearchResults(RefreshedResults, Entries);
+	const double RefreshMergeSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Every server is still listed after refreshing"), Entries.Num(), NumResults);
+
+	int32 NumKeptEntries = 0;
+	int32 NumNewEntries = 0;
+	for (const TPair< FString, TSharedPtr<FServerEntry> >& Entry : Entries)
+	{
+		const TSharedPtr<FServerEntry>* FirstEntry = FirstEntries.Find(Entry.Key);
+		if (FirstEntry && *FirstEntry == Entry.Value)
+		{
+			NumKeptEntries++;
+		}
+		else
+		{
+			NumNewEntries++;
+		}
+	}
+
+	const int32 NumChangedResults = NumResults / ChangedResultInterval;
+	TestEqual(TEXT("Only changed servers get new entries"), NumNewEntries, NumChangedResults);
+	TestEqual(TEXT("Unchanged servers keep their entries"), NumKeptEntries, NumResults - NumChangedResults);
+
+	// Filtering and sorting, what the worker does
+	const FString MapFilterName = MapNames[1];
+	TArray< TSharedPtr<FServerEntry> > Servers;
+	Entries.GenerateValueArray(Servers);
+
+	TArray< TSharedPtr<FServerEntry> > ServersOneByOne = Servers;
+	StartTime = FPlatformTime::Seconds();
+	FilterServersOneByOne(ServersOneByOne, MapFilterName);
+	const double OneByOneFilterSeconds = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	STrueFPSServerList::FilterAndSortServers(Servers, MapFilterName, "Ping", EColumnSortMode::Ascending);
+	const double FilterSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Filtering keeps the servers the previous filter kept"), Servers.Num(), ServersOneByOne.Num());
+	TestTrue(TEXT("Only servers running the map are listed"), Servers.Num() > 0 && !Servers.ContainsByPredicate([&MapFilterName](const TSharedPtr<FServerEntry>& Server)
+	{
+		return Server->MapName != MapFilterName;
+	}));
+
+	bool bSortedByPing = true;
+	for (int32 i = 1; i < Servers.Num(); i++)
+	{
+		bSortedByPing &= Servers[i - 1]->PingInMs <= Servers[i]->PingInMs;
+	}
+	TestTrue(TEXT("Servers are sorted by ping"), bSortedByPing);
+
+	TArray< TSharedPtr<FServerEntry> > ServersByPlayers;
+	Entries.GenerateValueArray(ServersByPlayers);
+	STrueFPSServerList::FilterAndSortServers(ServersByPlayers, TEXT("Any"), "Players", EColumnSortMode::Descending);
+
+	bool bSortedByPlayers = ServersByPlayers.Num() == NumResults;
+	for (int32 i = 1; i < ServersByPlayers.Num(); i++)
+	{
+		bSortedByPlayers &= ServersByPlayers[i - 1]->NumPlayers >= ServersByPlayers[i]->NumPlayers;
+	}
+	TestTrue(TEXT("Any map lists every server, sorted by players"), bSortedByPlayers);
+
+	AddInfo(FString::Printf(TEXT("%d results: first merge %.2fms, refresh merge %.2fms, filter and sort %.2fms (one by one filter %.2fms)"),
+		NumResults, FirstMergeSeconds * 1000.0, RefreshMergeSeconds * 1000.0, FilterSeconds * 1000.0, OneByOneFilterSeconds * 1000.0));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestWorld.h"
+#include "TrueFPSTestSightsAttachment.h"
+#include "UObject/CoreNet.h"
+#include "Weapons/TrueFPSWeaponBase.h"
+
+namespace TrueFPSSightsReplicationTests
+{
+	static const TCHAR* WeaponClassPath = TEXT("/TrueFPSSystemPlugin/Weapons/Pistol/BP_WeaponInstant_Pistol.BP_WeaponInstant_Pistol_C");
+
+	/** sights attachment points, named out of order so the index has to come from the sorted names */
+	struct FSightsPointDesc
+	{
+		const TCHAR* Name;
+		FVector Location;
+		float AimOffset;
+	};
+
+	static const FSightsPointDesc SightsPoints[] = {
+		{TEXT("SightsPoint_B"), FVector(5.f, 0.f, 9.f), 0.f},
+		{TEXT("SightsPoint_C"), FVector(12.f, 0.f, 11.5f), 4.f},
+		{TEXT("SightsPoint_A"), FVector(2.f, 0.5f, 8.f), 1.5f},
+	};
+
+	/** sights toggles per second of each player, and remote connections each toggle is sent to */
+	static constexpr float TogglesPerSecond = 1.f;
+	static constexpr int32 NumRemoteConnections = 63;
+
+	static ATrueFPSWeaponBase* SpawnWeaponWithSights(UWorld* World, UClass* WeaponClass, const bool bReverseOrder)
+	{
+		ATrueFPSWeaponBase* Weapon = World->SpawnActor<ATrueFPSWeaponBase>(WeaponClass, FTransform::Identity);
+
+		const int32 Num = UE_ARRAY_COUNT(SightsPoints);
+		for (int32 i = 0; i < Num; i++)
+		{
+			const FSightsPointDesc& Desc = SightsPoints[bReverseOrder ? Num - 1 - i : i];
+
+			UTrueFPSSightsAttachmentPoint* Point = NewObject<UTrueFPSSightsAttachmentPoint>(Weapon, Desc.Name);
+			Point->AimOffset = Desc.AimOffset;
+			Point->SetupAttachment(Weapon->GetRootComponent());
+			Point->SetRelativeLocation(Desc.Location);
+			Point->RegisterComponent();
+			Point->SpawnAttachment(ATrueFPSTestSightsAttachment::StaticClass());
+		}
+		return Weapon;
+	}
+
+	template<typename T>
+	static T& GetProperty(ATrueFPSWeaponBase* Weapon, const TCHAR* Name)
+	{
+		return *FindFProperty<FProperty>(ATrueFPSWeaponBase::StaticClass(), Name)->ContainerPtrToValuePtr<T>(Weapon);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSSightsReplicationTest, "TrueFPS.Weapons.SightsReplicationRoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSSightsReplicationTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSSightsReplicationTests;
+
+	UClass* WeaponClass = LoadClass<ATrueFPSWeaponBase>(nullptr, WeaponClassPath);
+	if (!TestNotNull(TEXT("Weapon class loads"), WeaponClass))
+	{
+		return false;
+	}
+
+	const FTrueFPSTestWorld TestWorld;
+	ATrueFPSWeaponBase* ServerWeapon = SpawnWeaponWithSights(TestWorld.World, WeaponClass, false);
+	ATrueFPSWeaponBase* RemoteWeapon = SpawnWeaponWithSights(TestWorld.World, WeaponClass, true);
+	RemoteWeapon->SetRole(ROLE_SimulatedProxy);
+
+	TArray<ATrueFPSSightsAttachment*> ServerSights;
+	ServerWeapon->GetSightsAttachments(ServerSights);
+	if (!TestEqual(TEXT("Every sights attachment spawned"), ServerSights.Num(), static_cast<int32>(UE_ARRAY_COUNT(SightsPoints))))
+	{
+		return false;
+	}
+
+	// Changed on the server after spawning, the remote only knows the attachment point's value
+	ServerSights.Last()->AimOffset = 2.7f;
+
+	UFunction* OnRepSights = RemoteWeapon->FindFunctionChecked(TEXT("OnRep_ReplicatedSights"));
+	int32 MaxBits = 0;
+
+	// Cycles through every sights and back to the default ones
+	for (int32 Toggle = 0; Toggle <= ServerSights.Num(); Toggle++)
+	{
+		ServerWeapon->ToggleSights();
+
+		FNetBitWriter Writer(nullptr, 256);
+		bool bSuccess = false;
+		GetProperty<FTrueFPSReplicatedSights>(ServerWeapon, TEXT("ReplicatedSights")).NetSerialize(Writer, nullptr, bSuccess);
+		MaxBits = FMath::Max(MaxBits, static_cast<int32>(Writer.GetNumBits()));
+
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		GetProperty<FTrueFPSReplicatedSights>(RemoteWeapon, TEXT("ReplicatedSights")).NetSerialize(Reader, nullptr, bSuccess);
+		RemoteWeapon->ProcessEvent(OnRepSights, nullptr);
+
+		const FString What = FString::Printf(TEXT("Toggle %d"), Toggle);
+		TestTrue(What + TEXT(" reads back everything it wrote"), bSuccess && !Reader.IsError() && Reader.AtEnd());
+		TestEqual(What + TEXT(" resolves the same sights"), RemoteWeapon->GetState().CurrentSights.IsValid(), ServerWeapon->GetState().CurrentSights.IsValid());
+
+		const FTransform& ServerTransform = GetProperty<FTransform>(ServerWeapon, TEXT("TargetSightsRelativeTransform"));
+		const FTransform& RemoteTransform = GetProperty<FTransform>(RemoteWeapon, TEXT("TargetSightsRelativeTransform"));
+		TestTrue(What + TEXT(" reconstructs the server's sights transform"), RemoteTransform.Equals(ServerTransform, 0.05));
+	}
+
+	// What every sights change cost before, the full transform
+	FNetBitWriter TransformWriter(nullptr, 1024);
+	FTransform Transform = FTransform::Identity;
+	TransformWriter << Transform;
+
+	const double CompactBytesPerSecond = MaxBits / 8.0 * TogglesPerSecond * NumRemoteConnections;
+	const double TransformBytesPerSecond = TransformWriter.GetNumBits() / 8.0 * TogglesPerSecond * NumRemoteConnections;
+	AddInfo(FString::Printf(TEXT("Sights change: %d bits, transform %d bits. Per player at %.0f toggle/s to %d connections: %.1f B/s, was %.1f B/s"),
+		MaxBits, static_cast<int32>(TransformWriter.GetNumBits()), TogglesPerSecond, NumRemoteConnections, CompactBytesPerSecond, TransformBytesPerSecond));
+	TestTrue(TEXT("A sights change fits in 4 bytes"), MaxBits <= 32);
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
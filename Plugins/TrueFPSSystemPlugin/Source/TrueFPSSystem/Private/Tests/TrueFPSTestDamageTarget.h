@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "GameFramework/Pawn.h"
+#include "TrueFPSTestDamageTarget.generated.h"
+
+/** pawn for the automation tests that blocks visibility and records the damage it takes */
+UCLASS(NotBlueprintable, NotPlaceable, HideDropdown, Transient)
+class ATrueFPSTestDamageTarget : public APawn
+{
+	GENERATED_BODY()
+
+public:
+
+	ATrueFPSTestDamageTarget(const FObjectInitializer& ObjectInitializer)
+		: Super(ObjectInitializer)
+	{
+		UCapsuleComponent* Capsule = CreateDefaultSubobject<UCapsuleComponent>(TEXT("Capsule"));
+		Capsule->InitCapsuleSize(34.f, 88.f);
+		Capsule->SetCollisionProfileName(UCollisionProfile::BlockAllDynamic_ProfileName);
+		RootComponent = Capsule;
+	}
+
+	/** damage taken since the last reset, after falloff */
+	float DamageTaken = 0.f;
+
+	/** damage events received since the last reset */
+	int32 NumDamageEvents = 0;
+
+	void ResetDamage()
+	{
+		DamageTaken = 0.f;
+		NumDamageEvents = 0;
+	}
+
+	virtual float TakeDamage(float Damage, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override
+	{
+		const float ActualDamage = Super::TakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser);
+		DamageTaken += ActualDamage;
+		NumDamageEvents++;
+		return ActualDamage;
+	}
+};
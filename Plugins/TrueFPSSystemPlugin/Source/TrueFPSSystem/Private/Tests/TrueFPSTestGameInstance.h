@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrueFPSGameInstance.h"
+#include "TrueFPSTestGameInstance.generated.h"
+
+/** game instance for the automation tests, records its state machine instead of loading maps and building menus */
+UCLASS(NotBlueprintable, Transient)
+class UTrueFPSTestGameInstance : public UTrueFPSGameInstance
+{
+	GENERATED_BODY()
+
+public:
+
+	struct FTransition
+	{
+		FName PrevState;
+		FName NewState;
+
+		/** the test's frame the state was entered on */
+		int32 Frame;
+	};
+
+	TArray<FTransition> Transitions;
+
+	/** frame the test is simulating, stamped on transitions */
+	int32 Frame = 0;
+
+	/** state machine updates run so far, whether for an event or the watchdog */
+	int32 NumStateUpdates = 0;
+
+	UTrueFPSTestGameInstance(const FObjectInitializer& ObjectInitializer)
+		: Super(ObjectInitializer)
+	{
+	}
+
+	/** replaces the queue end of match reports go through, nullptr writes them right away */
+	void SetMatchReportQueue(const TSharedPtr<class FTrueFPSMatchReportQueue>& InMatchReportQueue)
+	{
+		MatchReportQueue = InMatchReportQueue;
+	}
+
+protected:
+
+	virtual void UpdateState() override
+	{
+		NumStateUpdates++;
+		Super::UpdateState();
+	}
+
+	virtual void EndCurrentState(FName NextState) override
+	{
+	}
+
+	virtual void BeginNewState(FName NewState, FName PrevState) override
+	{
+		Transitions.Add({PrevState, NewState, Frame});
+	}
+};
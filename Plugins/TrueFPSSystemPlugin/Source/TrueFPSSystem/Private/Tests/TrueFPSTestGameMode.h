@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Online/TrueFPSGameMode.h"
+#include "TrueFPSTestGameMode.generated.h"
+
+/** game mode for the automation tests, with its config driven damage rules set by the test and an overridden CanDealDamage */
+UCLASS(NotBlueprintable, NotPlaceable, HideDropdown, Transient)
+class ATrueFPSTestGameMode : public ATrueFPSGameMode
+{
+	GENERATED_BODY()
+
+public:
+
+	ATrueFPSTestGameMode(const FObjectInitializer& ObjectInitializer)
+		: Super(ObjectInitializer)
+	{
+		DamageSelfScale = 1.f;
+	}
+
+	/** players of this team deal no damage to anyone, INDEX_NONE for none */
+	int32 PacifistTeamNum = INDEX_NONE;
+
+	void SetDamageRules(const bool bInAllowFriendlyFire, const float InDamageSelfScale)
+	{
+		bAllowFriendlyFire = bInAllowFriendlyFire;
+		DamageSelfScale = InDamageSelfScale;
+	}
+
+	void SetMaxPooledWeaponsPerClass(const int32 InMaxPooledWeaponsPerClass)
+	{
+		MaxPooledWeaponsPerClass = InMaxPooledWeaponsPerClass;
+	}
+
+	virtual bool CanDealDamage(const int32 InstigatorTeamNum, const int32 DamagedTeamNum) const override
+	{
+		return (PacifistTeamNum == INDEX_NONE || InstigatorTeamNum != PacifistTeamNum) && Super::CanDealDamage(InstigatorTeamNum, DamagedTeamNum);
+	}
+};
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Online/TrueFPSGameState.h"
+#include "TrueFPSTestGameState.generated.h"
+
+/** game state for the automation tests, recording the kill feed entries it shows */
+UCLASS(NotBlueprintable, NotPlaceable, HideDropdown, Transient)
+class ATrueFPSTestGameState : public ATrueFPSGameState
+{
+	GENERATED_BODY()
+
+public:
+
+	ATrueFPSTestGameState(const FObjectInitializer& ObjectInitializer)
+		: Super(ObjectInitializer)
+	{
+	}
+
+	/** kill feed entries shown, in the order they were */
+	TArray<FTrueFPSKillFeedEntry> ShownKills;
+
+	FTrueFPSKillFeed& GetKillFeed()
+	{
+		return KillFeed;
+	}
+
+protected:
+
+	virtual void ShowKill(const FTrueFPSKillFeedEntry& Entry) override
+	{
+		ShownKills.Add(Entry);
+		Super::ShowKill(Entry);
+	}
+};
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Character/TrueFPSLocalPlayer.h"
+#include "Character/TrueFPSPersistentUser.h"
+#include "TrueFPSTestLocalPlayer.generated.h"
+
+/** local player for the automation tests, saving to a slot of its own instead of the real player's save game */
+UCLASS(NotBlueprintable, Transient)
+class UTrueFPSTestLocalPlayer : public UTrueFPSLocalPlayer
+{
+	GENERATED_BODY()
+
+public:
+
+	UTrueFPSTestLocalPlayer(const FObjectInitializer& ObjectInitializer)
+		: Super(ObjectInitializer)
+	{
+	}
+
+	/** loads, or creates, the persistent user saved in the given slot */
+	void LoadTestPersistentUser(const FString& SlotName)
+	{
+		PersistentUser = UTrueFPSPersistentUser::LoadPersistentUser(SlotName, 0);
+	}
+};
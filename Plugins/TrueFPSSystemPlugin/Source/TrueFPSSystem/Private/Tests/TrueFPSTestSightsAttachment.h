@@ -0,0 +1,14 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Weapons/Attachments/TrueFPSSightsAttachment.h"
+#include "TrueFPSTestSightsAttachment.generated.h"
+
+/** concrete sights for the automation tests, the shipped sights are all blueprints */
+UCLASS(NotBlueprintable, NotPlaceable, HideDropdown, Transient)
+class ATrueFPSTestSightsAttachment : public ATrueFPSSightsAttachment
+{
+	GENERATED_BODY()
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Weapons/TrueFPSWeaponBase.h"
+#include "TrueFPSTestTickWeapon.generated.h"
+
+/** weapon for the automation tests that records its ticks, the shipped weapons are all blueprints */
+UCLASS(NotBlueprintable, NotPlaceable, HideDropdown, Transient)
+class ATrueFPSTestTickWeapon : public ATrueFPSWeaponBase
+{
+	GENERATED_BODY()
+
+public:
+
+	struct FTickRecord
+	{
+		const ATrueFPSTestTickWeapon* Weapon;
+
+		/** the group the world was ticking when the weapon ticked */
+		ETickingGroup TickGroup;
+
+		float DeltaTime;
+	};
+
+	/** ticks of every weapon sharing it, in the order they ran */
+	TArray<FTickRecord>* TickLog{nullptr};
+
+	/** settings taken from a shipped weapon, set before BeginPlay checks them */
+	void SetSettings(UTrueFPSWeaponSettings* NewSettings)
+	{
+		Settings = NewSettings;
+	}
+
+	virtual void TickAttached(const float DeltaTime) override
+	{
+		if (TickLog)
+		{
+			TickLog->Add({this, GetWorld()->TickGroup, DeltaTime});
+		}
+
+		Super::TickAttached(DeltaTime);
+	}
+
+protected:
+
+	virtual void FireWeapon() override
+	{
+	}
+};
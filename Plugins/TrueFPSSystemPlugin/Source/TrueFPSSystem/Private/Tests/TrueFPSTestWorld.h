@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+
+/** game world that has begun play without a map, for tests that spawn and tick actors headless */
+struct FTrueFPSTestWorld
+{
+	UWorld* World{nullptr};
+
+	FTrueFPSTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	~FTrueFPSTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	FTrueFPSTestWorld(const FTrueFPSTestWorld&) = delete;
+	FTrueFPSTestWorld& operator=(const FTrueFPSTestWorld&) = delete;
+
+	/** spawns the world's authority game mode, which worlds without a map don't have */
+	template <typename T>
+	T* SpawnGameMode(UClass* GameModeClass = T::StaticClass()) const
+	{
+		T* GameMode = World->SpawnActor<T>(GameModeClass);
+		World->AuthorityGameMode = GameMode;
+		return GameMode;
+	}
+
+	/** ticks the whole world, timers included, at a fixed frame time */
+	void Tick(const int32 NumFrames, const float DeltaTime = 1.f / 60.f) const
+	{
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+	}
+};
+
+/** game instance initialized standalone with its own game world, using the default online subsystem */
+template <typename T>
+struct TTrueFPSTestGameInstance
+{
+	T* GameInstance{nullptr};
+	UWorld* World{nullptr};
+
+	TTrueFPSTestGameInstance()
+	{
+		GameInstance = NewObject<T>(GEngine);
+		GameInstance->AddToRoot();
+		GameInstance->InitializeStandalone();
+		World = GameInstance->GetWorld();
+	}
+
+	~TTrueFPSTestGameInstance()
+	{
+		GameInstance->Shutdown();
+		GameInstance->RemoveFromRoot();
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	TTrueFPSTestGameInstance(const TTrueFPSTestGameInstance&) = delete;
+	TTrueFPSTestGameInstance& operator=(const TTrueFPSTestGameInstance&) = delete;
+};
+
+/** TrueFPS.BatchedTick for the actors spawned in its scope */
+struct FScopedBatchedTick
+{
+	IConsoleVariable* CVar;
+	bool bPrevious;
+
+	explicit FScopedBatchedTick(const bool bBatchedTick)
+		: CVar(IConsoleManager::Get().FindConsoleVariable(TEXT("TrueFPS.BatchedTick")))
+		, bPrevious(CVar->GetBool())
+	{
+		CVar->Set(bBatchedTick);
+	}
+
+	~FScopedBatchedTick()
+	{
+		CVar->Set(bPrevious);
+	}
+};
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestWorld.h"
+#include "TrueFPSTestTickWeapon.h"
+#include "Character/TrueFPSCharacter.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Weapons/TrueFPSWeaponBase.h"
+
+namespace TrueFPSTickManagerTests
+{
+	static const TCHAR* WeaponClassPath = TEXT("/TrueFPSSystemPlugin/Weapons/Pistol/BP_WeaponInstant_Pistol.BP_WeaponInstant_Pistol_C");
+	static const TCHAR* CharacterClassPath = TEXT("/TrueFPSSystemPlugin/Characters/BP_TrueFPSCharacter.BP_TrueFPSCharacter_C");
+
+	static constexpr int32 NumWeapons = 256;
+	static constexpr int32 NumFrames = 300;
+
+	/** seconds the world takes to tick equipped weapons, ticked by the tick manager or by their own actor tick */
+	static double TimeWeaponTicks(UClass* WeaponClass, const bool bBatchedTick)
+	{
+		const FScopedBatchedTick BatchedTick(bBatchedTick);
+		const FTrueFPSTestWorld TestWorld;
+
+		for (int32 i = 0; i < NumWeapons; i++)
+		{
+			ATrueFPSWeaponBase* Weapon = TestWorld.World->SpawnActor<ATrueFPSWeaponBase>(WeaponClass, FTransform(FVector(i * 100.0, 0.0, 0.0)));
+			Weapon->OnEquip(nullptr);
+		}
+
+		// Leave the first frames' tick registration and allocations out
+		TestWorld.Tick(10);
+
+		const double StartTime = FPlatformTime::Seconds();
+		TestWorld.Tick(NumFrames);
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	/** tick groups and time dilations the order test spreads its actors over, every pair of them */
+	static const ETickingGroup TickGroups[] = {TG_PrePhysics, TG_PostPhysics, TG_PostUpdateWork};
+	static const float TimeDilations[] = {1.f, 0.5f, 2.f};
+	static constexpr int32 NumActorsPerPair = 4;
+	static constexpr int32 NumOrderFrames = 60;
+
+	/** spawns the actor with its tick group and time dilation set before it begins play and registers its tick */
+	template <typename T>
+	static T* SpawnTicking(UWorld* World, UClass* Class, const FTransform& Transform, const ETickingGroup TickGroup, const float TimeDilation, TFunctionRef<void(T*)> Setup)
+	{
+		T* Actor = World->SpawnActorDeferred<T>(Class, Transform);
+		Actor->PrimaryActorTick.TickGroup = TickGroup;
+		Actor->CustomTimeDilation = TimeDilation;
+		Setup(Actor);
+		Actor->FinishSpawning(Transform);
+		return Actor;
+	}
+
+	/** the character's crouch target is protected, set through reflection and its OnRep the way a client receives it */
+	static void SetCrouchTarget(ATrueFPSCharacter* Character, const float Target)
+	{
+		*FindFProperty<FProperty>(ATrueFPSCharacter::StaticClass(), TEXT("CrouchValueTarget"))->ContainerPtrToValuePtr<float>(Character) = Target;
+		Character->ProcessEvent(Character->FindFunctionChecked(TEXT("OnRep_CrouchValueTarget")), nullptr);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSTickManagerBenchmark, "TrueFPS.TickManager.BenchmarkBatchedTick",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSTickManagerBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSTickManagerTests;
+
+	UClass* WeaponClass = LoadClass<ATrueFPSWeaponBase>(nullptr, WeaponClassPath);
+	if (!TestNotNull(TEXT("Weapon class loads"), WeaponClass))
+	{
+		return false;
+	}
+
+	const double PerActor = TimeWeaponTicks(WeaponClass, false);
+	const double Batched = TimeWeaponTicks(WeaponClass, true);
+
+	AddInfo(FString::Printf(TEXT("%d weapons x %d frames: batched %.3fms, per actor %.3fms"), NumWeapons, NumFrames, Batched * 1000.0, PerActor * 1000.0));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSTickManagerSettlingTest, "TrueFPS.TickManager.UnequippedWeaponsSettleRecoil",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSTickManagerSettlingTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSTickManagerTests;
+
+	UClass* WeaponClass = LoadClass<ATrueFPSWeaponBase>(nullptr, WeaponClassPath);
+	if (!TestNotNull(TEXT("Weapon class loads"), WeaponClass))
+	{
+		return false;
+	}
+
+	const FScopedBatchedTick BatchedTick(true);
+	const FTrueFPSTestWorld TestWorld;
+
+	ATrueFPSWeaponBase* Weapon = TestWorld.World->SpawnActor<ATrueFPSWeaponBase>(WeaponClass, FTransform::Identity);
+	Weapon->OnEquip(nullptr);
+	TestWorld.Tick(1);
+
+	// Switched away from right after a shot, both recoil modes have half a second left to play
+	Weapon->OnUnEquip();
+	FRecoilInstance Recoil;
+	Recoil.Lifetime = 0.5f;
+	Weapon->GetState().CurrentRecoilInstance = Recoil;
+	Weapon->GetState().RecoilInstances.Add(Recoil);
+
+	TestFalse(TEXT("Weapon is unequipped"), Weapon->IsAttachedToPawn());
+	TestTrue(TEXT("Recoil is settling"), Weapon->IsRecoilSettling());
+
+	TestWorld.Tick(6);
+	const FTrueFPSWeaponState& State = Weapon->GetState();
+	const bool bRecoilAdvanced = State.CurrentRecoilInstance.CurrentTime > 0.f || (State.RecoilInstances.Num() > 0 && State.RecoilInstances[0].CurrentTime > 0.f);
+	TestTrue(TEXT("The tick manager keeps ticking the unequipped weapon's recoil"), bRecoilAdvanced && Weapon->IsRecoilSettling());
+
+	TestWorld.Tick(40);
+	TestFalse(TEXT("Recoil settles once its lifetime is over"), Weapon->IsRecoilSettling());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSTickManagerOrderTest, "TrueFPS.TickManager.TicksOncePerFrameInGroupOrder",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSTickManagerOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSTickManagerTests;
+
+	UClass* WeaponClass = LoadClass<ATrueFPSWeaponBase>(nullptr, WeaponClassPath);
+	UClass* CharacterClass = LoadClass<ATrueFPSCharacter>(nullptr, CharacterClassPath);
+	if (!TestNotNull(TEXT("Weapon class loads"), WeaponClass) || !TestNotNull(TEXT("Character class loads"), CharacterClass))
+	{
+		return false;
+	}
+	UTrueFPSWeaponSettings* WeaponSettings = WeaponClass->GetDefaultObject<ATrueFPSWeaponBase>()->GetSettings();
+
+	// The tick manager has to tick every actor like its own actor tick does
+	for (const bool bBatchedTick : {false, true})
+	{
+		const FScopedBatchedTick BatchedTick(bBatchedTick);
+		const FTrueFPSTestWorld TestWorld;
+		const TCHAR* TickName = bBatchedTick ? TEXT("tick manager") : TEXT("actor tick");
+
+		TArray<ATrueFPSTestTickWeapon::FTickRecord> TickLog;
+		TArray<ATrueFPSTestTickWeapon*> Weapons;
+		TArray<ATrueFPSCharacter*> Characters;
+		for (const ETickingGroup TickGroup : TickGroups)
+		{
+			for (const float TimeDilation : TimeDilations)
+			{
+				for (int32 i = 0; i < NumActorsPerPair; i++)
+				{
+					const double X = Weapons.Num() * 200.0;
+					ATrueFPSTestTickWeapon* Weapon = SpawnTicking<ATrueFPSTestTickWeapon>(TestWorld.World, ATrueFPSTestTickWeapon::StaticClass(), FTransform(FVector(X, 0.0, 100.0)), TickGroup, TimeDilation,
+						[WeaponSettings, &TickLog](ATrueFPSTestTickWeapon* NewWeapon)
+						{
+							NewWeapon->SetSettings(WeaponSettings);
+							NewWeapon->TickLog = &TickLog;
+						});
+					Weapon->OnEquip(nullptr);
+					Weapons.Add(Weapon);
+
+					Characters.Add(SpawnTicking<ATrueFPSCharacter>(TestWorld.World, CharacterClass, FTransform(FVector(X, 500.0, 100.0)), TickGroup, TimeDilation,
+						[](ATrueFPSCharacter*) {}));
+				}
+			}
+		}
+		TestWorld.Tick(1);
+
+		// Characters crouching tick as long as the test, each refresh moves them one dilated frame closer
+		TArray<float> ReferenceCrouch;
+		for (ATrueFPSCharacter* Character : Characters)
+		{
+			SetCrouchTarget(Character, 1.f);
+			ReferenceCrouch.Add(ITrueFPSCharacterInterface::Execute_TrueFPSInterface_GetCrouchValue(Character));
+		}
+
+		int32 NumMissedTicks = 0;
+		int32 NumExtraTicks = 0;
+		int32 NumWrongGroups = 0;
+		int32 NumOutOfOrder = 0;
+		int32 NumWrongDeltaTimes = 0;
+		float MaxCrouchDifference = 0.f;
+		for (int32 Frame = 0; Frame < NumOrderFrames; Frame++)
+		{
+			const float DeltaTime = 1.f / 60.f;
+			TickLog.Reset();
+			TestWorld.Tick(1, DeltaTime);
+
+			TMap<const ATrueFPSTestTickWeapon*, int32> NumTicks;
+			for (int32 Index = 0; Index < TickLog.Num(); Index++)
+			{
+				const ATrueFPSTestTickWeapon::FTickRecord& Record = TickLog[Index];
+				NumTicks.FindOrAdd(Record.Weapon)++;
+				NumWrongGroups += Record.TickGroup != Record.Weapon->PrimaryActorTick.TickGroup ? 1 : 0;
+				NumOutOfOrder += Index > 0 && Record.TickGroup < TickLog[Index - 1].TickGroup ? 1 : 0;
+				NumWrongDeltaTimes += !FMath::IsNearlyEqual(Record.DeltaTime, DeltaTime * Record.Weapon->CustomTimeDilation) ? 1 : 0;
+			}
+			for (const ATrueFPSTestTickWeapon* Weapon : Weapons)
+			{
+				const int32 WeaponTicks = NumTicks.FindRef(Weapon);
+				NumMissedTicks += WeaponTicks == 0 ? 1 : 0;
+				NumExtraTicks += FMath::Max(WeaponTicks - 1, 0);
+			}
+
+			for (int32 Index = 0; Index < Characters.Num(); Index++)
+			{
+				ReferenceCrouch[Index] = UKismetMathLibrary::FInterpTo(ReferenceCrouch[Index], 1.f, DeltaTime * Characters[Index]->CustomTimeDilation, 8.f);
+				const float CrouchValue = ITrueFPSCharacterInterface::Execute_TrueFPSInterface_GetCrouchValue(Characters[Index]);
+				MaxCrouchDifference = FMath::Max(MaxCrouchDifference, FMath::Abs(CrouchValue - ReferenceCrouch[Index]));
+			}
+		}
+
+		TestEqual(FString::Printf(TEXT("Weapon frames missed by the %s"), TickName), NumMissedTicks, 0);
+		TestEqual(FString::Printf(TEXT("Weapon ticks repeated within a frame by the %s"), TickName), NumExtraTicks, 0);
+		TestEqual(FString::Printf(TEXT("Weapon ticks outside their tick group by the %s"), TickName), NumWrongGroups, 0);
+		TestEqual(FString::Printf(TEXT("Weapon ticks out of tick group order by the %s"), TickName), NumOutOfOrder, 0);
+		TestEqual(FString::Printf(TEXT("Weapon ticks not dilated by their CustomTimeDilation by the %s"), TickName), NumWrongDeltaTimes, 0);
+		TestEqual(FString::Printf(TEXT("Crouch refreshed once per dilated frame by the %s"), TickName), MaxCrouchDifference, 0.f);
+	}
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
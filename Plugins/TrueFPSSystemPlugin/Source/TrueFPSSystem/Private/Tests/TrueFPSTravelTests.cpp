@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSGameInstance.h"
+#include "TrueFPSTestWorld.h"
+#include "Online/TrueFPSGameMode.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "Weapons/TrueFPSWeaponBase.h"
+#include "Weapons/Attachments/TrueFPSWeaponAttachmentBase.h"
+
+namespace TrueFPSTravelTests
+{
+	static const TCHAR* MapRotation[] = {
+		TEXT("/Game/Maps/Killhouse2"),
+		TEXT("/Game/FPS_Weapon_Bundle/Maps/Weapons_Showcase"),
+		TEXT("/TrueFPSSystemPlugin/Maps/Welcome"),
+	};
+
+	static const TCHAR* WeaponPackageNames[] = {
+		TEXT("/TrueFPSSystemPlugin/Weapons/Pistol/BP_WeaponInstant_Pistol"),
+		TEXT("/TrueFPSSystemPlugin/Weapons/Rifle/BP_WeaponInstant_Rifle"),
+	};
+
+	static const TCHAR* WeaponClassPaths[] = {
+		TEXT("/TrueFPSSystemPlugin/Weapons/Pistol/BP_WeaponInstant_Pistol.BP_WeaponInstant_Pistol_C"),
+		TEXT("/TrueFPSSystemPlugin/Weapons/Rifle/BP_WeaponInstant_Rifle.BP_WeaponInstant_Rifle_C"),
+	};
+
+	/** async loading time sliced like a frame of the game thread would */
+	static constexpr double AsyncLoadingTimeLimit = 0.005;
+
+	/** frames given to a single preload before giving up on it */
+	static constexpr int32 MaxPreloadFrames = 10000;
+
+	static bool IsPackageLoaded(const TCHAR* PackageName)
+	{
+		const UPackage* Package = FindPackage(nullptr, PackageName);
+		return Package && Package->IsFullyLoaded();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSMapRotationPreloadTest, "TrueFPS.Travel.MapRotationPreload",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSMapRotationPreloadTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSTravelTests;
+
+	const TTrueFPSTestGameInstance<UTrueFPSGameInstance> TestGameInstance;
+
+	TArray<FName> WeaponPackages;
+	for (const TCHAR* PackageName : WeaponPackageNames)
+	{
+		WeaponPackages.Add(PackageName);
+	}
+
+	// Any package loaded synchronously while preloading would be a game thread stall
+	TArray<FString> SyncLoadedPackages;
+	const FDelegateHandle SyncLoadHandle = FCoreUObjectDelegates::OnSyncLoadPackage.AddLambda([&SyncLoadedPackages](const FString& PackageName)
+	{
+		SyncLoadedPackages.Add(PackageName);
+	});
+
+	for (const TCHAR* MapName : MapRotation)
+	{
+		// Ends the previous match, then the next one's packages stream in while the scoreboard is up
+		TestGameInstance.GameInstance->PreloadTravelPackages(MapName, WeaponPackages);
+
+		int32 NumFrames = 0;
+		double MaxFrameSeconds = 0.0;
+		while (IsAsyncLoading() && NumFrames < MaxPreloadFrames)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			ProcessAsyncLoading(true, false, AsyncLoadingTimeLimit);
+			TestGameInstance.World->Tick(LEVELTICK_All, 1.f / 60.f);
+			MaxFrameSeconds = FMath::Max(MaxFrameSeconds, FPlatformTime::Seconds() - StartTime);
+			NumFrames++;
+		}
+
+		AddInfo(FString::Printf(TEXT("%s preloaded over %d frames, longest frame %.2fms"), MapName, NumFrames, MaxFrameSeconds * 1000.0));
+
+		// Travel then finds everything in memory instead of loading it on the spot
+		TestTrue(FString::Printf(TEXT("%s is loaded ahead of travel"), MapName), IsPackageLoaded(MapName));
+		for (const TCHAR* PackageName : WeaponPackageNames)
+		{
+			TestTrue(FString::Printf(TEXT("%s is loaded ahead of travel to %s"), PackageName, MapName), IsPackageLoaded(PackageName));
+		}
+
+		TestGameInstance.GameInstance->NotifyMatchPlayable();
+	}
+
+	FCoreUObjectDelegates::OnSyncLoadPackage.Remove(SyncLoadHandle);
+	TestEqual(FString::Printf(TEXT("No package is loaded synchronously while preloading (%s)"), *FString::Join(SyncLoadedPackages, TEXT(", "))), SyncLoadedPackages.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSSeamlessTravelPoolTest, "TrueFPS.Travel.SeamlessTravelCarriesWeaponPools",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSSeamlessTravelPoolTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSTravelTests;
+
+	TArray<UClass*> WeaponClasses;
+	for (const TCHAR* ClassPath : WeaponClassPaths)
+	{
+		UClass* WeaponClass = LoadClass<ATrueFPSWeaponBase>(nullptr, ClassPath);
+		if (!TestNotNull(FString::Printf(TEXT("%s loads"), ClassPath), WeaponClass))
+		{
+			return false;
+		}
+		WeaponClasses.Add(WeaponClass);
+	}
+
+	const FTrueFPSTestWorld TestWorld;
+	ATrueFPSGameMode* PreviousGameMode = TestWorld.SpawnGameMode<ATrueFPSGameMode>();
+
+	// The previous match ends with every weapon back in its pool
+	TArray<ATrueFPSWeaponBase*> PooledWeapons;
+	for (UClass* WeaponClass : WeaponClasses)
+	{
+		PooledWeapons.Add(PreviousGameMode->AcquireWeapon(WeaponClass));
+	}
+	for (ATrueFPSWeaponBase* Weapon : PooledWeapons)
+	{
+		PreviousGameMode->ReleaseWeapon(Weapon);
+	}
+
+	TArray<AActor*> TravelActors;
+	PreviousGameMode->GetSeamlessTravelActorList(false, TravelActors);
+
+	TArray<ATrueFPSWeaponAttachmentBase*> Attachments;
+	for (ATrueFPSWeaponBase* Weapon : PooledWeapons)
+	{
+		TestTrue(FString::Printf(TEXT("%s travels"), *Weapon->GetName()), TravelActors.Contains(Weapon));
+
+		Weapon->GetAttachments(Attachments);
+		for (ATrueFPSWeaponAttachmentBase* Attachment : Attachments)
+		{
+			TestTrue(FString::Printf(TEXT("%s travels with its weapon"), *Attachment->GetName()), TravelActors.Contains(Attachment));
+		}
+	}
+
+	// The next match's game mode adopts the weapons that travelled instead of spawning new ones
+	PreviousGameMode->Destroy();
+	ATrueFPSGameMode* NextGameMode = TestWorld.SpawnGameMode<ATrueFPSGameMode>();
+	NextGameMode->PostSeamlessTravel();
+
+	int32 NumSpawnedActors = 0;
+	const FDelegateHandle SpawnedHandle = TestWorld.World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateLambda([&NumSpawnedActors](AActor*)
+	{
+		NumSpawnedActors++;
+	}));
+
+	for (UClass* WeaponClass : WeaponClasses)
+	{
+		ATrueFPSWeaponBase* Weapon = NextGameMode->AcquireWeapon(WeaponClass);
+		TestTrue(FString::Printf(TEXT("%s comes from the weapons that travelled"), *WeaponClass->GetName()), PooledWeapons.Contains(Weapon));
+	}
+
+	TestWorld.World->RemoveOnActorSpawnedHandler(SpawnedHandle);
+	TestEqual(TEXT("Nothing is spawned for the next match's weapons"), NumSpawnedActors, 0);
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
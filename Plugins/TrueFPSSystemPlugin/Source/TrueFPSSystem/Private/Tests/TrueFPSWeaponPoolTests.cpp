@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestGameMode.h"
+#include "TrueFPSTestWorld.h"
+#include "Weapons/TrueFPSWeaponBase.h"
+#include "Weapons/Attachments/TrueFPSWeaponAttachmentBase.h"
+
+namespace TrueFPSWeaponPoolTests
+{
+	static const TCHAR* WeaponClassPaths[] = {
+		TEXT("/TrueFPSSystemPlugin/Weapons/Pistol/BP_WeaponInstant_Pistol.BP_WeaponInstant_Pistol_C"),
+		TEXT("/TrueFPSSystemPlugin/Weapons/Rifle/BP_WeaponInstant_Rifle.BP_WeaponInstant_Rifle_C"),
+	};
+
+	static constexpr int32 NumPawns = 32;
+	static constexpr int32 NumWaves = 10;
+
+	struct FStormResult
+	{
+		/** actors spawned by the respawn waves, weapons and attachments alike */
+		int32 NumSpawnedActors = 0;
+
+		/** slowest respawn wave */
+		double MaxWaveSeconds = 0.0;
+
+		/** weapons handed out that didn't come back as they were spawned */
+		int32 NumDirtyWeapons = 0;
+	};
+
+	static int32 CountAttachments(const ATrueFPSWeaponBase* Weapon)
+	{
+		TArray<ATrueFPSWeaponAttachmentBase*> Attachments;
+		Weapon->GetAttachments(Attachments);
+		return Attachments.Num();
+	}
+
+	/** every pawn dies and respawns with its default weapons at once, NumWaves times */
+	static FStormResult RunRespawnStorm(const TArray<UClass*>& WeaponClasses, const int32 MaxPooledWeaponsPerClass)
+	{
+		const FTrueFPSTestWorld TestWorld;
+		ATrueFPSTestGameMode* GameMode = TestWorld.SpawnGameMode<ATrueFPSTestGameMode>();
+		GameMode->SetMaxPooledWeaponsPerClass(MaxPooledWeaponsPerClass);
+
+		TMap<UClass*, int32> SpawnedAttachments;
+		TArray<ATrueFPSWeaponBase*> Inventories;
+
+		// First spawns are the pool's warm-up, and tell how many attachments a clean weapon has
+		for (int32 Pawn = 0; Pawn < NumPawns; Pawn++)
+		{
+			for (UClass* WeaponClass : WeaponClasses)
+			{
+				ATrueFPSWeaponBase* Weapon = GameMode->AcquireWeapon(WeaponClass);
+				SpawnedAttachments.FindOrAdd(WeaponClass) = CountAttachments(Weapon);
+				Inventories.Add(Weapon);
+			}
+		}
+
+		FStormResult Result;
+		const FDelegateHandle SpawnedHandle = TestWorld.World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateLambda([&Result](AActor*)
+		{
+			Result.NumSpawnedActors++;
+		}));
+
+		for (int32 Wave = 0; Wave < NumWaves; Wave++)
+		{
+			for (ATrueFPSWeaponBase* Weapon : Inventories)
+			{
+				// Died mid fire with their last sights on
+				Weapon->GetState().bWantsToFire = true;
+				Weapon->ToggleSights();
+				GameMode->ReleaseWeapon(Weapon);
+			}
+			Inventories.Reset();
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Pawn = 0; Pawn < NumPawns; Pawn++)
+			{
+				for (UClass* WeaponClass : WeaponClasses)
+				{
+					Inventories.Add(GameMode->AcquireWeapon(WeaponClass));
+				}
+				Inventories[Pawn * WeaponClasses.Num()]->OnEquip(nullptr);
+			}
+			Result.MaxWaveSeconds = FMath::Max(Result.MaxWaveSeconds, FPlatformTime::Seconds() - StartTime);
+
+			for (int32 i = 0; i < Inventories.Num(); i++)
+			{
+				const ATrueFPSWeaponBase* Weapon = Inventories[i];
+				const bool bClean = !Weapon->GetState().bWantsToFire && !Weapon->GetState().CurrentSights.IsValid()
+					&& CountAttachments(Weapon) == SpawnedAttachments[Weapon->GetClass()]
+					&& (i % WeaponClasses.Num() == 0 ? !Weapon->IsHolstered() : Weapon->IsHolstered());
+				Result.NumDirtyWeapons += bClean ? 0 : 1;
+			}
+
+			TestWorld.Tick(1);
+		}
+
+		TestWorld.World->RemoveOnActorSpawnedHandler(SpawnedHandle);
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSWeaponPoolStormTest, "TrueFPS.Weapons.PoolRespawnStorm",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSWeaponPoolStormTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSWeaponPoolTests;
+
+	TArray<UClass*> WeaponClasses;
+	for (const TCHAR* WeaponClassPath : WeaponClassPaths)
+	{
+		UClass* WeaponClass = LoadClass<ATrueFPSWeaponBase>(nullptr, WeaponClassPath);
+		if (!TestNotNull(FString::Printf(TEXT("%s loads"), WeaponClassPath), WeaponClass))
+		{
+			return false;
+		}
+		WeaponClasses.Add(WeaponClass);
+	}
+
+	// Without a pool every released weapon is destroyed and spawned again
+	const FStormResult Spawned = RunRespawnStorm(WeaponClasses, 0);
+	const FStormResult Pooled = RunRespawnStorm(WeaponClasses, NumPawns);
+
+	AddInfo(FString::Printf(TEXT("%d pawns x %d weapons, %d respawn waves. Pooled: %d actor spawns, %.3fms worst wave. Unpooled: %d actor spawns, %.3fms worst wave"),
+		NumPawns, WeaponClasses.Num(), NumWaves, Pooled.NumSpawnedActors, Pooled.MaxWaveSeconds * 1000.0, Spawned.NumSpawnedActors, Spawned.MaxWaveSeconds * 1000.0));
+
+	TestTrue(TEXT("Without a pool every respawn spawns its weapons"), Spawned.NumSpawnedActors >= NumPawns * WeaponClasses.Num() * NumWaves);
+	TestEqual(TEXT("A warm pool spawns no actors during a respawn storm"), Pooled.NumSpawnedActors, 0);
+	TestEqual(TEXT("Recycled weapons come back clean, with their default attachments"), Pooled.NumDirtyWeapons, 0);
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
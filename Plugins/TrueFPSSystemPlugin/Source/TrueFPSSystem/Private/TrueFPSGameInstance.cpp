@@ -15,15 +15,21 @@
 #include "Character/TrueFPSPlayerController.h"
 #include "Character/TrueFPSPlayerController_Menu.h"
 #include "Engine/Canvas.h"
+#include "Engine/DemoNetDriver.h"
 //#include "Engine/Engine.h"
 //#include "Misc/Ticker.h"
 #include "Containers/Ticker.h"
 #include "GameFramework/GameModeBase.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/PackageName.h"
 #include "Online/TrueFPSGameSession.h"
 #include "Online/TrueFPSGameState.h"
+#include "Online/TrueFPSLeaderboardCache.h"
 #include "Online/TrueFPSOnlineSessionClient.h"
+#include "Online/TrueFPSMatchReportQueue.h"
 #include "Online/TrueFPSPlayerState.h"
+#include "Online/TrueFPSPresenceCoordinator.h"
+#include "Online/TrueFPSReplayIndex.h"
 #include "UI/Style/TrueFPSMenuItemWidgetStyle.h"
 #include "UI/Style/TrueFPSStyle.h"
 
@@ -101,6 +107,7 @@ UTrueFPSGameInstance::UTrueFPSGameInstance(const FObjectInitializer& ObjectIniti
 	, bIsLicensed(true) // Default to licensed (should have been checked by OS on boot)
 {
 	CurrentState = TrueFPSGameInstanceState::None;
+	StateWatchdogInterval = 1.0f;
 }
 
 
@@ -143,9 +150,14 @@ void UTrueFPSGameInstance::Init()
 	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UTrueFPSGameInstance::OnPostLoadMap);
 
 	FCoreUObjectDelegates::PostDemoPlay.AddUObject(this, &UTrueFPSGameInstance::OnPostDemoPlay);
+	FNetworkReplayDelegates::OnReplayRecordingComplete.AddUObject(this, &UTrueFPSGameInstance::OnReplayRecordingComplete);
 
 	bPendingEnableSplitscreen = false;
 
+	PresenceCoordinator = MakeShared<FTrueFPSPresenceCoordinator>(this);
+	MatchReportQueue = MakeShared<FTrueFPSMatchReportQueue>();
+	LeaderboardCache = MakeShared<FTrueFPSLeaderboardCache>(this);
+
 	OnlineSub->AddOnConnectionStatusChangedDelegate_Handle( FOnConnectionStatusChangedDelegate::CreateUObject( this, &UTrueFPSGameInstance::HandleNetworkConnectionStatusChanged ) );
 
 	if (SessionInterface.IsValid())
@@ -155,11 +167,12 @@ void UTrueFPSGameInstance::Init()
 	
 	OnEndSessionCompleteDelegate = FOnEndSessionCompleteDelegate::CreateUObject(this, &UTrueFPSGameInstance::OnEndSessionComplete);
 
-	// Register delegate for ticker callback
-	float MyDelay = 0.0f; // 0 for "next frame"
-	TickDelegate = FTickerDelegate::CreateUObject(this, &UTrueFPSGameInstance::Tick);
-	TickDelegateHandle = FTSTicker::GetCoreTicker().AddTicker(TickDelegate, MyDelay);
-	//Get().AddTicker(TickDelegate, MyDelay);
+	// Register delegate for the watchdog ticker, state changes themselves are handled as they're requested
+	if (!IsDedicatedServerInstance())
+	{
+		TickDelegate = FTickerDelegate::CreateUObject(this, &UTrueFPSGameInstance::Tick);
+		TickDelegateHandle = FTSTicker::GetCoreTicker().AddTicker(TickDelegate, StateWatchdogInterval);
+	}
 
 	// Register activities delegate callback
  	OnGameActivityActivationRequestedDelegate = FOnGameActivityActivationRequestedDelegate::CreateUObject(this, &UTrueFPSGameInstance::OnGameActivityActivationRequestComplete);
@@ -191,6 +204,12 @@ void UTrueFPSGameInstance::Shutdown()
 
 	// Unregister ticker delegate
 	FTSTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameDelegateHandle);
+	EndFrameDelegateHandle.Reset();
+
+	PresenceCoordinator.Reset();
+	MatchReportQueue.Reset();
+	LeaderboardCache.Reset();
 }
 
 void UTrueFPSGameInstance::HandleNetworkConnectionStatusChanged( const FString& ServiceName, EOnlineServerConnectionStatus::Type LastConnectionStatus, EOnlineServerConnectionStatus::Type ConnectionStatus )
@@ -268,6 +287,12 @@ void UTrueFPSGameInstance::OnPreLoadMap(const FString& MapName)
 			bPendingEnableSplitscreen = false;
 		}
 	}
+
+	// Seamless travel loads the transition map first, keep timing from the start of the whole trip
+	if (TravelStartTime == 0.0)
+	{
+		TravelStartTime = FPlatformTime::Seconds();
+	}
 }
 
 void UTrueFPSGameInstance::OnPostLoadMap(UWorld*)
@@ -278,6 +303,95 @@ void UTrueFPSGameInstance::OnPostLoadMap(UWorld*)
 	{
 		TrueFPSGameViewportClient->HideLoadingScreen();
 	}
+
+	TravelMapLoadedTime = FPlatformTime::Seconds();
+}
+
+void UTrueFPSGameInstance::PreloadTravelPackages(const FString& MapName, const TArray<FName>& PackageNames)
+{
+	UWorld* const World = GetWorld();
+	if (World == nullptr || World->IsPlayInEditor() || MapName == PreloadMapName)
+	{
+		return;
+	}
+
+	FString MapPackageName = MapName;
+	if (!FPackageName::IsValidLongPackageName(MapPackageName) && !FPackageName::SearchForPackageOnDisk(MapName + FPackageName::GetMapPackageExtension(), &MapPackageName))
+	{
+		UE_LOG(LogTrueFPSSystem, Warning, TEXT("Can't preload %s, map package not found"), *MapName);
+		return;
+	}
+
+	ReleasePreloadedPackages();
+	PreloadMapName = MapName;
+
+	// Restarting the current map needs nothing loaded, and holding on to the current world would keep it from being cleaned up
+	if (MapPackageName != UWorld::RemovePIEPrefix(World->GetOutermost()->GetName()))
+	{
+		LoadPackageAsync(MapPackageName, FLoadPackageAsyncDelegate::CreateUObject(this, &UTrueFPSGameInstance::OnPreloadPackageLoaded));
+	}
+
+	for (const FName& PackageName : PackageNames)
+	{
+		LoadPackageAsync(PackageName.ToString(), FLoadPackageAsyncDelegate::CreateUObject(this, &UTrueFPSGameInstance::OnPreloadPackageLoaded));
+	}
+}
+
+void UTrueFPSGameInstance::OnPreloadPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+{
+	if (Result != EAsyncLoadingResult::Succeeded || LoadedPackage == nullptr)
+	{
+		UE_LOG(LogTrueFPSSystem, Warning, TEXT("Failed to preload %s"), *PackageName.ToString());
+		return;
+	}
+
+	// The preload was dropped while this package was in flight
+	if (PreloadMapName.IsEmpty())
+	{
+		return;
+	}
+
+	ForEachObjectWithPackage(LoadedPackage, [this](UObject* Object)
+	{
+		if (Object->IsAsset())
+		{
+			PreloadedAssets.Add(Object);
+		}
+		return true;
+	}, false);
+}
+
+void UTrueFPSGameInstance::ReleasePreloadedPackages()
+{
+	PreloadMapName.Reset();
+	PreloadedAssets.Reset();
+}
+
+void UTrueFPSGameInstance::HandleNetworkError(ENetworkFailure::Type FailureType, bool bIsServer)
+{
+	Super::HandleNetworkError(FailureType, bIsServer);
+
+	ReleasePreloadedPackages();
+}
+
+void UTrueFPSGameInstance::HandleTravelError(ETravelFailure::Type FailureType)
+{
+	Super::HandleTravelError(FailureType);
+
+	ReleasePreloadedPackages();
+}
+
+void UTrueFPSGameInstance::NotifyMatchPlayable()
+{
+	if (TravelStartTime > 0.0)
+	{
+		const double Now = FPlatformTime::Seconds();
+		const double LoadTime = TravelMapLoadedTime > TravelStartTime ? TravelMapLoadedTime - TravelStartTime : 0.0;
+		UE_LOG(LogTrueFPSSystem, Log, TEXT("%s playable %.2fs after travel started (map loaded in %.2fs)"), *GetWorld()->GetMapName(), Now - TravelStartTime, LoadTime);
+		TravelStartTime = 0.0;
+	}
+
+	ReleasePreloadedPackages();
 }
 
 void UTrueFPSGameInstance::OnUserCanPlayInvite(const FUniqueNetId& UserId, EUserPrivileges::Type Privilege, uint32 PrivilegeResults)
@@ -293,6 +407,7 @@ void UTrueFPSGameInstance::OnUserCanPlayInvite(const FUniqueNetId& UserId, EUser
 		if (UserId == *PendingInvite.UserId)
 		{
 			PendingInvite.bPrivilegesCheckedAndAllowed = true;
+			RequestStateUpdate();
 		}		
 	}
 	else
@@ -307,6 +422,12 @@ void UTrueFPSGameInstance::OnPostDemoPlay()
 	GotoState( TrueFPSGameInstanceState::Playing );
 }
 
+void UTrueFPSGameInstance::OnReplayRecordingComplete(UWorld* World)
+{
+	// Refresh the replay index now so the demo browser can list the new recording straight from it
+	FTrueFPSReplayIndex::Rebuild(FNetworkReplayStreaming::Get().GetFactory().CreateReplayStreamer(), FNetworkVersion::GetReplayVersion());
+}
+
 void UTrueFPSGameInstance::HandleDemoPlaybackFailure( EReplayResult, const FString& ErrorString )
 {
 	if (GetWorld() != nullptr && GetWorld()->WorldType == EWorldType::PIE)
@@ -531,8 +652,14 @@ bool UTrueFPSGameInstance::LoadFrontEndMap(const FString& MapName)
 
 	if (URL.Valid && !HasAnyFlags(RF_ClassDefaultObject)) //CastChecked<UEngine>() will fail if using Default__TrueFPSSystemInstance, so make sure that we're not default
 	{
+		// Nothing preloaded for a match is needed in the front end
+		ReleasePreloadedPackages();
+
 		BrowseRet = GetEngine()->Browse(*WorldContext, URL, Error);
 
+		// Menus never become playable, don't count this load towards the next match
+		TravelStartTime = 0.0;
+
 		// Handle failure.
 		if (BrowseRet != EBrowseReturnVal::Success)
 		{
@@ -589,22 +716,28 @@ void UTrueFPSGameInstance::GotoState(FName NewState)
 	UE_LOG( LogOnline, Log, TEXT( "GotoState: NewState: %s" ), *NewState.ToString() );
 
 	PendingState = NewState;
+
+	RequestStateUpdate();
 }
 
 void UTrueFPSGameInstance::MaybeChangeState()
 {
-	if ( (PendingState != CurrentState) && (PendingState != TrueFPSGameInstanceState::None) )
+	// States may send us on to another state while beginning or ending, follow those within the same update
+	while ( (PendingState != CurrentState) && (PendingState != TrueFPSGameInstanceState::None) )
 	{
 		FName const OldState = CurrentState;
+		FName const NewState = PendingState;
+
+		// clear pending change
+		PendingState = TrueFPSGameInstanceState::None;
 
 		// end current state
-		EndCurrentState(PendingState);
+		EndCurrentState(NewState);
+		CurrentState = TrueFPSGameInstanceState::None;
 
 		// begin new state
-		BeginNewState(PendingState, OldState);
-
-		// clear pending change
-		PendingState = TrueFPSGameInstanceState::None;
+		BeginNewState(NewState, OldState);
+		CurrentState = NewState;
 	}
 }
 
@@ -631,8 +764,6 @@ void UTrueFPSGameInstance::EndCurrentState(FName NextState)
 	{
 		EndPlayingState();
 	}
-
-	CurrentState = TrueFPSGameInstanceState::None;
 }
 
 void UTrueFPSGameInstance::BeginNewState(FName NewState, FName PrevState)
@@ -659,8 +790,6 @@ void UTrueFPSGameInstance::BeginNewState(FName NewState, FName PrevState)
 	{
 		BeginPlayingState();
 	}
-
-	CurrentState = NewState;
 }
 
 void UTrueFPSGameInstance::BeginPendingInviteState()
@@ -721,20 +850,10 @@ void UTrueFPSGameInstance::SetPresenceForLocalPlayers(const FString& StatusStr,
 
 void UTrueFPSGameInstance::SetPresenceForLocalPlayer(int32 LocalUserNum, const FString& StatusStr, const FVariantData& PresenceData)
 {
-	const IOnlinePresencePtr Presence = Online::GetPresenceInterface(GetWorld());
-	if (Presence.IsValid())
+	// Only what changed is sent, and calls for every local player made this frame go out together
+	if (PresenceCoordinator.IsValid() && LocalPlayers.IsValidIndex(LocalUserNum))
 	{
-		const FUniqueNetIdRepl UserId = LocalPlayers[LocalUserNum]->GetPreferredUniqueNetId();
-
-		if (UserId.IsValid())
-		{
-			FOnlineUserPresenceStatus PresenceStatus;
-			PresenceStatus.StatusStr = StatusStr;
-			PresenceStatus.State = EOnlinePresenceState::Online;
-			PresenceStatus.Properties.Add(DefaultPresenceKey, PresenceData);
-
-			Presence->SetPresence(*UserId, PresenceStatus);
-		}
+		PresenceCoordinator->SetPresence(LocalUserNum, LocalPlayers[LocalUserNum]->GetPreferredUniqueNetId(), StatusStr, DefaultPresenceKey, PresenceData);
 	}
 }
 
@@ -750,6 +869,9 @@ void UTrueFPSGameInstance::BeginMainMenuState()
 
 	SetOnlineMode(EOnlineMode::Offline);
 
+	// Also when the front end map is already loaded and LoadFrontEndMap won't browse
+	ReleasePreloadedPackages();
+
 	// Disallow splitscreen
 	UGameViewportClient* GameViewportClient = GetGameViewportClient();
 	
@@ -889,6 +1011,9 @@ void UTrueFPSGameInstance::OnEndSessionComplete( FName SessionName, bool bWasSuc
 
 	// continue
 	CleanupSessionOnReturnToMenu();
+
+	// a pending invite may have been waiting for this session to go away
+	RequestStateUpdate();
 }
 
 void UTrueFPSGameInstance::CleanupSessionOnReturnToMenu()
@@ -1275,9 +1400,11 @@ bool UTrueFPSGameInstance::FindSessions(ULocalPlayer* PlayerOwner, bool bIsDedic
 			GameSession->OnFindSessionsComplete().RemoveAll(this);
 			OnSearchSessionsCompleteDelegateHandle = GameSession->OnFindSessionsComplete().AddUObject(this, &UTrueFPSGameInstance::OnSearchSessionsComplete);
 
-			GameSession->FindSessions(PlayerOwner->GetPreferredUniqueNetId().GetUniqueNetId(), NAME_GameSession, bFindLAN, !bIsDedicatedServer);
-
-			bResult = true;
+			bResult = GameSession->FindSessions(PlayerOwner->GetPreferredUniqueNetId().GetUniqueNetId(), NAME_GameSession, bFindLAN, !bIsDedicatedServer);
+			if (!bResult)
+			{
+				GameSession->OnFindSessionsComplete().Remove(OnSearchSessionsCompleteDelegateHandle);
+			}
 		}
 	}
 
@@ -1295,20 +1422,51 @@ void UTrueFPSGameInstance::OnSearchSessionsComplete(bool bWasSuccessful)
 }
 
 bool UTrueFPSGameInstance::Tick(float DeltaSeconds)
+{
+	// State changes are driven by events, this only catches up on whatever couldn't be handled when its event fired
+	// (a dialog was up, or another PIE viewport had focus)
+	UpdateState();
+
+	return true;
+}
+
+void UTrueFPSGameInstance::RequestStateUpdate()
 {
 	// Dedicated server doesn't need to worry about game state
-	if (IsDedicatedServerInstance() == true)
+	if (IsDedicatedServerInstance() || EndFrameDelegateHandle.IsValid())
 	{
-		return true;
+		return;
 	}
 
+	// Handled at the end of this frame, outside of whichever world or slate tick requested it
+	EndFrameDelegateHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UTrueFPSGameInstance::HandleEndFrame);
+}
+
+void UTrueFPSGameInstance::HandleEndFrame()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameDelegateHandle);
+	EndFrameDelegateHandle.Reset();
+
+	UpdateState();
+}
+
+bool UTrueFPSGameInstance::IsGameViewportActive() const
+{
 	UTrueFPSGameViewportClient* TrueFPSGameViewportClient = Cast<UTrueFPSGameViewportClient>(GetGameViewportClient());
 	if (FSlateApplication::IsInitialized() && TrueFPSGameViewportClient != nullptr)
 	{
-		if (FSlateApplication::Get().GetGameViewport() != TrueFPSGameViewportClient->GetGameViewportWidget())
-		{
-			return true;
-		}
+		return FSlateApplication::Get().GetGameViewport() == TrueFPSGameViewportClient->GetGameViewportWidget();
+	}
+
+	return true;
+}
+
+void UTrueFPSGameInstance::UpdateState()
+{
+	// Dedicated server doesn't need to worry about game state
+	if (IsDedicatedServerInstance() == true || !IsGameViewportActive())
+	{
+		return;
 	}
 
 	// Because this takes place outside the normal UWorld tick, we need to register what world we're ticking/modifying here to avoid issues in the editor
@@ -1316,42 +1474,63 @@ bool UTrueFPSGameInstance::Tick(float DeltaSeconds)
 
 	MaybeChangeState();
 
-	if (CurrentState != TrueFPSGameInstanceState::WelcomeScreen && TrueFPSGameViewportClient != nullptr)
+	CheckLicense();
+	CheckControllerConnections();
+	TryAcceptPendingInvite();
+
+	// Follow up on anything the checks above asked for right away
+	MaybeChangeState();
+}
+
+void UTrueFPSGameInstance::CheckLicense()
+{
+	UTrueFPSGameViewportClient* TrueFPSGameViewportClient = Cast<UTrueFPSGameViewportClient>(GetGameViewportClient());
+
+	// If at any point we aren't licensed (but we are after welcome screen) bounce them back to the welcome screen
+	if (!bIsLicensed && CurrentState != TrueFPSGameInstanceState::WelcomeScreen && CurrentState != TrueFPSGameInstanceState::None && TrueFPSGameViewportClient != nullptr && !TrueFPSGameViewportClient->IsShowingDialog())
 	{
-		// If at any point we aren't licensed (but we are after welcome screen) bounce them back to the welcome screen
-		if (!bIsLicensed && CurrentState != TrueFPSGameInstanceState::None && TrueFPSGameViewportClient != nullptr && !TrueFPSGameViewportClient->IsShowingDialog())
-		{
-			const FText ReturnReason	= NSLOCTEXT( "ProfileMessages", "NeedLicense", "The signed in users do not have a license for this game. Please purchase TrueFPSSystem from the Xbox Marketplace or sign in a user with a valid license." );
-			const FText OKButton		= NSLOCTEXT( "DialogButtons", "OKAY", "OK" );
+		const FText ReturnReason	= NSLOCTEXT( "ProfileMessages", "NeedLicense", "The signed in users do not have a license for this game. Please purchase TrueFPSSystem from the Xbox Marketplace or sign in a user with a valid license." );
+		const FText OKButton		= NSLOCTEXT( "DialogButtons", "OKAY", "OK" );
 
-			ShowMessageThenGotoState( ReturnReason, OKButton, FText::GetEmpty(), TrueFPSGameInstanceState::WelcomeScreen );
-		}
+		ShowMessageThenGotoState( ReturnReason, OKButton, FText::GetEmpty(), TrueFPSGameInstanceState::WelcomeScreen );
+	}
+}
 
-		// Show controller disconnected dialog if any local players have an invalid controller
-		if (!TrueFPSGameViewportClient->IsShowingDialog())
+void UTrueFPSGameInstance::CheckControllerConnections()
+{
+	UTrueFPSGameViewportClient* TrueFPSGameViewportClient = Cast<UTrueFPSGameViewportClient>(GetGameViewportClient());
+	if (CurrentState == TrueFPSGameInstanceState::WelcomeScreen || TrueFPSGameViewportClient == nullptr)
+	{
+		return;
+	}
+
+	// Show controller disconnected dialog if any local players have an invalid controller
+	if (!TrueFPSGameViewportClient->IsShowingDialog())
+	{
+		for (int i = 0; i < LocalPlayers.Num(); ++i)
 		{
-			for (int i = 0; i < LocalPlayers.Num(); ++i)
+			if (LocalPlayers[i] && LocalPlayers[i]->GetControllerId() == -1)
 			{
-				if (LocalPlayers[i] && LocalPlayers[i]->GetControllerId() == -1)
-				{
-					TrueFPSGameViewportClient->ShowDialog( 
-						LocalPlayers[i],
-						ETrueFPSDialogType::ControllerDisconnected,
-						FText::Format(NSLOCTEXT("ProfileMessages", "PlayerReconnectControllerFmt", "Player {0}, please reconnect your controller."), FText::AsNumber(i + 1)),
+				TrueFPSGameViewportClient->ShowDialog( 
+					LocalPlayers[i],
+					ETrueFPSDialogType::ControllerDisconnected,
+					FText::Format(NSLOCTEXT("ProfileMessages", "PlayerReconnectControllerFmt", "Player {0}, please reconnect your controller."), FText::AsNumber(i + 1)),
 #if TRUEFPS_XBOX_STRINGS
-						NSLOCTEXT("DialogButtons", "AButtonContinue", "A - Continue"),
+					NSLOCTEXT("DialogButtons", "AButtonContinue", "A - Continue"),
 #else
-						NSLOCTEXT("DialogButtons", "EnterContinue", "Enter - Continue"),
+					NSLOCTEXT("DialogButtons", "EnterContinue", "Enter - Continue"),
 #endif
-						FText::GetEmpty(),
-						FOnClicked::CreateUObject(this, &UTrueFPSGameInstance::OnControllerReconnectConfirm),
-						FOnClicked()
-					);
-				}
+					FText::GetEmpty(),
+					FOnClicked::CreateUObject(this, &UTrueFPSGameInstance::OnControllerReconnectConfirm),
+					FOnClicked()
+				);
 			}
 		}
 	}
+}
 
+void UTrueFPSGameInstance::TryAcceptPendingInvite()
+{
 	// If we have a pending invite, and we are at the welcome screen, and the session is properly shut down, accept it
 	if (PendingInvite.UserId.IsValid() && PendingInvite.bPrivilegesCheckedAndAllowed && CurrentState == TrueFPSGameInstanceState::PendingInvite)
 	{
@@ -1387,8 +1566,6 @@ bool UTrueFPSGameInstance::Tick(float DeltaSeconds)
 			}
 		}
 	}
-
-	return true;
 }
 
 bool UTrueFPSGameInstance::HandleOpenCommand(const TCHAR* Cmd, FOutputDevice& Ar, UWorld* InWorld)
@@ -1455,12 +1632,18 @@ void UTrueFPSGameInstance::HandleUserLoginChanged(int32 GameUserIndex, ELoginSta
 
 	TSharedPtr<GenericApplication> GenericApplication = FSlateApplication::Get().GetPlatformApplication();
 	bIsLicensed = GenericApplication->ApplicationLicenseValid();
+	RequestStateUpdate();
 
 	// Find the local player associated with this unique net id
 	ULocalPlayer * LocalPlayer = FindLocalPlayerFromUniqueNetId( UserId );
 
 	LocalPlayerOnlineStatus[GameUserIndex] = LoginStatus;
 
+	if (PresenceCoordinator.IsValid() && LoginStatus != PreviousLoginStatus)
+	{
+		PresenceCoordinator->ResetUser(GameUserIndex);
+	}
+
 	// If this user is signed out, but was previously signed in, punt to welcome (or remove splitscreen if that makes sense)
 	if ( LocalPlayer != nullptr )
 	{
@@ -1564,6 +1747,8 @@ void UTrueFPSGameInstance::HandleAppLicenseUpdate()
 {
 	TSharedPtr<GenericApplication> GenericApplication = FSlateApplication::Get().GetPlatformApplication();
 	bIsLicensed = GenericApplication->ApplicationLicenseValid();
+
+	RequestStateUpdate();
 }
 
 void UTrueFPSGameInstance::HandleSafeFrameChanged()
@@ -1706,6 +1891,8 @@ void UTrueFPSGameInstance::HandleControllerConnectionChange( bool bIsConnection,
 
 		// Invalidate this local player's controller id.
 		LocalPlayer->SetControllerId(-1);
+
+		RequestStateUpdate();
 	}
 }
 
@@ -1717,6 +1904,9 @@ FReply UTrueFPSGameInstance::OnControllerReconnectConfirm()
 		TrueFPSViewport->HideDialog();
 	}
 
+	// other players may still be waiting on their controller
+	RequestStateUpdate();
+
 	return FReply::Handled();
 }
 
@@ -2,15 +2,25 @@
 
 #include "TrueFPSFriends.h"
 #include "OnlineSubsystemUtils.h"
+#include "TrueFPSGameInstance.h"
 #include "TrueFPSGameUserSettings.h"
 #include "Character/TrueFPSLocalPlayer.h"
 #include "Character/TrueFPSPersistentUser.h"
+#include "Online/TrueFPSPresenceCoordinator.h"
 #include "UI/Style/TrueFPSStyle.h"
 #include "UI/Style/TrueFPSOptionsWidgetStyle.h"
 #include "Widgets/STrueFPSMenuWidget.h"
 
 #define LOCTEXT_NAMESPACE "TrueFPSSystem.HUD.Menu"
 
+FTrueFPSFriends::~FTrueFPSFriends()
+{
+	if (TSharedPtr<FTrueFPSPresenceCoordinator> Coordinator = PresenceCoordinator.Pin())
+	{
+		Coordinator->OnFriendsListChanged().Remove(FriendsListChangedHandle);
+	}
+}
+
 void FTrueFPSFriends::Construct(ULocalPlayer* _PlayerOwner, int32 LocalUserNum_)
 {
 	FriendsStyle = &FTrueFPSStyle::Get().GetWidgetStyle<FTrueFPSOptionsStyle>("DefaultTrueFPSOptionsStyle");
@@ -20,6 +30,7 @@ void FTrueFPSFriends::Construct(ULocalPlayer* _PlayerOwner, int32 LocalUserNum_)
 	CurrFriendIndex = 0;
 	MinFriendIndex = 0;
 	MaxFriendIndex = 0; //initialized after the friends list is read in
+	DisplayedFriendsVersion = 0;
 
 	/** Friends menu root item */
 	TSharedPtr<FTrueFPSMenuItem> FriendsRoot = FTrueFPSMenuItem::CreateRoot();
@@ -30,7 +41,13 @@ void FTrueFPSFriends::Construct(ULocalPlayer* _PlayerOwner, int32 LocalUserNum_)
 	if (PlayerOwner)
 	{
 		OnlineSub = Online::GetSubsystem(PlayerOwner->GetWorld());
-		OnlineFriendsPtr = OnlineSub->GetFriendsInterface();
+
+		UTrueFPSGameInstance* GameInstance = Cast<UTrueFPSGameInstance>(PlayerOwner->GetGameInstance());
+		if (GameInstance && GameInstance->GetPresenceCoordinator().IsValid())
+		{
+			PresenceCoordinator = GameInstance->GetPresenceCoordinator();
+			FriendsListChangedHandle = GameInstance->GetPresenceCoordinator()->OnFriendsListChanged().AddSP(this, &FTrueFPSFriends::OnFriendsListChanged);
+		}
 	}
 
 	UpdateFriends(LocalUserNum);
@@ -90,39 +107,53 @@ UTrueFPSPersistentUser* FTrueFPSFriends::GetPersistentUser() const
 
 void FTrueFPSFriends::UpdateFriends(int32 NewOwnerIndex)
 {
-	if (!OnlineFriendsPtr.IsValid())
+	TSharedPtr<FTrueFPSPresenceCoordinator> Coordinator = PresenceCoordinator.Pin();
+	if (!Coordinator.IsValid())
 	{
 		return;
 	}
 
-	LocalUserNum = NewOwnerIndex;
-	OnlineFriendsPtr->ReadFriendsList(LocalUserNum, EFriendsLists::ToString(EFriendsLists::OnlinePlayers), FOnReadFriendsListComplete::CreateSP(this, &FTrueFPSFriends::OnFriendsUpdated));
+	if (LocalUserNum != NewOwnerIndex)
+	{
+		LocalUserNum = NewOwnerIndex;
+		DisplayedFriendsVersion = 0;
+	}
+
+	// Show whatever is cached right away, a read only goes out if the cache is out of date
+	RefreshFriendItems();
+	Coordinator->RefreshFriends(LocalUserNum);
+}
+
+void FTrueFPSFriends::OnFriendsListChanged(int32 UpdatedUserNum, uint32 Version)
+{
+	if (UpdatedUserNum == LocalUserNum)
+	{
+		RefreshFriendItems();
+	}
 }
 
-void FTrueFPSFriends::OnFriendsUpdated(int32 /*unused*/, bool bWasSuccessful, const FString& FriendListName, const FString& ErrorString)
+void FTrueFPSFriends::RefreshFriendItems()
 {
-	if (!bWasSuccessful)
+	TSharedPtr<FTrueFPSPresenceCoordinator> Coordinator = PresenceCoordinator.Pin();
+	if (!Coordinator.IsValid() || Coordinator->GetFriendsVersion(LocalUserNum) == DisplayedFriendsVersion)
 	{
-		UE_LOG(LogOnline, Warning, TEXT("Unable to update friendslist %s due to error=[%s]"), *FriendListName, *ErrorString);
 		return;
 	}
 
 	MenuHelper::ClearSubMenu(FriendsItem);
 
-	Friends.Reset();
-	if (OnlineFriendsPtr->GetFriendsList(LocalUserNum, EFriendsLists::ToString(EFriendsLists::OnlinePlayers), Friends))
+	DisplayedFriendsVersion = Coordinator->GetFriends(LocalUserNum, Friends);
+	for (const TSharedRef<FOnlineFriend>& Friend : Friends)
 	{
-		for (const TSharedRef<FOnlineFriend>& Friend : Friends)
-		{
-			TSharedRef<FTrueFPSMenuItem> FriendItem = MenuHelper::AddMenuItem(FriendsItem, FText::FromString(Friend->GetDisplayName()));
-			FriendItem->OnControllerFacebuttonDownPressed.BindSP(this, &FTrueFPSFriends::ViewSelectedFriendProfile);
-			FriendItem->OnControllerDownInputPressed.BindSP(this, &FTrueFPSFriends::IncrementFriendsCounter);
-			FriendItem->OnControllerUpInputPressed.BindSP(this, &FTrueFPSFriends::DecrementFriendsCounter);
-		}
-
-		MaxFriendIndex = Friends.Num() - 1;
+		TSharedRef<FTrueFPSMenuItem> FriendItem = MenuHelper::AddMenuItem(FriendsItem, FText::FromString(Friend->GetDisplayName()));
+		FriendItem->OnControllerFacebuttonDownPressed.BindSP(this, &FTrueFPSFriends::ViewSelectedFriendProfile);
+		FriendItem->OnControllerDownInputPressed.BindSP(this, &FTrueFPSFriends::IncrementFriendsCounter);
+		FriendItem->OnControllerUpInputPressed.BindSP(this, &FTrueFPSFriends::DecrementFriendsCounter);
 	}
 
+	MaxFriendIndex = Friends.Num() - 1;
+	CurrFriendIndex = FMath::Clamp(CurrFriendIndex, MinFriendIndex, FMath::Max(MaxFriendIndex, MinFriendIndex));
+
 	MenuHelper::AddMenuItemSP(FriendsItem, LOCTEXT("Close", "CLOSE"), this, &FTrueFPSFriends::OnApplySettings);
 }
 
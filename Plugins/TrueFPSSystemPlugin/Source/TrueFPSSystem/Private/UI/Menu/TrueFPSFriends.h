@@ -8,6 +8,7 @@
 class UTrueFPSPersistentUser;
 class UTrueFPSGameUserSettings;
 class FTrueFPSMenuItem;
+class FTrueFPSPresenceCoordinator;
 
 /** delegate called when changes are applied */
 DECLARE_DELEGATE(FOnApplyChanges);
@@ -30,10 +31,12 @@ DECLARE_DELEGATE(FOnOnControllerFacebuttonDownPressed);
 class FTrueFPSFriends : public TSharedFromThis<FTrueFPSFriends>
 {
 public:
+	~FTrueFPSFriends();
+
 	/** sets owning player controller */
 	void Construct(ULocalPlayer* _PlayerOwner, int32 LocalUserNum);
 
-	/** get current Friends values for display */
+	/** get current Friends values for display, the list is only re-read when the cached one is out of date */
 	void UpdateFriends(int32 NewOwnerIndex);
 
 	/** UI callback for applying settings, plays sound */
@@ -86,10 +89,20 @@ public:
 	TArray< TSharedRef<FOnlineFriend> > Friends;
 
 	IOnlineSubsystem* OnlineSub;
-	IOnlineFriendsPtr OnlineFriendsPtr;
 
 protected:
-	void OnFriendsUpdated(int32 UpdatedPlayerIndex, bool bWasSuccessful, const FString& FriendListName, const FString& ErrorString);
+	void OnFriendsListChanged(int32 UpdatedUserNum, uint32 Version);
+
+	/** rebuilds the menu items from the cached friends list if it changed since they were built */
+	void RefreshFriendItems();
+
+	/** shared friends cache */
+	TWeakPtr<FTrueFPSPresenceCoordinator> PresenceCoordinator;
+
+	FDelegateHandle FriendsListChangedHandle;
+
+	/** version of the cached friends list the menu items were built from */
+	uint32 DisplayedFriendsVersion;
 
 	/** User settings pointer */
 	UTrueFPSGameUserSettings* UserSettings;
@@ -132,17 +132,9 @@ bool FTrueFPSIngameMenu::GetIsGameMenuUp() const
 
 void FTrueFPSIngameMenu::UpdateFriendsList()
 {
-	if (PlayerOwner)
+	if (TrueFPSFriends.IsValid())
 	{
-		IOnlineSubsystem* OnlineSub = Online::GetSubsystem(PlayerOwner->GetWorld());
-		if (OnlineSub)
-		{
-			IOnlineFriendsPtr OnlineFriendsPtr = OnlineSub->GetFriendsInterface();
-			if (OnlineFriendsPtr.IsValid())
-			{
-				OnlineFriendsPtr->ReadFriendsList(GetOwnerUserIndex(), EFriendsLists::ToString(EFriendsLists::OnlinePlayers));
-			}
-		}
+		TrueFPSFriends->UpdateFriends(GetOwnerUserIndex());
 	}
 }
 
@@ -219,6 +211,9 @@ void FTrueFPSIngameMenu::ToggleGameMenu()
 		{
 			TrueFPSRecentlyMet->UpdateRecentlyMet(OwnerUserIndex);
 		}
+		// Read once when the menu opens, the friends list follows the backend's change notifications while it's up.
+		// The presence coordinator keeps reads well below the web api rate limit (75 requests / 15 minutes, 0x80552C81 past that).
+		UpdateFriendsList();
 		GameMenuWidget->BuildAndShowMenu();
 		bIsGameMenuUp = true;
 
@@ -4,6 +4,8 @@
 #include "NetworkReplayStreaming.h"
 #include "TrueFPSGameInstance.h"
 #include "TrueFPSGameViewportClient.h"
+#include "Async/Async.h"
+#include "Online/TrueFPSReplayIndex.h"
 #include "UI/Style/TrueFPSStyle.h"
 
 #define LOCTEXT_NAMESPACE "TrueFPSSystem.HUD.Menu"
@@ -16,11 +18,28 @@ struct FDemoEntry
 	int32		ResultsIndex;
 };
 
+/** Number of indexed demos handed to the list at once */
+static const int32 DemoListPageSize = 50;
+
+static TSharedPtr<FDemoEntry> MakeDemoEntry(const FNetworkReplayStreamInfo& StreamInfo)
+{
+	float SizeInKilobytes = StreamInfo.SizeInBytes / 1024.0f;
+
+	TSharedPtr<FDemoEntry> NewDemoEntry = MakeShareable( new FDemoEntry() );
+
+	NewDemoEntry->StreamInfo	= StreamInfo;
+	NewDemoEntry->Date			= StreamInfo.Timestamp.ToString( TEXT( "%m/%d/%Y %h:%M %A" ) );	// UTC time
+	NewDemoEntry->Size			= SizeInKilobytes >= 1024.0f ? FString::Printf( TEXT("%2.2f MB" ), SizeInKilobytes / 1024.0f ) : FString::Printf( TEXT("%i KB" ), (int)SizeInKilobytes );
+
+	return NewDemoEntry;
+}
+
 void STrueFPSDemoList::Construct(const FArguments& InArgs)
 {
 	PlayerOwner			= InArgs._PlayerOwner;
 	OwnerWidget			= InArgs._OwnerWidget;
 	bUpdatingDemoList	= false;
+	BuildSerial			= 0;
 	StatusText			= FText::GetEmpty();
 	
 	EnumerateStreamsVersion = FNetworkVersion::GetReplayVersion();
@@ -88,6 +107,7 @@ void STrueFPSDemoList::Construct(const FArguments& InArgs)
 	];
 
 	ReplayStreamer = FNetworkReplayStreaming::Get().GetFactory().CreateReplayStreamer();
+	FTrueFPSReplayIndex::GetDemoDirectory(ReplayStreamer, DemoDirectory);
 
 	BuildDemoList();
 }
@@ -98,17 +118,25 @@ void STrueFPSDemoList::OnEnumerateStreamsComplete(const FEnumerateStreamsResult&
 
 	bool bFinished = true;
 
+	// Replaces whatever the out of date index listed, keeping the selected demo selected
+	const FString SelectedStreamName = SelectedItem.IsValid() ? SelectedItem->StreamInfo.Name : FString();
+	DemoList.Reset( Result.FoundStreams.Num() );
+
 	for ( const auto& StreamInfo : Result.FoundStreams )
 	{
-		float SizeInKilobytes = StreamInfo.SizeInBytes / 1024.0f;
-
-		TSharedPtr<FDemoEntry> NewDemoEntry = MakeShareable( new FDemoEntry() );
-
-		NewDemoEntry->StreamInfo	= StreamInfo;
-		NewDemoEntry->Date			= StreamInfo.Timestamp.ToString( TEXT( "%m/%d/%Y %h:%M %A" ) );	// UTC time
-		NewDemoEntry->Size			= SizeInKilobytes >= 1024.0f ? FString::Printf( TEXT("%2.2f MB" ), SizeInKilobytes / 1024.0f ) : FString::Printf( TEXT("%i KB" ), (int)SizeInKilobytes );
+		DemoList.Add( MakeDemoEntry( StreamInfo ) );
+		if ( StreamInfo.Name == SelectedStreamName )
+		{
+			SelectedItem = DemoList.Last();
+		}
+	}
 
-		DemoList.Add( NewDemoEntry );
+	if ( Result.WasSuccessful() && !DemoDirectory.IsEmpty() )
+	{
+		Async( EAsyncExecution::ThreadPool, [ DemoDirectory = DemoDirectory, Version = EnumerateStreamsVersion, Streams = Result.FoundStreams ]()
+		{
+			FTrueFPSReplayIndex::Save( DemoDirectory, Version, Streams );
+		});
 	}
 
 	// Sort demo names by date
@@ -178,9 +206,82 @@ void STrueFPSDemoList::BuildDemoList()
 {
 	bUpdatingDemoList = true;
 	DemoList.Empty();
+	DemoListWidget->RequestListRefresh();
 
-	if ( ReplayStreamer.IsValid() )
+	const int32 Serial = ++BuildSerial;
+	TWeakPtr<STrueFPSDemoList> WeakThis = SharedThis(this);
+
+	// Replays that aren't local files have no index, the streamer lists them
+	if (DemoDirectory.IsEmpty())
+	{
+		OnReplayIndexRead(false);
+		return;
+	}
+
+	// Read the index in the background and hand the demos over a page at a time, so the first rows show up right away
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Serial, DemoDirectory = DemoDirectory, Version = EnumerateStreamsVersion]()
 	{
+		TArray<FTrueFPSReplayIndexEntry> Entries;
+		bool bIsStale = true;
+		const bool bLoaded = FTrueFPSReplayIndex::Load(DemoDirectory, Version, Entries, bIsStale);
+
+		for (int32 PageStart = 0; PageStart < Entries.Num(); PageStart += DemoListPageSize)
+		{
+			TArray<FNetworkReplayStreamInfo> Page;
+			const int32 PageEnd = FMath::Min(PageStart + DemoListPageSize, Entries.Num());
+			Page.Reserve(PageEnd - PageStart);
+			for (int32 i = PageStart; i < PageEnd; ++i)
+			{
+				Page.Add(MoveTemp(Entries[i].StreamInfo));
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, Page = MoveTemp(Page)]()
+			{
+				TSharedPtr<STrueFPSDemoList> DemoListPtr = WeakThis.Pin();
+				if (DemoListPtr.IsValid() && DemoListPtr->BuildSerial == Serial)
+				{
+					DemoListPtr->AddDemoEntries(Page);
+				}
+			});
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, bIndexValid = bLoaded && !bIsStale]()
+		{
+			TSharedPtr<STrueFPSDemoList> DemoListPtr = WeakThis.Pin();
+			if (DemoListPtr.IsValid() && DemoListPtr->BuildSerial == Serial)
+			{
+				DemoListPtr->OnReplayIndexRead(bIndexValid);
+			}
+		});
+	});
+}
+
+void STrueFPSDemoList::AddDemoEntries(const TArray<FNetworkReplayStreamInfo>& Streams)
+{
+	const bool bWasEmpty = DemoList.Num() == 0;
+
+	for ( const FNetworkReplayStreamInfo& StreamInfo : Streams )
+	{
+		DemoList.Add( MakeDemoEntry( StreamInfo ) );
+	}
+
+	DemoListWidget->RequestListRefresh();
+	if (bWasEmpty && DemoList.Num() > 0)
+	{
+		DemoListWidget->SetSelection(DemoList[0], ESelectInfo::OnNavigation);
+	}
+}
+
+void STrueFPSDemoList::OnReplayIndexRead(bool bIndexValid)
+{
+	if ( bIndexValid )
+	{
+		StatusText = LOCTEXT("DemoSelectionInfo","Press ENTER to Play. Press DEL to delete.");
+		OnBuildDemoListFinished();
+	}
+	else if ( ReplayStreamer.IsValid() )
+	{
+		// Replays were recorded or changed since the index was written, the streamer has the final say
 		ReplayStreamer->EnumerateStreams(EnumerateStreamsVersion, INDEX_NONE, FString(), TArray<FString>(), FEnumerateStreamsCallback::CreateSP(this, &STrueFPSDemoList::OnEnumerateStreamsComplete));
 	}
 }
@@ -259,7 +360,6 @@ FReply STrueFPSDemoList::OnDemoDeleteConfirm()
 	if (SelectedItem.IsValid() && ReplayStreamer.IsValid())
 	{
 		bUpdatingDemoList = true;
-		DemoList.Empty();
 
 		ReplayStreamer->DeleteFinishedStream(SelectedItem->StreamInfo.Name, FDeleteFinishedStreamCallback::CreateSP(this, &STrueFPSDemoList::OnDeleteFinishedStreamComplete));
 	}
@@ -298,7 +398,26 @@ FReply STrueFPSDemoList::OnDemoDeleteCancel()
 
 void STrueFPSDemoList::OnDeleteFinishedStreamComplete(const FDeleteFinishedStreamResult& Result)
 {
-	BuildDemoList();
+	const int32 DeletedIndex = DemoList.IndexOfByKey(SelectedItem);
+	if (!Result.WasSuccessful() || DeletedIndex == INDEX_NONE)
+	{
+		BuildDemoList();
+		return;
+	}
+
+	// Drop the deleted demo from the list and the index instead of enumerating everything again
+	const FString DeletedStreamName = SelectedItem->StreamInfo.Name;
+	if (!DemoDirectory.IsEmpty())
+	{
+		Async(EAsyncExecution::ThreadPool, [DemoDirectory = DemoDirectory, DeletedStreamName]()
+		{
+			FTrueFPSReplayIndex::Remove(DemoDirectory, DeletedStreamName);
+		});
+	}
+
+	DemoList.RemoveAt(DeletedIndex);
+	SelectedItem = DemoList.IsValidIndex(DeletedIndex) ? DemoList[DeletedIndex] : (DemoList.Num() > 0 ? DemoList.Last() : nullptr);
+	OnBuildDemoListFinished();
 }
 
 void STrueFPSDemoList::OnFocusLost(const FFocusEvent& InFocusEvent)
@@ -49,9 +49,15 @@ public:
 	/** Updates the list until it's completely populated */
 	void UpdateBuildDemoListStatus();
 
-	/** Populates the demo list */
+	/** Populates the demo list, from the replay index first and from the replay streamer if the index is out of date */
 	void BuildDemoList();
 
+	/** Appends a page of demos read from the replay index */
+	void AddDemoEntries(const TArray<FNetworkReplayStreamInfo>& Streams);
+
+	/** Called once the whole replay index has been read */
+	void OnReplayIndexRead(bool bIndexValid);
+
 	/** Called when demo list building finished */
 	void OnBuildDemoListFinished();
 
@@ -100,6 +106,9 @@ protected:
 	/** Whether we're building the demo list or not */
 	bool bUpdatingDemoList;
 
+	/** Bumped every time the list is rebuilt, pages read for an older build are dropped */
+	int32 BuildSerial;
+
 	/** action bindings array */
 	TArray< TSharedPtr<FDemoEntry> > DemoList;
 
@@ -123,6 +132,9 @@ protected:
 
 	/** Network replay streaming interface */
 	TSharedPtr<INetworkReplayStreamer> ReplayStreamer;
+
+	/** where the streamer records its replays, empty if they can't be indexed and are always enumerated */
+	FString DemoDirectory;
 };
 
 
@@ -2,8 +2,10 @@
 
 #include "STrueFPSLeaderboard.h"
 #include "OnlineSubsystemUtils.h"
+#include "TrueFPSGameInstance.h"
 #include "TrueFPSLeaderboards.h"
 #include "TrueFPSSystem.h"
+#include "Online/TrueFPSLeaderboardCache.h"
 #include "UI/TrueFPSUIHelpers.h"
 #include "UI/Style/TrueFPSStyle.h"
 
@@ -11,10 +13,14 @@
 #define INTERACTIVE_LEADERBOARD	0
 #endif
 
+/** pages kept in the list, the ones furthest from where the player scrolled to are dropped */
+static constexpr int32 MaxLoadedPages = 4;
+
 FLeaderboardRow::FLeaderboardRow(const FOnlineStatsRow& Row)
 	: Rank(FString::FromInt(Row.Rank))
 	, PlayerName(Row.NickName)
 	, PlayerId(Row.PlayerId)
+	, RankValue(Row.Rank)
 {
 	if (const FVariantData* ScoreData = Row.Columns.Find(LEADERBOARD_STAT_SCORE))
 	{
@@ -30,8 +36,10 @@ void STrueFPSLeaderboard::Construct(const FArguments& InArgs)
 	OwnerWidget = InArgs._OwnerWidget;
 	const int32 BoxWidth = 125;
 	bReadingStats = false;
-
-	LeaderboardReadCompleteDelegate = FOnLeaderboardReadCompleteDelegate::CreateRaw(this, &STrueFPSLeaderboard::OnStatsRead);
+	ReadSerial = 0;
+	FirstPage = INDEX_NONE;
+	LastPage = INDEX_NONE;
+	OwnerRank = 0;
 
 	ChildSlot
 	.VAlign(VAlign_Fill)
@@ -101,64 +109,153 @@ void STrueFPSLeaderboard::OnLoginCompleteReadStats(int32 LocalUserNum, bool bWas
 	}
 }
 
+TSharedPtr<FTrueFPSLeaderboardCache> STrueFPSLeaderboard::GetLeaderboardCache() const
+{
+	UTrueFPSGameInstance* const GI = PlayerOwner.IsValid() ? Cast<UTrueFPSGameInstance>(PlayerOwner->GetGameInstance()) : nullptr;
+	return GI ? GI->GetLeaderboardCache() : nullptr;
+}
+
 /** Starts reading leaderboards for the game */
 void STrueFPSLeaderboard::ReadStats()
 {
 	StatRows.Reset();
+	RowListWidget->RequestListRefresh();
+	FirstPage = INDEX_NONE;
+	LastPage = INDEX_NONE;
+	OwnerRank = 0;
 
-	IOnlineSubsystem* const OnlineSub = Online::GetSubsystem(GetWorld());
-	if (OnlineSub)
+	TSharedPtr<FTrueFPSLeaderboardCache> LeaderboardCache = GetLeaderboardCache();
+	if (LeaderboardCache.IsValid())
 	{
-		IOnlineLeaderboardsPtr Leaderboards = OnlineSub->GetLeaderboardsInterface();
-		if (Leaderboards.IsValid())
-		{
-			// We are about to read the stats. The delegate will set this to false once the read is complete.
-			LeaderboardReadCompleteDelegateHandle = Leaderboards->AddOnLeaderboardReadCompleteDelegate_Handle(LeaderboardReadCompleteDelegate);
-			bReadingStats = true;
+		check(PlayerOwner.IsValid());
 
-			// There's no reason to request leaderboard requests while one is in progress, so only do it if there isn't one active.
-			if (!IsLeaderboardReadInProgress())
-			{
-				ReadObject = MakeShareable(new FTrueFPSAllTimeMatchResultsRead());
-				FOnlineLeaderboardReadRef ReadObjectRef = ReadObject.ToSharedRef();
+		// Find the player's rank first, the pages around it are read from there. Reading again while the menu is
+		// reopened quickly is fine, the cache hands out the rows it has or joins the read already in flight.
+		bReadingStats = true;
+		LeaderboardCache->ReadAroundUser(PlayerOwner->GetPreferredUniqueNetId(), FOnLeaderboardCacheReadComplete::CreateSP(this, &STrueFPSLeaderboard::OnStatsRead, ++ReadSerial));
+	}
+	else
+	{
+		// TODO: message the user?
+	}
+}
 
-				check(PlayerOwner.IsValid());
-				FUniqueNetIdRepl OwnerNetId = PlayerOwner->GetPreferredUniqueNetId();
-				TArray<TSharedRef<const FUniqueNetId> > Players;
-				Players.Add(OwnerNetId->AsShared());
+/** Called on a particular leaderboard read */
+void STrueFPSLeaderboard::OnStatsRead(bool bWasSuccessful, uint32 Serial)
+{
+	TSharedPtr<FTrueFPSLeaderboardCache> LeaderboardCache = GetLeaderboardCache();
+	if (Serial != ReadSerial || !LeaderboardCache.IsValid() || !PlayerOwner.IsValid())
+	{
+		return;
+	}
 
-				bReadingStats = Leaderboards->ReadLeaderboards(Players, ReadObjectRef);
+	const FUniqueNetIdRepl OwnerNetId = PlayerOwner->GetPreferredUniqueNetId();
+	const TArray<FOnlineStatsRow>* Rows = bWasSuccessful ? LeaderboardCache->GetRowsAroundUser(OwnerNetId) : nullptr;
+	if (Rows)
+	{
+		for (const FOnlineStatsRow& Row : *Rows)
+		{
+			if (Row.PlayerId.IsValid() && OwnerNetId.IsValid() && *Row.PlayerId == *OwnerNetId)
+			{
+				OwnerRank = Row.Rank;
 			}
 		}
-		else
+
+		// Show what we have straight away, the page replaces it once read
+		for (const FOnlineStatsRow& Row : *Rows)
 		{
-			// TODO: message the user?
+			StatRows.Add(MakeShareable(new FLeaderboardRow(Row)));
 		}
+		RowListWidget->RequestListRefresh();
+	}
+
+	if (OwnerRank > 0)
+	{
+		FirstPage = LastPage = FTrueFPSLeaderboardCache::GetPageIndex(OwnerRank);
+		RequestPage(FirstPage);
+	}
+	else
+	{
+		bReadingStats = false;
 	}
 }
 
-/** Called on a particular leaderboard read */
-void STrueFPSLeaderboard::OnStatsRead(bool bWasSuccessful)
+void STrueFPSLeaderboard::RequestPage(int32 PageIndex)
+{
+	TSharedPtr<FTrueFPSLeaderboardCache> LeaderboardCache = GetLeaderboardCache();
+	if (LeaderboardCache.IsValid())
+	{
+		bReadingStats = true;
+		LeaderboardCache->ReadPage(PageIndex, FOnLeaderboardCacheReadComplete::CreateSP(this, &STrueFPSLeaderboard::OnPageRead, ReadSerial, PageIndex));
+	}
+}
+
+void STrueFPSLeaderboard::OnPageRead(bool bWasSuccessful, uint32 Serial, int32 PageIndex)
 {
-	// It's possible for another read request to happen while another one is ongoing (such as when the player leaves the menu and
-	// re-enters quickly). We only want to process a leaderboard read if our read object is done.
-	if (!IsLeaderboardReadInProgress())
+	if (Serial != ReadSerial)
 	{
-		ClearOnLeaderboardReadCompleteDelegate();
+		return;
+	}
 
-		if (bWasSuccessful)
+	bReadingStats = false;
+
+	if (!bWasSuccessful)
+	{
+		// Keep what is shown, only the page that failed is given up on
+		if (PageIndex == LastPage && LastPage > FirstPage)
 		{
-			for (int Idx = 0; Idx < ReadObject->Rows.Num(); ++Idx)
-			{
-				TSharedPtr<FLeaderboardRow> NewLeaderboardRow = MakeShareable(new FLeaderboardRow(ReadObject->Rows[Idx]));
+			--LastPage;
+		}
+		else if (PageIndex == FirstPage && FirstPage < LastPage)
+		{
+			++FirstPage;
+		}
+		return;
+	}
 
-				StatRows.Add(NewLeaderboardRow);
-			}
+	UpdateStatRows(SelectedItem.IsValid() ? SelectedItem->RankValue : OwnerRank);
+}
 
-			RowListWidget->RequestListRefresh();
+void STrueFPSLeaderboard::UpdateStatRows(int32 SelectRank)
+{
+	TSharedPtr<FTrueFPSLeaderboardCache> LeaderboardCache = GetLeaderboardCache();
+	if (!LeaderboardCache.IsValid() || FirstPage == INDEX_NONE)
+	{
+		return;
+	}
+
+	TArray< TSharedPtr<FLeaderboardRow> > NewRows;
+	TSharedPtr<FLeaderboardRow> NewSelectedItem;
+	for (int32 PageIndex = FirstPage; PageIndex <= LastPage; ++PageIndex)
+	{
+		if (const TArray<FOnlineStatsRow>* Rows = LeaderboardCache->GetPage(PageIndex))
+		{
+			for (const FOnlineStatsRow& Row : *Rows)
+			{
+				// Reads around a rank may run over into the neighbouring pages
+				if (FTrueFPSLeaderboardCache::GetPageIndex(Row.Rank) == PageIndex)
+				{
+					NewRows.Add(MakeShareable(new FLeaderboardRow(Row)));
+					if (Row.Rank == SelectRank)
+					{
+						NewSelectedItem = NewRows.Last();
+					}
+				}
+			}
 		}
+	}
 
-		bReadingStats = false;
+	if (NewRows.Num() == 0)
+	{
+		return;
+	}
+
+	StatRows = MoveTemp(NewRows);
+	RowListWidget->RequestListRefresh();
+	if (NewSelectedItem.IsValid())
+	{
+		RowListWidget->SetSelection(NewSelectedItem);
+		RowListWidget->RequestScrollIntoView(NewSelectedItem);
 	}
 }
 
@@ -220,6 +317,24 @@ void STrueFPSLeaderboard::MoveSelection(int32 MoveBy)
 	{
 		RowListWidget->SetSelection(StatRows[SelectedItemIndex+MoveBy]);
 	}
+	else if (!bReadingStats && FirstPage != INDEX_NONE)
+	{
+		// Scrolled off the loaded pages, read the next one along and drop the furthest one if there are too many
+		TSharedPtr<FTrueFPSLeaderboardCache> LeaderboardCache = GetLeaderboardCache();
+		const TArray<FOnlineStatsRow>* Rows = LeaderboardCache.IsValid() ? LeaderboardCache->GetPage(LastPage) : nullptr;
+		if (MoveBy > 0 && Rows && Rows->Num() >= FTrueFPSLeaderboardCache::PageSize)
+		{
+			++LastPage;
+			FirstPage = FMath::Max(FirstPage, LastPage - MaxLoadedPages + 1);
+			RequestPage(LastPage);
+		}
+		else if (MoveBy < 0 && FirstPage > 0)
+		{
+			--FirstPage;
+			LastPage = FMath::Min(LastPage, FirstPage + MaxLoadedPages - 1);
+			RequestPage(FirstPage);
+		}
+	}
 }
 
 FReply STrueFPSLeaderboard::OnKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent) 
@@ -240,7 +355,8 @@ FReply STrueFPSLeaderboard::OnKeyDown(const FGeometry& MyGeometry, const FKeyEve
 	{
 		if (bReadingStats)
 		{
-			ClearOnLeaderboardReadCompleteDelegate();
+			// The read carries on in the cache, we just stop waiting for it
+			++ReadSerial;
 			bReadingStats = false;
 		}
 	}
@@ -298,21 +414,3 @@ TSharedRef<ITableRow> STrueFPSLeaderboard::MakeListViewWidget(TSharedPtr<FLeader
 	};
 	return SNew(SLeaderboardRowWidget, OwnerTable, Item);
 }
-
-void STrueFPSLeaderboard::ClearOnLeaderboardReadCompleteDelegate()
-{
-	IOnlineSubsystem* OnlineSub = Online::GetSubsystem(GetWorld());
-	if (OnlineSub)
-	{
-		IOnlineLeaderboardsPtr Leaderboards = OnlineSub->GetLeaderboardsInterface();
-		if (Leaderboards.IsValid())
-		{
-			Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(LeaderboardReadCompleteDelegateHandle);
-		}
-	}
-}
-
-bool STrueFPSLeaderboard::IsLeaderboardReadInProgress()
-{
-	return ReadObject.IsValid() && (ReadObject->ReadState == EOnlineAsyncTaskState::InProgress || ReadObject->ReadState == EOnlineAsyncTaskState::NotStarted);
-}
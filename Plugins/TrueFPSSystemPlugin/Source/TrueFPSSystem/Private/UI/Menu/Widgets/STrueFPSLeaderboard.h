@@ -22,6 +22,9 @@ struct FLeaderboardRow
 	/** Unique Id for the player at this rank */
 	const TSharedPtr<const FUniqueNetId> PlayerId;
 
+	/** player rank, as a number */
+	const int32 RankValue;
+
 	/** Default Constructor */
 	FLeaderboardRow(const FOnlineStatsRow& Row);
 };
@@ -68,11 +71,14 @@ public:
 	/** profile open ui handler */
 	bool ProfileUIOpened() const;
 
-	/** Starts reading leaderboards for the game */
+	/** Starts reading leaderboards for the game, from the page the local player is on */
 	void ReadStats();
 
-	/** Called on a particular leaderboard read */
-	void OnStatsRead(bool bWasSuccessful);
+	/** Called when the rows around the local player have been read */
+	void OnStatsRead(bool bWasSuccessful, uint32 Serial);
+
+	/** Called when a page of the leaderboard has been read */
+	void OnPageRead(bool bWasSuccessful, uint32 Serial, int32 PageIndex);
 
 	/** Called to login on relevant platforms first before making a leaderboard read */
 	void ReadStatsLoginRequired();
@@ -87,23 +93,30 @@ public:
 
 protected:
 
-	/** Removes the bound LeaderboardReadCompleteDelegate if possible*/
-	void ClearOnLeaderboardReadCompleteDelegate();
+	/** Requests a page, from the cache if it's still fresh */
+	void RequestPage(int32 PageIndex);
 
-	/** Returns true if a leaderboard read request is in progress or scheduled */
-	bool IsLeaderboardReadInProgress();
+	/** Rebuilds the rows from the loaded pages, keeping the selected rank selected */
+	void UpdateStatRows(int32 SelectRank);
+
+	/** @return the leaderboard cache of the game instance */
+	TSharedPtr<class FTrueFPSLeaderboardCache> GetLeaderboardCache() const;
 
 	/** action bindings array */
 	TArray< TSharedPtr<FLeaderboardRow> > StatRows;
 
-	/** Leaderboard read object */
-	FOnlineLeaderboardReadPtr ReadObject;
-
 	/** Indicates that a stats read operation has been initiated */
 	bool bReadingStats;
 
-	/** Delegate called when a leaderboard has been successfully read */
-	FOnLeaderboardReadCompleteDelegate LeaderboardReadCompleteDelegate;
+	/** bumped by each new read and by cancelling, completions from older reads are ignored */
+	uint32 ReadSerial;
+
+	/** range of leaderboard pages the rows are built from, INDEX_NONE before the first page is read */
+	int32 FirstPage;
+	int32 LastPage;
+
+	/** rank of the local player, 0 if not ranked */
+	int32 OwnerRank;
 
 	/** action bindings list slate widget */
 	TSharedPtr< SListView< TSharedPtr<FLeaderboardRow> > > RowListWidget; 
@@ -117,9 +130,6 @@ protected:
 	/** pointer to our parent widget */
 	TSharedPtr<class SWidget> OwnerWidget;
 
-	/** Handle to the registered LeaderboardReadComplete delegate */
-	FDelegateHandle LeaderboardReadCompleteDelegateHandle;
-	
 	/** Handle to the registered LoginComplete delegate */
 	FDelegateHandle OnLoginCompleteDelegateHandle;
 };
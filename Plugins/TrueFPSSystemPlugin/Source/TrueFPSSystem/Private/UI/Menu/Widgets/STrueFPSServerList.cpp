@@ -4,6 +4,7 @@
 
 #include "TrueFPSSystem.h"
 #include "TrueFPSGameInstance.h"
+#include "Async/Async.h"
 #include "Online/TrueFPSGameSession.h"
 #include "UI/Style/TrueFPSStyle.h"
 
@@ -19,6 +20,9 @@ void STrueFPSServerList::Construct(const FArguments& InArgs)
 	StatusText = FText::GetEmpty();
 	BoxWidth = 125;
 	LastSearchTime = 0.0f;
+	FilterSerial = 0;
+	SortColumn = "Ping";
+	SortMode = EColumnSortMode::Ascending;
 	
 #if PLATFORM_SWITCH
 	MinTimeBetweenSearches = 6.0;
@@ -50,8 +54,11 @@ void STrueFPSServerList::Construct(const FArguments& InArgs)
 					+ SHeaderRow::Column("ServerName").FixedWidth(BoxWidth*2) .DefaultLabel(NSLOCTEXT("ServerList", "ServerNameColumn", "Server Name"))
 					+ SHeaderRow::Column("GameType") .DefaultLabel(NSLOCTEXT("ServerList", "GameTypeColumn", "Game Type"))
 					+ SHeaderRow::Column("Map").DefaultLabel(NSLOCTEXT("ServerList", "MapNameColumn", "Map"))
+						.SortMode(this, &STrueFPSServerList::GetColumnSortMode, FName("Map")).OnSort(this, &STrueFPSServerList::OnColumnSortModeChanged)
 					+ SHeaderRow::Column("Players") .DefaultLabel(NSLOCTEXT("ServerList", "PlayersColumn", "Players"))
-					+ SHeaderRow::Column("Ping") .DefaultLabel(NSLOCTEXT("ServerList", "NetworkPingColumn", "Ping")))
+						.SortMode(this, &STrueFPSServerList::GetColumnSortMode, FName("Players")).OnSort(this, &STrueFPSServerList::OnColumnSortModeChanged)
+					+ SHeaderRow::Column("Ping") .DefaultLabel(NSLOCTEXT("ServerList", "NetworkPingColumn", "Ping"))
+						.SortMode(this, &STrueFPSServerList::GetColumnSortMode, FName("Ping")).OnSort(this, &STrueFPSServerList::OnColumnSortModeChanged))
 			]
 		]
 		+SVerticalBox::Slot()
@@ -73,6 +80,14 @@ void STrueFPSServerList::Construct(const FArguments& InArgs)
 	];
 }
 
+STrueFPSServerList::~STrueFPSServerList()
+{
+	if (ATrueFPSGameSession* GameSession = SearchingGameSession.Get())
+	{
+		GameSession->OnFindSessionsComplete().Remove(OnFindSessionsCompleteHandle);
+	}
+}
+
 /** 
  * Get the current game session
  */
@@ -106,7 +121,6 @@ void STrueFPSServerList::UpdateSearchStatus()
 			case EOnlineAsyncTaskState::Done:
 				// copy the results
 				{
-					ServerList.Empty();
 					const TArray<FOnlineSessionSearchResult> & SearchResults = TrueFPSGameSession->GetSearchResults();
 					check(SearchResults.Num() == NumSearchResults);
 					if (NumSearchResults == 0)
@@ -130,27 +144,7 @@ void STrueFPSServerList::UpdateSearchStatus()
 #endif
 					}
 
-					for (int32 IdxResult = 0; IdxResult < NumSearchResults; ++IdxResult)
-					{
-						TSharedPtr<FServerEntry> NewServerEntry = MakeShareable(new FServerEntry());
-
-						const FOnlineSessionSearchResult& Result = SearchResults[IdxResult];
-
-						NewServerEntry->ServerName = Result.Session.OwningUserName;
-						NewServerEntry->Ping = FString::FromInt(Result.PingInMs);
-						NewServerEntry->CurrentPlayers = FString::FromInt(Result.Session.SessionSettings.NumPublicConnections 
-							+ Result.Session.SessionSettings.NumPrivateConnections 
-							- Result.Session.NumOpenPublicConnections 
-							- Result.Session.NumOpenPrivateConnections);
-						NewServerEntry->MaxPlayers = FString::FromInt(Result.Session.SessionSettings.NumPublicConnections
-							+ Result.Session.SessionSettings.NumPrivateConnections);
-						NewServerEntry->SearchResultsIndex = IdxResult;
-					
-						Result.Session.SessionSettings.Get(SETTING_GAMEMODE, NewServerEntry->GameType);
-						Result.Session.SessionSettings.Get(SETTING_MAPNAME, NewServerEntry->MapName);
-
-						ServerList.Add(NewServerEntry);
-					}
+					MergeSearchResults(SearchResults, ServerEntries);
 				}
 				break;
 
@@ -158,6 +152,8 @@ void STrueFPSServerList::UpdateSearchStatus()
 				// intended fall-through
 			case EOnlineAsyncTaskState::NotStarted:
 				StatusText = FText::GetEmpty();
+				// the listed entries point into results that are gone now
+				ServerEntries.Reset();
 				// intended fall-through
 			default:
 				break;
@@ -170,26 +166,64 @@ void STrueFPSServerList::UpdateSearchStatus()
 	}
 }
 
-
-FText STrueFPSServerList::GetBottomText() const
+void STrueFPSServerList::OnFindSessionsComplete(bool bWasSuccessful)
 {
-	 return StatusText;
+	if (ATrueFPSGameSession* GameSession = SearchingGameSession.Get())
+	{
+		GameSession->OnFindSessionsComplete().Remove(OnFindSessionsCompleteHandle);
+	}
+	SearchingGameSession.Reset();
+
+	if (bSearchingForServers)
+	{
+		UpdateSearchStatus();
+	}
 }
 
-/**
- * Ticks this widget.  Override in derived classes, but always call the parent implementation.
- *
- * @param  InCurrentTime  Current absolute real time
- * @param  InDeltaTime  Real time passed since last tick
- */
-void STrueFPSServerList::Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime )
+void STrueFPSServerList::MergeSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults, TMap< FString, TSharedPtr<FServerEntry> >& Entries)
 {
-	SCompoundWidget::Tick( AllottedGeometry, InCurrentTime, InDeltaTime );
+	TMap< FString, TSharedPtr<FServerEntry> > MergedEntries;
+	MergedEntries.Reserve(SearchResults.Num());
 
-	if ( bSearchingForServers )
+	for (int32 IdxResult = 0; IdxResult < SearchResults.Num(); ++IdxResult)
 	{
-		UpdateSearchStatus();
+		const FOnlineSessionSearchResult& Result = SearchResults[IdxResult];
+
+		FServerEntry NewServerEntry;
+		NewServerEntry.SessionId = Result.GetSessionIdStr();
+		NewServerEntry.ServerName = Result.Session.OwningUserName;
+		NewServerEntry.PingInMs = Result.PingInMs;
+		NewServerEntry.Ping = FString::FromInt(Result.PingInMs);
+		NewServerEntry.NumPlayers = Result.Session.SessionSettings.NumPublicConnections 
+			+ Result.Session.SessionSettings.NumPrivateConnections 
+			- Result.Session.NumOpenPublicConnections 
+			- Result.Session.NumOpenPrivateConnections;
+		NewServerEntry.CurrentPlayers = FString::FromInt(NewServerEntry.NumPlayers);
+		NewServerEntry.MaxPlayers = FString::FromInt(Result.Session.SessionSettings.NumPublicConnections
+			+ Result.Session.SessionSettings.NumPrivateConnections);
+		NewServerEntry.SearchResultsIndex = IdxResult;
+
+		Result.Session.SessionSettings.Get(SETTING_GAMEMODE, NewServerEntry.GameType);
+		Result.Session.SessionSettings.Get(SETTING_MAPNAME, NewServerEntry.MapName);
+
+		// Entries are never modified once listed (a worker may be sorting them), changed servers get a new entry and with it a new row
+		const TSharedPtr<FServerEntry>* ExistingEntry = Entries.Find(NewServerEntry.SessionId);
+		if (ExistingEntry && (*ExistingEntry)->IsSameAs(NewServerEntry))
+		{
+			MergedEntries.Add(NewServerEntry.SessionId, *ExistingEntry);
+		}
+		else
+		{
+			MergedEntries.Add(NewServerEntry.SessionId, MakeShareable(new FServerEntry(MoveTemp(NewServerEntry))));
+		}
 	}
+
+	Entries = MoveTemp(MergedEntries);
+}
+
+FText STrueFPSServerList::GetBottomText() const
+{
+	 return StatusText;
 }
 
 /** Starts searching for servers */
@@ -206,13 +240,22 @@ void STrueFPSServerList::BeginServerSearch(bool bLANMatch, bool bIsDedicatedServ
 		bDedicatedServer = bIsDedicatedServer;
 		MapFilterName = InMapFilterName;
 		bSearchingForServers = true;
-		ServerList.Empty();
 		LastSearchTime = CurrentTime;
+		StatusText = LOCTEXT("Searching","SEARCHING...");
 
+		// Bound before searching in case the search completes right away
+		ATrueFPSGameSession* GameSession = GetGameSession();
+		if (GameSession && !SearchingGameSession.IsValid())
+		{
+			SearchingGameSession = GameSession;
+			OnFindSessionsCompleteHandle = GameSession->OnFindSessionsComplete().AddSP(this, &STrueFPSServerList::OnFindSessionsComplete);
+		}
+
+		// The previous results stay listed until the new ones are merged in
 		UTrueFPSGameInstance* const GI = Cast<UTrueFPSGameInstance>(PlayerOwner->GetGameInstance());
-		if (GI)
+		if (!GI || !GI->FindSessions(PlayerOwner.Get(), bIsDedicatedServer, bLANMatchSearch))
 		{
-			GI->FindSessions(PlayerOwner.Get(), bIsDedicatedServer, bLANMatchSearch);
+			OnServerSearchFailedToStart();
 		}
 	}
 }
@@ -225,31 +268,114 @@ void STrueFPSServerList::OnServerSearchFinished()
 	UpdateServerList();
 }
 
+void STrueFPSServerList::OnServerSearchFailedToStart()
+{
+	if (ATrueFPSGameSession* GameSession = SearchingGameSession.Get())
+	{
+		GameSession->OnFindSessionsComplete().Remove(OnFindSessionsCompleteHandle);
+	}
+	SearchingGameSession.Reset();
+
+	StatusText = FText::GetEmpty();
+	// the listed entries point into the previous results, a new search replaced them
+	ServerEntries.Reset();
+
+	// Searching again right away is allowed
+	LastSearchTime = 0.0;
+
+	OnServerSearchFinished();
+}
+
 void STrueFPSServerList::UpdateServerList()
 {
-	/** Only filter maps if a specific map is specified */
-	if (MapFilterName != "Any")
+	TArray< TSharedPtr<FServerEntry> > Servers;
+	ServerEntries.GenerateValueArray(Servers);
+
+	const int32 Serial = ++FilterSerial;
+	TWeakPtr<STrueFPSServerList> WeakThis = SharedThis(this);
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Serial, Servers = MoveTemp(Servers), FilterName = MapFilterName, Column = SortColumn, Mode = SortMode]() mutable
 	{
-		for (int32 i = 0; i < ServerList.Num(); ++i)
+		FilterAndSortServers(Servers, FilterName, Column, Mode);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, Servers = MoveTemp(Servers)]() mutable
 		{
-			/** Only filter maps if a specific map is specified */
-			if (ServerList[i]->MapName != MapFilterName)
+			TSharedPtr<STrueFPSServerList> ServerListPtr = WeakThis.Pin();
+			if (ServerListPtr.IsValid() && ServerListPtr->FilterSerial == Serial)
 			{
-				ServerList.RemoveAt(i);
-				i--;
+				ServerListPtr->ApplyServerList(MoveTemp(Servers));
 			}
-		}
+		});
+	});
+}
+
+void STrueFPSServerList::FilterAndSortServers(TArray< TSharedPtr<FServerEntry> >& Servers, const FString& InMapFilterName, FName InSortColumn, EColumnSortMode::Type InSortMode)
+{
+	/** Only filter maps if a specific map is specified */
+	if (InMapFilterName != "Any")
+	{
+		Servers.RemoveAll([&InMapFilterName](const TSharedPtr<FServerEntry>& Server)
+		{
+			return Server->MapName != InMapFilterName;
+		});
 	}
 
-	int32 SelectedItemIndex = ServerList.IndexOfByKey(SelectedItem);
+	if (InSortMode == EColumnSortMode::None)
+	{
+		return;
+	}
+
+	const bool bAscending = InSortMode == EColumnSortMode::Ascending;
+	Servers.StableSort([InSortColumn, bAscending](const TSharedPtr<FServerEntry>& A, const TSharedPtr<FServerEntry>& B)
+	{
+		int32 Difference;
+		if (InSortColumn == "Players")
+		{
+			Difference = A->NumPlayers - B->NumPlayers;
+		}
+		else if (InSortColumn == "Map")
+		{
+			Difference = A->MapName.Compare(B->MapName, ESearchCase::IgnoreCase);
+		}
+		else
+		{
+			Difference = A->PingInMs - B->PingInMs;
+		}
+		return bAscending ? Difference < 0 : Difference > 0;
+	});
+}
+
+void STrueFPSServerList::ApplyServerList(TArray< TSharedPtr<FServerEntry> >&& FilteredServerList)
+{
+	ServerList = MoveTemp(FilteredServerList);
 
+	// Keep the selected server selected even if its entry was replaced
+	const FString SelectedSessionId = SelectedItem.IsValid() ? SelectedItem->SessionId : FString();
+	int32 SelectedItemIndex = ServerList.IndexOfByPredicate([&SelectedSessionId](const TSharedPtr<FServerEntry>& Server)
+	{
+		return Server->SessionId == SelectedSessionId;
+	});
+
+	// Only entries the list hasn't seen before get new rows
 	ServerListWidget->RequestListRefresh();
 	if (ServerList.Num() > 0)
 	{
 		ServerListWidget->UpdateSelectionSet();
 		ServerListWidget->SetSelection(ServerList[SelectedItemIndex > -1 ? SelectedItemIndex : 0],ESelectInfo::OnNavigation);
 	}
+}
 
+EColumnSortMode::Type STrueFPSServerList::GetColumnSortMode(FName ColumnId) const
+{
+	return ColumnId == SortColumn ? SortMode : EColumnSortMode::None;
+}
+
+void STrueFPSServerList::OnColumnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type NewSortMode)
+{
+	SortColumn = ColumnId;
+	SortMode = NewSortMode;
+
+	UpdateServerList();
 }
 
 void STrueFPSServerList::ConnectToServer()
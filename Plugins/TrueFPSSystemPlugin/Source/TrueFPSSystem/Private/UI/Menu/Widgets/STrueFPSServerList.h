@@ -7,16 +7,28 @@
 #include "STrueFPSMenuWidget.h"
 
 class ATrueFPSGameSession;
+class FOnlineSessionSearchResult;
 
 struct FServerEntry
 {
+	FString SessionId;
 	FString ServerName;
 	FString CurrentPlayers;
 	FString MaxPlayers;
 	FString GameType;
 	FString MapName;
 	FString Ping;
+	int32 NumPlayers;
+	int32 PingInMs;
 	int32 SearchResultsIndex;
+
+	/** whether both entries show the same row and join the same search result */
+	bool IsSameAs(const FServerEntry& Other) const
+	{
+		return SessionId == Other.SessionId && SearchResultsIndex == Other.SearchResultsIndex && PingInMs == Other.PingInMs
+			&& CurrentPlayers == Other.CurrentPlayers && MaxPlayers == Other.MaxPlayers && ServerName == Other.ServerName
+			&& GameType == Other.GameType && MapName == Other.MapName;
+	}
 };
 
 //class declare
@@ -34,6 +46,8 @@ public:
 	/** needed for every widget */
 	void Construct(const FArguments& InArgs);
 
+	virtual ~STrueFPSServerList();
+
 	/** if we want to receive focus */
 	virtual bool SupportsKeyboardFocus() const override { return true; }
 
@@ -65,30 +79,42 @@ public:
 	/** Updates current search status */
 	void UpdateSearchStatus();
 
+	/** Called by the game session once the search has completed */
+	void OnFindSessionsComplete(bool bWasSuccessful);
+
 	/** Starts searching for servers */
 	void BeginServerSearch(bool bLANMatch, bool bIsDedicatedServer, const FString& InMapFilterName);
 
 	/** Called when server search is finished */
 	void OnServerSearchFinished();
 
-	/** fill/update server list, should be called before showing this control */
+	/** Called when the search couldn't be started, nothing would complete it */
+	void OnServerSearchFailedToStart();
+
+	/** fill/update server list, should be called before showing this control. filtering and sorting runs on a worker thread */
 	void UpdateServerList();
 
+	/** merges new search results into the server entries by session id, entries that didn't change are kept as they are */
+	static void MergeSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults, TMap< FString, TSharedPtr<FServerEntry> >& Entries);
+
+	/** swaps in a filtered and sorted server list */
+	void ApplyServerList(TArray< TSharedPtr<FServerEntry> >&& FilteredServerList);
+
+	/** filters out servers not running the given map, then sorts by the given column */
+	static void FilterAndSortServers(TArray< TSharedPtr<FServerEntry> >& Servers, const FString& InMapFilterName, FName InSortColumn, EColumnSortMode::Type InSortMode);
+
+	/** sort mode shown in a column header */
+	EColumnSortMode::Type GetColumnSortMode(FName ColumnId) const;
+
+	/** column header clicked */
+	void OnColumnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type NewSortMode);
+
 	/** connect to chosen server */
 	void ConnectToServer();
 
 	/** selects item at current + MoveBy index */
 	void MoveSelection(int32 MoveBy);
 
-	/**
-	 * Ticks this widget.  Override in derived classes, but always call the parent implementation.
-	 *
-	 * @param  AllottedGeometry The space allotted for this widget
-	 * @param  InCurrentTime  Current absolute real time
-	 * @param  InDeltaTime  Real time passed since last tick
-	 */
-	void Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime );
-
 protected:
 
 	/** Whether last searched for LAN (so spacebar works) */
@@ -109,6 +135,24 @@ protected:
 	/** action bindings array */
 	TArray< TSharedPtr<FServerEntry> > ServerList;
 
+	/** every server found by the last search, by session id */
+	TMap< FString, TSharedPtr<FServerEntry> > ServerEntries;
+
+	/** bumped for every filter pass, results of older passes are dropped */
+	int32 FilterSerial;
+
+	/** column the list is sorted by */
+	FName SortColumn;
+
+	/** direction the list is sorted in */
+	EColumnSortMode::Type SortMode;
+
+	/** game session we're waiting on for search results */
+	TWeakObjectPtr<ATrueFPSGameSession> SearchingGameSession;
+
+	/** handle to our search complete binding on the game session */
+	FDelegateHandle OnFindSessionsCompleteHandle;
+
 	/** action bindings list slate widget */
 	TSharedPtr< SListView< TSharedPtr<FServerEntry> > > ServerListWidget; 
 
@@ -10,6 +10,7 @@
 #define CHAT_BOX_WIDTH 576.0f
 #define CHAT_BOX_HEIGHT 192.0f
 #define CHAT_BOX_PADDING 20.0f
+#define CHAT_MAX_LINES 64
 
 void SChatWidget::Construct(const FArguments& InArgs, const FLocalPlayerContext& InContext)
 {
@@ -23,6 +24,7 @@ void SChatWidget::Construct(const FArguments& InArgs, const FLocalPlayerContext&
 	ChatFadeTime = 10.0;
 	LastChatLineTime = -1.0;
 	bVisibiltyNeedsFocus = true;
+	ChatHistory = FTrueFPSChatHistory(CHAT_MAX_LINES);
 
 	//some constant values
 	const int32 PaddingValue = 2;
@@ -52,7 +54,7 @@ void SChatWidget::Construct(const FArguments& InArgs, const FLocalPlayerContext&
 				[
 					SAssignNew(ChatHistoryListView, SListView< TSharedPtr<FChatLine> >)
 					.SelectionMode(ESelectionMode::None)
-					.ListItemsSource(&ChatHistory)
+					.ListItemsSource(&ChatHistory.GetLines())
 					.OnGenerateRow(this, &SChatWidget::GenerateChatRow)
 				]
 			]
@@ -111,15 +113,22 @@ FSlateColor SChatWidget::GetStyleColor( const FLinearColor& InColor ) const
 	return FSlateColor( ReturnColor );
 }
 
+FText SChatWidget::GetChatLineText(TSharedPtr<FChatLine> ChatLine) const
+{
+	return ChatLine->DisplayString;
+}
+
 void SChatWidget::AddChatLine(const FText& ChatString, bool SetFocus)
 {
-	ChatHistory.Add(MakeShareable(new FChatLine(ChatString)));
+	// A repeat of the last line only bumps its count, its row picks the new text up through its attribute
+	if (ChatHistory.Add(ChatString) && ChatHistoryListView.IsValid())
+	{
+		ChatHistoryListView->RequestListRefresh();
+	}
 
 	if(ChatHistoryListView.IsValid())
 	{
-		FChatLine* LastLine  = ChatHistory[ChatHistory.Num() - 1].Get();
-		UE_LOG(LogOnline, Warning, TEXT("request scroll last=%s"), *LastLine->ChatString.ToString());
-		ChatHistoryListView->RequestScrollIntoView(ChatHistory[ChatHistory.Num() - 1]);
+		ChatHistoryListView->ScrollToBottom();
 	}
 	
 	FSlateApplication::Get().PlaySound(ChatStyle->RxMessgeSound);
@@ -232,7 +241,7 @@ TSharedRef<ITableRow> SChatWidget::GenerateChatRow(TSharedPtr<FChatLine> ChatLin
 		SNew(STableRow< TSharedPtr< FChatLine> >, OwnerTable )
 		[
 			SNew(STextBlock)
-			.Text(ChatLine->ChatString)
+			.Text(this, &SChatWidget::GetChatLineText, ChatLine)
 			.Font(ChatFont)
 			.ColorAndOpacity(this, &SChatWidget::GetChatLineColor)
 			.WrapTextAt(CHAT_BOX_WIDTH - CHAT_BOX_PADDING)
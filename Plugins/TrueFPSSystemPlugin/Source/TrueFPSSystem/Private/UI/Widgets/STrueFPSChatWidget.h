@@ -4,6 +4,7 @@
 
 #include "SlateBasics.h"
 #include "SlateExtras.h"
+#include "TrueFPSChatHistory.h"
 #include "UI/TrueFPSHUDPCTrackerBase.h"
 
 
@@ -40,7 +41,8 @@ public:
 	void SetEntryVisibility( TAttribute<EVisibility> InVisibility );
 
 	/** 
-	 * Add a new chat line.
+	 * Add a new chat line. The history is bounded, once full the oldest line is recycled, and a line
+	 * repeating the last one only bumps its count.
 	 *
 	 * @param	ChatString		String to add.
 	 * @param	SetFocus		Should the window be given focus
@@ -51,17 +53,7 @@ public:
 
 protected:
 
-	// Struct to hold chat lines.
-	struct FChatLine
-	{
-		// Source string of this chat message.
-		FText ChatString;
-
-		FChatLine(const FText& InChatString)
-			: ChatString(InChatString)
-		{
-		}
-	};
+	typedef FTrueFPSChatLine FChatLine;
 
 	/** Update function. Allows us to focus keyboard. */
 	void Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime );
@@ -83,6 +75,9 @@ protected:
 	/** Return the font color. */
 	FSlateColor GetChatLineColor() const;
 
+	/** Return the text of a chat line, rows stay bound to their line when it's recycled. */
+	FText GetChatLineText(TSharedPtr<FChatLine> ChatLine) const;
+
 	/** 
 	 * Return the adjusted color based on whether the chatbox is visible
 	 * 
@@ -112,8 +107,8 @@ protected:
 	/** The chat history list view. */
 	TSharedPtr< SListView< TSharedPtr< FChatLine> > > ChatHistoryListView;
 
-	/** The array of chat history. */
-	TArray< TSharedPtr< FChatLine> > ChatHistory;
+	/** The chat history, oldest first. Never grows past CHAT_MAX_LINES, the lines are recycled instead. */
+	FTrueFPSChatHistory ChatHistory;
 
 	/** Should this chatbox be kept visible. */
 	uint32 bAlwaysVisible : 1;
@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "TrueFPSChatHistory.h"
+
+FTrueFPSChatHistory::FTrueFPSChatHistory(int32 InMaxLines)
+	: MaxLines(FMath::Max(InMaxLines, 1))
+{
+	Lines.Reserve(MaxLines);
+}
+
+bool FTrueFPSChatHistory::Add(const FText& ChatString)
+{
+	const TSharedPtr<FTrueFPSChatLine> LastLine = Lines.Num() > 0 ? Lines.Last() : nullptr;
+	if (LastLine.IsValid() && LastLine->ChatString.ToString().Equals(ChatString.ToString(), ESearchCase::CaseSensitive))
+	{
+		// The same line again only bumps the count of the last one
+		LastLine->AddRepeat();
+		return false;
+	}
+
+	if (Lines.Num() < MaxLines)
+	{
+		Lines.Add(MakeShareable(new FTrueFPSChatLine(ChatString)));
+		return true;
+	}
+
+	// Full, the oldest line (and the row generated for it) is recycled for the new one
+	TSharedPtr<FTrueFPSChatLine> RecycledLine = Lines[0];
+	Lines.RemoveAt(0, 1, false);
+	RecycledLine->Reset(ChatString);
+	Lines.Add(RecycledLine);
+	return true;
+}
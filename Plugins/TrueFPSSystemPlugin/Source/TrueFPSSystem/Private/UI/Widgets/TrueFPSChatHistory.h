@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A line of the chat history */
+struct FTrueFPSChatLine
+{
+	/** source string of this chat message */
+	FText ChatString;
+
+	/** string displayed, with the repeat count */
+	FText DisplayString;
+
+	/** number of times this message was received in a row */
+	int32 RepeatCount;
+
+	FTrueFPSChatLine(const FText& InChatString)
+	{
+		Reset(InChatString);
+	}
+
+	void Reset(const FText& InChatString)
+	{
+		ChatString = InChatString;
+		DisplayString = InChatString;
+		RepeatCount = 1;
+	}
+
+	void AddRepeat()
+	{
+		++RepeatCount;
+		DisplayString = FText::Format(NSLOCTEXT("ChatWidget", "RepeatedLine", "{0} (x{1})"), ChatString, FText::AsNumber(RepeatCount));
+	}
+};
+
+/**
+ * The chat lines received, oldest first. The history is bounded, once full the oldest line is recycled
+ * for the new one, and a line repeating the last one only bumps its count. Adding a line never allocates
+ * once the history is full, and costs at most MaxLines pointer moves whatever the number of lines received.
+ */
+class FTrueFPSChatHistory
+{
+public:
+
+	explicit FTrueFPSChatHistory(int32 InMaxLines = 64);
+
+	/**
+	 * Adds a chat line.
+	 *
+	 * @return	true if a line was added or recycled, false if the last line was only repeated
+	 */
+	bool Add(const FText& ChatString);
+
+	/** the lines, oldest first, what the chat list view shows */
+	const TArray< TSharedPtr<FTrueFPSChatLine> >& GetLines() const
+	{
+		return Lines;
+	}
+
+	int32 GetMaxLines() const
+	{
+		return MaxLines;
+	}
+
+private:
+
+	/** never grows past MaxLines, the lines are recycled instead */
+	TArray< TSharedPtr<FTrueFPSChatLine> > Lines;
+
+	int32 MaxLines;
+};
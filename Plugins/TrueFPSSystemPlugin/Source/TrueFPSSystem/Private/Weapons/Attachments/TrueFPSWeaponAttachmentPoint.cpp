@@ -19,22 +19,32 @@ void UTrueFPSWeaponAttachmentPoint::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if (HasAuthority() && DefaultAttachment)
+	if (HasAuthority() && DefaultAttachment && !IsValid(Attachment))
 	{
-		const auto& SpawnDefaultAttachment = [this]()->void
-		{
-			/*FActorSpawnParameters Params;
-			Params.Owner = GetOwner();
-			Attachment = GetWorld()->SpawnActor<AWeaponAttachmentBase>(DefaultAttachment, Params);
-			if(Attachment) OnRep_Attachment();*/
-			ATrueFPSWeaponAttachmentBase::SpawnAttachment(DefaultAttachment, this);
-		};
-
 		// Add a small delay to spawning the attachment so the OwningWeapon is valid
-		GetWorld()->GetTimerManager().SetTimer(DefaultAttachmentDelay, SpawnDefaultAttachment, 0.1f, false);
+		GetWorld()->GetTimerManager().SetTimer(DefaultAttachmentDelay, this, &ThisClass::SpawnDefaultAttachment, 0.1f, false);
 	}
 }
 
+void UTrueFPSWeaponAttachmentPoint::SpawnDefaultAttachment()
+{
+	GetWorld()->GetTimerManager().ClearTimer(DefaultAttachmentDelay);
+
+	// Pooled weapons keep their attachments, and warm-up may have already spawned it
+	if (!HasAuthority() || !DefaultAttachment || IsValid(Attachment)) return;
+	
+	ATrueFPSWeaponAttachmentBase::SpawnAttachment(DefaultAttachment, this);
+}
+
+void UTrueFPSWeaponAttachmentPoint::ResetToDefaultAttachment()
+{
+	if (!HasAuthority()) return;
+	if (IsValid(Attachment) && Attachment->GetClass() == DefaultAttachment) return;
+
+	DestroyAttachment();
+	SpawnDefaultAttachment();
+}
+
 void UTrueFPSWeaponAttachmentPoint::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -92,6 +102,7 @@ void UTrueFPSWeaponAttachmentPoint::OnRep_Attachment()
 			if (ATrueFPSWeaponBase* OwningWeapon = Cast<ATrueFPSWeaponBase>(Owner))
 			{
 				Attachment->Internal_OnAttached(OwningWeapon);
+				OwningWeapon->RefreshAttachmentHolstered(Attachment);
 				break;
 			}
 
@@ -0,0 +1,175 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Weapons/TrueFPSExplosionResolver.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "WorldCollision.h"
+
+void FTrueFPSExplosionResolver::Resolve(UWorld* World, const FTrueFPSExplosionParams& InParams)
+{
+	Params = InParams;
+	Victims.Reset();
+	NumPendingTraces = 0;
+	++ResolveId;
+
+	if (!World || Params.BaseDamage <= 0.f || Params.Radius <= 0.f)
+	{
+		return;
+	}
+
+	// Single overlap for everything in range
+	FCollisionQueryParams SphereParams(SCENE_QUERY_STAT(TrueFPSExplosionOverlap), false, Params.DamageCauser.Get());
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByObjectType(Overlaps, Params.Origin, FQuat::Identity, FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllDynamicObjects), FCollisionShape::MakeSphere(Params.Radius), SphereParams);
+
+	// Deduplicate per actor before tracing, keeping the component closest to the origin
+	TMap<AActor*, int32> VictimIndices;
+	VictimIndices.Reserve(Overlaps.Num());
+	Victims.Reserve(Overlaps.Num());
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* const OverlapActor = Overlap.OverlapObjectHandle.FetchActor();
+		UPrimitiveComponent* const OverlapComponent = Overlap.Component.Get();
+		if (!OverlapActor || !OverlapActor->CanBeDamaged() || OverlapActor == Params.DamageCauser.Get() || !OverlapComponent)
+		{
+			continue;
+		}
+
+		const float DistSquared = FVector::DistSquared(Params.Origin, OverlapComponent->Bounds.Origin);
+		if (const int32* VictimIndex = VictimIndices.Find(OverlapActor))
+		{
+			FVictim& Victim = Victims[*VictimIndex];
+			if (DistSquared < Victim.DistSquared)
+			{
+				Victim.Component = OverlapComponent;
+				Victim.DistSquared = DistSquared;
+			}
+		}
+		else
+		{
+			VictimIndices.Add(OverlapActor, Victims.Add({ OverlapActor, OverlapComponent, DistSquared }));
+		}
+	}
+
+	// Closest first, so the synchronous budget goes to the victims taking the most damage
+	Victims.Sort([](const FVictim& A, const FVictim& B) { return A.DistSquared < B.DistSquared; });
+
+	// Asynchronous results are bound to the damage causer, without one everything is traced right away
+	AActor* const DamageCauser = Params.DamageCauser.Get();
+	const int32 NumSyncTraces = (Params.SyncTraceBudget < 0 || !DamageCauser) ? Victims.Num() : FMath::Min(Params.SyncTraceBudget, Victims.Num());
+	const FCollisionQueryParams TraceParams = GetTraceParams();
+
+	for (int32 i = 0; i < NumSyncTraces; i++)
+	{
+		FVector TraceStart, TraceEnd;
+		GetTraceSegment(Victims[i], TraceStart, TraceEnd);
+
+		FHitResult BlockingHit;
+		const bool bBlocked = World->LineTraceSingleByChannel(BlockingHit, TraceStart, TraceEnd, Params.DamagePreventionChannel, TraceParams);
+
+		FHitResult ComponentHit;
+		if (ResolveVisibility(Victims[i], bBlocked ? &BlockingHit : nullptr, ComponentHit))
+		{
+			ApplyDamage(Victims[i], ComponentHit);
+		}
+	}
+
+	if (NumSyncTraces < Victims.Num())
+	{
+		FTraceDelegate TraceDelegate = FTraceDelegate::CreateWeakLambda(DamageCauser, [this, TraceResolveId = ResolveId](const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+		{
+			OnAsyncTraceDone(TraceResolveId, TraceDatum);
+		});
+
+		for (int32 i = NumSyncTraces; i < Victims.Num(); i++)
+		{
+			FVector TraceStart, TraceEnd;
+			GetTraceSegment(Victims[i], TraceStart, TraceEnd);
+
+			World->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, Params.DamagePreventionChannel, TraceParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, i);
+			NumPendingTraces++;
+		}
+	}
+}
+
+void FTrueFPSExplosionResolver::GetTraceSegment(const FVictim& Victim, FVector& OutStart, FVector& OutEnd) const
+{
+	// Trace to the middle of the component's bounds, nudging the start if they coincide
+	OutStart = Params.Origin;
+	OutEnd = Victim.Component.IsValid() ? Victim.Component->Bounds.Origin : Params.Origin;
+	if (OutStart == OutEnd)
+	{
+		OutStart.Z += 0.01f;
+	}
+}
+
+FCollisionQueryParams FTrueFPSExplosionResolver::GetTraceParams() const
+{
+	return FCollisionQueryParams(SCENE_QUERY_STAT(TrueFPSExplosionOcclusion), true, Params.DamageCauser.Get());
+}
+
+bool FTrueFPSExplosionResolver::ResolveVisibility(const FVictim& Victim, const FHitResult* BlockingHit, FHitResult& OutHit) const
+{
+	UPrimitiveComponent* const VictimComponent = Victim.Component.Get();
+	if (!VictimComponent)
+	{
+		return false;
+	}
+
+	if (BlockingHit)
+	{
+		// Only damageable if the victim itself is what blocked the trace
+		if (BlockingHit->GetComponent() != VictimComponent)
+		{
+			return false;
+		}
+
+		OutHit = *BlockingHit;
+		return true;
+	}
+
+	// Nothing in the way, model the damage as having hit the component's center
+	const FVector FakeHitLocation = VictimComponent->GetComponentLocation();
+	OutHit = FHitResult(VictimComponent->GetOwner(), VictimComponent, FakeHitLocation, (Params.Origin - FakeHitLocation).GetSafeNormal());
+	return true;
+}
+
+void FTrueFPSExplosionResolver::ApplyDamage(const FVictim& Victim, const FHitResult& Hit) const
+{
+	AActor* const VictimActor = Victim.Actor.Get();
+	if (!VictimActor)
+	{
+		return;
+	}
+
+	// With a single component hit, AActor::InternalTakeRadialDamage evaluates the falloff exactly once
+	FRadialDamageEvent DamageEvent;
+	DamageEvent.DamageTypeClass = Params.DamageType ? Params.DamageType : TSubclassOf<UDamageType>(UDamageType::StaticClass());
+	DamageEvent.Origin = Params.Origin;
+	DamageEvent.Params = FRadialDamageParams(Params.BaseDamage, 0.f, 0.f, Params.Radius, 1.f);
+	DamageEvent.ComponentHits.Add(Hit);
+
+	VictimActor->TakeDamage(Params.BaseDamage, DamageEvent, Params.InstigatedBy.Get(), Params.DamageCauser.Get());
+}
+
+void FTrueFPSExplosionResolver::OnAsyncTraceDone(const uint32 TraceResolveId, const FTraceDatum& TraceDatum)
+{
+	if (TraceResolveId != ResolveId || !Victims.IsValidIndex(TraceDatum.UserData))
+	{
+		return;
+	}
+
+	NumPendingTraces = FMath::Max(0, NumPendingTraces - 1);
+
+	const FHitResult* BlockingHit = (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit) ? &TraceDatum.OutHits[0] : nullptr;
+
+	FHitResult ComponentHit;
+	if (ResolveVisibility(Victims[TraceDatum.UserData], BlockingHit, ComponentHit))
+	{
+		ApplyDamage(Victims[TraceDatum.UserData], ComponentHit);
+	}
+}
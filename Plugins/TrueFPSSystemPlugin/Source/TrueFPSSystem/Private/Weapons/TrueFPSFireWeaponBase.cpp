@@ -37,6 +37,21 @@ void ATrueFPSFireWeaponBase::PostInitializeComponents()
 	}
 }
 
+void ATrueFPSFireWeaponBase::ResetForPool()
+{
+	// Super clears all timers, including the reload ones
+	Super::ResetForPool();
+
+	FireState = FTrueFPSFireWeaponState();
+	bPendingReload = false;
+
+	if (IsValid(FireSettings) && FireSettings->InitialClips > 0)
+	{
+		CurrentAmmoInClip = FireSettings->AmmoPerClip;
+		CurrentAmmo = FireSettings->AmmoPerClip * FireSettings->InitialClips;
+	}
+}
+
 void ATrueFPSFireWeaponBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -15,9 +15,9 @@ ATrueFPSMeleeWeaponBase::ATrueFPSMeleeWeaponBase(const FObjectInitializer& Objec
 	bWeaponTracing = false;
 }
 
-void ATrueFPSMeleeWeaponBase::Tick(float DeltaSeconds)
+void ATrueFPSMeleeWeaponBase::TickAttached(float DeltaSeconds)
 {
-	Super::Tick(DeltaSeconds);
+	Super::TickAttached(DeltaSeconds);
 
 	HandleAttackTick();
 }
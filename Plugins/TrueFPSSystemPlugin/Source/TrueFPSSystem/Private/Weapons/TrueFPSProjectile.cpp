@@ -110,7 +110,15 @@ void ATrueFPSProjectile::Explode(const FHitResult& Impact)
 
 	if (WeaponConfig->ExplosionDamage > 0 && WeaponConfig->ExplosionRadius > 0 && WeaponConfig->DamageType)
 	{
-		UGameplayStatics::ApplyRadialDamage(this, WeaponConfig->ExplosionDamage, NudgedImpactLocation, WeaponConfig->ExplosionRadius, WeaponConfig->DamageType, TArray<AActor*>(), this, MyController.Get());
+		FTrueFPSExplosionParams ExplosionParams;
+		ExplosionParams.Origin = NudgedImpactLocation;
+		ExplosionParams.BaseDamage = WeaponConfig->ExplosionDamage;
+		ExplosionParams.Radius = WeaponConfig->ExplosionRadius;
+		ExplosionParams.DamageType = WeaponConfig->DamageType;
+		ExplosionParams.DamageCauser = this;
+		ExplosionParams.InstigatedBy = MyController;
+		ExplosionParams.SyncTraceBudget = WeaponConfig->ExplosionSyncTraceBudget;
+		ExplosionResolver.Resolve(GetWorld(), ExplosionParams);
 	}
 
 	if (ExplosionTemplate)
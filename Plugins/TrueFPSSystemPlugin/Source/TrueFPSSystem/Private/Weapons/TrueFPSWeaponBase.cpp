@@ -4,6 +4,7 @@
 #include "Weapons/TrueFPSWeaponBase.h"
 
 #include "TrueFPSSystem.h"
+#include "Character/TrueFPSTickManager.h"
 #include "Character/TrueFPSCharacterInterface.h"
 #include "GameFramework/Character.h"
 #include "VisualizationMacros.h"
@@ -69,21 +70,75 @@ void ATrueFPSWeaponBase::BeginPlay()
 	// By default, the sights relative transform should equal whatever
 	// the GetDefaultSightsRelativeTransform implementation returns.
 	TargetSightsRelativeTransform = GetDefaultSightsRelativeTransform();
+
+	// Blueprint tick events still need the actor tick
+	bBlueprintTick = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(ATrueFPSWeaponBase, ReceiveTick));
+	if (UTrueFPSTickManager* TickManager = UTrueFPSTickManager::Get(this))
+	{
+		TickManager->RegisterWeapon(this);
+		bManagedTick = true;
+	}
+	UpdateActorTickEnabled();
+}
+
+void ATrueFPSWeaponBase::UpdateActorTickEnabled()
+{
+	// A weapon holstered mid recoil keeps ticking until it settled, the tick manager does the same for the weapons it ticks
+	const bool bSettlingRecoil = !bManagedTick && IsRecoilSettling();
+	SetActorTickEnabled((!bHolstered || bSettlingRecoil) && (!bManagedTick || bBlueprintTick));
+}
+
+void ATrueFPSWeaponBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bManagedTick)
+	{
+		if (UTrueFPSTickManager* TickManager = GetWorld()->GetSubsystem<UTrueFPSTickManager>())
+		{
+			TickManager->UnregisterWeapon(this);
+		}
+		bManagedTick = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ATrueFPSWeaponBase::Tick(const float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	HandleRecoil(DeltaTime);
-	
+	if (bManagedTick) return;
+
+	TickAttached(DeltaTime);
+	TickAttachedInterpolation(DeltaTime);
+
+	if (bHolstered && !IsRecoilSettling())
+	{
+		UpdateActorTickEnabled();
+	}
+}
+
+void ATrueFPSWeaponBase::TickAttached(const float DeltaTime)
+{
 	RefreshCameraRecoil(DeltaTime);
 
-	// Smooth sights toggling
-	State.SightsRelativeTransform = UKismetMathLibrary::TInterpTo(State.SightsRelativeTransform, TargetSightsRelativeTransform, DeltaTime, 8.f);
+	// Weapons only ticking to settle their recoil are out of the way already
+	State.TargetWallOffsetTransformAlpha = IsAttachedToPawn() ? CalculateWallOffsetTransformAlpha() : 0.f;
+}
+
+void ATrueFPSWeaponBase::TickAttachedInterpolation(const float DeltaTime)
+{
+	HandleRecoil(DeltaTime);
+
+	// Smooth sights toggling, settling on the target so the sights stop changing
+	if (!State.SightsRelativeTransform.Equals(TargetSightsRelativeTransform, 0.f))
+	{
+		const FTransform SightsRelativeTransform = UKismetMathLibrary::TInterpTo(State.SightsRelativeTransform, TargetSightsRelativeTransform, DeltaTime, 8.f);
+		State.SightsRelativeTransform = SightsRelativeTransform.Equals(TargetSightsRelativeTransform) ? TargetSightsRelativeTransform : SightsRelativeTransform;
+		State.SightsChangeCounter++;
+	}
 
 	// Smooth wall offset
-	State.WallOffsetTransformAlpha = UKismetMathLibrary::FInterpTo(State.WallOffsetTransformAlpha, CalculateWallOffsetTransformAlpha(), DeltaTime, 8.f);
+	State.WallOffsetTransformAlpha = UKismetMathLibrary::FInterpTo(State.WallOffsetTransformAlpha, State.TargetWallOffsetTransformAlpha, DeltaTime, 8.f);
 }
 
 void ATrueFPSWeaponBase::PostInitializeComponents()
@@ -105,13 +160,14 @@ void ATrueFPSWeaponBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& O
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME( ThisClass, MyPawn );
-	DOREPLIFETIME( ThisClass, TargetSightsRelativeTransform );
 
 	DOREPLIFETIME_CONDITION( ThisClass, BurstCounter, COND_SkipOwner );
+	DOREPLIFETIME_CONDITION( ThisClass, ReplicatedSights, COND_SkipOwner );
 }
 
 void ATrueFPSWeaponBase::OnEquip(const ATrueFPSWeaponBase* LastWeapon)
 {
+	SetHolstered(false);
 	AttachMeshToPawn();
 
 	State.bPendingEquip = true;
@@ -168,11 +224,18 @@ void ATrueFPSWeaponBase::OnUnEquip()
 	}
 
 	DetermineWeaponState();
+	SetHolstered(true);
 }
 
 void ATrueFPSWeaponBase::OnEnterInventory(ACharacter* NewOwner)
 {
 	SetOwningPawn(NewOwner);
+
+	// The current weapon may have replicated and been equipped before its owner
+	if (!IsAttachedToPawn())
+	{
+		SetHolstered(true);
+	}
 }
 
 void ATrueFPSWeaponBase::OnLeaveInventory()
@@ -188,6 +251,47 @@ void ATrueFPSWeaponBase::OnLeaveInventory()
 	}
 }
 
+void ATrueFPSWeaponBase::ResetForPool()
+{
+	StopSimulatingWeaponFire();
+	DetachMeshFromPawn();
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	State = FTrueFPSWeaponState();
+	BurstCounter = 0;
+	ReplicatedSights = FTrueFPSReplicatedSights();
+	TargetSightsRelativeTransform = GetDefaultSightsRelativeTransform();
+	State.SightsRelativeTransform = TargetSightsRelativeTransform;
+
+	// The next owner gets the weapon as it was spawned, not the previous owner's attachments
+	TArray<UTrueFPSWeaponAttachmentPoint*> AttachmentPoints;
+	GetAttachmentPoints(AttachmentPoints);
+	for (UTrueFPSWeaponAttachmentPoint* AttachmentPoint : AttachmentPoints)
+		AttachmentPoint->ResetToDefaultAttachment();
+
+	SetHolstered(true);
+}
+
+void ATrueFPSWeaponBase::Reinitialize()
+{
+	SetNetDormancy(DORM_Awake);
+	UpdateActorTickEnabled();
+}
+
+void ATrueFPSWeaponBase::SpawnDefaultAttachments()
+{
+	if (GetLocalRole() < ROLE_Authority)
+	{
+		return;
+	}
+
+	TArray<UTrueFPSWeaponAttachmentPoint*> AttachmentPoints;
+	GetAttachmentPoints(AttachmentPoints);
+
+	for (UTrueFPSWeaponAttachmentPoint* AttachmentPoint : AttachmentPoints)
+		AttachmentPoint->SpawnDefaultAttachment();
+}
+
 bool ATrueFPSWeaponBase::IsEquipped() const
 {
 	return State.bIsEquipped;
@@ -198,6 +302,42 @@ bool ATrueFPSWeaponBase::IsAttachedToPawn() const
 	return State.bIsEquipped || State.bPendingEquip;
 }
 
+bool ATrueFPSWeaponBase::IsRecoilSettling() const
+{
+	// Only one of the two is played, see HandleRecoil
+	const bool bRecoilPlaying = Settings->bStackRecoil ? !State.RecoilInstances.IsEmpty() : !State.CurrentRecoilInstance.IsExpired();
+	return bRecoilPlaying || State.bShouldUpdateCameraRecoil;
+}
+
+void ATrueFPSWeaponBase::SetHolstered(const bool bNewHolstered)
+{
+	if (bHolstered == bNewHolstered) return;
+	bHolstered = bNewHolstered;
+
+	// The meshes are already hidden while detached, which keeps them out of the render scene,
+	// restoring the defaults on equip is cheaper than registering the components again
+	const ATrueFPSWeaponBase* DefaultWeapon = GetClass()->GetDefaultObject<ATrueFPSWeaponBase>();
+	Mesh1P->SetComponentTickEnabled(!bHolstered && Mesh1P->PrimaryComponentTick.bStartWithTickEnabled);
+	Mesh3P->SetComponentTickEnabled(!bHolstered && Mesh3P->PrimaryComponentTick.bStartWithTickEnabled);
+	Mesh1P->SetCollisionEnabled(bHolstered ? ECollisionEnabled::NoCollision : DefaultWeapon->Mesh1P->GetCollisionEnabled());
+	Mesh3P->SetCollisionEnabled(bHolstered ? ECollisionEnabled::NoCollision : DefaultWeapon->Mesh3P->GetCollisionEnabled());
+
+	TArray<ATrueFPSWeaponAttachmentBase*> CurrentAttachments;
+	GetAttachments(CurrentAttachments);
+	for (ATrueFPSWeaponAttachmentBase* CurrentAttachment : CurrentAttachments)
+		RefreshAttachmentHolstered(CurrentAttachment);
+
+	NetUpdateFrequency = bHolstered ? FMath::Min(Settings->HolsteredNetUpdateFrequency, DefaultWeapon->NetUpdateFrequency) : DefaultWeapon->NetUpdateFrequency;
+
+	UpdateActorTickEnabled();
+}
+
+void ATrueFPSWeaponBase::RefreshAttachmentHolstered(ATrueFPSWeaponAttachmentBase* Attachment) const
+{
+	Attachment->SetActorEnableCollision(!bHolstered && Attachment->GetClass()->GetDefaultObject<AActor>()->GetActorEnableCollision());
+	Attachment->SetActorTickEnabled(!bHolstered && Attachment->PrimaryActorTick.bStartWithTickEnabled);
+}
+
 void ATrueFPSWeaponBase::StartFire()
 {
 	if (GetLocalRole() < ROLE_Authority)
@@ -232,23 +372,59 @@ void ATrueFPSWeaponBase::ToggleSights()
 	{
 		ServerToggleSights();
 	}
-	else
+
+	// The owning client cycles locally as well, the selection is only replicated to everyone else
+	TArray<ATrueFPSSightsAttachment*> AllSights;
+	GetSightsAttachments(AllSights);
+
+	int32 NewIndex = INDEX_NONE;
+	if (State.CurrentSights.IsValid())
+	{
+		const int32 CurrentIndex = AllSights.Find(State.CurrentSights.Get());
+		NewIndex = CurrentIndex != INDEX_NONE && AllSights.IsValidIndex(CurrentIndex + 1) ? CurrentIndex + 1 : INDEX_NONE;
+	}
+	else if (AllSights.IsValidIndex(0))
+	{
+		NewIndex = 0;
+	}
+
+	State.CurrentSights = AllSights.IsValidIndex(NewIndex) ? AllSights[NewIndex] : nullptr;
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		ReplicatedSights = State.CurrentSights.IsValid() ? FTrueFPSReplicatedSights(NewIndex + 1, State.CurrentSights->AimOffset) : FTrueFPSReplicatedSights();
+	}
+
+	RefreshTargetSightsRelativeTransform();
+}
+
+void ATrueFPSWeaponBase::RefreshTargetSightsRelativeTransform()
+{
+	const bool bIsOwner = GetLocalRole() == ROLE_Authority || (MyPawn && MyPawn->IsLocallyControlled());
+	if (!bIsOwner)
 	{
+		// Resolve the replicated index against the sights attachments this client knows about
 		TArray<ATrueFPSSightsAttachment*> AllSights;
-		GetAttachments(AllSights);
+		GetSightsAttachments(AllSights);
+
+		const int32 SightsIndex = static_cast<int32>(ReplicatedSights.SightsIndex) - 1;
+		State.CurrentSights = AllSights.IsValidIndex(SightsIndex) ? AllSights[SightsIndex] : nullptr;
 
 		if (State.CurrentSights.IsValid())
 		{
-			const int32 CurrentIndex = AllSights.Find(State.CurrentSights.Get());
-			State.CurrentSights = CurrentIndex != INDEX_NONE && AllSights.IsValidIndex(CurrentIndex + 1) ? AllSights[CurrentIndex + 1] : nullptr;
+			// Apply the replicated aim offset in place of the locally configured one
+			const FTransform AimOffsetDelta(FVector(State.CurrentSights->AimOffset - ReplicatedSights.GetAimOffset(), 0.f, 0.f));
+			TargetSightsRelativeTransform = (AimOffsetDelta * State.CurrentSights->GetSightsWorldTransform()).GetRelativeTransform(GetActorTransform());
+			return;
 		}
-		else if (AllSights.IsValidIndex(0))
-		{
-			State.CurrentSights = AllSights[0];
-		}
-		
-		TargetSightsRelativeTransform = State.CurrentSights.IsValid() ? State.CurrentSights->GetSightsWorldTransform().GetRelativeTransform(GetActorTransform()) : GetDefaultSightsRelativeTransform();
 	}
+	else if (State.CurrentSights.IsValid())
+	{
+		TargetSightsRelativeTransform = State.CurrentSights->GetSightsWorldTransform().GetRelativeTransform(GetActorTransform());
+		return;
+	}
+
+	TargetSightsRelativeTransform = GetDefaultSightsRelativeTransform();
 }
 
 bool ATrueFPSWeaponBase::CanFire() const
@@ -338,6 +514,18 @@ void ATrueFPSWeaponBase::GetAttachmentPoints(TArray<UTrueFPSWeaponAttachmentPoin
 	GetComponents<UTrueFPSWeaponAttachmentPoint>(OutAttachmentPoints);
 }
 
+void ATrueFPSWeaponBase::GetSightsAttachments(TArray<ATrueFPSSightsAttachment*>& OutSights) const
+{
+	// Component iteration order isn't guaranteed to match between server and clients
+	TArray<UTrueFPSWeaponAttachmentPoint*> AttachmentPoints;
+	GetAttachmentPoints(AttachmentPoints);
+	AttachmentPoints.Sort([](const UTrueFPSWeaponAttachmentPoint& A, const UTrueFPSWeaponAttachmentPoint& B) { return A.GetFName().LexicalLess(B.GetFName()); });
+
+	for (const UTrueFPSWeaponAttachmentPoint* AttachmentPoint : AttachmentPoints)
+		if (ATrueFPSSightsAttachment* Sights = AttachmentPoint->GetAttachment<ATrueFPSSightsAttachment>())
+			OutSights.Add(Sights);
+}
+
 void ATrueFPSWeaponBase::ServerStartFire_Implementation()
 {
 	StartFire();
@@ -377,6 +565,11 @@ void ATrueFPSWeaponBase::OnRep_BurstCounter()
 	}
 }
 
+void ATrueFPSWeaponBase::OnRep_ReplicatedSights()
+{
+	RefreshTargetSightsRelativeTransform();
+}
+
 void ATrueFPSWeaponBase::SimulateWeaponFire()
 {
 	if (GetLocalRole() == ROLE_Authority && State.CurrentState != EWeaponState::Firing)
@@ -589,19 +782,51 @@ void ATrueFPSWeaponBase::DetermineWeaponState()
 
 void ATrueFPSWeaponBase::HandleRecoil(const float DeltaSeconds)
 {
-	FRecoilInstance& RecoilInstance = State.CurrentRecoilInstance;
-		
-	const float CurrentTime = RecoilInstance.CurrentTime += DeltaSeconds * RecoilInstance.PlayRate;
+	FVector CurveRotationVector(ForceInitToZero);
+	FVector CurveLocation(ForceInitToZero);
 
-	if (CurrentTime >= RecoilInstance.Lifetime)
+	if (!Settings->bStackRecoil)
 	{
-		State.RecoilOffset = FTransform::Identity;
-		return;
+		FRecoilInstance& RecoilInstance = State.CurrentRecoilInstance;
+
+		const float CurrentTime = RecoilInstance.CurrentTime += DeltaSeconds * RecoilInstance.PlayRate;
+		if (CurrentTime >= RecoilInstance.Lifetime)
+		{
+			State.RecoilOffset = FTransform::Identity;
+			return;
+		}
+
+		RecoilInstance.Sample(CurrentTime, CurveRotationVector, CurveLocation);
+	}
+	else
+	{
+		FRecoilInstanceRing& RecoilInstances = State.RecoilInstances;
+
+		// Sum the live instances so the transform is only built once
+		for (int32 i = 0; i < RecoilInstances.Num(); ++i)
+		{
+			FRecoilInstance& RecoilInstance = RecoilInstances[i];
+
+			const float CurrentTime = RecoilInstance.CurrentTime += DeltaSeconds * RecoilInstance.PlayRate;
+			if (CurrentTime >= RecoilInstance.Lifetime) continue;
+
+			FVector InstanceRotation;
+			FVector InstanceLocation;
+			RecoilInstance.Sample(CurrentTime, InstanceRotation, InstanceLocation);
+			CurveRotationVector += InstanceRotation;
+			CurveLocation += InstanceLocation;
+		}
+
+		RecoilInstances.RemoveExpired();
+
+		if (RecoilInstances.IsEmpty())
+		{
+			State.RecoilOffset = FTransform::Identity;
+			return;
+		}
 	}
 
-	const FVector CurveRotationVector = RecoilInstance.RotationCurve->GetVectorValue(CurrentTime);
 	const FRotator CurveRotation(CurveRotationVector.Y, CurveRotationVector.Z, CurveRotationVector.X);
-	const FVector CurveLocation(RecoilInstance.LocationCurve->GetVectorValue(CurrentTime));
 	const FTransform CurrentValue(CurveRotation, CurveLocation);
 
 	State.RecoilOffset = CurrentValue;
@@ -633,17 +858,26 @@ void ATrueFPSWeaponBase::ResetCameraRecoil()
 	State.bResetCameraRecoil = true;
 	State.CameraRecoilCurrentTime = 0.f;
 	State.bShouldUpdateCameraRecoil = true;
+
+	// The recovery may start after the weapon was holstered and its tick turned off
+	if (bHolstered)
+	{
+		UpdateActorTickEnabled();
+	}
 }
 
 void ATrueFPSWeaponBase::RefreshCameraRecoil(float DeltaTime)
 {
-	if (!MyPawn) return;
-	if (!MyPawn->Implements<UTrueFPSCharacterInterface>()) return;
-	APlayerController* PC = MyPawn->GetController<APlayerController>();
-	if (!PC) return;
-
 	if (!State.bShouldUpdateCameraRecoil) return;
 
+	// Dropped or its owner lost its controller, there is no camera left to recover
+	const APlayerController* PC = MyPawn && MyPawn->Implements<UTrueFPSCharacterInterface>() ? MyPawn->GetController<APlayerController>() : nullptr;
+	if (!PC)
+	{
+		State.bShouldUpdateCameraRecoil = false;
+		return;
+	}
+
 	const FRotator ControllerInput = ITrueFPSCharacterInterface::Execute_TrueFPSInterface_GetLastUpdatedRotationValues(MyPawn);
 
 	const FVector2D RecoverySubtract = FVector2D(
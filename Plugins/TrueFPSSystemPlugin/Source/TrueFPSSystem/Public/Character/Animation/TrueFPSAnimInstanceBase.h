@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "TrueFPSTypes.h"
 #include "State/TrueFPSAnimInstanceState.h"
 #include "TrueFPSAnimInstanceBase.generated.h"
 
@@ -55,6 +56,40 @@ private:
 
 	void RefreshTurnInPlaceState(float DeltaTime);
 
+	// Whether the character is close enough to a local camera for its weapon sway to be seen
+	bool IsWithinWeaponSwayDistance() const;
+
+	// Weapon sway curve values at a point in time, before any scaling
+	struct FSwaySamples
+	{
+		FVector Idle{FVector::ZeroVector};
+		FVector MovementLocation{FVector::ZeroVector};
+		FVector MovementRotation{FVector::ZeroVector};
+	};
+
+	FSwaySamples SampleSwayCurves() const;
+
+	// Samples the sway curves, at the reduced sway sample rate if set
+	FSwaySamples UpdateSwaySamples(float DeltaTime);
+
+	// The current weapon's sway curves, baked when the weapon changes
+	FTrueFPSBakedCurveVector BakedIdleSway;
+	FTrueFPSBakedCurveVector BakedMovementSwayLocation;
+	FTrueFPSBakedCurveVector BakedMovementSwayRotation;
+
+	// Sway samples interpolated between when sampling at a reduced rate
+	FSwaySamples PreviousSwaySamples;
+	FSwaySamples NextSwaySamples;
+	float SwaySampleTime{0.f};
+
+	// What State.WeaponChangeCounter was last bumped for
+	TWeakObjectPtr<const ATrueFPSWeaponBase> CountedWeapon;
+	int32 CountedSightsChangeCounter{0};
+
+	// Character movement velocity, read once per update
+	FVector CurrentVelocity{FVector::ZeroVector};
+	float CurrentSpeed{0.f};
+
 	void PostRefresh();
 
 public:
@@ -15,6 +15,7 @@ class UInputAction;
 class UInputMappingContext;
 class UInputComponent;
 class USkeletalMeshComponent;
+struct FAnimUpdateRateParameters;
 class USceneComponent;
 class UCameraComponent;
 class UAnimMontage;
@@ -96,10 +97,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|TrueFPS Character", Transient, ReplicatedUsing = OnRep_LastTakeHitInfo)
 	FTakeHitInfo LastTakeHitInfo;
 	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|TrueFPS Character", Transient, Replicated)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|TrueFPS Character", Transient, ReplicatedUsing = OnRep_LeanValueTarget)
 	float LeanValueTarget{0.f};
 	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|TrueFPS Character", Transient, Replicated)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|TrueFPS Character", Transient, ReplicatedUsing = OnRep_CrouchValueTarget)
 	float CrouchValueTarget{0.f};
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|TrueFPS Character", Transient, Replicated)
@@ -120,9 +121,18 @@ public:
 	/** spawn inventory, setup initial variables */
 	virtual void PostInitializeComponents() override;
 
-	/** Update the character. (Running, health etc). */
+	/** Update the character's lean, crouch and wall avoidance while any of them is active, unless the tick manager does, see UpdateActorTickEnabled */
 	virtual void Tick(float DeltaTime) override;
 
+	/** unregister from the tick manager */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Refreshes lean, crouch and wall avoidance, each while its flag is set */
+	void RefreshState(float DeltaTime);
+
+	/** Whether lean, crouch or wall avoidance still needs refreshing */
+	FORCEINLINE bool NeedsStateRefresh() const { return bRefreshLean || bRefreshCrouch || bRefreshWallAvoidance; }
+
 	/** cleanup inventory */
 	virtual void Destroyed() override;
 
@@ -135,6 +145,9 @@ public:
 	/** [client] perform PlayerState related setup */
 	virtual void OnRep_PlayerState() override;
 
+	/** [server + client] updates what depends on the character being locally controlled */
+	virtual void NotifyControllerChanged() override;
+
 	/** [server] called to determine if we should pause replication this actor to a specific player */
 	virtual bool IsReplicationPausedForConnection(const FNetViewer& ConnectionOwnerNetViewer) override;
 
@@ -148,6 +161,18 @@ public:
 	*/
 	bool IsEnemyFor(AController* TestPC) const;
 
+	/** [server + client] caches the team used by damage and enemy checks */
+	void RefreshTeamCache();
+
+	/** get cached team, INDEX_NONE if there is no player state */
+	FORCEINLINE int32 GetTeamNum() const { return State.TeamNum; }
+
+	/** get team of a controller, using its pawn's cached team when possible */
+	static int32 GetTeamNumOf(const AController* InController);
+
+	/** check if damage instigated by the given team may hurt this pawn, by the game mode's CanDealDamage */
+	bool CanBeDamagedByTeam(int32 InstigatorTeamNum) const;
+
 	UFUNCTION(BlueprintPure)
 	FORCEINLINE USkeletalMeshComponent* GetClientMesh() const { return ClientMesh; }
 
@@ -156,6 +181,8 @@ public:
 
 	UFUNCTION(BlueprintPure)
 	FORCEINLINE bool GetIsDying() const { return State.bIsDying; }
+
+	FORCEINLINE UTrueFPSCharacterSettings* GetSettings() const { return Settings; }
 	
 protected:
 	
@@ -176,6 +203,21 @@ public:
 	virtual void AddControllerYawInput(float Val) override;
 	virtual void AddControllerRollInput(float Val) override;
 
+	/** head offset table resolution, crouch rows go from standing to crouched, lean columns from left to right */
+	static constexpr int32 HeadOffsetCrouchSteps = 3;
+	static constexpr int32 HeadOffsetLeanSteps = 5;
+
+	/**
+	 * Fills a head offset table from the reference pose, before any pose was recorded.
+	 * Crouching lowers the head, leaning rolls it around the pelvis.
+	 *
+	 * @param	MeshRelativeTransform	the mesh relative to the actor, the table is built relative to the actor
+	 * @param	CrouchHeadDrop			how much lower the head is fully crouched
+	 * @param	LeanAmount				lean angle in degrees at either end of the lean columns
+	 * @return	false if the skeleton has no head bone
+	 */
+	static bool BuildHeadOffsetTable(const FReferenceSkeleton& RefSkeleton, const FTransform& MeshRelativeTransform, float CrouchHeadDrop, float LeanAmount, TArrayView<FVector> OutTable);
+
 	//////////////////////////////////////////////////////////////////////////
 	// Inventory
 
@@ -359,14 +401,45 @@ protected:
 	UFUNCTION(Server, Reliable)
 	void ServerToggleCrouching(bool bNewCrouching);
 
+	UFUNCTION()
+	void OnRep_LeanValueTarget();
+
+	UFUNCTION()
+	void OnRep_CrouchValueTarget();
+
+	/** Interpolates the lean value, until it reaches its target */
 	void RefreshLeanValue(float DeltaTime);
 
+	/** Interpolates the crouch value, until it reaches its target */
 	void RefreshCrouchValue(float DeltaTime);
 
-	void RefreshHealthRegen(float DeltaTime);
+	/** [server] Timer callback, regenerates health every HealthRegenInterval */
+	void RefreshHealthRegen();
 
+	/** Stops aiming when the weapon is too close to a wall, while aiming locally */
 	void RefreshWallAvoidanceState(float DeltaTime);
 
+	/** Ticks the actor only while something needs refreshing, or if a blueprint ticks */
+	void UpdateActorTickEnabled();
+
+	/** Tells the audio thread whether the character is locally controlled, for the local player sound nodes */
+	void UpdateLocallyControlledActorCache() const;
+
+	/** Sets up the third person mesh's update rate optimizations from the character settings */
+	void OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params);
+
+	/** Seeds the head offset table from the mesh's reference pose and the crouched capsule */
+	void InitHeadOffsetTable();
+
+	/** Records where the head ended up in the pose just finished, for the camera target modes that don't wait on the pose */
+	void OnPoseFinalized();
+
+	/** @return the head location relative to the third person mesh, interpolated from the recorded head offsets */
+	FVector GetBakedHeadOffset() const;
+
+	/** @return the crouch and lean values as fractional indices into the head offset table */
+	FVector2f GetHeadOffsetTableCoords() const;
+
 protected:
 	
 	/** Responsible for cleaning up bodies on clients. */
@@ -377,6 +450,28 @@ private:
 	/** Whether or not the character is moving (based on movement input). */
 	bool IsMoving() const;
 
+	/** refreshes that need the character to tick, cleared once there is nothing left to do */
+	bool bRefreshLean{false};
+	bool bRefreshCrouch{false};
+	bool bRefreshWallAvoidance{false};
+
+	/** a blueprint implements the tick event, so the actor always ticks */
+	bool bBlueprintTick{false};
+
+	/** refreshed by the world's UTrueFPSTickManager rather than the actor tick */
+	bool bManagedTick{false};
+
+	FTimerHandle TimerHandle_HealthRegen;
+
+	/** head locations relative to the third person mesh, seeded by BuildHeadOffsetTable and refined from finished poses */
+	FVector HeadOffsetTable[HeadOffsetCrouchSteps * HeadOffsetLeanSteps];
+	bool bHasHeadOffsetTable{false};
+
+	/** head location in the last finished pose, and the world time it finished at */
+	FVector LastPoseHeadLocation{FVector::ZeroVector};
+	double LastPoseTime{0.0};
+	bool bHasLastPose{false};
+
 	//////////////////////////////////////////////////////////////////////////
 	// TrueFPSCharacterInterface overriding
 	
@@ -547,11 +642,6 @@ inline float ATrueFPSCharacter::TrueFPSInterface_GetLeanValue_Implementation() c
 	return State.LeanValue;
 }
 
-inline FVector ATrueFPSCharacter::TrueFPSInterface_GetFirstPersonCameraTarget_Implementation() const
-{
-	return GetMesh()->GetSocketLocation(FName("head"));
-}
-
 inline FRotator ATrueFPSCharacter::TrueFPSInterface_GetFirstPersonCameraTargetRotation_Implementation() const
 {
 	return GetControlRotation();
@@ -27,7 +27,7 @@ UTrueFPSLocalPlayer(const FObjectInitializer& ObjectInitializer);
 	/** Initializes the PersistentUser */
 	void LoadPersistentUser();
 
-private:
+protected:
 	/** Persistent user data stored between sessions (i.e. the user's savegame) */
 	UPROPERTY()
 	class UTrueFPSPersistentUser* PersistentUser;
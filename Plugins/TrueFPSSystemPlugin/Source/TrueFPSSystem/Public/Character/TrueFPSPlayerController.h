@@ -7,6 +7,18 @@
 #include "GameFramework/PlayerController.h"
 #include "TrueFPSPlayerController.generated.h"
 
+/** What a player did in a match, copied out of the player state when the match ends so it can be reported later */
+struct FTrueFPSMatchResult
+{
+	FName SessionName;
+	FString MapName;
+	int32 Kills = 0;
+	int32 Deaths = 0;
+	int32 Score = 0;
+	int32 BulletsFired = 0;
+	bool bIsWinner = false;
+};
+
 /**
  * 
  */
@@ -27,6 +39,10 @@ public:
 	UFUNCTION(reliable, client)
 	void ClientGameStarted();
 
+	/** Starts loading the map of the next match while the current one wraps up */
+	UFUNCTION(reliable, client)
+	void ClientPreloadMap(const FString& MapName);
+
 	/** Starts the online game using the session name in the PlayerState */
 	UFUNCTION(reliable, client)
 	void ClientStartOnlineGame();
@@ -180,6 +196,24 @@ public:
 	 */
 	void UpdateAchievementProgress( const FString& Id, float Percent );
 
+	/**
+	 * Writes several achievements at once (unless another write is in progress).
+	 *
+	 * @param Write achievement ids and their progress
+	 */
+	void WriteAchievements( const FOnlineAchievementsWriteRef& Write );
+
+	/**
+	 * Runs the next step of the end of match report (save file, achievements, leaderboards, stats).
+	 *
+	 * @param bOutWroteLeaderboards set if the step wrote leaderboards, the caller flushes them
+	 * @return true if there are steps left
+	 */
+	bool RunMatchReportStep(bool& bOutWroteLeaderboards);
+
+	/** Runs every step of the end of match report right away, for results that can't wait for the report queue */
+	void FlushMatchReports();
+
 	/** Returns a pointer to the TrueFPS game hud. May return nullptr. */
 	class ATrueFPSHUD* GetTrueFPSHUD() const;
 
@@ -240,6 +274,9 @@ protected:
 
 	virtual void BeginDestroy() override;
 
+	/** finishes any pending end of match report */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	//Begin AActor interface
 
 	/** after all game elements are created */
@@ -302,24 +339,30 @@ public:
 	void ServerSuicide();
 
 	/** Updates achievements based on the PersistentUser stats at the end of a round */
-	void UpdateAchievementsOnGameEnd();
+	void UpdateAchievementsOnGameEnd(const FTrueFPSMatchResult& Result);
 
-	/** Updates leaderboard stats at the end of a round */
-	void UpdateLeaderboardsOnGameEnd();
+	/** Updates leaderboard stats at the end of one or more rounds, the leaderboards are flushed by the caller */
+	void UpdateLeaderboardsOnGameEnd(const TArray<FTrueFPSMatchResult>& Results);
 
-	/** Updates stats at the end of a round */
-	void UpdateStatsOnGameEnd(bool bIsWinner);
+	/** Updates stats at the end of one or more rounds */
+	void UpdateStatsOnGameEnd(const TArray<FTrueFPSMatchResult>& Results);
 
-	/** Updates the save file at the end of a round */
-	void UpdateSaveFileOnGameEnd(bool bIsWinner);
+	/** Updates the save file at the end of one or more rounds */
+	void UpdateSaveFileOnGameEnd(const TArray<FTrueFPSMatchResult>& Results);
+
+	/** Results of matches that ended and haven't been reported yet, piled up results are reported together */
+	TArray<FTrueFPSMatchResult> PendingMatchResults;
+
+	/** Results currently being reported */
+	TArray<FTrueFPSMatchResult> ReportingMatchResults;
+
+	/** Next step of the report of ReportingMatchResults */
+	uint8 MatchReportStep;
 
 	// End APlayerController interface
 
 	FName ServerSayString;
 
-	// Timer used for updating friends in the player tick.
-	float TrueFPSFriendUpdateTimer;
-
 	// For tracking whether or not to send the end event
 	bool bHasSentStartEvents;
 
@@ -331,6 +374,32 @@ public:
 	UPROPERTY(config)
 	float FireTriggerThreshold;
 
+	/** chat messages a player can send in a row before being rate limited */
+	UPROPERTY(config)
+	float ChatBurstSize;
+
+	/** chat messages per second a player can keep sending once the burst is used up */
+	UPROPERTY(config)
+	float ChatMessagesPerSecond;
+
+	/** the same chat message sent again within this many seconds is dropped */
+	UPROPERTY(config)
+	float ChatRepeatInterval;
+
+	/** chat messages are cut to this many characters, by the sender and again by the server */
+	UPROPERTY(config)
+	int32 ChatMaxMessageLength;
+
+	/** [server] chat messages the player can send right now */
+	float ChatAllowance;
+
+	/** [server] time ChatAllowance was last topped up */
+	double LastChatAllowanceTime;
+
+	/** [server] last chat message broadcast for the player, and when */
+	FString LastChatMessage;
+	double LastChatMessageTime;
+
 private:
 
 	/** Handle for efficient management of ClientStartOnlineGame timer */
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TrueFPSRagdollManager.generated.h"
+
+class ACharacter;
+
+/**
+ * Keeps the number of simulated ragdolls within budget.
+ * - ragdolls are ranked by distance to the local players' view, ragdolls that weren't rendered recently count as further away
+ * - only the TrueFPS.MaxSimulatedRagdolls best ranked ones simulate, the others are queued in their current pose
+ *   and simulate again from it as soon as they rank within budget
+ * - ragdolls that came to rest are frozen, frozen ragdolls never simulate again
+ * - ragdolls ranked beyond TrueFPS.MaxRagdolls have their lifespan shortened
+ */
+UCLASS()
+class TRUEFPSSYSTEM_API UTrueFPSRagdollManager : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Starts managing a character that just started simulating its mesh */
+	void AddRagdoll(ACharacter* Character);
+
+	virtual void Deinitialize() override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	struct FRagdoll
+	{
+		TWeakObjectPtr<ACharacter> Character;
+		double StartTime = 0.0;
+
+		/** when it last started simulating, it can't settle before it simulated for a while */
+		double SimulateStartTime = 0.0;
+
+		/** lower is more important */
+		double Priority = 0.0;
+
+		/** collision of the simulated mesh, restored when a queued ragdoll simulates again */
+		TEnumAsByte<ECollisionEnabled::Type> CollisionEnabled = ECollisionEnabled::NoCollision;
+
+		bool bQueued = false;
+		bool bFrozen = false;
+	};
+
+	/** Ranks the ragdolls, then freezes the settled ones, queues or resumes the others by budget and shortens the lifespan of the ones over it */
+	void UpdateRagdolls();
+
+	/** Stops simulating for good, the mesh keeps its last simulated pose */
+	void FreezeRagdoll(FRagdoll& Ragdoll) const;
+
+	/** Stops simulating until a slot frees up, the mesh keeps its last simulated pose */
+	void QueueRagdoll(FRagdoll& Ragdoll) const;
+
+	/** Simulates a queued ragdoll again from the pose it was queued in */
+	void ResumeRagdoll(FRagdoll& Ragdoll, double Now) const;
+
+	TArray<FRagdoll> Ragdolls;
+
+	FTimerHandle TimerHandle_UpdateRagdolls;
+};
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TrueFPSTickManager.generated.h"
+
+class ATrueFPSCharacter;
+class ATrueFPSWeaponBase;
+class UTrueFPSTickManager;
+
+/** Tick function the manager runs the registered actors of one tick group from */
+USTRUCT()
+struct FTrueFPSTickManagerTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UTrueFPSTickManager* Manager{nullptr};
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTrueFPSTickManagerTickFunction> : public TStructOpsTypeTraitsBase2<FTrueFPSTickManagerTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Ticks every character and weapon of the world from one tick function per tick group instead of one per actor.
+ * - actors tick in the tick group their actor tick had when they registered, scaled by their CustomTimeDilation like the actor tick
+ * - characters are refreshed first, then the weapons attached to a pawn or still settling their recoil, other weapons in the inventory are skipped
+ * - the weapons' interpolation runs in a ParallelFor when TrueFPS.ParallelWeaponTick is set
+ * - registered actors keep their actor tick disabled, unless a blueprint implements the tick event
+ * - TrueFPS.BatchedTick 0 falls back to per actor ticking, to compare the two with stat game
+ */
+UCLASS()
+class TRUEFPSSYSTEM_API UTrueFPSTickManager : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** @return the world's tick manager, null if batched ticking is disabled */
+	static UTrueFPSTickManager* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+	void RegisterCharacter(ATrueFPSCharacter* Character);
+	void UnregisterCharacter(ATrueFPSCharacter* Character);
+
+	void RegisterWeapon(ATrueFPSWeaponBase* Weapon);
+	void UnregisterWeapon(ATrueFPSWeaponBase* Weapon);
+
+	/** Runs the registered characters of the tick group, then their weapons */
+	void Tick(float DeltaTime, ETickingGroup TickGroup);
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	/** @return the tick function of the group, registered the first time an actor ticks in it */
+	FTrueFPSTickManagerTickFunction& FindOrAddTickFunction(ETickingGroup TickGroup);
+
+	/** The actor's meshes evaluate their animation after the manager updated the state they read */
+	void AddMeshPrerequisites(AActor* Actor, FTrueFPSTickManagerTickFunction& TickFunction);
+	void RemoveMeshPrerequisites(AActor* Actor, FTrueFPSTickManagerTickFunction& TickFunction);
+
+	TUniquePtr<FTrueFPSTickManagerTickFunction> TickFunctions[TG_MAX];
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ATrueFPSCharacter>> Characters;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ATrueFPSWeaponBase>> Weapons;
+
+	/** the tick group each character and weapon registered in, at the same index */
+	TArray<TEnumAsByte<ETickingGroup>> CharacterTickGroups;
+	TArray<TEnumAsByte<ETickingGroup>> WeaponTickGroups;
+
+	/** weapons ticked this frame, kept around so the array isn't reallocated every tick */
+	TArray<ATrueFPSWeaponBase*> TickingWeapons;
+};
@@ -9,6 +9,17 @@
 class ATrueFPSAIController;
 class ATrueFPSPlayerController;
 class ATrueFPSPlayerState;
+class ATrueFPSWeaponBase;
+
+/** Idle weapons of a single class, waiting to be handed to the next spawned pawn */
+USTRUCT()
+struct FTrueFPSWeaponPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<ATrueFPSWeaponBase>> Weapons;
+};
 
 UCLASS()
 class TRUEFPSSYSTEM_API ATrueFPSGameMode : public AGameMode
@@ -59,8 +70,11 @@ public:
 	/** notify about kills */
 	virtual void Killed(AController* Killer, AController* KilledPlayer, APawn* KilledPawn, const UDamageType* DamageType);
 
-	/** can players damage each other? */
-	virtual bool CanDealDamage(ATrueFPSPlayerState* DamageInstigator, ATrueFPSPlayerState* DamagedPlayer) const;
+	/**
+	 * can a player of one team damage a player of another? INDEX_NONE is no team.
+	 * the one friendly fire rule, used by ModifyDamage and the characters' enemy checks with their cached teams
+	 */
+	virtual bool CanDealDamage(int32 InstigatorTeamNum, int32 DamagedTeamNum) const;
 
 	/** always create cheat manager */
 	virtual bool AllowCheats(APlayerController* P) override;
@@ -77,15 +91,30 @@ public:
 	/** new player joins */
 	virtual void HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer) override;
 
-	/** hides the onscreen hud and restarts the map */
+	/** hides the onscreen hud and restarts the map, or travels to the next map in the rotation */
 	virtual void RestartGame() override;
 
+	/** carries the idle pooled weapons over to the next map */
+	virtual void GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList) override;
+
+	/** takes over the pooled weapons carried by the previous game mode */
+	virtual void PostSeamlessTravel() override;
+
+	/** returns the map the next match is played on, empty when the current map restarts */
+	FString GetNextMapName() const;
+
 	/** Creates AIControllers for all bots */
 	void CreateBotControllers();
 
 	/** Create a bot */
 	ATrueFPSAIController* CreateBot(int32 BotNum);
 
+	/** [server] takes a weapon of the given class from its pool, spawning a new one if the pool is empty */
+	ATrueFPSWeaponBase* AcquireWeapon(TSubclassOf<ATrueFPSWeaponBase> WeaponClass);
+
+	/** [server] resets a weapon that left its owner's inventory and puts it back into its pool, or destroys it if the pool is full */
+	void ReleaseWeapon(ATrueFPSWeaponBase* Weapon);
+
 	virtual void PostInitProperties() override;
 
 protected:
@@ -113,9 +142,25 @@ protected:
 	UPROPERTY(config)
 	float DamageSelfScale;
 
+	/** whether players on the same team can damage each other */
+	UPROPERTY(config)
+	bool bAllowFriendlyFire = true;
+
 	UPROPERTY(config)
 	int32 MaxBots;
 
+	/** weapons pre-spawned per default weapon class before the match starts */
+	UPROPERTY(config)
+	int32 WeaponPoolWarmUpSize;
+
+	/** idle weapons kept per class, released weapons beyond this are destroyed */
+	UPROPERTY(config)
+	int32 MaxPooledWeaponsPerClass;
+
+	/** maps cycled through between matches, as long package names. the current map restarts when empty */
+	UPROPERTY(config)
+	TArray<FString> MapRotation;
+
 	UPROPERTY(config)
 	bool bDrawDeathMessages = false;
 
@@ -128,6 +173,10 @@ protected:
 	UPROPERTY()
 	TArray<ATrueFPSAIController*> BotControllers;
 
+	/** idle weapons by class, recycled between deaths and respawns */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<ATrueFPSWeaponBase>, FTrueFPSWeaponPool> WeaponPools;
+
 	UPROPERTY(config)
 	TSubclassOf<ATrueFPSPlayerController> PlatformPlayerControllerClass;
 	
@@ -144,6 +193,18 @@ protected:
 	/** initialization for bot after creation */
 	virtual void InitBot(ATrueFPSAIController* AIC, int32 BotNum);
 
+	/** pre-spawns the default weapons of the player and bot pawn classes into their pools */
+	void WarmUpWeaponPools();
+
+	/** gathers the default weapons of the player and bot pawn classes */
+	void GetDefaultWeaponClasses(TSet<TSubclassOf<ATrueFPSWeaponBase>>& OutWeaponClasses) const;
+
+	/** starts loading the next map and its weapons on the server and all clients while the scoreboard is up */
+	void PreloadNextMatch();
+
+	/** spawns a new weapon along with its default attachments */
+	ATrueFPSWeaponBase* SpawnPooledWeapon(TSubclassOf<ATrueFPSWeaponBase> WeaponClass);
+
 	/** check who won */
 	virtual void DetermineMatchWinner();
 
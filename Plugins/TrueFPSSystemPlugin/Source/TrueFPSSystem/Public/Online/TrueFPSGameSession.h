@@ -190,8 +190,10 @@ public:
 	 * @param SessionName name of session this search will generate
 	 * @param bIsLAN are we searching LAN matches
 	 * @param bIsPresence are we searching presence sessions
+	 *
+	 * @return bool true if a search is under way and OnFindSessionsComplete will fire, false if it couldn't be started
 	 */
-	void FindSessions(TSharedPtr<const FUniqueNetId> UserId, FName SessionName, bool bIsLAN, bool bIsPresence);
+	bool FindSessions(TSharedPtr<const FUniqueNetId> UserId, FName SessionName, bool bIsLAN, bool bIsPresence);
 
 	/**
 	 * Joins one of the session in search results
@@ -3,12 +3,106 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GameFramework/DamageType.h"
 #include "GameFramework/GameState.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "TrueFPSGameState.generated.h"
 
 /** ranked PlayerState map, created from the GameState */
 typedef TMap<int32, TWeakObjectPtr<class ATrueFPSPlayerState> > RankedPlayerMap; 
 
+/** kill feed entry flags */
+namespace EKillFeedFlags
+{
+	enum Type : uint8
+	{
+		/** nobody gets the kill, e.g. fell out of the world */
+		NoKiller = 1 << 0,
+		/** killed by themselves */
+		Suicide = 1 << 1,
+	};
+}
+
+/**
+ * One kill, kept as small as possible as every client receives every kill.
+ * The feed is cosmetic: entries can be overwritten before a client sees them, anything that must not miss a kill
+ * (achievements, stats) goes through ATrueFPSPlayerState::InformAboutKill instead.
+ */
+USTRUCT()
+struct FTrueFPSKillFeedEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** no player, as a player id */
+	static constexpr uint16 NoPlayer = MAX_uint16;
+
+	/** increases with every kill and wraps around, used to drop entries already shown and to show them in order */
+	UPROPERTY()
+	uint16 Serial = 0;
+
+	/** APlayerState::GetPlayerId of the killer and victim, truncated to 16 bits (ids are handed out in order, a session never gets near it) */
+	UPROPERTY()
+	uint16 KillerId = NoPlayer;
+
+	UPROPERTY()
+	uint16 VictimId = NoPlayer;
+
+	/** index into ATrueFPSGameState::KillFeedDamageTypes, INDEX_NONE as a byte if unknown */
+	UPROPERTY()
+	uint8 DamageTypeIndex = MAX_uint8;
+
+	/** EKillFeedFlags */
+	UPROPERTY()
+	uint8 Flags = 0;
+
+	void PostReplicatedAdd(const struct FTrueFPSKillFeed& InArraySerializer);
+	void PostReplicatedChange(const struct FTrueFPSKillFeed& InArraySerializer);
+
+	/** @return true if serial A was added after serial B, accounting for wrap around */
+	static bool IsNewerSerial(const uint16 A, const uint16 B) { return static_cast<int16>(A - B) > 0; }
+
+	static uint16 ToEntryPlayerId(const class APlayerState* PlayerState);
+};
+
+/** the last few kills, as a ring: new kills overwrite the oldest entry */
+USTRUCT()
+struct FTrueFPSKillFeed : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	/** entries kept for clients that miss an update */
+	static constexpr int32 Capacity = 8;
+
+	UPROPERTY()
+	TArray<FTrueFPSKillFeedEntry> Items;
+
+	/** game state owning the feed, not replicated */
+	UPROPERTY(NotReplicated)
+	TObjectPtr<class ATrueFPSGameState> Owner = nullptr;
+
+	/** serial of the last kill added on the server */
+	uint16 LastSerial = 0;
+
+	/** Adds a kill, reusing the slot of the oldest one once full */
+	const FTrueFPSKillFeedEntry& AddKill(uint16 KillerId, uint16 VictimId, uint8 DamageTypeIndex, uint8 Flags);
+
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FTrueFPSKillFeedEntry, FTrueFPSKillFeed>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FTrueFPSKillFeed> : public TStructOpsTypeTraitsBase2<FTrueFPSKillFeed>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
 UCLASS()
 class TRUEFPSSYSTEM_API ATrueFPSGameState : public AGameState
 {
@@ -37,6 +131,36 @@ public:
 	/** gets ranked PlayerState map for specific team */
 	void GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const;
 
+	/** [server] adds a kill to the kill feed, shown by every client's HUD */
+	void AddKill(class ATrueFPSPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class ATrueFPSPlayerState* KilledPlayerState);
+
+	/** [client] called by the kill feed for each entry received, queued until the whole update is in */
+	void OnKillFeedEntryReceived(const FTrueFPSKillFeedEntry& Entry);
+
+	/** [client] shows the queued kill feed entries, oldest first */
+	void FlushReceivedKills();
+
 	void RequestFinishAndExitToMainMenu();
+
+protected:
+
+	virtual void PostInitializeComponents() override;
+
+	/** Resolves a kill feed entry to player states and hands it to the local controllers */
+	virtual void ShowKill(const FTrueFPSKillFeedEntry& Entry);
+
+	/** recent kills, replicated as a ring instead of one reliable multicast per kill */
+	UPROPERTY(Transient, Replicated)
+	FTrueFPSKillFeed KillFeed;
+
+	/** damage types kill feed entries index into, added to as new ones kill someone */
+	UPROPERTY(Transient, Replicated)
+	TArray<TSubclassOf<UDamageType>> KillFeedDamageTypes;
+
+	/** entries received in the current update, waiting to be shown in order */
+	TArray<FTrueFPSKillFeedEntry> ReceivedKills;
+
+	/** serial of the last kill shown, older or repeated entries are dropped */
+	uint16 LastShownKillSerial = 0;
 	
 };
@@ -65,13 +65,9 @@ public:
 	/** gets truncated player name to fit in death log and scoreboards */
 	FString GetShortPlayerName() const;
 
-	/** Sends kill (excluding self) to clients */
+	/** Credits a kill to the owning client's online events, not through the kill feed which may drop entries */
 	UFUNCTION(Reliable, Client)
-	void InformAboutKill(class ATrueFPSPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class ATrueFPSPlayerState* KilledPlayerState);
-
-	/** broadcast death to local clients */
-	UFUNCTION(Reliable, NetMulticast)
-	void BroadcastDeath(class ATrueFPSPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class ATrueFPSPlayerState* KilledPlayerState);
+	void InformAboutKill();
 
 	/** replicate team colors. Updated the players mesh colors appropriately */
 	UFUNCTION()
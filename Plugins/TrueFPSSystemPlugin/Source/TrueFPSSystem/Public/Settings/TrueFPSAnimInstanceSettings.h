@@ -47,5 +47,17 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings")
 	float MinMoveSpeedToApplyMovementSway{100.f};
+
+	// Samples per second the weapon sway curves are baked at when the weapon changes
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|LOD", Meta = (ClampMin = 1, ForceUnits = "Hz"))
+	float SwayBakeSampleRate{60.f};
+
+	// Rate the weapon sway curves are sampled at, interpolating in between. 0 samples them every update
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|LOD", Meta = (ClampMin = 0, ForceUnits = "Hz"))
+	float SwaySampleRate{0.f};
+
+	// Third person characters further than this from every local camera skip weapon sway and accumulative offsets
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|LOD", Meta = (ForceUnits = "cm"))
+	float MaxWeaponSwayDistance{3000.f};
 	
 };
@@ -8,6 +8,17 @@ class ATrueFPSWeaponBase;
 class USoundCue;
 class UAnimMontage;
 
+UENUM(BlueprintType)
+enum class ETrueFPSCameraTargetMode : uint8
+{
+	// The head socket of the current pose. The camera waits on the animation to finish every frame
+	HeadSocket,
+	// Head offsets seeded from the reference pose and the crouched capsule, refined by the finished poses, looked up from the crouch and lean values
+	Analytic,
+	// The head socket of the last finished pose, moved along by the character's velocity since
+	Extrapolated
+};
+
 UCLASS(Blueprintable, BlueprintType)
 class TRUEFPSSYSTEM_API UTrueFPSCharacterSettings : public UDataAsset
 {
@@ -38,9 +49,21 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Config|Animation")
 	TObjectPtr<UAnimMontage> DeathAnim;
 
+	// Frames the third person mesh skips between animation updates, indexed by mesh LOD. The last value is used for any LOD past the end
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Animation|LOD")
+	TArray<int32> ThirdPersonLODFrameSkips{0, 1, 2, 3};
+
+	// Skipped frames are interpolated as long as the mesh updates at least once every this many frames
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Animation|LOD", meta = (ClampMin = 1))
+	int32 MaxInterpolatedUpdateRate{4};
+
 	UPROPERTY(EditDefaultsOnly, Category = "Config|Pawn")
 	TObjectPtr<USoundCue> DeathSound;
 
+	// Seconds between health regeneration steps on the server, when regeneration is enabled
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Pawn", meta = (ClampMin = 0.02))
+	float HealthRegenInterval{0.25f};
+
 	// Weapons
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Weapon")
@@ -53,5 +76,9 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Camera", meta = (ClampMin = 0, ClampMax = 90))
 	float CameraPitchClamp{88.9f};
+
+	// Where the first person camera (and the weapon traces from it) get their location from
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Camera")
+	ETrueFPSCameraTargetMode CameraTargetMode{ETrueFPSCameraTargetMode::HeadSocket};
 	
 };
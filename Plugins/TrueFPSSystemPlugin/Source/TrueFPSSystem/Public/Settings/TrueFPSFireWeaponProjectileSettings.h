@@ -34,6 +34,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|WeaponStat")
 	TSubclassOf<UDamageType> DamageType{UDamageType::StaticClass()};
 
+	/** occlusion traces done on the explosion frame, closest actors first; the rest are traced asynchronously and damaged next frame */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|WeaponStat", Meta = (ClampMin = "0"))
+	int32 ExplosionSyncTraceBudget{16};
+
 	// Projectile
 
 	/** projectile class */
@@ -51,6 +51,12 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Stats")
 	bool bAllowAutomaticWeaponCatchup{true};
 
+	// Replication
+
+	/** Net update frequency while the weapon is holstered in an inventory, capped by the weapon's own */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Replication", meta = (ClampMin = "1"))
+	float HolsteredNetUpdateFrequency{2.f};
+
 	// Animations
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Animations")
@@ -113,6 +119,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Animations|Recoil")
 	FRecoilParams Recoil;
 
+	/** samples per second the recoil curves are baked at */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Animations|Recoil", meta = (ClampMin = "1"))
+	float RecoilBakeSampleRate{120.f};
+
+	/** true - the recoil of shots fired while the previous ones still play adds up (up to 64), false - each shot restarts the recoil */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|Animations|Recoil")
+	bool bStackRecoil{false};
+
 	// Effects
 
 	/** camera shake on firing */
@@ -205,5 +219,29 @@ public:
 	/** true - crosshair will not be shown unless aiming with the weapon */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|HUD")
 	bool bHideCrosshairWhileAiming{true};
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif// WITH_EDITOR
+
+	/** bakes the recoil curves into lookup tables, skipped if they're already baked from the current curves */
+	void BakeRecoil(const bool bForce = false);
+
+	FORCEINLINE const FTrueFPSBakedRecoil& GetBakedRecoil() const { return BakedRecoil; }
+
+private:
+
+	FTrueFPSBakedRecoil BakedRecoil;
+
+#if WITH_EDITORONLY_DATA
+	/** recoil curves whose edits rebake the tables */
+	TArray<TWeakObjectPtr<UCurveBase>> BoundRecoilCurves;
+#endif// WITH_EDITORONLY_DATA
+
+#if WITH_EDITOR
+	void OnRecoilCurveUpdated(UCurveBase* Curve, EPropertyChangeType::Type ChangeType);
+#endif// WITH_EDITOR
 	
 };
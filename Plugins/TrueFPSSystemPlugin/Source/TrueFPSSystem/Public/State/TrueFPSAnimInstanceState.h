@@ -64,6 +64,11 @@ struct TRUEFPSSYSTEM_API FTrueFPSAnimInstanceState
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS|Animation|IK")
 	FTransform OriginRelativeTransform{FTransform::Identity};
 
+	// Bumped whenever the weapon or its sights change, i.e. the sights transform above. The origin isn't covered, it moves with the aiming value.
+	// Bind to the arms IK node's Weapon Change Counter so it only recomputes what it derives from the sights and weapon offset then.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TrueFPS|Animation|IK")
+	int32 WeaponChangeCounter{0};
+
 	// Applies an offset to the weapon transform
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS|Animation|IK")
 	FTransform OffsetTransform{FTransform::Identity};
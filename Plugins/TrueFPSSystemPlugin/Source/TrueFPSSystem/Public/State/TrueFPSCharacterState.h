@@ -26,6 +26,12 @@ struct TRUEFPSSYSTEM_API FTrueFPSCharacterState
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS")
 	bool bWantsToFire{false};
 
+	// Team
+
+	/** Team of the owning player state, INDEX_NONE without one. Cached whenever the player state or its team changes */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TrueFPS")
+	int32 TeamNum{INDEX_NONE};
+
 	// Input
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS")
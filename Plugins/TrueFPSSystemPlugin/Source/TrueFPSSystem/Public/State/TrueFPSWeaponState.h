@@ -73,16 +73,28 @@ struct TRUEFPSSYSTEM_API FTrueFPSWeaponState
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS")
 	FTransform SightsRelativeTransform{FTransform::Identity};
 
+	// Bumped every time the sights relative transform moves
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TrueFPS")
+	int32 SightsChangeCounter{0};
+
 	// Custom weapon offset transform
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS")
 	FTransform OffsetTransform{FTransform::Identity};
 	
+	// The recoil instance of the last shot, the only one played unless the settings stack recoil
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS")
 	FRecoilInstance CurrentRecoilInstance;
+
+	// Live recoil instances accumulated into RecoilOffset, when the settings stack recoil
+	FRecoilInstanceRing RecoilInstances;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS")
 	float WallOffsetTransformAlpha{0.f};
 
+	// The wall offset alpha traced this frame, WallOffsetTransformAlpha is smoothed toward it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS")
+	float TargetWallOffsetTransformAlpha{0.f};
+
 	// Camera
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TrueFPS")
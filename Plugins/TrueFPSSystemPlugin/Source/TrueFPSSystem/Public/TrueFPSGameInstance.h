@@ -90,6 +90,7 @@ public:
 
 	UTrueFPSGameInstance(const FObjectInitializer& ObjectInitializer);
 
+	/** Low frequency watchdog, retries state work that couldn't be handled when its event fired */
 	bool Tick(float DeltaSeconds);
 
 	ATrueFPSGameSession* GetGameSession() const;
@@ -105,6 +106,10 @@ public:
 	virtual void ReceivedNetworkEncryptionToken(const FString& EncryptionToken, const FOnEncryptionKeyResponse& Delegate) override;
 	virtual void ReceivedNetworkEncryptionAck(const FOnEncryptionKeyResponse& Delegate) override;
 
+	/** releases the packages preloaded for a match that won't be reached */
+	virtual void HandleNetworkError(ENetworkFailure::Type FailureType, bool bIsServer) override;
+	virtual void HandleTravelError(ETravelFailure::Type FailureType) override;
+
 	bool HostGame(ULocalPlayer* LocalPlayer, const FString& GameType, const FString& InTravelURL);
 	bool JoinSession(ULocalPlayer* LocalPlayer, int32 SessionIndexInSearchResults);
 	bool JoinSession(ULocalPlayer* LocalPlayer, const FOnlineSessionSearchResult& SearchResult);
@@ -207,9 +212,24 @@ public:
 	/** Sets a rich presence string for given local player. */
 	void SetPresenceForLocalPlayer(int32 LocalUserNum, const FString& StatusStr, const FVariantData& PresenceData);
 
+	/** @return the queue local players' end of match reports are written through */
+	TSharedPtr<class FTrueFPSMatchReportQueue> GetMatchReportQueue() const { return MatchReportQueue; }
+
+	/** @return the coordinator all presence and friends list requests go through */
+	TSharedPtr<class FTrueFPSPresenceCoordinator> GetPresenceCoordinator() const { return PresenceCoordinator; }
+
+	/** @return the cache leaderboard reads go through */
+	TSharedPtr<class FTrueFPSLeaderboardCache> GetLeaderboardCache() const { return LeaderboardCache; }
+
 	/** Handle game activity requests */
 	void OnGameActivityActivationRequestComplete(const FUniqueNetId& PlayerId, const FString& ActivityId, const FOnlineSessionSearchResult* SessionInfo);
 
+	/** Starts loading the next match's map and the given packages in the background, so travel finds them already in memory */
+	void PreloadTravelPackages(const FString& MapName, const TArray<FName>& PackageNames);
+
+	/** Logs the time from the start of travel until the match became playable, and drops the preloaded packages */
+	void NotifyMatchPlayable();
+
 
 private:
 
@@ -219,6 +239,10 @@ private:
 	UPROPERTY(config)
 	FString MainMenuMap;
 
+	/** Seconds between watchdog ticks */
+	UPROPERTY(config)
+	float StateWatchdogInterval;
+
 
 	FName CurrentState;
 	FName PendingState;
@@ -270,12 +294,26 @@ private:
 	FDelegateHandle OnDestroySessionCompleteDelegateHandle;
 	FDelegateHandle OnCreatePresenceSessionCompleteDelegateHandle;
 	FDelegateHandle OnGameActivityActivationRequestedDelegateHandle;
+	FDelegateHandle EndFrameDelegateHandle;
 	
 	FOnGameActivityActivationRequestedDelegate OnGameActivityActivationRequestedDelegate;
 
 	/** Local player login status when the system is suspended */
 	TArray<ELoginStatus::Type> LocalPlayerOnlineStatus;
 
+	/** Long package name of the map currently being preloaded for travel */
+	FString PreloadMapName;
+
+	/** Assets of packages loaded ahead of travel, kept alive until the next match is playable */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UObject>> PreloadedAssets;
+
+	/** Time travel to a new map started, zero when not travelling */
+	double TravelStartTime = 0.0;
+
+	/** Time the travel destination finished loading */
+	double TravelMapLoadedTime = 0.0;
+
 	/** A hard-coded encryption key used to try out the encryption code. This is NOT SECURE, do not use this technique in production! */
 	TArray<uint8> DebugTestEncryptionKey;
 
@@ -285,7 +323,10 @@ private:
 	
 	void OnPreLoadMap(const FString& MapName);
 	void OnPostLoadMap(UWorld*);
+	void OnPreloadPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+	void ReleasePreloadedPackages();
 	void OnPostDemoPlay();
+	void OnReplayRecordingComplete(UWorld* World);
 
 	void HandleDemoPlaybackFailure(EReplayResult, const FString& ErrorString );
 	
@@ -298,9 +339,18 @@ private:
 
 	void OnEndSessionComplete( FName SessionName, bool bWasSuccessful );
 
+	/** Runs the state machine and the checks that depend on it at the end of the current frame */
+	void RequestStateUpdate();
+	void HandleEndFrame();
+
+	/** False while another PIE instance's viewport has focus */
+	bool IsGameViewportActive() const;
+
+	void CheckLicense();
+	void CheckControllerConnections();
+	void TryAcceptPendingInvite();
+
 	void MaybeChangeState();
-	void EndCurrentState(FName NextState);
-	void BeginNewState(FName NewState, FName PrevState);
 
 	void BeginPendingInviteState();
 	void BeginWelcomeScreenState();
@@ -393,6 +443,24 @@ private:
 	FReply OnControllerReconnectConfirm();	
 
 protected:
+
+	/** Runs the state machine, then the license, controller and invite checks that may change state */
+	virtual void UpdateState();
+
+	/** Per-state custom ending code, the maps and menus of the state being left */
+	virtual void EndCurrentState(FName NextState);
+
+	/** Per-state custom starting code, the maps and menus of the state being entered */
+	virtual void BeginNewState(FName NewState, FName PrevState);
+
+	/** Batches and throttles presence updates and friends list reads for every local player */
+	TSharedPtr<class FTrueFPSPresenceCoordinator> PresenceCoordinator;
+
+	/** Spreads end of match save file and online writes over several frames */
+	TSharedPtr<class FTrueFPSMatchReportQueue> MatchReportQueue;
+
+	/** Cached, paged reads of the leaderboard */
+	TSharedPtr<class FTrueFPSLeaderboardCache> LeaderboardCache;
 	
 	bool HandleOpenCommand(const TCHAR* Cmd, FOutputDevice& Ar, UWorld* InWorld);
 	bool HandleDisconnectCommand(const TCHAR* Cmd, FOutputDevice& Ar, UWorld* InWorld);
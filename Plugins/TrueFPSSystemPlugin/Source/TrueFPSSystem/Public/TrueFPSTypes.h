@@ -4,6 +4,8 @@
 #include "Curves/CurveVector.h"
 #include "Engine/DamageEvents.h"
 #include "Engine/DataTable.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/Actor.h"
 
 #include "TrueFPSTypes.generated.h"
 
@@ -101,7 +103,7 @@ struct FDecalData
 	}
 };
 
-/** replicated information on a hit we've taken */
+/** replicated information on a hit we've taken, reduced to what remote clients need to play the hit back */
 USTRUCT(BlueprintType)
 struct FTakeHitInfo
 {
@@ -135,22 +137,44 @@ public:
 
 private:
 
-	/** A rolling counter used to ensure the struct is dirty and will replicate. */
+	/** A rolling counter used to ensure the struct is dirty and will replicate. Its low bits are sent, so that a hit identical to the last one still changes the received value */
 	UPROPERTY()
 	uint8 EnsureReplicationByte;
 
-	/** Describes general damage. */
+	/** Direction the point or radial damage travelled in, the only part of those events clients use */
 	UPROPERTY()
-	FDamageEvent GeneralDamageEvent;
+	FVector HitDirection;
 
-	/** Describes point damage, if that is what was received. */
-	UPROPERTY()
+	/** Damage events rebuilt locally from the replicated data by GetDamageEvent */
+	FDamageEvent GeneralDamageEvent;
 	FPointDamageEvent PointDamageEvent;
-
-	/** Describes radial damage, if that is what was received. */
-	UPROPERTY()
 	FRadialDamageEvent RadialDamageEvent;
 
+	/** Which of the damage events above is used, two bits on the wire */
+	enum class EDamageEventKind : uint8
+	{
+		General,
+		Point,
+		Radial,
+	};
+
+	/** bits of EnsureReplicationByte sent, a repeated hit only goes unnoticed if exactly a multiple of 16 hits happened in between */
+	static constexpr uint8 ReplicationBitsNum = 4;
+	static constexpr uint8 ReplicationBitsMask = (1 << ReplicationBitsNum) - 1;
+
+	FORCEINLINE EDamageEventKind GetDamageEventKind() const
+	{
+		switch (DamageEventClassID)
+		{
+		case FPointDamageEvent::ClassID:
+			return EDamageEventKind::Point;
+		case FRadialDamageEvent::ClassID:
+			return EDamageEventKind::Radial;
+		default:
+			return EDamageEventKind::General;
+		}
+	}
+
 public:
 	
 	FTakeHitInfo()
@@ -161,57 +185,172 @@ public:
 		, DamageEventClassID(0)
 		, bKilled(false)
 		, EnsureReplicationByte(0)
+		, HitDirection(FVector::ZeroVector)
 	{}
 
-	FDamageEvent& GetDamageEvent()
+	/** Rebuilds the damage event for the given hit actor, so that GetBestHitInfo yields the replicated direction */
+	FDamageEvent& GetDamageEvent(const AActor* HitActor)
 	{
-		switch (DamageEventClassID)
+		UClass* const UseDamageTypeClass = DamageTypeClass ? DamageTypeClass : UDamageType::StaticClass();
+		const FVector HitLocation = HitActor ? HitActor->GetActorLocation() : FVector::ZeroVector;
+
+		switch (GetDamageEventKind())
 		{
-		case FPointDamageEvent::ClassID:
-			if (PointDamageEvent.DamageTypeClass == nullptr)
-			{
-				PointDamageEvent.DamageTypeClass = DamageTypeClass ? DamageTypeClass : UDamageType::StaticClass();
-			}
+		case EDamageEventKind::Point:
+			PointDamageEvent.DamageTypeClass = UseDamageTypeClass;
+			PointDamageEvent.Damage = ActualDamage;
+			PointDamageEvent.ShotDirection = HitDirection;
+			PointDamageEvent.HitInfo.Location = PointDamageEvent.HitInfo.ImpactPoint = HitLocation;
+			PointDamageEvent.HitInfo.Normal = PointDamageEvent.HitInfo.ImpactNormal = -HitDirection;
 			return PointDamageEvent;
 
-		case FRadialDamageEvent::ClassID:
-			if (RadialDamageEvent.DamageTypeClass == nullptr)
-			{
-				RadialDamageEvent.DamageTypeClass = DamageTypeClass ? DamageTypeClass : UDamageType::StaticClass();
-			}
+		case EDamageEventKind::Radial:
+			RadialDamageEvent.DamageTypeClass = UseDamageTypeClass;
+			RadialDamageEvent.Params.BaseDamage = ActualDamage;
+			RadialDamageEvent.Origin = HitLocation - HitDirection;
+			RadialDamageEvent.ComponentHits.SetNum(1);
+			RadialDamageEvent.ComponentHits[0].Location = RadialDamageEvent.ComponentHits[0].ImpactPoint = HitLocation;
 			return RadialDamageEvent;
 
 		default:
-			if (GeneralDamageEvent.DamageTypeClass == nullptr)
-			{
-				GeneralDamageEvent.DamageTypeClass = DamageTypeClass ? DamageTypeClass : UDamageType::StaticClass();
-			}
+			GeneralDamageEvent.DamageTypeClass = UseDamageTypeClass;
 			return GeneralDamageEvent;
 		}
 	}
 	
-	void SetDamageEvent(const FDamageEvent& DamageEvent)
+	void SetDamageEvent(const FDamageEvent& DamageEvent, const AActor* HitActor, const AActor* HitInstigator)
 	{
 		DamageEventClassID = DamageEvent.GetTypeID();
-		switch (DamageEventClassID)
+		DamageTypeClass = DamageEvent.DamageTypeClass;
+		HitDirection = FVector::ZeroVector;
+
+		if (GetDamageEventKind() != EDamageEventKind::General)
 		{
-		case FPointDamageEvent::ClassID:
-			PointDamageEvent = *((FPointDamageEvent const*)(&DamageEvent));
-			break;
-		case FRadialDamageEvent::ClassID:
-			RadialDamageEvent = *((FRadialDamageEvent const*)(&DamageEvent));
-			break;
-		default:
-			GeneralDamageEvent = DamageEvent;
+			FHitResult UnusedHitInfo;
+			DamageEvent.GetBestHitInfo(HitActor, HitInstigator, UnusedHitInfo, HitDirection);
 		}
-
-		DamageTypeClass = DamageEvent.DamageTypeClass;
 	}
 	
 	void EnsureReplication()
 	{
 		EnsureReplicationByte++;
 	}
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = true;
+
+		Ar << ActualDamage;
+		Ar << DamageTypeClass;
+		Ar << PawnInstigator;
+		Ar << DamageCauser;
+
+		uint8 Kind = static_cast<uint8>(GetDamageEventKind());
+		Ar.SerializeBits(&Kind, 2);
+
+		uint8 bKilledBit = bKilled;
+		Ar.SerializeBits(&bKilledBit, 1);
+
+		// Without it a hit identical to the previous one (same damage, instigator and direction) wouldn't trigger the rep notify
+		uint8 ReplicationBits = EnsureReplicationByte & ReplicationBitsMask;
+		Ar.SerializeBits(&ReplicationBits, ReplicationBitsNum);
+
+		if (Ar.IsLoading())
+		{
+			bKilled = bKilledBit;
+			EnsureReplicationByte = ReplicationBits;
+
+			switch (static_cast<EDamageEventKind>(Kind))
+			{
+			case EDamageEventKind::Point:
+				DamageEventClassID = FPointDamageEvent::ClassID;
+				break;
+			case EDamageEventKind::Radial:
+				DamageEventClassID = FRadialDamageEvent::ClassID;
+				break;
+			default:
+				DamageEventClassID = FDamageEvent::ClassID;
+				HitDirection = FVector::ZeroVector;
+			}
+		}
+
+		// General damage derives its direction from the instigator, so only point and radial hits carry one
+		if (static_cast<EDamageEventKind>(Kind) != EDamageEventKind::General)
+		{
+			bOutSuccess &= SerializeFixedVector<1, 16>(HitDirection, Ar);
+		}
+
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FTakeHitInfo> : public TStructOpsTypeTraitsBase2<FTakeHitInfo>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/** replicated sights selection, reconstructed into a relative transform from the receiver's own attachment data */
+USTRUCT()
+struct FTrueFPSReplicatedSights
+{
+	GENERATED_BODY()
+
+	/** 0 for the weapon's default sights, otherwise 1 + index into the weapon's sights attachments */
+	UPROPERTY()
+	uint8 SightsIndex = 0;
+
+	/** the selected sights' aim offset in tenths of a unit, so server-side aim offset changes survive reconstruction */
+	UPROPERTY()
+	int16 QuantizedAimOffset = 0;
+
+	FTrueFPSReplicatedSights() {}
+	FTrueFPSReplicatedSights(const uint8 SightsIndex, const float AimOffset)
+		: SightsIndex(SightsIndex)
+		, QuantizedAimOffset(static_cast<int16>(FMath::Clamp(FMath::RoundToInt(AimOffset * 10.f), MIN_int16, MAX_int16)))
+	{}
+
+	FORCEINLINE float GetAimOffset() const { return QuantizedAimOffset * 0.1f; }
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+	{
+		Ar << SightsIndex;
+
+		// Most sights don't carry an aim offset, skip the offset entirely for those
+		uint8 bHasAimOffset = QuantizedAimOffset != 0;
+		Ar.SerializeBits(&bHasAimOffset, 1);
+		if (bHasAimOffset)
+		{
+			Ar << QuantizedAimOffset;
+		}
+		else if (Ar.IsLoading())
+		{
+			QuantizedAimOffset = 0;
+		}
+
+		bOutSuccess = true;
+		return true;
+	}
+
+	FORCEINLINE bool operator==(const FTrueFPSReplicatedSights& Other) const
+	{
+		return SightsIndex == Other.SightsIndex && QuantizedAimOffset == Other.QuantizedAimOffset;
+	}
+
+	FORCEINLINE bool operator!=(const FTrueFPSReplicatedSights& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FTrueFPSReplicatedSights> : public TStructOpsTypeTraitsBase2<FTrueFPSReplicatedSights>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
 };
 
 USTRUCT(BlueprintType)
@@ -238,39 +377,197 @@ struct FRecoilParams
 	float Magnitude = 1.f;
 };
 
+/** fixed-rate lookup table baked from a UCurveVector, one table per channel sampled with linear interpolation and the channel's own extrapolation */
+struct FTrueFPSBakedCurveVector
+{
+	/** one channel's table, covering that channel's own key range */
+	struct FChannel
+	{
+		TArray<float> Values;
+
+		float MinTime = 0.f;
+		float Duration = 0.f;
+		float InvSampleInterval = 0.f;
+
+		/** whether the channel cycles before its first and past its last key, sampling then wraps around instead of clamping */
+		bool bCycleBefore = false;
+		bool bCycleAfter = false;
+
+		void Bake(const FRichCurve& Curve, const float SampleRate)
+		{
+			float MaxTime;
+			Curve.GetTimeRange(MinTime, MaxTime);
+			Duration = FMath::Max(MaxTime - MinTime, 0.f);
+			bCycleBefore = Curve.PreInfinityExtrap == RCCE_Cycle && Duration > 0.f;
+			bCycleAfter = Curve.PostInfinityExtrap == RCCE_Cycle && Duration > 0.f;
+
+			// Always bake at least two samples so sampling never has to special case a single key
+			const int32 NumSamples = FMath::Max(FMath::CeilToInt(Duration * FMath::Max(SampleRate, 1.f)), 1) + 1;
+			const float SampleInterval = Duration / (NumSamples - 1);
+			InvSampleInterval = SampleInterval > 0.f ? 1.f / SampleInterval : 0.f;
+
+			Values.SetNumUninitialized(NumSamples);
+			for (int32 i = 0; i < NumSamples; ++i)
+			{
+				Values[i] = Curve.Eval(MinTime + SampleInterval * i);
+			}
+		}
+
+		FORCEINLINE float Sample(const float Time) const
+		{
+			float LocalTime = Time - MinTime;
+			if ((LocalTime < 0.f && bCycleBefore) || (LocalTime > Duration && bCycleAfter))
+			{
+				LocalTime = FMath::Fmod(LocalTime, Duration);
+				if (LocalTime < 0.f) LocalTime += Duration;
+			}
+
+			const int32 LastIndex = Values.Num() - 1;
+			const float Position = FMath::Clamp(LocalTime * InvSampleInterval, 0.f, static_cast<float>(LastIndex));
+			const int32 Index = FMath::Min(FMath::FloorToInt(Position), LastIndex - 1);
+			return FMath::Lerp(Values[Index], Values[Index + 1], Position - Index);
+		}
+	};
+
+	FChannel Channels[3];
+
+	/** key range of all the channels together */
+	float MinTime = 0.f;
+	float MaxTime = 0.f;
+
+	/** curve the table was baked from, to tell if the table is stale and to evaluate when it couldn't be baked */
+	const UCurveVector* SourceCurve = nullptr;
+
+	/** a channel extrapolates in a way the tables don't reproduce (linear, oscillating or cycling with offset), sampling evaluates the source curve instead */
+	bool bEvaluateSourceCurve = false;
+
+	FORCEINLINE bool IsBaked() const { return Channels[0].Values.Num() > 0; }
+
+	/** whether sampling returns the source curve's values, from the tables or from the curve itself */
+	FORCEINLINE bool IsValid() const { return IsBaked() || bEvaluateSourceCurve; }
+
+	/** extrapolations the tables reproduce, none clamps like constant */
+	static bool CanBakeExtrapolation(const ERichCurveExtrapolation Extrapolation)
+	{
+		return Extrapolation == RCCE_Constant || Extrapolation == RCCE_None || Extrapolation == RCCE_Cycle;
+	}
+
+	void Reset()
+	{
+		for (FChannel& Channel : Channels)
+		{
+			Channel = FChannel();
+		}
+		MinTime = MaxTime = 0.f;
+		SourceCurve = nullptr;
+		bEvaluateSourceCurve = false;
+	}
+
+	void Bake(const UCurveVector* Curve, const float SampleRate)
+	{
+		Reset();
+		if (!Curve) return;
+
+		SourceCurve = Curve;
+		Curve->GetTimeRange(MinTime, MaxTime);
+
+		for (const FRichCurve& RichCurve : Curve->FloatCurves)
+		{
+			if (!CanBakeExtrapolation(RichCurve.PreInfinityExtrap) || !CanBakeExtrapolation(RichCurve.PostInfinityExtrap))
+			{
+				bEvaluateSourceCurve = true;
+				return;
+			}
+		}
+
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			Channels[Channel].Bake(Curve->FloatCurves[Channel], SampleRate);
+		}
+	}
+
+	FORCEINLINE FVector Sample(const float Time) const
+	{
+		if (bEvaluateSourceCurve) return SourceCurve->GetVectorValue(Time);
+		if (!IsBaked()) return FVector::ZeroVector;
+
+		return FVector(Channels[0].Sample(Time), Channels[1].Sample(Time), Channels[2].Sample(Time));
+	}
+};
+
+/** recoil curves baked into lookup tables when the weapon settings load */
+struct FTrueFPSBakedRecoil
+{
+	FTrueFPSBakedCurveVector Location;
+	FTrueFPSBakedCurveVector Rotation;
+
+	float SampleRate = 0.f;
+	float Lifetime = 0.f;
+
+	FORCEINLINE bool IsValid() const { return Location.IsValid(); }
+
+	FORCEINLINE bool IsBakedFrom(const FRecoilParams& RecoilParams) const
+	{
+		return Location.SourceCurve == RecoilParams.LocationCurve && Rotation.SourceCurve == RecoilParams.RotationCurve;
+	}
+
+	FORCEINLINE bool IsBakedFrom(const FRecoilParams& RecoilParams, const float InSampleRate) const
+	{
+		return IsBakedFrom(RecoilParams) && SampleRate == InSampleRate;
+	}
+
+	void Bake(const FRecoilParams& RecoilParams, const float InSampleRate)
+	{
+		SampleRate = InSampleRate;
+		Location.Bake(RecoilParams.LocationCurve, InSampleRate);
+		Rotation.Bake(RecoilParams.RotationCurve, InSampleRate);
+		Lifetime = Location.MaxTime;
+	}
+};
+
 USTRUCT(BlueprintType)
 struct FRecoilInstance
 {
 	GENERATED_BODY()
 	
 	FRecoilInstance(){}
-	FRecoilInstance(const FRecoilParams& RecoilParams) : LocationCurve(RecoilParams.LocationCurve), RotationCurve(RecoilParams.RotationCurve), PlayRate(RecoilParams.PlayRate)
-	{
-		if (!LocationCurve || !RotationCurve) return;
-		
-		float MinTime;
-		LocationCurve->GetTimeRange(MinTime, Lifetime);
-	}
 
-	FORCEINLINE bool IsValid() const
+	/** plays the params' curves, from the baked tables if they were baked from the same curves */
+	FRecoilInstance(const FRecoilParams& RecoilParams, const FTrueFPSBakedRecoil* InBakedRecoil)
+		: LocationCurve(RecoilParams.LocationCurve), RotationCurve(RecoilParams.RotationCurve), PlayRate(RecoilParams.PlayRate)
 	{
-		if (!LocationCurve || !RotationCurve) return false;
+		if (InBakedRecoil && InBakedRecoil->IsValid() && InBakedRecoil->IsBakedFrom(RecoilParams))
+		{
+			BakedRecoil = InBakedRecoil;
+			Lifetime = BakedRecoil->Lifetime;
+		}
+		else if (LocationCurve)
+		{
+			float MinTime;
+			LocationCurve->GetTimeRange(MinTime, Lifetime);
+		}
+	}
 
-		float MinTime1;
-		float MaxTime1;
-		LocationCurve->GetTimeRange(MinTime1, MaxTime1);
+	FORCEINLINE bool IsExpired() const { return CurrentTime >= Lifetime; }
 
-		float MinTime2;
-		float MaxTime2;
-		RotationCurve->GetTimeRange(MinTime2, MaxTime2);
-		
-		if (MinTime1 != MinTime2 || MaxTime1 != MaxTime2) return false;
+	FORCEINLINE void Sample(const float Time, FVector& OutRotation, FVector& OutLocation) const
+	{
+		if (BakedRecoil)
+		{
+			OutRotation = BakedRecoil->Rotation.Sample(Time);
+			OutLocation = BakedRecoil->Location.Sample(Time);
+			return;
+		}
 
-		return true;
+		OutRotation = RotationCurve ? RotationCurve->GetVectorValue(Time) : FVector::ZeroVector;
+		OutLocation = LocationCurve ? LocationCurve->GetVectorValue(Time) : FVector::ZeroVector;
 	}
-	
+
 	class UCurveVector* LocationCurve = nullptr;
 	class UCurveVector* RotationCurve = nullptr;
+
+	/** tables baked from the curves above, owned by the weapon settings */
+	const FTrueFPSBakedRecoil* BakedRecoil = nullptr;
 	
 	float PlayRate = 1.f;
 	
@@ -278,6 +575,58 @@ struct FRecoilInstance
 	float Lifetime = 0.f;
 };
 
+/** fixed-capacity ring of live recoil instances, once full the oldest instance is overwritten */
+struct FRecoilInstanceRing
+{
+	static constexpr int32 Capacity = 64;
+	static_assert((Capacity & (Capacity - 1)) == 0, "FRecoilInstanceRing capacity must be a power of two");
+
+	FORCEINLINE int32 Num() const { return Count; }
+	FORCEINLINE bool IsEmpty() const { return Count == 0; }
+
+	/** index 0 is the oldest live instance */
+	FORCEINLINE FRecoilInstance& operator[](const int32 Index) { return Instances[(Head + Index) & (Capacity - 1)]; }
+	FORCEINLINE const FRecoilInstance& operator[](const int32 Index) const { return Instances[(Head + Index) & (Capacity - 1)]; }
+
+	void Add(const FRecoilInstance& Instance)
+	{
+		if (Count == Capacity)
+		{
+			PopFront();
+		}
+
+		Instances[(Head + Count) & (Capacity - 1)] = Instance;
+		++Count;
+	}
+
+	/** drops expired instances from the front, instances sharing a play rate expire in the order they were added */
+	void RemoveExpired()
+	{
+		while (Count > 0 && Instances[Head].IsExpired())
+		{
+			PopFront();
+		}
+	}
+
+	void Reset()
+	{
+		Head = 0;
+		Count = 0;
+	}
+
+private:
+
+	FORCEINLINE void PopFront()
+	{
+		Head = (Head + 1) & (Capacity - 1);
+		--Count;
+	}
+
+	FRecoilInstance Instances[Capacity];
+	int32 Head = 0;
+	int32 Count = 0;
+};
+
 UENUM(BlueprintType)
 enum class EAnimState : uint8
 {
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "TrueFPSWeaponAttachmentBase.h"
 #include "Weapons/Attachments/TrueFPSWeaponAttachmentPoint.h"
+#include "Weapons/TrueFPSWeaponBase.h"
 #include "TrueFPSSightsAttachment.generated.h"
 
 UCLASS(Abstract, Meta = (DisplayName = "Sights Attachment"))
@@ -56,7 +57,13 @@ public:
 	{
 		Super::OnRep_Attachment();
 		if (ATrueFPSSightsAttachment* Sights = Cast<ATrueFPSSightsAttachment>(Attachment))
+		{
 			Sights->AimOffset = AimOffset;
+
+			// The replicated sights selection may have arrived before this attachment did
+			if (ATrueFPSWeaponBase* OwningWeapon = Sights->GetOwningWeapon<ATrueFPSWeaponBase>())
+				OwningWeapon->RefreshTargetSightsRelativeTransform();
+		}
 	}
 
 protected:
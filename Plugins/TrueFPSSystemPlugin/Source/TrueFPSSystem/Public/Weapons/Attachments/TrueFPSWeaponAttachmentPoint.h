@@ -65,6 +65,12 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Meta = (AutoCreateRefTerm = "AttachmentClass", DeterminesOutputType = "AttachmentClass"), Category = "Attachment")
 	class ATrueFPSWeaponAttachmentBase* SpawnAttachment(const TSubclassOf<class ATrueFPSWeaponAttachmentBase>& AttachmentClass);
 
+	// Spawns the default attachment right away if none is set yet, cancelling the delayed spawn from BeginPlay.
+	void SpawnDefaultAttachment();
+
+	// Replaces the current attachment with the default one, unless it already is the default one.
+	void ResetToDefaultAttachment();
+
 	// Destroys the current attachment at this attachment point.
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Attachment")
 	void DestroyAttachment();
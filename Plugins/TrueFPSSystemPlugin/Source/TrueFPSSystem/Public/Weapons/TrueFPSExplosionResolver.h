@@ -0,0 +1,87 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Engine/EngineTypes.h"
+#include "GameFramework/DamageType.h"
+
+class AActor;
+class AController;
+class UPrimitiveComponent;
+struct FTraceDatum;
+
+/** inputs of a single explosion, matching UGameplayStatics::ApplyRadialDamage with linear falloff to zero */
+struct FTrueFPSExplosionParams
+{
+	/** damage origin */
+	FVector Origin{FVector::ZeroVector};
+
+	/** damage at the origin */
+	float BaseDamage{0.f};
+
+	/** radius of damage */
+	float Radius{0.f};
+
+	/** type of damage */
+	TSubclassOf<UDamageType> DamageType;
+
+	/** actor that exploded, never damaged itself. Required for asynchronous traces */
+	TWeakObjectPtr<AActor> DamageCauser;
+
+	/** controller credited with the damage */
+	TWeakObjectPtr<AController> InstigatedBy;
+
+	/** channel that blocks damage between the origin and a victim */
+	TEnumAsByte<ECollisionChannel> DamagePreventionChannel{ECC_Visibility};
+
+	/** occlusion traces done on the explosion frame, closest victims first. The rest are traced asynchronously and damaged next frame. Negative traces everything right away */
+	int32 SyncTraceBudget{-1};
+};
+
+/**
+ * Resolves radial damage with a single overlap query and one occlusion trace per damaged actor.
+ * Overlapping components are deduplicated per actor up front, keeping the one closest to the origin,
+ * so each victim gets exactly one component hit and its falloff is evaluated once.
+ */
+class TRUEFPSSYSTEM_API FTrueFPSExplosionResolver
+{
+public:
+
+	/** gathers victims and applies damage, deferring traces beyond the budget to the next frame */
+	void Resolve(UWorld* World, const FTrueFPSExplosionParams& InParams);
+
+	/** check if asynchronous traces of the last explosion are still in flight */
+	FORCEINLINE bool IsPending() const { return NumPendingTraces > 0; }
+
+private:
+
+	/** a damageable actor in range, with the overlapping component to trace against */
+	struct FVictim
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		float DistSquared;
+	};
+
+	FTrueFPSExplosionParams Params;
+
+	TArray<FVictim> Victims;
+
+	/** bumped on every Resolve, so late results of a previous explosion are dropped */
+	uint32 ResolveId{0};
+
+	int32 NumPendingTraces{0};
+
+	void GetTraceSegment(const FVictim& Victim, FVector& OutStart, FVector& OutEnd) const;
+
+	FCollisionQueryParams GetTraceParams() const;
+
+	/** turns a trace result into the component hit passed with the damage event, false if the victim is occluded */
+	bool ResolveVisibility(const FVictim& Victim, const FHitResult* BlockingHit, FHitResult& OutHit) const;
+
+	void ApplyDamage(const FVictim& Victim, const FHitResult& Hit) const;
+
+	void OnAsyncTraceDone(uint32 TraceResolveId, const FTraceDatum& TraceDatum);
+};
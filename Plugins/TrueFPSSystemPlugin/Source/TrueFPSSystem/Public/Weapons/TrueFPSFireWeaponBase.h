@@ -44,6 +44,9 @@ public:
 	/** perform initial setup */
 	virtual void PostInitializeComponents() override;
 
+	/** [server] stops reloading and refills ammo to its initial amount */
+	virtual void ResetForPool() override;
+
 	//////////////////////////////////////////////////////////////////////////
 	// Reading Data
 
@@ -65,7 +65,7 @@ public:
 
 	ATrueFPSMeleeWeaponBase(const FObjectInitializer& ObjectInitializer);
 
-	virtual void Tick(float DeltaSeconds) override;
+	virtual void TickAttached(float DeltaSeconds) override;
 
 	//////////////////////////////////////////////////////////////////////////
 	// Input
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Settings/TrueFPSFireWeaponProjectileSettings.h"
+#include "Weapons/TrueFPSExplosionResolver.h"
 #include "Weapons/TrueFPSFireWeaponProjectile.h"
 #include "TrueFPSProjectile.generated.h"
 
@@ -56,6 +57,9 @@ protected:
 	UPROPERTY()
 	UTrueFPSFireWeaponProjectileSettings* WeaponConfig;
 
+	/** applies the explosion's radial damage, possibly over two frames */
+	FTrueFPSExplosionResolver ExplosionResolver;
+
 	/** did it explode? */
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_Exploded)
 	bool bExploded;
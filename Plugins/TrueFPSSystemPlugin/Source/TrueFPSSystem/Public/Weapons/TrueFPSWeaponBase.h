@@ -16,6 +16,7 @@ class UParticleSystemComponent;
 class UForceFeedbackEffect;
 class USoundBase;
 class UCameraShakeBase;
+class ATrueFPSWeaponAttachmentBase;
 
 UCLASS(Abstract)
 class TRUEFPSSYSTEM_API ATrueFPSWeaponBase : public AActor
@@ -48,9 +49,22 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|MM Weapon", Transient, ReplicatedUsing = OnRep_BurstCounter)
 	int32 BurstCounter{0};
 
-	/** target sights relative transform */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|MM Weapon", Transient, Replicated)
+	/** sights selection, replicated to non-owners for the third-person aim pose */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_ReplicatedSights)
+	FTrueFPSReplicatedSights ReplicatedSights;
+
+	/** target sights relative transform, reconstructed locally from the current sights */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|MM Weapon", Transient)
 	FTransform TargetSightsRelativeTransform{FTransform::Identity};
+
+	/** ticked by the world's UTrueFPSTickManager rather than the actor tick */
+	bool bManagedTick{false};
+
+	/** a blueprint implements the tick event, so the actor ticks while not holstered */
+	bool bBlueprintTick{false};
+
+	/** in an inventory without being equipped, see SetHolstered */
+	bool bHolstered{false};
 	
 public:
 
@@ -58,7 +72,20 @@ public:
 
 	virtual void BeginPlay() override;
 
+	/** Ticks the weapon, unless the tick manager does, see TickAttached */
 	virtual void Tick(float DeltaTime) override;
+
+	/** unregister from the tick manager */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Game thread part of the tick: camera recoil and wall offset trace */
+	virtual void TickAttached(float DeltaTime);
+
+	/** Part of the tick that only touches the weapon's own state: recoil, sights and wall offset smoothing. Safe to run off the game thread */
+	void TickAttachedInterpolation(float DeltaTime);
+
+	/** Ticks the actor unless holstered with its recoil settled or ticked by the tick manager, or if a blueprint ticks */
+	void UpdateActorTickEnabled();
 	
 	/** perform initial setup */
 	virtual void PostInitializeComponents() override;
@@ -103,9 +130,39 @@ public:
 	/** check if it's currently equipped */
 	bool IsEquipped() const;
 
+	/**
+	 * Turns off the weapon's tick, its meshes' tick and collision, its attachments' tick and collision, and lowers its net update frequency.
+	 * The components stay registered so equipping again doesn't have to recreate their render and physics state.
+	 * Holstered weapons are hidden (their meshes are detached from the pawn) and have no collision on purpose: nothing is meant to see,
+	 * hit or trace against a weapon in an inventory. The actor tick only stops once the recoil settled, see IsRecoilSettling.
+	 */
+	void SetHolstered(bool bNewHolstered);
+
+	/** Applies the holstered state to an attachment's tick and collision, for the attachments spawned after holstering as well */
+	void RefreshAttachmentHolstered(ATrueFPSWeaponAttachmentBase* Attachment) const;
+
+	/** check if it's holstered in an inventory */
+	FORCEINLINE bool IsHolstered() const { return bHolstered; }
+
 	/** check if mesh is already attached */
 	bool IsAttachedToPawn() const;
 
+	/** check if the recoil or the camera recoil of the last shots is still playing out, the weapon keeps ticking until it settles */
+	bool IsRecoilSettling() const;
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// Pooling
+
+	/** [server] returns the weapon to a clean, unequipped state with its default attachments before it goes back into the weapon pool */
+	virtual void ResetForPool();
+
+	/** [server] wakes a pooled weapon up again before it's handed to a new owner */
+	virtual void Reinitialize();
+
+	/** [server] spawns the default attachment of every empty attachment point right away instead of waiting for their timers */
+	void SpawnDefaultAttachments();
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// Input
@@ -116,9 +173,12 @@ public:
 	/** [local + server] stop weapon fire */
 	virtual void StopFire();
 
-	/** [server] toggle between sights */
+	/** [local + server] toggle between sights */
 	virtual void ToggleSights();
 
+	/** recomputes the target sights transform, e.g. once the current sights attachment replicates */
+	void RefreshTargetSightsRelativeTransform();
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// Control
@@ -173,6 +233,9 @@ public:
 	void GetAttachmentsOfClass(TArray<class ATrueFPSWeaponAttachmentBase*>& OutAttachments, const TSubclassOf<class ATrueFPSWeaponAttachmentBase>& Class) const;
 
 	void GetAttachmentPoints(TArray<class UTrueFPSWeaponAttachmentPoint*>& OutAttachmentPoints) const;
+
+	/** sights attachments ordered by attachment point name, so indices match on every connection */
+	void GetSightsAttachments(TArray<class ATrueFPSSightsAttachment*>& OutSights) const;
 	
 	FORCEINLINE bool IsCloseToWall() const { return GetWallOffsetTransformAlpha() > 0.f; }
 
@@ -200,6 +263,9 @@ protected:
 	UFUNCTION()
 	void OnRep_BurstCounter();
 
+	UFUNCTION()
+	void OnRep_ReplicatedSights();
+
 	/** Called in network play to do the cosmetic fx for firing */
 	virtual void SimulateWeaponFire();
 
@@ -236,11 +302,16 @@ protected:
 	/** determine current weapon state */
 	virtual void DetermineWeaponState();
 
-	/** adds new recoil instance */
+	/** adds new recoil instance, sampled from the settings' baked recoil tables when it plays the settings' curves */
 	FORCEINLINE void AddRecoilInstance(const FRecoilParams& RecoilParams)
 	{
 		if (!RecoilParams.IsValid()) return;
-		State.CurrentRecoilInstance = FRecoilInstance(RecoilParams);
+
+		State.CurrentRecoilInstance = FRecoilInstance(RecoilParams, &Settings->GetBakedRecoil());
+		if (Settings->bStackRecoil)
+		{
+			State.RecoilInstances.Add(State.CurrentRecoilInstance);
+		}
 	}
 
 	/** handles recoil instances */
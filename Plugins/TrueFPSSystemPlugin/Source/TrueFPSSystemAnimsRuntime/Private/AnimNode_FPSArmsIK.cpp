@@ -61,6 +61,7 @@ void FAnimNode_FPSArmsIK::GatherDebugData(FNodeDebugData& DebugData)
 void FAnimNode_FPSArmsIK::Update_AnyThread(const FAnimationUpdateContext& Context)
 {
 	BasePose.Update(Context);
+	if(!IsLODEnabled(Context.AnimInstanceProxy)) return;
 	GetEvaluateGraphExposedInputs().Execute(Context);
 }
 
@@ -95,14 +96,73 @@ bool FAnimNode_FPSArmsIK::CanEvaluate() const
 	return true;		
 }
 
+// Both arms used to be solved at once in VectorRegisters. That was dropped: the two solves are a small part of Evaluate next to
+// the transform products around them, and the batched math reordered the solve so the arms no longer came out as AnimationCore
+// solves them. TrueFPS.Anim.ArmsIKEvaluate logs the ns per evaluate to measure against before batching it again.
+void FAnimNode_FPSArmsIK::SolveArmIK(FTransform& UpperArm, FTransform& LowerArm, FTransform& Hand, const FVector& JointTarget, const FTransform& Effector)
+{
+	AnimationCore::SolveTwoBoneIK(UpperArm, LowerArm, Hand, JointTarget, Effector.GetLocation(), false, 0.f, 0.f);
+	Hand.SetRotation(Effector.GetRotation());
+}
+
+void FAnimNode_FPSArmsIK::UpdateWeaponInvariants()
+{
+	if(WeaponInvariants.bValid)
+	{
+		if(WeaponChangeCounter != INDEX_NONE)
+		{
+			if(WeaponInvariants.WeaponChangeCounter == WeaponChangeCounter) return;
+		}
+		// Without a counter bound, compare the pins themselves
+		else if(WeaponInvariants.SightsRelativeTransform.Equals(SightsRelativeTransform, 0.f) && WeaponInvariants.CustomWeaponOffsetTransform.Equals(CustomWeaponOffsetTransform, 0.f))
+		{
+			return;
+		}
+	}
+
+	WeaponInvariants.WeaponChangeCounter = WeaponChangeCounter;
+	WeaponInvariants.SightsRelativeTransform = SightsRelativeTransform;
+	WeaponInvariants.CustomWeaponOffsetTransform = CustomWeaponOffsetTransform;
+
+	WeaponInvariants.SightsInverse = SightsRelativeTransform.Inverse();
+	WeaponInvariants.CustomWeaponOffsetInverse = CustomWeaponOffsetTransform.Inverse();
+	WeaponInvariants.bValid = true;
+}
+
+FVector FAnimNode_FPSArmsIK::GetJointLocation(const FTransform& JointTransform, const FTransform& JointInfluenceWeaponTransform, const FTransform& BaseWeaponTransform,
+	const FQuat& InitJointRotation, const FJointClampConfig& JointClamp) const
+{
+	// Removing the custom weapon offset from the weapon transform to get the original joint location without an offset
+	const FTransform JointTargetTransform = JointTransform * WeaponInvariants.CustomWeaponOffsetInverse * JointInfluenceWeaponTransform;
+
+	// Set to target location if no clamping is needed
+	if(!JointClamp.IsClamping() || FMath::IsNearlyZero(ArmsJointAlpha))
+		return JointTargetTransform.GetLocation();
+
+	// The joint transform without any additives applied
+	const FTransform JointNoAdditiveTransform = JointTransform * BaseWeaponTransform;
+
+	FTransform Offset = JointTargetTransform.GetRelativeTransform(JointNoAdditiveTransform);
+	FVector OrientationOffsetLocation = InitJointRotation.UnrotateVector(Offset.GetLocation());
+
+	// Clamp the orientation location offset between the ranges
+	ClampRange(OrientationOffsetLocation.Y, JointClamp.HorizontalRange);
+	ClampRange(OrientationOffsetLocation.Z, JointClamp.VerticalRange);
+	Offset.SetLocation(InitJointRotation.RotateVector(OrientationOffsetLocation));
+
+	// Set joint location by the clamped joint location blended by the target joint location
+	return (Offset * JointNoAdditiveTransform).GetLocation() * ArmsJointAlpha + JointTargetTransform.GetLocation() * (1.f - ArmsJointAlpha);
+}
+
 #define CS_TRANSFORM(Index) FAnimationRuntime::GetComponentSpaceTransform(RefSkel, BSBoneTransforms, Index)
 
 void FAnimNode_FPSArmsIK::Evaluate_AnyThread(FPoseContext& Output)
 {
 	BasePose.Evaluate(Output);
-	if(!CanEvaluate()) return;
+	if(!IsLODEnabled(Output.AnimInstanceProxy) || !CanEvaluate()) return;
 	
 	CameraRelativeRotation.Normalize();
+	UpdateWeaponInvariants();
 	
 	//
 	//	Cache initial transforms
@@ -112,53 +172,61 @@ void FAnimNode_FPSArmsIK::Evaluate_AnyThread(FPoseContext& Output)
 	const FReferenceSkeleton& RefSkel = RequiredBones.GetReferenceSkeleton();
 	TArray<FTransform>& BSBoneTransforms = *(TArray<FTransform>*)&Output.Pose.GetBones();
 
-	// Init arm transforms. Component-space.
-	const FTransform CSInitRightJointTransform = CS_TRANSFORM(RightLowerArmIndex);
-	const FTransform CSInitLeftJointTransform = CS_TRANSFORM(LeftLowerArmIndex);
-
-	const FTransform CSInitRightHandTransform = BSBoneTransforms[RightHand.BoneIndex] * CSInitRightJointTransform;
-	const FTransform CSInitLeftHandTransform = BSBoneTransforms[LeftHand.BoneIndex] * CSInitLeftJointTransform;
-	
-	const FTransform CSInitCameraTransform = FTransform(FRotator(0.f, MeshYawOffset, 0.f), (FTransform(CameraRelativeLocation) * CS_TRANSFORM(Head.BoneIndex)).GetLocation());
-	FTransform CSInitWeaponTransform = OriginRelativeTransform * (bRightHanded ? CSInitRightHandTransform : CSInitLeftHandTransform);// Weapon relative transform is bone-space off of primary hand
-
-	//
-	//	Post aim offset applied
-	//
+	// Arm transforms in component-space, built down from the upper arm parents. Nothing modifies the pose
+	// before the solve, so these are the initial arm transforms as well.
+	const FTransform CSRightUpperArmParentTransform = CS_TRANSFORM(CachedRightUpperArmParentBoneIndex);
+	const FTransform CSLeftUpperArmParentTransform = CS_TRANSFORM(CachedLeftUpperArmParentBoneIndex);
 
-	// Initialize arm transform vars
-	FTransform RightUpperArmTransform = CS_TRANSFORM(RightUpperArmIndex);
+	FTransform RightUpperArmTransform = BSBoneTransforms[RightUpperArmIndex] * CSRightUpperArmParentTransform;
 	FTransform RightLowerArmTransform = BSBoneTransforms[RightLowerArmIndex] * RightUpperArmTransform;
 	FTransform RightHandTransform = BSBoneTransforms[RightHand.BoneIndex] * RightLowerArmTransform;
 
-	FTransform LeftUpperArmTransform = CS_TRANSFORM(LeftUpperArmIndex);
+	FTransform LeftUpperArmTransform = BSBoneTransforms[LeftUpperArmIndex] * CSLeftUpperArmParentTransform;
 	FTransform LeftLowerArmTransform = BSBoneTransforms[LeftLowerArmIndex] * LeftUpperArmTransform;
 	FTransform LeftHandTransform = BSBoneTransforms[LeftHand.BoneIndex] * LeftLowerArmTransform;
 
+	const FTransform CSInitRightJointTransform = RightLowerArmTransform;
+	const FTransform CSInitLeftJointTransform = LeftLowerArmTransform;
+
+	const FTransform CSInitRightHandTransform = RightHandTransform;
+	const FTransform CSInitLeftHandTransform = LeftHandTransform;
+
+	const FVector CSCameraLocation = CS_TRANSFORM(Head.BoneIndex).TransformPosition(CameraRelativeLocation);
+	const FRotator MeshYawRotation(0.f, MeshYawOffset, 0.f);
+	const FTransform CSInitWeaponTransform = OriginRelativeTransform * (bRightHanded ? CSInitRightHandTransform : CSInitLeftHandTransform);// Weapon relative transform is bone-space off of primary hand
+
+	// Hands and joints relative to the initial weapon transform
+	const FTransform RightHandWeaponSpaceTransform = CSInitRightHandTransform.GetRelativeTransform(CSInitWeaponTransform);
+	const FTransform LeftHandWeaponSpaceTransform = CSInitLeftHandTransform.GetRelativeTransform(CSInitWeaponTransform);
+	const FTransform RightJointWeaponSpaceTransform = CSInitRightJointTransform.GetRelativeTransform(CSInitWeaponTransform);
+	const FTransform LeftJointWeaponSpaceTransform = CSInitLeftJointTransform.GetRelativeTransform(CSInitWeaponTransform);
+
 	//
 	//	Calculate weapon transform in component-space
 	//
 	
 	// Current component-space camera transform.
-	const FTransform& CSCameraTransform = FTransform(CameraRelativeRotation + FRotator(0.f, MeshYawOffset, 0.f), (FTransform(CameraRelativeLocation) * CS_TRANSFORM(Head.BoneIndex)).GetLocation());
+	const FTransform CSCameraTransform(CameraRelativeRotation + MeshYawRotation, CSCameraLocation);
 
-	// Camera transform to weapon transform with root offset and accumulative spine offset applied.
-	const FTransform& CameraToWeaponTransform = CSInitWeaponTransform.GetRelativeTransform(
-		FTransform(BSBoneTransforms[0].GetRotation()/* * AccumulativeOffsetInverse.Inverse()*/ * CSInitCameraTransform.GetRotation(), CSInitCameraTransform.GetLocation()));
+	// Camera transform to weapon transform with root offset applied.
+	const FTransform CameraToWeaponTransform = CSInitWeaponTransform.GetRelativeTransform(
+		FTransform(BSBoneTransforms[0].GetRotation() * MeshYawRotation.Quaternion(), CSCameraLocation));
 	
-	// Get current weapon transform by the camera offset
-	FTransform CSWeaponTransform = CameraToWeaponTransform * CSCameraTransform;
+	// Get current weapon transform by the camera offset, this is the weapon transform without additives
+	const FTransform CSBaseWeaponTransform = CameraToWeaponTransform * CSCameraTransform;
 	
 	// Get aiming and non-aiming transforms
-	const FTransform& AimingTransform = OriginRelativeTransform.GetRelativeTransform(SightsRelativeTransform) * CSCameraTransform;
-	
-	FTransform NonAimingTransform = CustomWeaponOffsetTransform * CSWeaponTransform;
+	FTransform NonAimingTransform = CustomWeaponOffsetTransform * CSBaseWeaponTransform;
 	NonAimingTransform.SetRotation(FQuat::FastLerp(CSInitWeaponTransform.GetRotation(), NonAimingTransform.GetRotation(), WeaponRotationAlpha));
 	NonAimingTransform.SetLocation(NonAimingTransform.GetLocation() * WeaponLocationAlpha + CSInitWeaponTransform.GetLocation() * (1.f - WeaponLocationAlpha));
 
-	CSWeaponTransform = NonAimingTransform;
+	FTransform CSWeaponTransform = NonAimingTransform;
 	CSWeaponTransform.NormalizeRotation();
-	CSWeaponTransform.BlendWith(AimingTransform, AimingValue);
+	if(FAnimWeight::IsRelevant(AimingValue))
+	{
+		const FTransform AimingTransform = OriginRelativeTransform * WeaponInvariants.SightsInverse * CSCameraTransform;
+		CSWeaponTransform.BlendWith(AimingTransform, AimingValue);
+	}
 	CSWeaponTransform = OffsetTransform * CSWeaponTransform;
 
 	// If arm pull-back is enabled...
@@ -170,12 +238,12 @@ void FAnimNode_FPSArmsIK::Evaluate_AnyThread(FPoseContext& Output)
 		float MaxReach;
 		if(bRightHanded)
 		{// Calculate the projected hand transform
-			ReachDist = (LeftUpperArmTransform.GetLocation() - (CSInitLeftHandTransform.GetRelativeTransform(CSInitWeaponTransform) * CSWeaponTransform).GetLocation()).Size();
+			ReachDist = (LeftUpperArmTransform.GetLocation() - CSWeaponTransform.TransformPosition(LeftHandWeaponSpaceTransform.GetLocation())).Size();
 			MaxReach = BSBoneTransforms[LeftLowerArmIndex].GetLocation().Size() + BSBoneTransforms[LeftHand.BoneIndex].GetLocation().Size();
 		}
 		else
 		{
-			ReachDist = (RightUpperArmTransform.GetLocation() - (CSInitRightHandTransform.GetRelativeTransform(CSInitWeaponTransform) * CSWeaponTransform).GetLocation()).Size();
+			ReachDist = (RightUpperArmTransform.GetLocation() - CSWeaponTransform.TransformPosition(RightHandWeaponSpaceTransform.GetLocation())).Size();
 			MaxReach = BSBoneTransforms[RightLowerArmIndex].GetLocation().Size() + BSBoneTransforms[RightHand.BoneIndex].GetLocation().Size();
 		}
 
@@ -196,108 +264,42 @@ void FAnimNode_FPSArmsIK::Evaluate_AnyThread(FPoseContext& Output)
 		JointInfluenceWeaponTransform.BlendWith(NonAimingTransform, 1.f - AimingJointInfluence);
 
 	//
-	// Right Arm IK
+	// Effectors and joint targets
 	//
 
-	// The new right hand transform in component-space
-	const FTransform& RightEffectorTransform = CSInitRightHandTransform.GetRelativeTransform(CSInitWeaponTransform) * (RightHandAdditiveTransform * CSWeaponTransform);
-
-	// Removing the custom weapon offset from the weapon transform to get the original joint location without an offset then applying whatever offset specified
-	/*const FVector& RightJointLocation = (CSInitRightJointTransform.GetRelativeTransform(CSInitWeaponTransform) *
-		FTransform(RightJointLocationOffset) * CustomWeaponOffsetTransform.Inverse() * (RightHandAdditiveTransform * JointInfluenceWeaponTransform)).GetLocation();*/
+	// The new hand transforms in component-space
+	const FTransform RightEffectorTransform = RightHandWeaponSpaceTransform * (RightHandAdditiveTransform * CSWeaponTransform);
+	const FTransform LeftEffectorTransform = LeftHandAdditiveTransform * (LeftHandWeaponSpaceTransform * CSWeaponTransform);
 
 	FTransform RightJointAdditiveTransform;
 	RightJointAdditiveTransform.BlendWith(RightHandAdditiveTransform, RightHandAdditiveJointInfluence);
 
-	// The target transform for the right joint in component-space
-	const FTransform RightJointTargetTransform = RightJointAdditiveTransform * CSInitRightJointTransform.GetRelativeTransform(CSInitWeaponTransform) *
-		FTransform(RightJointLocationOffset) * CustomWeaponOffsetTransform.Inverse() * JointInfluenceWeaponTransform;
-
-	// Right joint location in component-space
-	FVector RightJointLocation;
-	if(RightJointClamp.IsClamping() && !FMath::IsNearlyZero(ArmsJointAlpha))
-	{
-		// The joint transform without any additives applied
-		const FTransform JointNoAdditiveTransform = RightJointAdditiveTransform * CSInitRightJointTransform.GetRelativeTransform(CSInitWeaponTransform) *
-			FTransform(RightJointLocationOffset) * CameraToWeaponTransform * CSCameraTransform;// CameraToWeaponTransform * CSCameraTransform gets the weapon transform without additives
-
-		FTransform Offset = RightJointTargetTransform.GetRelativeTransform(JointNoAdditiveTransform);
-		const FQuat Orientation = CSInitRightJointTransform.GetRotation();
-		FVector OrientationOffsetLocation = Orientation.UnrotateVector(Offset.GetLocation());
-
-		// Clamp the orientation location offset between the ranges
-		ClampRange(OrientationOffsetLocation.Y, RightJointClamp.HorizontalRange);
-		ClampRange(OrientationOffsetLocation.Z, RightJointClamp.VerticalRange);
-		Offset.SetLocation(Orientation.RotateVector(OrientationOffsetLocation));
-		
-		// Set joint location by the clamped joint location blended by the target joint location
-		RightJointLocation = (Offset * JointNoAdditiveTransform).GetLocation() * ArmsJointAlpha + RightJointTargetTransform.GetLocation() * (1.f - ArmsJointAlpha);
-	}
-	else
-	{// Set to target location if no clamping is needed
-		RightJointLocation = RightJointTargetTransform.GetLocation();
-	}
-	
-	AnimationCore::SolveTwoBoneIK(RightUpperArmTransform, RightLowerArmTransform, RightHandTransform,
-		RightJointLocation, RightEffectorTransform.GetLocation(), false, 0.f, 0.f);
-
-	RightHandTransform.SetRotation(RightEffectorTransform.GetRotation());
-
-	//
-	// Left Arm IK
-	//
-
-	// The new left hand transform in component-space
-	const FTransform LeftEffectorTransform = LeftHandAdditiveTransform * (CSInitLeftHandTransform.GetRelativeTransform(CSInitWeaponTransform) * CSWeaponTransform);
-
 	FTransform LeftJointAdditiveTransform;
 	LeftJointAdditiveTransform.BlendWith(LeftHandAdditiveTransform, LeftHandAdditiveJointInfluence);
 
-	// Target transform for the left joint in component-space
-	const FTransform LeftJointTargetTransform = LeftJointAdditiveTransform * CSInitLeftJointTransform.GetRelativeTransform(CSInitWeaponTransform) *
-			FTransform(LeftJointLocationOffset) * CustomWeaponOffsetTransform.Inverse() * JointInfluenceWeaponTransform;
-
-	// Left joint location in component-space
-	FVector LeftJointLocation;
-	if(LeftJointClamp.IsClamping() && !FMath::IsNearlyZero(ArmsJointAlpha))
-	{
-		// The joint transform without any additives applied
-		const FTransform JointNoAdditiveTransform = LeftJointAdditiveTransform * CSInitLeftJointTransform.GetRelativeTransform(CSInitWeaponTransform) *
-			FTransform(LeftJointLocationOffset) * CameraToWeaponTransform * CSCameraTransform;// CameraToWeaponTransform * CSCameraTransform gets the weapon transform without additives
-
-		FTransform Offset = LeftJointTargetTransform.GetRelativeTransform(JointNoAdditiveTransform);
-		const FQuat Orientation = CSInitLeftJointTransform.GetRotation();
-		FVector OrientationOffsetLocation = Orientation.UnrotateVector(Offset.GetLocation());
-
-		// Clamp the orientation location offset between the ranges
-		ClampRange(OrientationOffsetLocation.Y, LeftJointClamp.HorizontalRange);
-		ClampRange(OrientationOffsetLocation.Z, LeftJointClamp.VerticalRange);
-		Offset.SetLocation(Orientation.RotateVector(OrientationOffsetLocation));
+	// Joints in weapon-space with the additive and offset applied
+	const FTransform RightJointTransform = RightJointAdditiveTransform * RightJointWeaponSpaceTransform * FTransform(RightJointLocationOffset);
+	const FTransform LeftJointTransform = LeftJointAdditiveTransform * LeftJointWeaponSpaceTransform * FTransform(LeftJointLocationOffset);
 
-		// Set joint location by the clamped joint location blended by the target joint location
-		LeftJointLocation = (Offset * JointNoAdditiveTransform).GetLocation() * ArmsJointAlpha + LeftJointTargetTransform.GetLocation() * (1.f - ArmsJointAlpha);
-	}
-	else
-	{// Set to target location if no clamping is needed
-		LeftJointLocation = LeftJointTargetTransform.GetLocation();
-	}
-	
-	
-	AnimationCore::SolveTwoBoneIK(LeftUpperArmTransform, LeftLowerArmTransform, LeftHandTransform,
-		LeftJointLocation, LeftEffectorTransform.GetLocation(), false, 0.f, 0.f);
+	//
+	// Arms IK
+	//
 
-	LeftHandTransform.SetRotation(LeftEffectorTransform.GetRotation());
+	SolveArmIK(RightUpperArmTransform, RightLowerArmTransform, RightHandTransform,
+		GetJointLocation(RightJointTransform, JointInfluenceWeaponTransform, CSBaseWeaponTransform, CSInitRightJointTransform.GetRotation(), RightJointClamp), RightEffectorTransform);
+	SolveArmIK(LeftUpperArmTransform, LeftLowerArmTransform, LeftHandTransform,
+		GetJointLocation(LeftJointTransform, JointInfluenceWeaponTransform, CSBaseWeaponTransform, CSInitLeftJointTransform.GetRotation(), LeftJointClamp), LeftEffectorTransform);
 	
 	//
 	// Apply IKs
 	//
 
 	const float TotalArmsAlpha = Alpha * ArmsAlpha;
-	BSBoneTransforms[RightUpperArmIndex].BlendWith(RightUpperArmTransform.GetRelativeTransform(CS_TRANSFORM(CachedRightUpperArmParentBoneIndex)), TotalArmsAlpha);
+	BSBoneTransforms[RightUpperArmIndex].BlendWith(RightUpperArmTransform.GetRelativeTransform(CSRightUpperArmParentTransform), TotalArmsAlpha);
 	BSBoneTransforms[RightLowerArmIndex].BlendWith(RightLowerArmTransform.GetRelativeTransform(RightUpperArmTransform), TotalArmsAlpha);
 	BSBoneTransforms[RightHand.BoneIndex].BlendWith(RightHandTransform.GetRelativeTransform(RightLowerArmTransform), TotalArmsAlpha);
 
-	BSBoneTransforms[LeftUpperArmIndex].BlendWith(LeftUpperArmTransform.GetRelativeTransform(CS_TRANSFORM(CachedLeftUpperArmParentBoneIndex)), TotalArmsAlpha);
+	BSBoneTransforms[LeftUpperArmIndex].BlendWith(LeftUpperArmTransform.GetRelativeTransform(CSLeftUpperArmParentTransform), TotalArmsAlpha);
 	BSBoneTransforms[LeftLowerArmIndex].BlendWith(LeftLowerArmTransform.GetRelativeTransform(LeftUpperArmTransform), TotalArmsAlpha);
 	BSBoneTransforms[LeftHand.BoneIndex].BlendWith(LeftHandTransform.GetRelativeTransform(LeftLowerArmTransform), TotalArmsAlpha);
 }
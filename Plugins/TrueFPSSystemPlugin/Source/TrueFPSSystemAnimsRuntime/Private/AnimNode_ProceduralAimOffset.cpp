@@ -49,10 +49,28 @@ void FAnimNode_ProceduralAimOffset::GatherDebugData(FNodeDebugData& DebugData)
 
 void FAnimNode_ProceduralAimOffset::Update_AnyThread(const FAnimationUpdateContext& Context)
 {
+	BasePose.Update(Context);
+	if(!IsLODEnabled(Context.AnimInstanceProxy)) return;
+
 	// Set vars
 	GetEvaluateGraphExposedInputs().Execute(Context);
-	BasePose.Update(Context);
-	ReferencePose.Update(Context);
+	if(!bCacheReferencePose || !ReferencePoseCache.IsValidFor(Context.AnimInstanceProxy->GetRequiredBones()))
+		ReferencePose.Update(Context);
+}
+
+void FReferencePoseCache::Build(FPoseLink& ReferencePose, const FPoseContext& Output, TConstArrayView<FCompactPoseBoneIndex> InBones)
+{
+	FPoseContext ReferencePoseContext(Output.AnimInstanceProxy);
+	ReferencePose.Evaluate(ReferencePoseContext);
+
+	Bones.Reset();
+	Bones.Append(InBones.GetData(), InBones.Num());
+
+	CSTransforms.Reset();
+	for(const FCompactPoseBoneIndex Bone : Bones)
+		CSTransforms.Add(WSAnimUtils::GetCSTransform(ReferencePoseContext.Pose, Bone));
+
+	SerialNumber = Output.Pose.GetBoneContainer().GetSerialNumber();
 }
 
 FQuat FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(const int32 BoneIndex, const FCompactPose& BasePose, const FCompactPose& StablePose)
@@ -60,8 +78,12 @@ FQuat FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(const int32 Bo
 	//FQuat AccumulativeOffsetInverse = FAnimationRuntime::GetComponentSpaceTransform(ReferenceSkeleton, ReferenceBoneTransforms, BoneIndex).GetRotation() *
 	//	FAnimationRuntime::GetComponentSpaceTransform(ReferenceSkeleton, CurrentBoneTransforms, BoneIndex).GetRotation().Inverse() * CurrentBoneTransforms[0].GetRotation();
 	const FCompactPoseBoneIndex CompactBoneIndex = WSAnimUtils::SkeletonIndexToCompactPoseIndex(BasePose.GetBoneContainer(), FSkeletonPoseBoneIndex(BoneIndex));
-	FQuat AccumulativeOffsetInverse = WSAnimUtils::GetCSTransform(StablePose, CompactBoneIndex).GetRotation() *
-		WSAnimUtils::GetCSTransform(BasePose, CompactBoneIndex).GetRotation().Inverse() * BasePose.GetBones()[0].GetRotation();
+	return GetAccumulativeOffsetInverse(CompactBoneIndex, BasePose, WSAnimUtils::GetCSTransform(StablePose, CompactBoneIndex).GetRotation());
+}
+
+FQuat FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(const FCompactPoseBoneIndex BoneIndex, const FCompactPose& BasePose, const FQuat& StableCSRotation)
+{
+	FQuat AccumulativeOffsetInverse = StableCSRotation * WSAnimUtils::GetCSTransform(BasePose, BoneIndex).GetRotation().Inverse() * BasePose.GetBones()[0].GetRotation();
 	
 	// Reverse twisting if exceeds 180 degrees
 	if(abs(AccumulativeOffsetInverse.GetAngle()) > PI)
@@ -74,7 +96,7 @@ FQuat FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(const int32 Bo
 void FAnimNode_ProceduralAimOffset::Evaluate_AnyThread(FPoseContext& Output)
 {
 	BasePose.Evaluate(Output);
-	if(FMath::IsNearlyZero(Alpha) || !bIsValidBoneNames) return;
+	if(FMath::IsNearlyZero(Alpha) || !bIsValidBoneNames || !IsLODEnabled(Output.AnimInstanceProxy)) return;
 	
 	/*FCompactPose OutRefPose(Output.Pose);
 	FBlendedCurve OutRefCurve;
@@ -91,11 +113,12 @@ void FAnimNode_ProceduralAimOffset::Evaluate_AnyThread(FPoseContext& Output)
 		OutRefData.GetPose().ResetToRefPose();
 	}*/
 
-	FPoseContext StablePoseContext(Output.AnimInstanceProxy);
-	ReferencePose.Evaluate(StablePoseContext);
-	const TArray<FTransform>& RefBoneTransforms = reinterpret_cast<const TArray<FTransform>&>(StablePoseContext.Pose.GetBones());
+	// The accumulative spine offset is taken from the last index of the spine params
+	const FCompactPoseBoneIndex LastSpineIndex = WSAnimUtils::SkeletonIndexToCompactPoseIndex(Output.Pose.GetBoneContainer(), FSkeletonPoseBoneIndex(SpineBoneParams.Last().Bone.BoneIndex));
+	if(!bCacheReferencePose || !ReferencePoseCache.IsValidFor(Output.Pose.GetBoneContainer()))
+		ReferencePoseCache.Build(ReferencePose, Output, MakeArrayView(&LastSpineIndex, 1));
 	
-	const FReferenceSkeleton& RefSkel = Output.AnimInstanceProxy->GetSkeleton()->GetReferenceSkeleton();
+	const FReferenceSkeleton& RefSkel = Output.Pose.GetBoneContainer().GetReferenceSkeleton();
 	//const TArray<FTransform>& RefBoneTransforms = (TArray<FTransform>&)OutRefData.GetPose().GetBones();
 	const TArray<FTransform>& CurrBoneTransforms = (TArray<FTransform>&)Output.Pose.GetBones();
 
@@ -108,7 +131,7 @@ void FAnimNode_ProceduralAimOffset::Evaluate_AnyThread(FPoseContext& Output)
 	if(abs(AccumulativeOffsetInverse.GetAngle()) > PI)
 		AccumulativeOffsetInverse *= FQuat(AccumulativeOffsetInverse.Vector(), -2 * PI);*/
 
-	const FQuat& AccumulativeOffsetInverse = GetAccumulativeOffsetInverse(SpineBoneParams[SpineBoneParams.Num() - 1].Bone.BoneIndex, Output.Pose, StablePoseContext.Pose);
+	const FQuat AccumulativeOffsetInverse = GetAccumulativeOffsetInverse(LastSpineIndex, Output.Pose, ReferencePoseCache.CSTransforms[0].GetRotation());
 
 	// Cache spine offset inverses to be applied later so that
 	// the references to not get modified in the process of application
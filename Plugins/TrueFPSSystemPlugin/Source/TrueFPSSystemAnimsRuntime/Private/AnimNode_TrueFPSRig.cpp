@@ -8,6 +8,56 @@
 #include "Animation/AnimInstanceProxy.h"
 #include "AnimationCore/Public/TwoBoneIK.h"
 #include "BoneControllers/AnimNode_TwoBoneIK.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/ObjectKey.h"
+#include <atomic>
+
+namespace TrueFPSRig
+{
+	// Meshes a binding error was already logged for. CacheBones runs again on every LOD change
+	// and every instance of the mesh, a misconfigured mesh is only reported once until it binds again.
+	static TSet<FObjectKey> ReportedMeshes;
+	static FCriticalSection ReportedMeshesCS;
+
+	// ReportedMeshes.Num(), readable without the lock so meshes binding fine never take it
+	static std::atomic<int32> NumReportedMeshes{0};
+
+	// Forgets the meshes unloaded since, so the set doesn't keep every mesh that ever failed. Needs the lock
+	static void PruneReportedMeshes()
+	{
+		for(auto It = ReportedMeshes.CreateIterator(); It; ++It)
+		{
+			if(!It->ResolveObjectPtr()) It.RemoveCurrent();
+		}
+	}
+
+	static void ReportBindingError(const FBoneContainer& RequiredBones, const FString& Error)
+	{
+		const UObject* Mesh = RequiredBones.GetAsset();
+		{
+			FScopeLock Lock(&ReportedMeshesCS);
+			PruneReportedMeshes();
+
+			bool bAlreadyReported = false;
+			ReportedMeshes.Add(FObjectKey(Mesh), &bAlreadyReported);
+			NumReportedMeshes.store(ReportedMeshes.Num(), std::memory_order_relaxed);
+			if(bAlreadyReported) return;
+		}
+
+		UE_LOG(LogTemp, Error, TEXT("True FPS Rig: %s on %s, the rig will be bypassed"), *Error, *GetNameSafe(Mesh));
+	}
+
+	// A mesh fixed and reimported binds again, report it anew if it breaks later on
+	static void ClearBindingError(const FBoneContainer& RequiredBones)
+	{
+		if(NumReportedMeshes.load(std::memory_order_relaxed) == 0) return;
+
+		FScopeLock Lock(&ReportedMeshesCS);
+		ReportedMeshes.Remove(FObjectKey(RequiredBones.GetAsset()));
+		PruneReportedMeshes();
+		NumReportedMeshes.store(ReportedMeshes.Num(), std::memory_order_relaxed);
+	}
+}
 
 FAnimNode_TrueFPSRig::FAnimNode_TrueFPSRig()
 {
@@ -26,6 +76,12 @@ void FAnimNode_TrueFPSRig::Initialize_AnyThread(const FAnimationInitializeContex
 {
 	BasePose.Initialize(Context);
 	ReferencePose.Initialize(Context);
+}
+
+void FAnimNode_TrueFPSRig::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
+{
+	BasePose.CacheBones(Context);
+	ReferencePose.CacheBones(Context);
 
 	const FBoneContainer& RequiredBones = Context.AnimInstanceProxy->GetRequiredBones();
 	RightHand.Initialize(RequiredBones);
@@ -36,112 +92,117 @@ void FAnimNode_TrueFPSRig::Initialize_AnyThread(const FAnimationInitializeContex
 	for(FBoneParams& Bone : SpineBoneParams)
 		Bone.Bone.Initialize(RequiredBones);
 
-	const FReferenceSkeleton& RefSkel = RequiredBones.GetReferenceSkeleton();
-	
-	if(!RightHand.IsValidToEvaluate() || !LeftHand.IsValidToEvaluate()) return;
-	RightLowerArmIndex = RefSkel.GetParentIndex(RightHand.BoneIndex);
-	if(RightLowerArmIndex != INDEX_NONE) RightUpperArmIndex = RefSkel.GetParentIndex(RightLowerArmIndex);
-
-	LeftLowerArmIndex = RefSkel.GetParentIndex(LeftHand.BoneIndex);
-	if(LeftLowerArmIndex != INDEX_NONE) LeftUpperArmIndex = RefSkel.GetParentIndex(LeftLowerArmIndex);
-
-	if(RightUpperArmIndex != INDEX_NONE) CachedRightUpperArmParentBoneIndex = RefSkel.GetParentIndex(RightUpperArmIndex);
-	if(LeftUpperArmIndex != INDEX_NONE) CachedLeftUpperArmParentBoneIndex = RefSkel.GetParentIndex(LeftUpperArmIndex);
+	FString Error;
+	Binding = BindBones(RequiredBones, Error);
+	if(Binding.bValid)
+	{
+		TrueFPSRig::ClearBindingError(RequiredBones);
+	}
+	else
+	{
+		TrueFPSRig::ReportBindingError(RequiredBones, Error);
+	}
 }
 
-void FAnimNode_TrueFPSRig::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
+FTrueFPSRigBoneBinding FAnimNode_TrueFPSRig::BindBones(const FBoneContainer& RequiredBones, FString& OutError) const
 {
-	BasePose.CacheBones(Context);
-	ReferencePose.CacheBones(Context);
-}
+	FTrueFPSRigBoneBinding NewBinding;
 
-void FAnimNode_TrueFPSRig::GatherDebugData(FNodeDebugData& DebugData)
-{
-	BasePose.GatherDebugData(DebugData);
-	ReferencePose.GatherDebugData(DebugData);
-}
+	if(!RightHand.IsValidToEvaluate(RequiredBones) || !LeftHand.IsValidToEvaluate(RequiredBones) || !Head.IsValidToEvaluate(RequiredBones))
+	{
+		OutError = TEXT("Hand and head bones are not valid");
+		return NewBinding;
+	}
 
+	NewBinding.RightHand = RightHand.GetCompactPoseIndex(RequiredBones);
+	NewBinding.LeftHand = LeftHand.GetCompactPoseIndex(RequiredBones);
+	NewBinding.Head = Head.GetCompactPoseIndex(RequiredBones);
+	NewBinding.StableBone = StableBone.GetCompactPoseIndex(RequiredBones);
 
-void FAnimNode_TrueFPSRig::Update_AnyThread(const FAnimationUpdateContext& Context)
-{
-	BasePose.Update(Context);
-	ReferencePose.Update(Context);
-	GetEvaluateGraphExposedInputs().Execute(Context);
-}
+	// The arm bones are the parents of the hands
+	NewBinding.RightLowerArm = RequiredBones.GetParentBoneIndex(NewBinding.RightHand);
+	if(NewBinding.RightLowerArm.IsValid()) NewBinding.RightUpperArm = RequiredBones.GetParentBoneIndex(NewBinding.RightLowerArm);
 
+	NewBinding.LeftLowerArm = RequiredBones.GetParentBoneIndex(NewBinding.LeftHand);
+	if(NewBinding.LeftLowerArm.IsValid()) NewBinding.LeftUpperArm = RequiredBones.GetParentBoneIndex(NewBinding.LeftLowerArm);
 
-bool FAnimNode_TrueFPSRig::CanEvaluate() const
-{
-	if(!FAnimWeight::IsRelevant(Alpha))
-		return false;
-	
-	if(!RightHand.IsValidToEvaluate() || !LeftHand.IsValidToEvaluate() || RightLowerArmIndex == INDEX_NONE || LeftLowerArmIndex == INDEX_NONE ||
-		RightUpperArmIndex == INDEX_NONE || LeftUpperArmIndex == INDEX_NONE)
+	if(!NewBinding.RightLowerArm.IsValid() || !NewBinding.RightUpperArm.IsValid() || !NewBinding.LeftLowerArm.IsValid() || !NewBinding.LeftUpperArm.IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("True FPS Rig: Not all arm bones are valid"));
-		return false;
+		OutError = TEXT("Not all arm bones are valid");
+		return NewBinding;
 	}
 
-	if(CachedRightUpperArmParentBoneIndex == INDEX_NONE)
+	NewBinding.RightUpperArmParent = RequiredBones.GetParentBoneIndex(NewBinding.RightUpperArm);
+	if(!NewBinding.RightUpperArmParent.IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("True FPS Rig: Right Upper Arm does not have valid parent bone"));
-		return false;
+		OutError = TEXT("Right Upper Arm does not have valid parent bone");
+		return NewBinding;
 	}
 
-	if(CachedLeftUpperArmParentBoneIndex == INDEX_NONE)
+	NewBinding.LeftUpperArmParent = RequiredBones.GetParentBoneIndex(NewBinding.LeftUpperArm);
+	if(!NewBinding.LeftUpperArmParent.IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("True FPS Righ: Left Upper Arm does not have valid parent bone"));
-		return false;
+		OutError = TEXT("Left Upper Arm does not have valid parent bone");
+		return NewBinding;
 	}
 
+	NewBinding.Spine.Reserve(SpineBoneParams.Num());
 	for(const FBoneParams& BoneParam : SpineBoneParams)
 	{
-		if(!BoneParam.Bone.IsValidToEvaluate())
+		if(!BoneParam.Bone.IsValidToEvaluate(RequiredBones))
 		{
-			UE_LOG(LogTemp, Error, TEXT("True FPS Rig: Spine parameter %s is not valid"), *BoneParam.Bone.BoneName.ToString());
-			return false;
+			OutError = FString::Printf(TEXT("Spine parameter %s is not valid"), *BoneParam.Bone.BoneName.ToString());
+			return NewBinding;
 		}
+		NewBinding.Spine.Add(BoneParam.Bone.GetCompactPoseIndex(RequiredBones));
 	}
-			
-	return true;
-}
 
-#define CS_TRANSFORM(BoneIndex) GetCSTransform(Output.Pose, BoneIndex)
+	NewBinding.bValid = true;
+	return NewBinding;
+}
 
-void FAnimNode_TrueFPSRig::Evaluate_AnyThread(FPoseContext& Output)
+void FAnimNode_TrueFPSRig::GatherDebugData(FNodeDebugData& DebugData)
 {
-	BasePose.Evaluate(Output);
-	if(!CanEvaluate()) return;
+	BasePose.GatherDebugData(DebugData);
+	ReferencePose.GatherDebugData(DebugData);
+}
+
 
-#define CHECK_VALID_BONE(BoneIndex) if(BoneIndex == INDEX_NONE) { UE_LOG(LogTemp, Error, TEXT("Bone Index %s is invalid"), *FString(#BoneIndex)); return; }
+void FAnimNode_TrueFPSRig::Update_AnyThread(const FAnimationUpdateContext& Context)
+{
+	BasePose.Update(Context);
+	if(!IsLODEnabled(Context.AnimInstanceProxy)) return;
+	if(!bCacheReferencePose || !ReferencePoseCache.IsValidFor(Context.AnimInstanceProxy->GetRequiredBones()))
+		ReferencePose.Update(Context);
+	GetEvaluateGraphExposedInputs().Execute(Context);
+}
 
-	const FBoneContainer& BoneContainer = Output.Pose.GetBoneContainer();
 
-	const int32 RightUpperArmPoseIndex = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(RightUpperArmIndex)).GetInt();
-	const int32 RightLowerArmPoseIndex = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(RightLowerArmIndex)).GetInt();
-	const int32 RightHandPoseIndex = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(RightHand.BoneIndex)).GetInt();
+bool FAnimNode_TrueFPSRig::CanEvaluate() const
+{
+	// Bones were validated in CacheBones
+	return Binding.bValid && FAnimWeight::IsRelevant(Alpha);
+}
 
-	const int32 LeftUpperArmPoseIndex = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(LeftUpperArmIndex)).GetInt();
-	const int32 LeftLowerArmPoseIndex = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(LeftLowerArmIndex)).GetInt();
-	const int32 LeftHandPoseIndex = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(LeftHand.BoneIndex)).GetInt();
+#define CS_TRANSFORM(BoneIndex) GetCSTransform(Output.Pose, BoneIndex)
 
-	const int32 HeadPoseIndex = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(Head.BoneIndex)).GetInt();
+void FAnimNode_TrueFPSRig::Evaluate_AnyThread(FPoseContext& Output)
+{
+	BasePose.Evaluate(Output);
+	if(!IsLODEnabled(Output.AnimInstanceProxy) || !CanEvaluate()) return;
 
-	CHECK_VALID_BONE(RightUpperArmPoseIndex);
-	CHECK_VALID_BONE(RightLowerArmPoseIndex);
-	CHECK_VALID_BONE(RightHandPoseIndex);
-	CHECK_VALID_BONE(LeftUpperArmPoseIndex);
-	CHECK_VALID_BONE(LeftLowerArmPoseIndex);
-	CHECK_VALID_BONE(LeftHandPoseIndex);
-	CHECK_VALID_BONE(HeadPoseIndex);
+	const int32 RightUpperArmPoseIndex = Binding.RightUpperArm.GetInt();
+	const int32 RightLowerArmPoseIndex = Binding.RightLowerArm.GetInt();
+	const int32 RightHandPoseIndex = Binding.RightHand.GetInt();
 
-	const int32 RightUpperArmParentPoseIndex = BoneContainer.GetCompactPoseParentBoneArray()[RightUpperArmPoseIndex].GetInt();
-	const int32 LeftUpperArmParentPoseIndex = BoneContainer.GetCompactPoseParentBoneArray()[LeftUpperArmPoseIndex].GetInt();
+	const int32 LeftUpperArmPoseIndex = Binding.LeftUpperArm.GetInt();
+	const int32 LeftLowerArmPoseIndex = Binding.LeftLowerArm.GetInt();
+	const int32 LeftHandPoseIndex = Binding.LeftHand.GetInt();
 
-	CHECK_VALID_BONE(RightUpperArmParentPoseIndex);
-	CHECK_VALID_BONE(LeftUpperArmParentPoseIndex);
+	const int32 HeadPoseIndex = Binding.Head.GetInt();
 
-#undef CHECK_VALID_BONE
+	const int32 RightUpperArmParentPoseIndex = Binding.RightUpperArmParent.GetInt();
+	const int32 LeftUpperArmParentPoseIndex = Binding.LeftUpperArmParent.GetInt();
 
 #define RightLowerArmIndex RightLowerArmPoseIndex
 #define RightUpperArmIndex RightUpperArmPoseIndex
@@ -153,7 +214,8 @@ void FAnimNode_TrueFPSRig::Evaluate_AnyThread(FPoseContext& Output)
 	
 	CameraRelativeRotation.Normalize();
 
-	if(FMath::IsNearlyZero(ArmsAlpha) && !SpineBoneParams.IsEmpty())
+	const bool bArmsLODEnabled = ArmsLODThreshold == INDEX_NONE || Output.AnimInstanceProxy->GetLODLevel() <= ArmsLODThreshold;
+	if((FMath::IsNearlyZero(ArmsAlpha) || !bArmsLODEnabled) && !SpineBoneParams.IsEmpty())
 	{
 		FQuat Temp;
 		ProceduralAimOffset(Output, Temp);
@@ -170,7 +232,7 @@ void FAnimNode_TrueFPSRig::Evaluate_AnyThread(FPoseContext& Output)
 	// Apply Aiming Head Rotation Offset
 	const FTransform HeadTransform = BSBoneTransforms[HeadPoseIndex];
 	const FTransform HeadOffset = FTransform(AimingHeadRotationOffset, FVector::ZeroVector);
-	Output.Pose[FCompactPoseBoneIndex(Head.BoneIndex)].BlendWith(HeadTransform.GetRelativeTransform(HeadOffset), AimingValue);
+	Output.Pose[Binding.Head].BlendWith(HeadTransform.GetRelativeTransform(HeadOffset), AimingValue);
 
 	// Init arm transforms. Component-space.
 	const FTransform CSInitRightJointTransform = CS_TRANSFORM(RightLowerArmIndex);
@@ -190,11 +252,7 @@ void FAnimNode_TrueFPSRig::Evaluate_AnyThread(FPoseContext& Output)
 	}
 	else
 	{
-		FPoseContext StablePose(Output.AnimInstanceProxy);
-		ReferencePose.Evaluate(StablePose);
-		//AccumulativeOffsetInverse = FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(StableBone.BoneIndex, BoneContainer.GetReferenceSkeleton(),
-		//	BSBoneTransforms, *reinterpret_cast<const TArray<FTransform>*>(&RefPose.Pose.GetBones()));
-		AccumulativeOffsetInverse = FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(StableBone.BoneIndex, Output.Pose, StablePose.Pose);
+		AccumulativeOffsetInverse = GetStableAccumulativeOffsetInverse(Output);
 	}
 
 	//
@@ -394,16 +452,9 @@ void FAnimNode_TrueFPSRig::ProceduralAimOffset(FPoseContext& Output, FQuat& Accu
 {
 	if(FMath::IsNearlyZero(SpineAlpha)) return;
 
-	FPoseContext StablePose(Output.AnimInstanceProxy);
-	ReferencePose.Evaluate(StablePose);
-
-	const FBoneContainer& BoneContainer = Output.Pose.GetBoneContainer();
-	const FReferenceSkeleton& RefSkel = Output.AnimInstanceProxy->GetSkeleton()->GetReferenceSkeleton();
-	const TArray<FTransform>& RefBoneTransforms = *reinterpret_cast<const TArray<FTransform>*>(&StablePose.Pose.GetBones());
 	const TArray<FTransform>& CurrBoneTransforms = (TArray<FTransform>&)Output.Pose.GetBones();
 	
-	//AccumulativeOffsetInverse = FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(StableBone.BoneIndex, RefSkel, CurrBoneTransforms, RefBoneTransforms);
-	AccumulativeOffsetInverse = FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(StableBone.BoneIndex, Output.Pose, StablePose.Pose);
+	AccumulativeOffsetInverse = GetStableAccumulativeOffsetInverse(Output);
 
 	// Reverse twisting if exceeds 180 degrees
 	if(abs(AccumulativeOffsetInverse.GetAngle()) > PI)
@@ -413,9 +464,9 @@ void FAnimNode_TrueFPSRig::ProceduralAimOffset(FPoseContext& Output, FQuat& Accu
 	// the references to not get modified in the process of application
 	TArray<FQuat, TInlineAllocator<12>> SpineOffsetInverses;
 	SpineOffsetInverses.Reserve(SpineBoneParams.Num());
-	for(const FBoneParams& BoneParams : SpineBoneParams)
+	for(const FCompactPoseBoneIndex SpineIndex : Binding.Spine)
 	{
-		const int32 i = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(BoneParams.Bone.BoneIndex)).GetInt();
+		const int32 i = SpineIndex.GetInt();
 		FQuat OffsetInverse = CurrBoneTransforms[i].GetRotation() * (CS_TRANSFORM(i).GetRotation().Inverse() * CurrBoneTransforms[0].GetRotation());
 		SpineOffsetInverses.Add(MoveTemp(OffsetInverse));
 	}
@@ -438,8 +489,7 @@ void FAnimNode_TrueFPSRig::ProceduralAimOffset(FPoseContext& Output, FQuat& Accu
 	// For each bone
 	for(int32 i = 0; i < SpineBoneParams.Num(); i++)
 	{// Reference to current spine bone transform to modify
-		const FCompactPoseBoneIndex SpineIndex = BoneContainer.GetCompactPoseIndexFromSkeletonPoseIndex(FSkeletonPoseBoneIndex(SpineBoneParams[i].Bone.BoneIndex));
-		FTransform& SpineTransform = Output.Pose[SpineIndex];
+		FTransform& SpineTransform = Output.Pose[Binding.Spine[i]];
 		
 		// Convert the camera rotation to axis and angle to modify axis of rotation
 		FVector Axis; float Angle;
@@ -458,4 +508,12 @@ void FAnimNode_TrueFPSRig::ProceduralAimOffset(FPoseContext& Output, FQuat& Accu
 	}
 }
 
+FQuat FAnimNode_TrueFPSRig::GetStableAccumulativeOffsetInverse(const FPoseContext& Output)
+{
+	if(!bCacheReferencePose || !ReferencePoseCache.IsValidFor(Output.Pose.GetBoneContainer()))
+		ReferencePoseCache.Build(ReferencePose, Output, MakeArrayView(&Binding.StableBone, 1));
+
+	return FAnimNode_ProceduralAimOffset::GetAccumulativeOffsetInverse(Binding.StableBone, Output.Pose, ReferencePoseCache.CSTransforms[0].GetRotation());
+}
+
 #undef CS_TRANSFORM
\ No newline at end of file
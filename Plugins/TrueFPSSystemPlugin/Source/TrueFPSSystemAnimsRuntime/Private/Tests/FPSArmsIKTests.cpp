@@ -0,0 +1,338 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestSkeleton.h"
+#include "AnimNode_FPSArmsIK.h"
+#include "AnimationRuntime.h"
+#include "AnimationCore/Public/TwoBoneIK.h"
+
+namespace FPSArmsIKTests
+{
+	// Random poses compared against the reference, and evaluations timed of each
+	static constexpr int32 NumPoses = 2048;
+	static constexpr int32 NumTimedEvaluations = 20000;
+
+	// Weapons the poses cycle through, switching every few poses like a player swapping weapons
+	static constexpr int32 NumWeapons = 8;
+	static constexpr int32 PosesPerWeapon = 16;
+
+	// Odds of a pose swapping the current weapon's sights
+	static constexpr float SightsChangeChance = 0.05f;
+
+	// Max bone difference to the reference, in cm and radians
+	static constexpr double LocationTolerance = 1e-2;
+	static constexpr double RotationTolerance = 1e-3;
+
+	struct FTestWeapon
+	{
+		FTransform Origin;
+		// The origin blended towards while aiming
+		FTransform SightsOrigin;
+		FTransform Sights;
+		FTransform CustomOffset;
+		bool bRightHanded = true;
+		// Whether the anim instance binds the weapon change counter, otherwise the node compares the pins
+		bool bCounted = true;
+	};
+
+	static FTransform RandomTransform(FRandomStream& Random, const float MaxAngle, const float MaxOffset)
+	{
+		const FRotator Rotation(Random.FRandRange(-MaxAngle, MaxAngle), Random.FRandRange(-MaxAngle, MaxAngle), Random.FRandRange(-MaxAngle, MaxAngle));
+		return FTransform(Rotation, Random.GetUnitVector() * Random.FRandRange(0.f, MaxOffset));
+	}
+
+	static FFloatRange RandomClampRange(FRandomStream& Random)
+	{
+		return Random.FRand() < 0.5f ? FFloatRange::All() : FFloatRange::Inclusive(-Random.FRandRange(0.f, 10.f), Random.FRandRange(0.f, 10.f));
+	}
+
+	static void RandomizeSights(FRandomStream& Random, FTestWeapon& Weapon)
+	{
+		Weapon.Sights = RandomTransform(Random, 5.f, 20.f);
+		Weapon.SightsOrigin = RandomTransform(Random, 5.f, 5.f) * Weapon.Origin;
+	}
+
+	// The anim instance's pins for the weapon, at a random aim, sway and hand placement
+	static void SetRandomPins(FRandomStream& Random, const FTestWeapon& Weapon, FAnimNode_FPSArmsIK& Node)
+	{
+		// Mostly fully in or out of aiming, as players are
+		Node.AimingValue = Random.FRand() < 0.5f ? (Random.FRand() < 0.5f ? 0.f : 1.f) : Random.FRand();
+		Node.OriginRelativeTransform.Blend(Weapon.Origin, Weapon.SightsOrigin, Node.AimingValue);
+		Node.SightsRelativeTransform = Weapon.Sights;
+		Node.CustomWeaponOffsetTransform = Weapon.CustomOffset;
+		Node.bRightHanded = Weapon.bRightHanded;
+
+		Node.CameraRelativeRotation = FRotator(Random.FRandRange(-60.f, 60.f), Random.FRandRange(-30.f, 30.f), 0.f);
+		Node.OffsetTransform = RandomTransform(Random, 5.f, 3.f);
+		Node.RightHandAdditiveTransform = RandomTransform(Random, 10.f, 3.f);
+		Node.LeftHandAdditiveTransform = RandomTransform(Random, 10.f, 3.f);
+		Node.RightJointLocationOffset = Random.GetUnitVector() * Random.FRandRange(0.f, 10.f);
+		Node.LeftJointLocationOffset = Random.GetUnitVector() * Random.FRandRange(0.f, 10.f);
+		Node.RightJointClamp.HorizontalRange = RandomClampRange(Random);
+		Node.RightJointClamp.VerticalRange = RandomClampRange(Random);
+		Node.LeftJointClamp.HorizontalRange = RandomClampRange(Random);
+		Node.LeftJointClamp.VerticalRange = RandomClampRange(Random);
+
+		Node.AimingJointInfluence = Random.FRand();
+		Node.WeaponLocationAlpha = Random.FRandRange(0.5f, 1.f);
+		Node.WeaponRotationAlpha = Random.FRandRange(0.5f, 1.f);
+		Node.ArmsJointAlpha = Random.FRand();
+		Node.ArmsAlpha = Random.FRandRange(0.5f, 1.f);
+		Node.MaxExtension = Random.FRandRange(0.8f, 1.f);
+		Node.ArmPullbackConfig.Config = static_cast<EArmPullbackConfig>(Random.RandRange(0, 2));
+	}
+
+	template<typename T>
+	static void ClampRange(T& InOutValue, const FFloatRange& Range)
+	{
+		InOutValue = FMath::Clamp<T>(InOutValue, Range.GetLowerBound().IsClosed() ? Range.GetLowerBoundValue() : -INFINITY,
+			Range.GetUpperBound().IsClosed() ? Range.GetUpperBoundValue() : INFINITY);
+	}
+
+	// FAnimNode_FPSArmsIK::Evaluate_AnyThread as it was before the weapon invariants and arm transforms were shared,
+	// applied to the pose the base pose evaluated to
+	static void EvaluateReference(const FAnimNode_FPSArmsIK& Node, FCompactPose& Pose)
+	{
+		const FBoneContainer& RequiredBones = Pose.GetBoneContainer();
+		const FReferenceSkeleton& RefSkel = RequiredBones.GetReferenceSkeleton();
+		TArray<FTransform>& BSBoneTransforms = *(TArray<FTransform>*)&Pose.GetBones();
+		const auto CSTransform = [&RefSkel, &BSBoneTransforms](const int32 Index) { return FAnimationRuntime::GetComponentSpaceTransform(RefSkel, BSBoneTransforms, Index); };
+
+		const FRotator CameraRelativeRotation = Node.CameraRelativeRotation.GetNormalized();
+
+		// Init arm transforms. Component-space.
+		const FTransform CSInitRightJointTransform = CSTransform(Node.RightLowerArmIndex);
+		const FTransform CSInitLeftJointTransform = CSTransform(Node.LeftLowerArmIndex);
+
+		const FTransform CSInitRightHandTransform = BSBoneTransforms[Node.RightHand.BoneIndex] * CSInitRightJointTransform;
+		const FTransform CSInitLeftHandTransform = BSBoneTransforms[Node.LeftHand.BoneIndex] * CSInitLeftJointTransform;
+
+		const FTransform CSInitCameraTransform = FTransform(FRotator(0.f, Node.MeshYawOffset, 0.f), (FTransform(Node.CameraRelativeLocation) * CSTransform(Node.Head.BoneIndex)).GetLocation());
+		const FTransform CSInitWeaponTransform = Node.OriginRelativeTransform * (Node.bRightHanded ? CSInitRightHandTransform : CSInitLeftHandTransform);
+
+		FTransform RightUpperArmTransform = CSTransform(Node.RightUpperArmIndex);
+		FTransform RightLowerArmTransform = BSBoneTransforms[Node.RightLowerArmIndex] * RightUpperArmTransform;
+		FTransform RightHandTransform = BSBoneTransforms[Node.RightHand.BoneIndex] * RightLowerArmTransform;
+
+		FTransform LeftUpperArmTransform = CSTransform(Node.LeftUpperArmIndex);
+		FTransform LeftLowerArmTransform = BSBoneTransforms[Node.LeftLowerArmIndex] * LeftUpperArmTransform;
+		FTransform LeftHandTransform = BSBoneTransforms[Node.LeftHand.BoneIndex] * LeftLowerArmTransform;
+
+		// Weapon transform in component-space
+		const FTransform CSCameraTransform = FTransform(CameraRelativeRotation + FRotator(0.f, Node.MeshYawOffset, 0.f), (FTransform(Node.CameraRelativeLocation) * CSTransform(Node.Head.BoneIndex)).GetLocation());
+		const FTransform CameraToWeaponTransform = CSInitWeaponTransform.GetRelativeTransform(
+			FTransform(BSBoneTransforms[0].GetRotation() * CSInitCameraTransform.GetRotation(), CSInitCameraTransform.GetLocation()));
+
+		FTransform CSWeaponTransform = CameraToWeaponTransform * CSCameraTransform;
+
+		const FTransform AimingTransform = Node.OriginRelativeTransform.GetRelativeTransform(Node.SightsRelativeTransform) * CSCameraTransform;
+
+		FTransform NonAimingTransform = Node.CustomWeaponOffsetTransform * CSWeaponTransform;
+		NonAimingTransform.SetRotation(FQuat::FastLerp(CSInitWeaponTransform.GetRotation(), NonAimingTransform.GetRotation(), Node.WeaponRotationAlpha));
+		NonAimingTransform.SetLocation(NonAimingTransform.GetLocation() * Node.WeaponLocationAlpha + CSInitWeaponTransform.GetLocation() * (1.f - Node.WeaponLocationAlpha));
+
+		CSWeaponTransform = NonAimingTransform;
+		CSWeaponTransform.NormalizeRotation();
+		CSWeaponTransform.BlendWith(AimingTransform, Node.AimingValue);
+		CSWeaponTransform = Node.OffsetTransform * CSWeaponTransform;
+
+		if(Node.ArmPullbackConfig.Config == EArmPullbackConfig::Enabled || (Node.ArmPullbackConfig.Config == EArmPullbackConfig::AimingValue && Node.ArmPullbackConfig.ArmPullbackThreshold > Node.AimingValue))
+		{
+			float ReachDist;
+			float MaxReach;
+			if(Node.bRightHanded)
+			{
+				ReachDist = (LeftUpperArmTransform.GetLocation() - (CSInitLeftHandTransform.GetRelativeTransform(CSInitWeaponTransform) * CSWeaponTransform).GetLocation()).Size();
+				MaxReach = BSBoneTransforms[Node.LeftLowerArmIndex].GetLocation().Size() + BSBoneTransforms[Node.LeftHand.BoneIndex].GetLocation().Size();
+			}
+			else
+			{
+				ReachDist = (RightUpperArmTransform.GetLocation() - (CSInitRightHandTransform.GetRelativeTransform(CSInitWeaponTransform) * CSWeaponTransform).GetLocation()).Size();
+				MaxReach = BSBoneTransforms[Node.RightLowerArmIndex].GetLocation().Size() + BSBoneTransforms[Node.RightHand.BoneIndex].GetLocation().Size();
+			}
+
+			const float PullbackDist = MaxReach * Node.MaxExtension - ReachDist;
+			if(PullbackDist < 0)
+			{
+				const FTransform PullbackTransform((CSWeaponTransform.GetLocation() - CSCameraTransform.GetLocation()).GetSafeNormal() * PullbackDist);
+				CSWeaponTransform *= PullbackTransform;
+				if(!FMath::IsNearlyZero(Node.AimingValue))
+					NonAimingTransform *= PullbackTransform;
+			}
+		}
+
+		FTransform JointInfluenceWeaponTransform = CSWeaponTransform;
+		if(!FMath::IsNearlyZero(Node.AimingJointInfluence))
+			JointInfluenceWeaponTransform.BlendWith(NonAimingTransform, 1.f - Node.AimingJointInfluence);
+
+		// One arm, as the node solved the right then the left one
+		const auto SolveArm = [&](FTransform& UpperArm, FTransform& LowerArm, FTransform& Hand, const FTransform& CSInitJointTransform, const FTransform& EffectorTransform,
+			const FTransform& HandAdditiveTransform, const float HandAdditiveJointInfluence, const FVector& JointLocationOffset, const FJointClampConfig& JointClamp)
+		{
+			FTransform JointAdditiveTransform;
+			JointAdditiveTransform.BlendWith(HandAdditiveTransform, HandAdditiveJointInfluence);
+
+			const FTransform JointTargetTransform = JointAdditiveTransform * CSInitJointTransform.GetRelativeTransform(CSInitWeaponTransform) *
+				FTransform(JointLocationOffset) * Node.CustomWeaponOffsetTransform.Inverse() * JointInfluenceWeaponTransform;
+
+			FVector JointLocation;
+			if(JointClamp.IsClamping() && !FMath::IsNearlyZero(Node.ArmsJointAlpha))
+			{
+				const FTransform JointNoAdditiveTransform = JointAdditiveTransform * CSInitJointTransform.GetRelativeTransform(CSInitWeaponTransform) *
+					FTransform(JointLocationOffset) * CameraToWeaponTransform * CSCameraTransform;
+
+				FTransform Offset = JointTargetTransform.GetRelativeTransform(JointNoAdditiveTransform);
+				const FQuat Orientation = CSInitJointTransform.GetRotation();
+				FVector OrientationOffsetLocation = Orientation.UnrotateVector(Offset.GetLocation());
+
+				ClampRange(OrientationOffsetLocation.Y, JointClamp.HorizontalRange);
+				ClampRange(OrientationOffsetLocation.Z, JointClamp.VerticalRange);
+				Offset.SetLocation(Orientation.RotateVector(OrientationOffsetLocation));
+
+				JointLocation = (Offset * JointNoAdditiveTransform).GetLocation() * Node.ArmsJointAlpha + JointTargetTransform.GetLocation() * (1.f - Node.ArmsJointAlpha);
+			}
+			else JointLocation = JointTargetTransform.GetLocation();
+
+			AnimationCore::SolveTwoBoneIK(UpperArm, LowerArm, Hand, JointLocation, EffectorTransform.GetLocation(), false, 0.f, 0.f);
+			Hand.SetRotation(EffectorTransform.GetRotation());
+		};
+
+		const FTransform RightEffectorTransform = CSInitRightHandTransform.GetRelativeTransform(CSInitWeaponTransform) * (Node.RightHandAdditiveTransform * CSWeaponTransform);
+		SolveArm(RightUpperArmTransform, RightLowerArmTransform, RightHandTransform, CSInitRightJointTransform, RightEffectorTransform,
+			Node.RightHandAdditiveTransform, Node.RightHandAdditiveJointInfluence, Node.RightJointLocationOffset, Node.RightJointClamp);
+
+		const FTransform LeftEffectorTransform = Node.LeftHandAdditiveTransform * (CSInitLeftHandTransform.GetRelativeTransform(CSInitWeaponTransform) * CSWeaponTransform);
+		SolveArm(LeftUpperArmTransform, LeftLowerArmTransform, LeftHandTransform, CSInitLeftJointTransform, LeftEffectorTransform,
+			Node.LeftHandAdditiveTransform, Node.LeftHandAdditiveJointInfluence, Node.LeftJointLocationOffset, Node.LeftJointClamp);
+
+		const float TotalArmsAlpha = Node.Alpha * Node.ArmsAlpha;
+		BSBoneTransforms[Node.RightUpperArmIndex].BlendWith(RightUpperArmTransform.GetRelativeTransform(CSTransform(Node.CachedRightUpperArmParentBoneIndex)), TotalArmsAlpha);
+		BSBoneTransforms[Node.RightLowerArmIndex].BlendWith(RightLowerArmTransform.GetRelativeTransform(RightUpperArmTransform), TotalArmsAlpha);
+		BSBoneTransforms[Node.RightHand.BoneIndex].BlendWith(RightHandTransform.GetRelativeTransform(RightLowerArmTransform), TotalArmsAlpha);
+
+		BSBoneTransforms[Node.LeftUpperArmIndex].BlendWith(LeftUpperArmTransform.GetRelativeTransform(CSTransform(Node.CachedLeftUpperArmParentBoneIndex)), TotalArmsAlpha);
+		BSBoneTransforms[Node.LeftLowerArmIndex].BlendWith(LeftLowerArmTransform.GetRelativeTransform(LeftUpperArmTransform), TotalArmsAlpha);
+		BSBoneTransforms[Node.LeftHand.BoneIndex].BlendWith(LeftHandTransform.GetRelativeTransform(LeftLowerArmTransform), TotalArmsAlpha);
+	}
+
+	// Largest bone-space location and rotation difference between two poses
+	static void AddMaxDifference(const FCompactPose& Pose, const FCompactPose& Reference, double& InOutLocation, double& InOutRotation)
+	{
+		for(const FCompactPoseBoneIndex BoneIndex : Pose.ForEachBoneIndex())
+		{
+			InOutLocation = FMath::Max(InOutLocation, FVector::Dist(Pose[BoneIndex].GetLocation(), Reference[BoneIndex].GetLocation()));
+			InOutRotation = FMath::Max(InOutRotation, static_cast<double>(Pose[BoneIndex].GetRotation().AngularDistance(Reference[BoneIndex].GetRotation())));
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFPSArmsIKEvaluateTest, "TrueFPS.Anim.ArmsIKEvaluate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFPSArmsIKEvaluateTest::RunTest(const FString& Parameters)
+{
+	using namespace FPSArmsIKTests;
+	using namespace TrueFPSTestSkeleton;
+
+	USkeleton* Skeleton = MakeSkeleton(TEXT("FPSArmsIKTest"));
+	FAnimInstanceProxy Proxy;
+	InitProxy(Proxy, Skeleton);
+	const FBoneContainer& RequiredBones = Proxy.GetRequiredBones();
+
+	FTestPoseNode PoseNode;
+	PoseNode.Pose.SetBoneContainer(&RequiredBones);
+	PoseNode.Pose.ResetToRefPose();
+
+	FAnimNode_FPSArmsIK Node;
+	Node.BasePose.SetLinkNode(&PoseNode);
+	Node.CameraRelativeLocation = FVector(10.f, 0.f, 5.f);
+	Node.Initialize_AnyThread(FAnimationInitializeContext(&Proxy));
+	Node.CacheBones_AnyThread(FAnimationCacheBonesContext(&Proxy));
+
+	// The node doesn't resolve its head reference itself, leaving the camera at the root. Resolve it so the camera moves with the spine.
+	Node.Head = FBoneReference(FName("head"));
+	Node.Head.Initialize(RequiredBones);
+	if(!TestTrue(TEXT("The arms bind"), Node.CanEvaluate())) return false;
+
+	FRandomStream Random(NumPoses);
+	TArray<FTestWeapon> Weapons;
+	for(int32 i = 0; i < NumWeapons; i++)
+	{
+		FTestWeapon& Weapon = Weapons.AddDefaulted_GetRef();
+		Weapon.Origin = RandomTransform(Random, 30.f, 10.f);
+		Weapon.CustomOffset = RandomTransform(Random, 10.f, 5.f);
+		Weapon.bRightHanded = i % 4 != 3;
+		Weapon.bCounted = i % 2 == 0;
+		RandomizeSights(Random, Weapon);
+	}
+
+	// The node against the reference on the same random poses, through weapon and sights changes
+	FPoseContext Output(&Proxy);
+	FCompactPose Reference;
+	Reference.SetBoneContainer(&RequiredBones);
+
+	int32 WeaponChangeCounter = 0;
+	int32 NumMismatches = 0;
+	double MaxLocationDifference = 0.0;
+	double MaxRotationDifference = 0.0;
+	for(int32 PoseIndex = 0; PoseIndex < NumPoses; PoseIndex++)
+	{
+		// Bumped as the anim instance does, on weapon and sights changes only
+		FTestWeapon& Weapon = Weapons[PoseIndex / PosesPerWeapon % NumWeapons];
+		if(PoseIndex % PosesPerWeapon == 0) WeaponChangeCounter++;
+		else if(Random.FRand() < SightsChangeChance)
+		{
+			RandomizeSights(Random, Weapon);
+			WeaponChangeCounter++;
+		}
+
+		SetRandomPose(Random, PoseNode.Pose);
+		SetRandomPins(Random, Weapon, Node);
+		Node.WeaponChangeCounter = Weapon.bCounted ? WeaponChangeCounter : INDEX_NONE;
+
+		Node.Update_AnyThread(FAnimationUpdateContext(&Proxy, 1.f / 60.f));
+		Node.Evaluate_AnyThread(Output);
+
+		Reference.CopyBonesFrom(PoseNode.Pose);
+		EvaluateReference(Node, Reference);
+
+		double LocationDifference = 0.0;
+		double RotationDifference = 0.0;
+		AddMaxDifference(Output.Pose, Reference, LocationDifference, RotationDifference);
+		NumMismatches += LocationDifference > LocationTolerance || RotationDifference > RotationTolerance ? 1 : 0;
+		MaxLocationDifference = FMath::Max(MaxLocationDifference, LocationDifference);
+		MaxRotationDifference = FMath::Max(MaxRotationDifference, RotationDifference);
+	}
+
+	TestEqual(TEXT("Poses the node evaluates differently than before"), NumMismatches, 0);
+
+	// Time both on the last pose, the counter unchanged as it is between weapon changes
+	double Seconds = 0.0;
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for(int32 i = 0; i < NumTimedEvaluations; i++)
+			Node.Evaluate_AnyThread(Output);
+		Seconds = FPlatformTime::Seconds() - StartTime;
+	}
+
+	double ReferenceSeconds = 0.0;
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for(int32 i = 0; i < NumTimedEvaluations; i++)
+		{
+			Reference.CopyBonesFrom(PoseNode.Pose);
+			EvaluateReference(Node, Reference);
+		}
+		ReferenceSeconds = FPlatformTime::Seconds() - StartTime;
+	}
+
+	AddInfo(FString::Printf(TEXT("%d random poses over %d weapons: max difference to the reference %.2ecm %.2erad. %.0fns per evaluate, %.0fns before"),
+		NumPoses, NumWeapons, MaxLocationDifference, MaxRotationDifference, Seconds * 1e9 / NumTimedEvaluations, ReferenceSeconds * 1e9 / NumTimedEvaluations));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
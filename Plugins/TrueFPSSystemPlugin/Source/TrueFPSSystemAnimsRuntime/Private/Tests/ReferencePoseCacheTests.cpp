@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestSkeleton.h"
+#include "AnimNode_ProceduralAimOffset.h"
+#include "AnimNode_TrueFPSRig.h"
+
+namespace ReferencePoseCacheTests
+{
+	// Random base poses each node pair is compared on, the mesh LOD changing halfway through
+	static constexpr int32 NumPoses = 512;
+
+	static constexpr int32 NumCharacters = 32;
+	static constexpr int32 NumFrames = 120;
+
+	// A node and its own links, the reference pose set by the test
+	template<typename NodeType>
+	struct TTestNode
+	{
+		NodeType Node;
+		TrueFPSTestSkeleton::FTestPoseNode BasePose;
+		TrueFPSTestSkeleton::FTestPoseNode ReferencePose;
+
+		void Initialize(FAnimInstanceProxy& Proxy, const bool bCacheReferencePose)
+		{
+			BasePose.Pose.SetBoneContainer(&Proxy.GetRequiredBones());
+			BasePose.Pose.ResetToRefPose();
+			ReferencePose.Pose.SetBoneContainer(&Proxy.GetRequiredBones());
+			ReferencePose.Pose.ResetToRefPose();
+
+			Node.BasePose.SetLinkNode(&BasePose);
+			Node.ReferencePose.SetLinkNode(&ReferencePose);
+			Node.bCacheReferencePose = bCacheReferencePose;
+			Node.Initialize_AnyThread(FAnimationInitializeContext(&Proxy));
+			Node.CacheBones_AnyThread(FAnimationCacheBonesContext(&Proxy));
+		}
+
+		void Evaluate(FAnimInstanceProxy& Proxy, FPoseContext& Output)
+		{
+			Node.Update_AnyThread(FAnimationUpdateContext(&Proxy, 1.f / 60.f));
+			Node.Evaluate_AnyThread(Output);
+		}
+	};
+
+	// The rig's pins the anim instance would otherwise set, its FVectors aren't initialized
+	static void InitRigPins(FAnimNode_TrueFPSRig& Node)
+	{
+		Node.CameraRelativeLocation = FVector(10.f, 0.f, 5.f);
+		Node.RightJointLocationOffset = FVector::ZeroVector;
+		Node.LeftJointLocationOffset = FVector::ZeroVector;
+	}
+
+	// Largest bone-space difference between two poses, 0 when identical
+	static double GetMaxDifference(const FCompactPose& Pose, const FCompactPose& Other)
+	{
+		double MaxDifference = 0.0;
+		for(const FCompactPoseBoneIndex BoneIndex : Pose.ForEachBoneIndex())
+		{
+			MaxDifference = FMath::Max(MaxDifference, FVector::Dist(Pose[BoneIndex].GetLocation(), Other[BoneIndex].GetLocation()));
+			MaxDifference = FMath::Max(MaxDifference, static_cast<double>(Pose[BoneIndex].GetRotation().AngularDistance(Other[BoneIndex].GetRotation())));
+		}
+		return MaxDifference;
+	}
+
+	// A node caching its reference pose against the same node evaluating it every frame, on the same random poses and aim.
+	// The mesh LOD changes halfway, the reference pose with it.
+	template<typename NodeType, typename SetPinsType>
+	static void CompareCached(FAutomationTestBase& Test, const TCHAR* What, SetPinsType SetPins)
+	{
+		using namespace TrueFPSTestSkeleton;
+
+		USkeleton* Skeleton = MakeSkeleton(TEXT("ReferencePoseCacheTest"));
+		FAnimInstanceProxy Proxy;
+		InitProxy(Proxy, Skeleton);
+
+		TTestNode<NodeType> Cached;
+		TTestNode<NodeType> Uncached;
+		Cached.Initialize(Proxy, true);
+		Uncached.Initialize(Proxy, false);
+
+		FRandomStream Random(NumPoses);
+		SetRandomPose(Random, Cached.ReferencePose.Pose, 10.f);
+		Uncached.ReferencePose.Pose.CopyBonesFrom(Cached.ReferencePose.Pose);
+
+		FPoseContext CachedOutput(&Proxy);
+		FPoseContext UncachedOutput(&Proxy);
+		double MaxDifference = 0.0;
+		for(int32 PoseIndex = 0; PoseIndex < NumPoses; PoseIndex++)
+		{
+			// A new LOD, the bones required anew, with a reference pose of its own
+			if(PoseIndex == NumPoses / 2)
+			{
+				InitProxy(Proxy, Skeleton);
+				SetRandomPose(Random, Cached.ReferencePose.Pose, 10.f);
+				Uncached.ReferencePose.Pose.CopyBonesFrom(Cached.ReferencePose.Pose);
+				Cached.Node.CacheBones_AnyThread(FAnimationCacheBonesContext(&Proxy));
+				Uncached.Node.CacheBones_AnyThread(FAnimationCacheBonesContext(&Proxy));
+			}
+
+			SetRandomPose(Random, Cached.BasePose.Pose);
+			Uncached.BasePose.Pose.CopyBonesFrom(Cached.BasePose.Pose);
+			FRandomStream PinsRandom = Random;
+			SetPins(PinsRandom, Uncached.Node);
+			SetPins(Random, Cached.Node);
+
+			Cached.Evaluate(Proxy, CachedOutput);
+			Uncached.Evaluate(Proxy, UncachedOutput);
+			MaxDifference = FMath::Max(MaxDifference, GetMaxDifference(CachedOutput.Pose, UncachedOutput.Pose));
+		}
+
+		Test.TestEqual(FString::Printf(TEXT("%s evaluates the same with the reference pose cached"), What), MaxDifference, 0.0);
+		Test.TestEqual(FString::Printf(TEXT("%s evaluates the reference pose once per LOD"), What), Cached.ReferencePose.NumEvaluations, 2);
+		Test.TestEqual(FString::Printf(TEXT("%s without the cache evaluates the reference pose every frame"), What), Uncached.ReferencePose.NumEvaluations, NumPoses);
+	}
+
+	struct FCharacterRun
+	{
+		// Poses evaluated over the timed frames, base and reference poses together
+		int32 NumEvaluations = 0;
+		double Seconds = 0.0;
+	};
+
+	// NumCharacters rigs, each with its own anim instance, evaluated for NumFrames
+	static FCharacterRun RunCharacters(USkeleton* Skeleton, const bool bCacheReferencePose)
+	{
+		TArray<TUniquePtr<FAnimInstanceProxy>> Proxies;
+		TArray<TUniquePtr<TTestNode<FAnimNode_TrueFPSRig>>> Rigs;
+		for(int32 i = 0; i < NumCharacters; i++)
+		{
+			FAnimInstanceProxy& Proxy = *Proxies.Add_GetRef(MakeUnique<FAnimInstanceProxy>());
+			TrueFPSTestSkeleton::InitProxy(Proxy, Skeleton);
+
+			TTestNode<FAnimNode_TrueFPSRig>& Rig = *Rigs.Add_GetRef(MakeUnique<TTestNode<FAnimNode_TrueFPSRig>>());
+			InitRigPins(Rig.Node);
+			Rig.Initialize(Proxy, bCacheReferencePose);
+		}
+
+		FCharacterRun Result;
+		const double StartTime = FPlatformTime::Seconds();
+		for(int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			for(int32 i = 0; i < NumCharacters; i++)
+			{
+				FPoseContext Output(Proxies[i].Get());
+				Rigs[i]->Evaluate(*Proxies[i], Output);
+			}
+		}
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+
+		for(const TUniquePtr<TTestNode<FAnimNode_TrueFPSRig>>& Rig : Rigs)
+			Result.NumEvaluations += Rig->BasePose.NumEvaluations + Rig->ReferencePose.NumEvaluations;
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReferencePoseCacheTest, "TrueFPS.Anim.ReferencePoseCache",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FReferencePoseCacheTest::RunTest(const FString& Parameters)
+{
+	using namespace ReferencePoseCacheTests;
+
+	CompareCached<FAnimNode_TrueFPSRig>(*this, TEXT("The rig"), [](FRandomStream& Random, FAnimNode_TrueFPSRig& Node)
+	{
+		InitRigPins(Node);
+		Node.CameraRelativeRotation = FRotator(Random.FRandRange(-60.f, 60.f), Random.FRandRange(-30.f, 30.f), 0.f);
+		Node.AimingValue = Random.FRand();
+	});
+
+	// Without arms, the rig only aims the spine
+	CompareCached<FAnimNode_TrueFPSRig>(*this, TEXT("The rig without arms"), [](FRandomStream& Random, FAnimNode_TrueFPSRig& Node)
+	{
+		InitRigPins(Node);
+		Node.CameraRelativeRotation = FRotator(Random.FRandRange(-60.f, 60.f), Random.FRandRange(-30.f, 30.f), 0.f);
+		Node.ArmsAlpha = 0.f;
+	});
+
+	CompareCached<FAnimNode_ProceduralAimOffset>(*this, TEXT("The aim offset"), [](FRandomStream& Random, FAnimNode_ProceduralAimOffset& Node)
+	{
+		Node.CameraRelativeRotation = FRotator(Random.FRandRange(-60.f, 60.f), Random.FRandRange(-30.f, 30.f), 0.f);
+	});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReferencePoseEvaluationsTest, "TrueFPS.Anim.ReferencePoseEvaluations",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FReferencePoseEvaluationsTest::RunTest(const FString& Parameters)
+{
+	using namespace ReferencePoseCacheTests;
+
+	USkeleton* Skeleton = TrueFPSTestSkeleton::MakeSkeleton(TEXT("ReferencePoseEvaluationsTest"));
+	const FCharacterRun Uncached = RunCharacters(Skeleton, false);
+	const FCharacterRun Cached = RunCharacters(Skeleton, true);
+
+	// The base pose every frame, the reference pose every frame without the cache and once with it
+	TestEqual(TEXT("Poses evaluated without the cache"), Uncached.NumEvaluations, NumCharacters * NumFrames * 2);
+	TestEqual(TEXT("Poses evaluated with the cache"), Cached.NumEvaluations, NumCharacters * (NumFrames + 1));
+
+	AddInfo(FString::Printf(TEXT("%d characters: %.2f pose evaluations per frame and %.3fms without the cache, %.2f and %.3fms with it"),
+		NumCharacters, static_cast<double>(Uncached.NumEvaluations) / NumFrames, Uncached.Seconds * 1000.0 / NumFrames,
+		static_cast<double>(Cached.NumEvaluations) / NumFrames, Cached.Seconds * 1000.0 / NumFrames));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TrueFPSTestSkeleton.h"
+#include "AnimNode_TrueFPSRig.h"
+
+namespace TrueFPSRigTests
+{
+	// Times a broken skeleton is rebound, as LOD changes and instances of the mesh would
+	static constexpr int32 NumRebinds = 1000;
+
+	// Whether the rig passed the base pose through, the unlinked base pose being the reference pose
+	static bool EvaluatesToBasePose(FAnimNode_TrueFPSRig& Node, FAnimInstanceProxy& Proxy)
+	{
+		FPoseContext Output(&Proxy);
+		Node.Evaluate_AnyThread(Output);
+
+		FPoseContext RefPose(&Proxy);
+		RefPose.ResetToRefPose();
+		for(const FCompactPoseBoneIndex BoneIndex : Output.Pose.ForEachBoneIndex())
+		{
+			if(!Output.Pose[BoneIndex].Equals(RefPose.Pose[BoneIndex])) return false;
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSRigBindingTest, "TrueFPS.Anim.RigBinding",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSRigBindingTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSRigTests;
+	using namespace TrueFPSTestSkeleton;
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		TArray<FName> MissingBones;
+	};
+	const FCase Cases[] = {
+		{TEXT("TrueFPSRigTest_NoHand"), {FName("hand_l")}},
+		{TEXT("TrueFPSRigTest_NoHead"), {FName("head")}},
+		{TEXT("TrueFPSRigTest_NoSpine"), {FName("spine_02")}},
+	};
+
+	// A mesh with every bone binds and runs the rig, without an error
+	{
+		USkeleton* Skeleton = MakeSkeleton(TEXT("TrueFPSRigTest_Complete"));
+		FAnimInstanceProxy Proxy;
+		InitProxy(Proxy, Skeleton);
+
+		FAnimNode_TrueFPSRig Node;
+		Node.CacheBones_AnyThread(FAnimationCacheBonesContext(&Proxy));
+		TestTrue(TEXT("A complete skeleton binds"), Node.CanEvaluate());
+	}
+
+	// Broken meshes are bypassed, each reported once however many times and nodes bind it
+	double RebindSeconds = 0.0;
+	for(const FCase& Case : Cases)
+	{
+		USkeleton* Skeleton = MakeSkeleton(Case.Name, Case.MissingBones);
+		FAnimInstanceProxy Proxy;
+		InitProxy(Proxy, Skeleton);
+
+		AddExpectedError(Skeleton->GetName(), EAutomationExpectedErrorFlags::Contains, 1);
+
+		FAnimNode_TrueFPSRig Node;
+		FAnimNode_TrueFPSRig OtherNode;
+		const double StartTime = FPlatformTime::Seconds();
+		for(int32 i = 0; i < NumRebinds; i++)
+		{
+			Node.CacheBones_AnyThread(FAnimationCacheBonesContext(&Proxy));
+			OtherNode.CacheBones_AnyThread(FAnimationCacheBonesContext(&Proxy));
+		}
+		RebindSeconds += FPlatformTime::Seconds() - StartTime;
+
+		TestFalse(FString::Printf(TEXT("%s doesn't bind"), Case.Name), Node.CanEvaluate() || OtherNode.CanEvaluate());
+		TestTrue(FString::Printf(TEXT("%s passes the base pose through"), Case.Name), EvaluatesToBasePose(Node, Proxy));
+	}
+
+	AddInfo(FString::Printf(TEXT("Rebinding a broken skeleton: %.2fus per CacheBones"), RebindSeconds * 1e6 / (UE_ARRAY_COUNT(Cases) * NumRebinds * 2)));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
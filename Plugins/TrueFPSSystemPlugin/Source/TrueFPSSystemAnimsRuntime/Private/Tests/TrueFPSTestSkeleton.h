@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Animation/AnimInstanceProxy.h"
+#include "Animation/AnimNodeBase.h"
+#include "Animation/Skeleton.h"
+
+// Synthetic mannequin skeletons for the node tests, no assets needed
+namespace TrueFPSTestSkeleton
+{
+	// The mannequin's bones the nodes use, each after its parent
+	struct FBoneDesc
+	{
+		const TCHAR* Name;
+		const TCHAR* Parent;
+		FVector Location;
+	};
+
+	inline const FBoneDesc Bones[] = {
+		{TEXT("root"), nullptr, FVector::ZeroVector},
+		{TEXT("pelvis"), TEXT("root"), FVector(0.f, 0.f, 95.f)},
+		{TEXT("spine_01"), TEXT("pelvis"), FVector(0.f, 0.f, 10.f)},
+		{TEXT("spine_02"), TEXT("spine_01"), FVector(0.f, 0.f, 12.f)},
+		{TEXT("spine_03"), TEXT("spine_02"), FVector(0.f, 0.f, 12.f)},
+		{TEXT("neck_01"), TEXT("spine_03"), FVector(0.f, 0.f, 20.f)},
+		{TEXT("head"), TEXT("neck_01"), FVector(0.f, 0.f, 10.f)},
+		{TEXT("clavicle_r"), TEXT("spine_03"), FVector(0.f, 5.f, 15.f)},
+		{TEXT("upperarm_r"), TEXT("clavicle_r"), FVector(0.f, 15.f, 0.f)},
+		{TEXT("lowerarm_r"), TEXT("upperarm_r"), FVector(0.f, 28.f, 0.f)},
+		{TEXT("hand_r"), TEXT("lowerarm_r"), FVector(0.f, 26.f, 0.f)},
+		{TEXT("clavicle_l"), TEXT("spine_03"), FVector(0.f, -5.f, 15.f)},
+		{TEXT("upperarm_l"), TEXT("clavicle_l"), FVector(0.f, -15.f, 0.f)},
+		{TEXT("lowerarm_l"), TEXT("upperarm_l"), FVector(0.f, -28.f, 0.f)},
+		{TEXT("hand_l"), TEXT("lowerarm_l"), FVector(0.f, -26.f, 0.f)},
+	};
+
+	// A skeleton of the bones above but the missing ones, their children attached to the closest bone left
+	inline USkeleton* MakeSkeleton(const TCHAR* Name, const TArray<FName>& MissingBones = {})
+	{
+		USkeleton* Skeleton = NewObject<USkeleton>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), USkeleton::StaticClass(), Name));
+
+		TMap<FName, FName> Parents;
+		FReferenceSkeletonModifier Modifier(Skeleton);
+		for(const FBoneDesc& Bone : Bones)
+		{
+			FName Parent = Bone.Parent ? FName(Bone.Parent) : NAME_None;
+			while(MissingBones.Contains(Parent)) Parent = Parents.FindChecked(Parent);
+			Parents.Add(Bone.Name, Parent);
+
+			if(MissingBones.Contains(Bone.Name)) continue;
+			const int32 ParentIndex = Parent.IsNone() ? INDEX_NONE : Modifier.FindBoneIndex(Parent);
+			Modifier.Add(FMeshBoneInfo(Bone.Name, Bone.Name, ParentIndex), FTransform(Bone.Location));
+		}
+		return Skeleton;
+	}
+
+	// A proxy requiring every bone of the skeleton, what CacheBones and Evaluate read the bones from
+	inline void InitProxy(FAnimInstanceProxy& Proxy, USkeleton* Skeleton)
+	{
+		TArray<FBoneIndexType> RequiredBoneIndices;
+		for(int32 BoneIndex = 0; BoneIndex < Skeleton->GetReferenceSkeleton().GetNum(); BoneIndex++)
+			RequiredBoneIndices.Add(static_cast<FBoneIndexType>(BoneIndex));
+		Proxy.GetRequiredBones().InitializeTo(RequiredBoneIndices, UE::Anim::FCurveFilterSettings(), *Skeleton);
+	}
+
+	// The reference pose bent at every bone by up to MaxAngle, as an animation would
+	inline void SetRandomPose(FRandomStream& Random, FCompactPose& Pose, const float MaxAngle = 30.f)
+	{
+		Pose.ResetToRefPose();
+		for(const FCompactPoseBoneIndex BoneIndex : Pose.ForEachBoneIndex())
+		{
+			const FRotator Rotation(Random.FRandRange(-MaxAngle, MaxAngle), Random.FRandRange(-MaxAngle, MaxAngle), Random.FRandRange(-MaxAngle, MaxAngle));
+			Pose[BoneIndex].SetRotation(Rotation.Quaternion() * Pose[BoneIndex].GetRotation());
+		}
+	}
+
+	// Feeds a pose set by the test into the pose link of the node under test, counting its evaluations
+	struct FTestPoseNode : public FAnimNode_Base
+	{
+		FCompactPose Pose;
+		int32 NumEvaluations = 0;
+
+		virtual void Evaluate_AnyThread(FPoseContext& Output) override
+		{
+			Output.Pose.CopyBonesFrom(Pose);
+			NumEvaluations++;
+		}
+	};
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -84,6 +84,11 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_FPSArmsIK : public FAnimNode_Base
 	// position apply the same value to the RightJointLocationOffset and LeftJointLocationOffset pins).
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (PinHiddenByDefault), Category = "Arms IK")
 	FTransform CustomWeaponOffsetTransform;
+
+	// Bumped whenever the weapon sights or custom weapon offset pins change, i.e. on weapon and sights changes. What the node
+	// derives from them is reused until it changes. Left at -1 the node compares the pins themselves every evaluation instead.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (PinHiddenByDefault), Category = "Arms IK")
+	int32 WeaponChangeCounter = INDEX_NONE;
 	
 	// Right joint location offset clamping in joint-space (inward horizontal displacement is affected by Min-Value
 	// and outward horizontal displacement is affected by Max-Value). Specifying "Open" on a range-boundary means that
@@ -188,7 +193,11 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_FPSArmsIK : public FAnimNode_Base
 
 	UPROPERTY(EditAnywhere, Meta = (EditCondition = "MaxExtension < 1", DisplayName = "Arm Pull-Back Configuration"), Category = "Configurations")
 	FArmPullbackConfig ArmPullbackConfig;
-	
+
+	// The max LOD this node runs at, -1 to always run. Past it the base pose is passed through untouched.
+	UPROPERTY(EditAnywhere, Category = "Performance", Meta = (PinHiddenByDefault, DisplayName = "LOD Threshold"))
+	int32 LODThreshold = INDEX_NONE;
+
 
 	// FAnimNode_Base interface
 	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
@@ -196,13 +205,41 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_FPSArmsIK : public FAnimNode_Base
 	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
 	virtual void Update_AnyThread(const FAnimationUpdateContext& Context) override;
 	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual int32 GetLODThreshold() const override { return LODThreshold; }
 	// End of FAnimNode_Base interface
 
 	bool CanEvaluate() const;
 
+	// Solves one arm onto the effector with AnimationCore::SolveTwoBoneIK, without stretching. Transforms in component-space,
+	// the hand takes the effector's rotation.
+	static void SolveArmIK(FTransform& UpperArm, FTransform& LowerArm, FTransform& Hand, const FVector& JointTarget, const FTransform& Effector);
+
 	//static void SortBones(TArray<FBoneTransform>& OutBoneTransforms);
 
 private:
+	// Transforms that only depend on the weapon and its sights, recomputed when they change. The weapon origin isn't one
+	// of them, it moves with the aiming value.
+	struct FWeaponInvariants
+	{
+		// The pins the invariants were computed from
+		int32 WeaponChangeCounter = INDEX_NONE;
+		FTransform SightsRelativeTransform;
+		FTransform CustomWeaponOffsetTransform;
+
+		FTransform SightsInverse;
+		FTransform CustomWeaponOffsetInverse;
+
+		bool bValid = false;
+	};
+
+	FWeaponInvariants WeaponInvariants;
+
+	void UpdateWeaponInvariants();
+
+	// The joint (elbow) location in component-space from the joint in weapon-space, clamped by the joint clamp config
+	FVector GetJointLocation(const FTransform& JointTransform, const FTransform& JointInfluenceWeaponTransform, const FTransform& BaseWeaponTransform,
+		const FQuat& InitJointRotation, const FJointClampConfig& JointClamp) const;
+
 	template<typename T>
 	static void ClampRange(T& InOutValue, const FFloatRange& Range)
 	{
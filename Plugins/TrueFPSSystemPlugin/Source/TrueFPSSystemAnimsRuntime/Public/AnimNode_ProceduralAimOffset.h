@@ -23,6 +23,22 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FBoneParams
 	float Weight = 1.f;
 };
 
+// Component-space transforms of a few bones of a Reference Pose link, kept for the required bones they were
+// evaluated with so the link only has to be evaluated again when the mesh or its LOD changes.
+struct TRUEFPSSYSTEMANIMSRUNTIME_API FReferencePoseCache
+{
+	TArray<FCompactPoseBoneIndex, TInlineAllocator<4>> Bones;
+	TArray<FTransform, TInlineAllocator<4>> CSTransforms;
+
+	// Serial number of the required bones the cache was built with, 0 if never built
+	uint16 SerialNumber = 0;
+
+	FORCEINLINE bool IsValidFor(const FBoneContainer& RequiredBones) const { return SerialNumber != 0 && SerialNumber == RequiredBones.GetSerialNumber(); }
+
+	// Evaluates the Reference Pose and caches the component-space transforms of InBones
+	void Build(FPoseLink& ReferencePose, const FPoseContext& Output, TConstArrayView<FCompactPoseBoneIndex> InBones);
+};
+
 /**
  * 
  */
@@ -63,6 +79,14 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_ProceduralAimOffset : public FAni
 	// The time in the Reference Pose we snapshot as our base. Should usually be 0
 	UPROPERTY(EditAnywhere, Category = Configurations)
 	float ReferenceFrameTime = 0.f;
+
+	// The max LOD this node runs at, -1 to always run. Past it the base pose is passed through untouched.
+	UPROPERTY(EditAnywhere, Category = "Performance", Meta = (PinHiddenByDefault, DisplayName = "LOD Threshold"))
+	int32 LODThreshold = INDEX_NONE;
+
+	// Evaluate the Reference Pose once per mesh LOD instead of every frame. Disable if the Reference Pose animates.
+	UPROPERTY(EditAnywhere, Category = "Performance", Meta = (DisplayName = "Cache Reference Pose"))
+	bool bCacheReferencePose = true;
 	
 	// Only true if all bone names are valid, if not this node will not do anything
 	bool bIsValidBoneNames = false;
@@ -73,8 +97,13 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_ProceduralAimOffset : public FAni
 	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
 	virtual void Update_AnyThread(const FAnimationUpdateContext& Context) override;
 	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual int32 GetLODThreshold() const override { return LODThreshold; }
 	// End of FAnimNode_Base interface
 
 	// Helper func
 	static FQuat GetAccumulativeOffsetInverse(const int32 BoneIndex, const FCompactPose& BasePose, const FCompactPose& StablePose);
+	static FQuat GetAccumulativeOffsetInverse(const FCompactPoseBoneIndex BoneIndex, const FCompactPose& BasePose, const FQuat& StableCSRotation);
+
+private:
+	FReferencePoseCache ReferencePoseCache;
 };
\ No newline at end of file
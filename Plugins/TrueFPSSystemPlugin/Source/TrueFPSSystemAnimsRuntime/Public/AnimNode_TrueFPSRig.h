@@ -8,6 +8,32 @@
 #include "AnimGlobals.h"
 #include "AnimNode_TrueFPSRig.generated.h"
 
+// Compact pose indices of the bones the rig drives. Resolved and validated once per bone container
+// in CacheBones so evaluation only has to check bValid.
+struct FTrueFPSRigBoneBinding
+{
+	FCompactPoseBoneIndex RightUpperArm{INDEX_NONE};
+	FCompactPoseBoneIndex RightLowerArm{INDEX_NONE};
+	FCompactPoseBoneIndex RightHand{INDEX_NONE};
+	FCompactPoseBoneIndex RightUpperArmParent{INDEX_NONE};
+
+	FCompactPoseBoneIndex LeftUpperArm{INDEX_NONE};
+	FCompactPoseBoneIndex LeftLowerArm{INDEX_NONE};
+	FCompactPoseBoneIndex LeftHand{INDEX_NONE};
+	FCompactPoseBoneIndex LeftUpperArmParent{INDEX_NONE};
+
+	FCompactPoseBoneIndex Head{INDEX_NONE};
+
+	// Not required, the accumulative offset is identity without it
+	FCompactPoseBoneIndex StableBone{INDEX_NONE};
+
+	// Same order as SpineBoneParams
+	TArray<FCompactPoseBoneIndex, TInlineAllocator<12>> Spine;
+
+	// Whether every bone was found, the base pose is passed through untouched otherwise
+	bool bValid = false;
+};
+
 /**
  * 
  */
@@ -41,16 +67,6 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_TrueFPSRig : public FAnimNode_Bas
 	UPROPERTY(EditAnywhere, Category = "Bone References")
 	FBoneReference StableBone;
 
-	// Cached arm bones
-	int32 RightLowerArmIndex = INDEX_NONE;
-	int32 RightUpperArmIndex = INDEX_NONE;
-	
-	int32 LeftLowerArmIndex = INDEX_NONE;
-	int32 LeftUpperArmIndex = INDEX_NONE;
-
-	int32 CachedRightUpperArmParentBoneIndex = INDEX_NONE;
-	int32 CachedLeftUpperArmParentBoneIndex = INDEX_NONE;
-
 	//
 	// Configurations
 	//
@@ -196,7 +212,19 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_TrueFPSRig : public FAnimNode_Bas
 
 	UPROPERTY(EditAnywhere, Meta = (EditCondition = "MaxExtension < 1", DisplayName = "Arm Pull-Back Configuration"), Category = "Configurations")
 	FArmPullbackConfig ArmPullbackConfig;
-	
+
+	// The max LOD this node runs at, -1 to always run. Past it the base pose is passed through untouched.
+	UPROPERTY(EditAnywhere, Category = "Performance", Meta = (PinHiddenByDefault, DisplayName = "LOD Threshold"))
+	int32 LODThreshold = INDEX_NONE;
+
+	// The max LOD the arms IK runs at, -1 to always run. Past it only the procedural aim offset is applied.
+	UPROPERTY(EditAnywhere, Category = "Performance", Meta = (PinHiddenByDefault, DisplayName = "Arms IK LOD Threshold"))
+	int32 ArmsLODThreshold = INDEX_NONE;
+
+	// Evaluate the Reference Pose once per mesh LOD instead of every frame. Disable if the Reference Pose animates.
+	UPROPERTY(EditAnywhere, Category = "Performance", Meta = (DisplayName = "Cache Reference Pose"))
+	bool bCacheReferencePose = true;
+
 
 	// FAnimNode_Base interface
 	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
@@ -204,6 +232,7 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_TrueFPSRig : public FAnimNode_Bas
 	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
 	virtual void Update_AnyThread(const FAnimationUpdateContext& Context) override;
 	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual int32 GetLODThreshold() const override { return LODThreshold; }
 	// End of FAnimNode_Base interface
 
 	bool CanEvaluate() const;
@@ -212,6 +241,17 @@ struct TRUEFPSSYSTEMANIMSRUNTIME_API FAnimNode_TrueFPSRig : public FAnimNode_Bas
 	//static void SortBones(TArray<FBoneTransform>& OutBoneTransforms);
 
 private:
+	// Resolves the bones against the required bones, OutError is set to why when a bone is missing
+	FTrueFPSRigBoneBinding BindBones(const FBoneContainer& RequiredBones, FString& OutError) const;
+
+	// Cached in CacheBones, only read during evaluation
+	FTrueFPSRigBoneBinding Binding;
+
+	FReferencePoseCache ReferencePoseCache;
+
+	// Accumulative offset inverse of the stable bone against the (cached) Reference Pose
+	FQuat GetStableAccumulativeOffsetInverse(const FPoseContext& Output);
+
 	template<typename T>
 	static void ClampRange(T& InOutValue, const FFloatRange& Range)
 	{
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include <atomic>
+
+struct FTrueFPSSystemLoadingScreenBrush;
+
+class STrueFPSLoadingScreen2 : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(STrueFPSLoadingScreen2) {}
+		/** object path of the image to stream in, the loading screen image if unset */
+		SLATE_ARGUMENT(FString, ImagePath)
+	SLATE_END_ARGS()
+
+	/** Where the loading screen is at, only ever moves forward */
+	enum class EState : uint8
+	{
+		/** showing the placeholder, image not requested yet */
+		Placeholder,
+		/** showing the placeholder while the image streams in */
+		StreamingImage,
+		/** showing the image */
+		ImageReady,
+		/** the image couldn't be loaded, the placeholder stays */
+		ImageFailed,
+	};
+
+	void Construct(const FArguments& InArgs);
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+	EState GetState() const
+	{
+		return State;
+	}
+
+	static const TCHAR* GetStateName(EState InState);
+
+	/** The brush is read while painting, which happens on the loading thread while the game thread loads */
+	const FSlateBrush* GetImageBrush() const;
+
+	/** Fraction of the async loads seen since the loading screen came up that are done, unset while nothing is known yet */
+	TOptional<float> GetLoadPercent() const;
+
+private:
+	void SetState(EState NewState);
+
+	/** Streams the loading screen image in, the placeholder is shown in the meantime */
+	void RequestImage();
+
+	void OnImageLoaded(UObject* Texture);
+
+	int32 GetNumPendingRequests() const;
+
+	EVisibility GetProgressVisibility() const;
+
+	EVisibility GetLoadIndicatorVisibility() const;
+
+	/** loading screen image brush */
+	TSharedPtr<FTrueFPSSystemLoadingScreenBrush> LoadingScreenBrush;
+
+	/** object path of the image shown once streamed in */
+	FString ImagePath;
+
+	std::atomic<EState> State{ EState::Placeholder };
+
+	/** most async loads seen pending at once, what progress is measured against */
+	mutable int32 MaxPendingPackages;
+
+	/** when the loading screen was requested */
+	double StartTime;
+
+	mutable bool bFirstFramePainted = false;
+};
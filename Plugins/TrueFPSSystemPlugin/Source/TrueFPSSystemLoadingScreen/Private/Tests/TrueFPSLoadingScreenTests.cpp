@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "STrueFPSLoadingScreen2.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Misc/PackageName.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace TrueFPSLoadingScreenTests
+{
+	static const TCHAR* ImagePath = TEXT("/TrueFPSSystemPlugin/UI/Menu/LoadingScreen.LoadingScreen");
+	static const TCHAR* MissingImagePath = TEXT("/TrueFPSSystemPlugin/Tests/NoSuchLoadingScreen.NoSuchLoadingScreen");
+
+	/** whether the widget is showing the placeholder, which has no image to it */
+	static bool IsShowingPlaceholder(const STrueFPSLoadingScreen2& LoadingScreen)
+	{
+		const FSlateBrush* Brush = LoadingScreen.GetImageBrush();
+		return Brush && Brush->GetResourceObject() == nullptr;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrueFPSLoadingScreenStatesTest, "TrueFPS.LoadingScreen.States",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTrueFPSLoadingScreenStatesTest::RunTest(const FString& Parameters)
+{
+	using namespace TrueFPSLoadingScreenTests;
+
+	// Runs with -nullrhi, the widget is built and polled but never painted
+	if (!FSlateApplication::IsInitialized())
+	{
+		AddInfo(TEXT("Skipped, the loading screen widget needs Slate"));
+		return true;
+	}
+
+	// An image that doesn't exist leaves the placeholder up
+	{
+		const TSharedRef<STrueFPSLoadingScreen2> LoadingScreen = SNew(STrueFPSLoadingScreen2).ImagePath(MissingImagePath);
+		TestEqual(TEXT("A missing image is requested"), LoadingScreen->GetState(), STrueFPSLoadingScreen2::EState::StreamingImage);
+		TestTrue(TEXT("The placeholder shows while a missing image is requested"), IsShowingPlaceholder(*LoadingScreen));
+		TestTrue(TEXT("The requested image counts as pending"), LoadingScreen->GetLoadPercent().IsSet() && LoadingScreen->GetLoadPercent().GetValue() < 1.0f);
+
+		AddExpectedError(TEXT("Couldn't load loading screen image"), EAutomationExpectedErrorFlags::Contains, 1);
+		FlushAsyncLoading();
+
+		TestEqual(TEXT("A missing image fails"), LoadingScreen->GetState(), STrueFPSLoadingScreen2::EState::ImageFailed);
+		TestTrue(TEXT("The placeholder stays when the image fails"), IsShowingPlaceholder(*LoadingScreen));
+	}
+
+	if (!FPackageName::DoesPackageExist(FPackageName::ObjectPathToPackageName(FString(ImagePath))))
+	{
+		AddInfo(TEXT("Loading screen image transitions skipped, the image isn't in this build"));
+		return true;
+	}
+
+	// The first loading screen streams the image in behind the placeholder
+	const bool bWasLoaded = FindObject<UObject>(nullptr, ImagePath) != nullptr;
+
+	double StartTime = FPlatformTime::Seconds();
+	const TSharedRef<STrueFPSLoadingScreen2> LoadingScreen = SNew(STrueFPSLoadingScreen2).ImagePath(ImagePath);
+	const double ConstructSeconds = FPlatformTime::Seconds() - StartTime;
+
+	if (!bWasLoaded)
+	{
+		TestEqual(TEXT("The image is requested"), LoadingScreen->GetState(), STrueFPSLoadingScreen2::EState::StreamingImage);
+		TestTrue(TEXT("The placeholder shows while the image streams in"), IsShowingPlaceholder(*LoadingScreen));
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	FlushAsyncLoading();
+	const double StreamSeconds = FPlatformTime::Seconds() - StartTime;
+
+	UObject* Image = FindObject<UObject>(nullptr, ImagePath);
+	TestEqual(TEXT("The image is shown once streamed in"), LoadingScreen->GetState(), STrueFPSLoadingScreen2::EState::ImageReady);
+	TestTrue(TEXT("The streamed in image is what's drawn"), Image && LoadingScreen->GetImageBrush()->GetResourceObject() == Image);
+	if (!bWasLoaded)
+	{
+		TestTrue(TEXT("Progress is complete once the image is in"), LoadingScreen->GetLoadPercent().IsSet() && LoadingScreen->GetLoadPercent().GetValue() == 1.0f);
+	}
+
+	// Later loading screens find it loaded and show it right away
+	const TSharedRef<STrueFPSLoadingScreen2> NextLoadingScreen = SNew(STrueFPSLoadingScreen2).ImagePath(ImagePath);
+	TestEqual(TEXT("A loaded image is shown right away"), NextLoadingScreen->GetState(), STrueFPSLoadingScreen2::EState::ImageReady);
+
+	AddInfo(FString::Printf(TEXT("Loading screen built in %.2fms (image %s), image streamed in %.2fms later"),
+		ConstructSeconds * 1000.0, bWasLoaded ? TEXT("already loaded") : TEXT("requested"), StreamSeconds * 1000.0));
+
+	return true;
+}
+
+#endif// WITH_DEV_AUTOMATION_TESTS
@@ -1,14 +1,28 @@
 ﻿
 #include "TrueFPSSystemLoadingScreen.h"
+#include "STrueFPSLoadingScreen2.h"
 #include "MoviePlayer.h"
+#include "Misc/PackageName.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
 #include "Widgets/Images/SThrobber.h"
 #include "Widgets/Layout/SSafeZone.h"
+#include "Widgets/Notifications/SProgressBar.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTrueFPSLoadingScreen, Log, All);
 
 // This module must be loaded "PreLoadingScreen" in the .uproject file, otherwise it will not hook in time!
 FLinearColor Tint = FLinearColor::White;
 ESlateBrushTileType::Type Tiling = ESlateBrushTileType::NoTile;
 ESlateBrushImageType::Type ImageType = ESlateBrushImageType::FullColor;
 
+static const TCHAR* LoadingScreenImagePath = TEXT("/TrueFPSSystemPlugin/UI/Menu/LoadingScreen.LoadingScreen");
+
+/** Shown until the loading screen image is streamed in, needs no asset at all */
+static const FSlateColorBrush LoadingScreenPlaceholderBrush(FLinearColor(0.005f, 0.005f, 0.008f));
+
 struct FTrueFPSSystemLoadingScreenBrush : public FSlateDynamicImageBrush, public FGCObject
 {
 	FTrueFPSSystemLoadingScreenBrush( const FName InTextureName, const FVector2D& InImageSize,const FLinearColor& InTint = FLinearColor::White,  // Default value for tint
@@ -16,7 +30,13 @@ struct FTrueFPSSystemLoadingScreenBrush : public FSlateDynamicImageBrush, public
 									 ESlateBrushImageType::Type InImageType = ESlateBrushImageType::FullColor ) // Default image type
 		: FSlateDynamicImageBrush( InTextureName, InImageSize, InTint, InTiling, InImageType )
 	{
-		SetResourceObject(LoadObject<UObject>( nullptr, *InTextureName.ToString() ));
+		// The texture is streamed in by the owner, see SetTexture
+	}
+
+	/** [game thread] Hands the streamed in texture to the brush */
+	void SetTexture(UObject* Texture)
+	{
+		SetResourceObject(Texture);
 	}
 
 	virtual void AddReferencedObjects(FReferenceCollector& Collector)
@@ -30,64 +50,169 @@ struct FTrueFPSSystemLoadingScreenBrush : public FSlateDynamicImageBrush, public
 	}
 };
 
-class STrueFPSLoadingScreen2 : public SCompoundWidget
+void STrueFPSLoadingScreen2::Construct(const FArguments& InArgs)
 {
-public:
-	SLATE_BEGIN_ARGS(STrueFPSLoadingScreen2) {}
-	SLATE_END_ARGS()
-
-	void Construct(const FArguments& InArgs)
-	{
-		static const FName LoadingScreenName(TEXT("/TrueFPSSystemPlugin/UI/Menu/LoadingScreen.LoadingScreen"));
-
-		//since we are not using game styles here, just load one image
-		LoadingScreenBrush = MakeShareable(
-			new FTrueFPSSystemLoadingScreenBrush(LoadingScreenName, FVector2D(1920, 1080), Tint, Tiling, ImageType));
-
-		ChildSlot
+	StartTime = FPlatformTime::Seconds();
+	MaxPendingPackages = 0;
+	ImagePath = InArgs._ImagePath.IsEmpty() ? FString(LoadingScreenImagePath) : InArgs._ImagePath;
+
+	LoadingScreenBrush = MakeShareable(
+		new FTrueFPSSystemLoadingScreenBrush(FName(*ImagePath), FVector2D(1920, 1080), Tint, Tiling, ImageType));
+
+	ChildSlot
+	[
+		SNew(SOverlay)
+		+SOverlay::Slot()
+		.HAlign(HAlign_Fill)
+		.VAlign(VAlign_Fill)
 		[
-			SNew(SOverlay)
-			+SOverlay::Slot()
-			.HAlign(HAlign_Fill)
-			.VAlign(VAlign_Fill)
-			[
-				SNew(SImage)
-				.Image(LoadingScreenBrush.Get())
-			]
-			+SOverlay::Slot()
-			.HAlign(HAlign_Fill)
-			.VAlign(VAlign_Fill)
+			SNew(SImage)
+			.Image(this, &STrueFPSLoadingScreen2::GetImageBrush)
+		]
+		+SOverlay::Slot()
+		.HAlign(HAlign_Fill)
+		.VAlign(VAlign_Fill)
+		[
+			SNew(SSafeZone)
+			.VAlign(VAlign_Bottom)
+			.HAlign(HAlign_Right)
+			.Padding(10.0f)
+			.IsTitleSafe(true)
 			[
-				SNew(SSafeZone)
-				.VAlign(VAlign_Bottom)
+				SNew(SVerticalBox)
+				+SVerticalBox::Slot()
+				.AutoHeight()
 				.HAlign(HAlign_Right)
-				.Padding(10.0f)
-				.IsTitleSafe(true)
 				[
 					SNew(SThrobber)
 					.Visibility(this, &STrueFPSLoadingScreen2::GetLoadIndicatorVisibility)
 				]
+				+SVerticalBox::Slot()
+				.AutoHeight()
+				[
+					SNew(SBox)
+					.WidthOverride(300.0f)
+					.Visibility(this, &STrueFPSLoadingScreen2::GetProgressVisibility)
+					[
+						SNew(SProgressBar)
+						.Percent(this, &STrueFPSLoadingScreen2::GetLoadPercent)
+					]
+				]
 			]
-		];
+		]
+	];
+
+	RequestImage();
+}
+
+int32 STrueFPSLoadingScreen2::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	if (!bFirstFramePainted)
+	{
+		bFirstFramePainted = true;
+		TRACE_BOOKMARK(TEXT("LoadingScreen.FirstFrame"));
+		UE_LOG(LogTrueFPSLoadingScreen, Log, TEXT("First loading screen frame %.1fms after it was requested (%s)"), (FPlatformTime::Seconds() - StartTime) * 1000.0, GetStateName(State));
 	}
 
-private:
-	EVisibility GetLoadIndicatorVisibility() const
+	return SCompoundWidget::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+}
+
+const TCHAR* STrueFPSLoadingScreen2::GetStateName(EState InState)
+{
+	switch (InState)
 	{
-		return EVisibility::Visible;
+	case EState::Placeholder: return TEXT("Placeholder");
+	case EState::StreamingImage: return TEXT("StreamingImage");
+	case EState::ImageReady: return TEXT("ImageReady");
+	default: return TEXT("ImageFailed");
 	}
+}
 
-	/** loading screen image brush */
-	TSharedPtr<FSlateDynamicImageBrush> LoadingScreenBrush;
-};
+void STrueFPSLoadingScreen2::SetState(EState NewState)
+{
+	UE_LOG(LogTrueFPSLoadingScreen, Verbose, TEXT("Loading screen %s -> %s"), GetStateName(State), GetStateName(NewState));
+	State = NewState;
+}
+
+void STrueFPSLoadingScreen2::RequestImage()
+{
+	// Already around if a previous loading screen loaded it
+	if (UObject* Texture = FindObject<UObject>(nullptr, *ImagePath))
+	{
+		OnImageLoaded(Texture);
+		return;
+	}
+
+	SetState(EState::StreamingImage);
+
+	TWeakPtr<STrueFPSLoadingScreen2> WeakThis = SharedThis(this);
+	LoadPackageAsync(FPackageName::ObjectPathToPackageName(ImagePath), FLoadPackageAsyncDelegate::CreateLambda([WeakThis](const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+	{
+		TSharedPtr<STrueFPSLoadingScreen2> LoadingScreen = WeakThis.Pin();
+		if (LoadingScreen.IsValid())
+		{
+			LoadingScreen->OnImageLoaded(Result == EAsyncLoadingResult::Succeeded ? FindObject<UObject>(nullptr, *LoadingScreen->ImagePath) : nullptr);
+		}
+	}), TAsyncLoadPriority(100));
+}
+
+void STrueFPSLoadingScreen2::OnImageLoaded(UObject* Texture)
+{
+	if (Texture == nullptr)
+	{
+		UE_LOG(LogTrueFPSLoadingScreen, Warning, TEXT("Couldn't load loading screen image %s"), *ImagePath);
+		SetState(EState::ImageFailed);
+		return;
+	}
+
+	LoadingScreenBrush->SetTexture(Texture);
+	SetState(EState::ImageReady);
+}
+
+const FSlateBrush* STrueFPSLoadingScreen2::GetImageBrush() const
+{
+	return State == EState::ImageReady ? LoadingScreenBrush.Get() : &LoadingScreenPlaceholderBrush;
+}
+
+int32 STrueFPSLoadingScreen2::GetNumPendingRequests() const
+{
+	// The image itself counts until it's in
+	return GetNumAsyncPackages() + (State == EState::StreamingImage ? 1 : 0);
+}
+
+TOptional<float> STrueFPSLoadingScreen2::GetLoadPercent() const
+{
+	const int32 PendingRequests = GetNumPendingRequests();
+	MaxPendingPackages = FMath::Max(MaxPendingPackages, PendingRequests);
+	if (MaxPendingPackages == 0)
+	{
+		return TOptional<float>();
+	}
+
+	return 1.0f - (float)PendingRequests / (float)MaxPendingPackages;
+}
+
+EVisibility STrueFPSLoadingScreen2::GetProgressVisibility() const
+{
+	return MaxPendingPackages > 0 ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+EVisibility STrueFPSLoadingScreen2::GetLoadIndicatorVisibility() const
+{
+	// Only spin when there is nothing to report progress on
+	return GetNumPendingRequests() > 0 || IsAsyncLoading() ? EVisibility::Collapsed : EVisibility::Visible;
+}
 
 class FTrueFPSSystemLoadingScreenModule : public ITrueFPSSystemLoadingScreenModule
 {
 public:
 	virtual void StartupModule() override
 	{		
-		// Load for cooker reference
-		LoadObject<UObject>(nullptr, TEXT("/TrueFPSSystemPlugin/UI/Menu/LoadingScreen.LoadingScreen") );
+		// Load for cooker reference. Anywhere else this would block startup before the first frame, the image is streamed in when needed
+		if (IsRunningCommandlet())
+		{
+			LoadObject<UObject>(nullptr, LoadingScreenImagePath);
+		}
 
 
 		// Previously, we set up our startup movie here to play while the engine was initially loading. By removing this behavior, 
@@ -111,6 +236,8 @@ public:
 
 	virtual void StartInGameLoadingScreen() override
 	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(StartInGameLoadingScreen);
+
 		FLoadingScreenAttributes LoadingScreen;
 		LoadingScreen.bAutoCompleteWhenLoadingCompletes = true;
 		LoadingScreen.WidgetLoadingScreen = SNew(STrueFPSLoadingScreen2);